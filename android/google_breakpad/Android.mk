@@ -79,6 +79,8 @@ LOCAL_SRC_FILES := \
     src/client/linux/microdump_writer/microdump_writer.cc \
     src/client/linux/minidump_writer/linux_dumper.cc \
     src/client/linux/minidump_writer/linux_ptrace_dumper.cc \
+    src/client/linux/minidump_writer/mapping_info_cache.cc \
+    src/client/linux/minidump_writer/minidump_compressor.cc \
     src/client/linux/minidump_writer/minidump_writer.cc \
     src/client/minidump_file_writer.cc \
     src/common/convert_UTF.cc \
@@ -31,14 +31,18 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <limits.h>
-#include <poll.h>
+#include <signal.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "client/linux/crash_generation/crash_generation_server.h"
@@ -50,9 +54,54 @@
 #include "common/linux/safe_readlink.h"
 
 static const char kCommandQuit = 'x';
+// Sent by a worker that freed a queue slot while the server was throttled.
+static const char kCommandWake = 'w';
+
+static const int kDefaultWorkerCount = 4;
+static const size_t kDefaultMaxPendingRequests = 64;
 
 namespace google_breakpad {
 
+namespace {
+
+uint64_t NowUsec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Return a pidfd referring to |pid|, or -1 if the kernel cannot make one.
+int OpenPidfd(pid_t pid) {
+#if defined(__NR_pidfd_open)
+  return syscall(__NR_pidfd_open, pid, 0);
+#else
+  return -1;
+#endif
+}
+
+}  // namespace
+
+// A dump request received from a client, waiting for a worker.
+struct CrashGenerationServer::PendingRequest {
+  ~PendingRequest() {
+    if (pidfd != -1)
+      close(pidfd);
+  }
+
+  pid_t pid;
+  // Pins |pid| to the client, so that killing it cannot hit another process
+  // that reused the pid after the client died.  -1 on kernels without
+  // pidfds, which fall back to kill().
+  int pidfd;
+  // Closing this releases the client.
+  int signal_fd;
+  uint64_t enqueue_usec;
+  // Set once the client has been killed for taking too long to dump.
+  bool killed;
+  string minidump_filename;
+  char crash_context[sizeof(ExceptionHandler::CrashContext)];
+};
+
 CrashGenerationServer::CrashGenerationServer(
   const int listen_fd,
   OnClientDumpRequestCallback dump_callback,
@@ -67,18 +116,30 @@ CrashGenerationServer::CrashGenerationServer(
     exit_callback_(exit_callback),
     exit_context_(exit_context),
     generate_dumps_(generate_dumps),
-    started_(false)
+    started_(false),
+    worker_count_(kDefaultWorkerCount),
+    max_pending_requests_(kDefaultMaxPendingRequests),
+    request_timeout_ms_(0),
+    stopping_(false),
+    throttled_(false)
 {
   if (dump_path)
     dump_dir_ = *dump_path;
   else
     dump_dir_ = "/tmp";
+
+  memset(&stats_, 0, sizeof(stats_));
+  pthread_mutex_init(&queue_mutex_, NULL);
+  pthread_cond_init(&queue_cond_, NULL);
 }
 
 CrashGenerationServer::~CrashGenerationServer()
 {
   if (started_)
     Stop();
+
+  pthread_cond_destroy(&queue_cond_);
+  pthread_mutex_destroy(&queue_mutex_);
 }
 
 bool
@@ -102,9 +163,30 @@ CrashGenerationServer::Start()
   control_pipe_in_ = control_pipe[0];
   control_pipe_out_ = control_pipe[1];
 
-  if (pthread_create(&thread_, NULL,
-                     ThreadMain, reinterpret_cast<void*>(this)))
+  stopping_ = false;
+  throttled_ = false;
+  for (int i = 0; i < worker_count_; ++i) {
+    pthread_t worker;
+    if (pthread_create(&worker, NULL,
+                       WorkerMain, reinterpret_cast<void*>(this)))
+      break;
+    workers_.push_back(worker);
+  }
+
+  if (workers_.size() != static_cast<size_t>(worker_count_) ||
+      pthread_create(&thread_, NULL,
+                     ThreadMain, reinterpret_cast<void*>(this))) {
+    pthread_mutex_lock(&queue_mutex_);
+    stopping_ = true;
+    pthread_cond_broadcast(&queue_cond_);
+    pthread_mutex_unlock(&queue_mutex_);
+    for (size_t i = 0; i < workers_.size(); ++i)
+      pthread_join(workers_[i], NULL);
+    workers_.clear();
+    close(control_pipe_in_);
+    close(control_pipe_out_);
     return false;
+  }
 
   started_ = true;
   return true;
@@ -123,6 +205,22 @@ CrashGenerationServer::Stop()
   void* dummy;
   pthread_join(thread_, &dummy);
 
+  // The server thread no longer queues requests; release the clients that
+  // are still waiting and let the workers finish their current dump.
+  pthread_mutex_lock(&queue_mutex_);
+  stopping_ = true;
+  while (!queue_.empty()) {
+    DropRequest(queue_.front());
+    queue_.pop_front();
+  }
+  stats_.queue_depth = 0;
+  pthread_cond_broadcast(&queue_cond_);
+  pthread_mutex_unlock(&queue_mutex_);
+
+  for (size_t i = 0; i < workers_.size(); ++i)
+    pthread_join(workers_[i], NULL);
+  workers_.clear();
+
   close(control_pipe_in_);
   close(control_pipe_out_);
 
@@ -153,45 +251,93 @@ CrashGenerationServer::CreateReportChannel(int* server_fd, int* client_fd)
   return true;
 }
 
+void
+CrashGenerationServer::GetStats(Stats* stats)
+{
+  pthread_mutex_lock(&queue_mutex_);
+  *stats = stats_;
+  pthread_mutex_unlock(&queue_mutex_);
+  stats->mapping_cache_hits = mapping_cache_.hits();
+  stats->mapping_cache_misses = mapping_cache_.misses();
+}
+
 // The following methods/functions execute on the server thread
 
 void
 CrashGenerationServer::Run()
 {
-  struct pollfd pollfds[2];
-  memset(&pollfds, 0, sizeof(pollfds));
-
-  pollfds[0].fd = server_fd_;
-  pollfds[0].events = POLLIN;
+  int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd < 0)
+    return;
 
-  pollfds[1].fd = control_pipe_in_;
-  pollfds[1].events = POLLIN;
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.fd = server_fd_;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_fd_, &event)) {
+    close(epoll_fd);
+    return;
+  }
+  event.data.fd = control_pipe_in_;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, control_pipe_in_, &event)) {
+    close(epoll_fd);
+    return;
+  }
 
+  bool reading = true;
   while (true) {
-    // infinite timeout
-    int nevents = poll(pollfds, sizeof(pollfds)/sizeof(pollfds[0]), -1);
+    pthread_mutex_lock(&queue_mutex_);
+    const int timeout_ms = ExpireRequestsLocked(NowUsec());
+    const bool throttle = queue_.size() >= max_pending_requests_;
+    throttled_ = throttle;
+    pthread_mutex_unlock(&queue_mutex_);
+
+    // While the queue is full, leave further requests in the socket: their
+    // clients stay blocked until a worker frees a slot and wakes us up.
+    // Hang-ups are still reported with an empty event mask.
+    if (throttle == reading) {
+      if (throttle)
+        event.events = 0;
+      else
+        event.events = EPOLLIN;
+      event.data.fd = server_fd_;
+      epoll_ctl(epoll_fd, EPOLL_CTL_MOD, server_fd_, &event);
+      reading = !throttle;
+    }
+
+    struct epoll_event events[2];
+    int nevents = epoll_wait(epoll_fd, events,
+                             sizeof(events)/sizeof(events[0]), timeout_ms);
     if (-1 == nevents) {
       if (EINTR == errno) {
         continue;
       } else {
-        return;
+        break;
       }
     }
 
-    if (pollfds[0].revents && !ClientEvent(pollfds[0].revents))
-      return;
-
-    if (pollfds[1].revents && !ControlEvent(pollfds[1].revents))
-      return;
+    bool keep_running = true;
+    for (int i = 0; i < nevents; ++i) {
+      if (events[i].data.fd == server_fd_) {
+        if (!ClientEvent(events[i].events))
+          keep_running = false;
+      } else if (!ControlEvent(events[i].events)) {
+        keep_running = false;
+      }
+    }
+    if (!keep_running)
+      break;
   }
+
+  close(epoll_fd);
 }
 
 bool
-CrashGenerationServer::ClientEvent(short revents)
+CrashGenerationServer::ClientEvent(uint32_t events)
 {
-  if (POLLHUP & revents)
+  if (EPOLLHUP & events)
     return false;
-  assert(POLLIN & revents);
+  assert(EPOLLIN & events);
 
   // A process has crashed and has signaled us by writing a datagram
   // to the death signal socket. The datagram contains the crash context needed
@@ -261,50 +407,201 @@ CrashGenerationServer::ClientEvent(short revents)
   }
 
   string minidump_filename;
-  if (!MakeMinidumpFilename(minidump_filename))
-    return true;
-
-  if (!google_breakpad::WriteMinidump(minidump_filename.c_str(),
-                                      crashing_pid, crash_context,
-                                      kCrashContextSize)) {
+  if (!MakeMinidumpFilename(minidump_filename)) {
     close(signal_fd);
     return true;
   }
 
-  if (dump_callback_) {
-    ClientInfo info(crashing_pid, this);
-
-    dump_callback_(dump_context_, &info, &minidump_filename);
-  }
-
-  // Send the done signal to the process: it can exit now.
-  // (Closing this will make the child's sys_read unblock and return 0.)
-  close(signal_fd);
+  PendingRequest* request = new PendingRequest;
+  request->pid = crashing_pid;
+  request->pidfd = OpenPidfd(crashing_pid);
+  request->signal_fd = signal_fd;
+  request->enqueue_usec = NowUsec();
+  request->killed = false;
+  request->minidump_filename = minidump_filename;
+  memcpy(request->crash_context, crash_context, kCrashContextSize);
+
+  pthread_mutex_lock(&queue_mutex_);
+  queue_.push_back(request);
+  stats_.queue_depth = queue_.size();
+  if (stats_.queue_depth > stats_.max_queue_depth)
+    stats_.max_queue_depth = stats_.queue_depth;
+  pthread_cond_signal(&queue_cond_);
+  pthread_mutex_unlock(&queue_mutex_);
 
   return true;
 }
 
 bool
-CrashGenerationServer::ControlEvent(short revents)
+CrashGenerationServer::ControlEvent(uint32_t events)
 {
-  if (POLLHUP & revents)
+  if (EPOLLHUP & events)
     return false;
-  assert(POLLIN & revents);
+  assert(EPOLLIN & events);
 
+  // Several wake-ups may have piled up; the pipe is non-blocking.
   char command;
-  if (read(control_pipe_in_, &command, 1))
-    return false;
-
-  switch (command) {
-  case kCommandQuit:
-    return false;
-  default:
-    assert(0);
+  while (HANDLE_EINTR(read(control_pipe_in_, &command, 1)) == 1) {
+    switch (command) {
+    case kCommandQuit:
+      return false;
+    case kCommandWake:
+      // Run() re-evaluates the queue on every iteration.
+      break;
+    default:
+      assert(0);
+    }
   }
 
   return true;
 }
 
+int
+CrashGenerationServer::ExpireRequestsLocked(uint64_t now_usec)
+{
+  int next_timeout_ms = -1;
+  if (request_timeout_ms_) {
+    const uint64_t timeout_usec =
+        static_cast<uint64_t>(request_timeout_ms_) * 1000;
+    // The queue is FIFO, so the oldest request is always at the front.
+    while (!queue_.empty()) {
+      PendingRequest* request = queue_.front();
+      const uint64_t age_usec = now_usec - request->enqueue_usec;
+      if (age_usec < timeout_usec) {
+        next_timeout_ms = (timeout_usec - age_usec + 999) / 1000;
+        break;
+      }
+      queue_.pop_front();
+      ++stats_.requests_timed_out;
+      DropRequest(request);
+    }
+
+    // A dump that takes too long is most likely stuck in ptrace on a
+    // wedged client.  Only the worker, as the tracer, could detach from
+    // it, so kill the client instead: that makes the worker's calls fail,
+    // and the dumper reaps the threads it had attached.
+    for (size_t i = 0; i < active_.size(); ++i) {
+      PendingRequest* request = active_[i];
+      if (request->killed)
+        continue;
+      const uint64_t age_usec = now_usec - request->enqueue_usec;
+      if (age_usec >= timeout_usec) {
+        KillClient(request);
+        request->killed = true;
+        ++stats_.dumps_timed_out;
+        continue;
+      }
+      const int timeout_ms = (timeout_usec - age_usec + 999) / 1000;
+      if (next_timeout_ms == -1 || timeout_ms < next_timeout_ms)
+        next_timeout_ms = timeout_ms;
+    }
+  }
+  stats_.queue_depth = queue_.size();
+  return next_timeout_ms;
+}
+
+void
+CrashGenerationServer::HandleRequest(PendingRequest* request)
+{
+  const uint64_t start_usec = NowUsec();
+  const bool written =
+      google_breakpad::WriteMinidump(request->minidump_filename.c_str(),
+                                     request->pid, request->crash_context,
+                                     sizeof(request->crash_context),
+                                     &mapping_cache_);
+  const uint64_t dump_usec = NowUsec() - start_usec;
+
+  pthread_mutex_lock(&queue_mutex_);
+  active_.erase(std::find(active_.begin(), active_.end(), request));
+  if (written) {
+    ++stats_.dumps_written;
+  } else {
+    ++stats_.dumps_failed;
+  }
+  stats_.total_dump_usec += dump_usec;
+  if (dump_usec > stats_.max_dump_usec)
+    stats_.max_dump_usec = dump_usec;
+  pthread_mutex_unlock(&queue_mutex_);
+
+  if (written && dump_callback_) {
+    ClientInfo info(request->pid, this);
+
+    dump_callback_(dump_context_, &info, &request->minidump_filename);
+  }
+
+  // Send the done signal to the process: it can exit now.
+  // (Closing this will make the child's sys_read unblock and return 0.)
+  close(request->signal_fd);
+  delete request;
+
+  pthread_mutex_lock(&queue_mutex_);
+  --stats_.active_dumps;
+  pthread_mutex_unlock(&queue_mutex_);
+}
+
+// static
+void
+CrashGenerationServer::KillClient(const PendingRequest* request)
+{
+#if defined(__NR_pidfd_send_signal)
+  if (request->pidfd != -1) {
+    syscall(__NR_pidfd_send_signal, request->pidfd, SIGKILL, NULL, 0);
+    return;
+  }
+#endif
+  kill(request->pid, SIGKILL);
+}
+
+// static
+void
+CrashGenerationServer::DropRequest(PendingRequest* request)
+{
+  close(request->signal_fd);
+  delete request;
+}
+
+void
+CrashGenerationServer::WorkerRun()
+{
+  pthread_mutex_lock(&queue_mutex_);
+  while (true) {
+    while (queue_.empty() && !stopping_)
+      pthread_cond_wait(&queue_cond_, &queue_mutex_);
+    if (stopping_)
+      break;
+
+    PendingRequest* request = queue_.front();
+    queue_.pop_front();
+    stats_.queue_depth = queue_.size();
+    const bool wake_server = throttled_;
+    throttled_ = false;
+
+    // The server thread only expires requests when it wakes up, so this one
+    // may have outlived its timeout while it waited for us.
+    if (request_timeout_ms_ &&
+        NowUsec() - request->enqueue_usec >=
+            static_cast<uint64_t>(request_timeout_ms_) * 1000) {
+      ++stats_.requests_timed_out;
+      DropRequest(request);
+      request = NULL;
+    } else {
+      // The server thread last saw this request queued, so its timeout
+      // already covers the request's deadline.
+      active_.push_back(request);
+      ++stats_.active_dumps;
+    }
+    pthread_mutex_unlock(&queue_mutex_);
+
+    if (wake_server)
+      HANDLE_EINTR(write(control_pipe_out_, &kCommandWake, 1));
+    if (request)
+      HandleRequest(request);
+
+    pthread_mutex_lock(&queue_mutex_);
+  }
+  pthread_mutex_unlock(&queue_mutex_);
+}
+
 bool
 CrashGenerationServer::MakeMinidumpFilename(string& outFilename)
 {
@@ -330,4 +627,12 @@ CrashGenerationServer::ThreadMain(void* arg)
   return NULL;
 }
 
+// static
+void*
+CrashGenerationServer::WorkerMain(void* arg)
+{
+  reinterpret_cast<CrashGenerationServer*>(arg)->WorkerRun();
+  return NULL;
+}
+
 }  // namespace google_breakpad
@@ -31,9 +31,13 @@
 #define CLIENT_LINUX_CRASH_GENERATION_CRASH_GENERATION_SERVER_H_
 
 #include <pthread.h>
+#include <stdint.h>
 
+#include <deque>
 #include <string>
+#include <vector>
 
+#include "client/linux/minidump_writer/mapping_info_cache.h"
 #include "common/using_std_string.h"
 
 namespace google_breakpad {
@@ -43,8 +47,9 @@ class ClientInfo;
 class CrashGenerationServer {
 public:
   // WARNING: callbacks may be invoked on a different thread
-  // than that which creates the CrashGenerationServer.  They must
-  // be thread safe.
+  // than that which creates the CrashGenerationServer.  With more than
+  // one worker thread they may also run concurrently with each other.
+  // They must be thread safe.
   typedef void (*OnClientDumpRequestCallback)(void* context,
                                               const ClientInfo* client_info,
                                               const string* file_path);
@@ -80,9 +85,58 @@ public:
   // Return true if initialization is successful; false otherwise.
   bool Start();
 
-  // Stop the server.
+  // Stop the server.  Requests still waiting in the queue are dropped
+  // (their clients are released without a dump); dumps already being
+  // written are allowed to finish.
   void Stop();
 
+  // Snapshot of the request pipeline counters.  Durations are in
+  // microseconds.
+  struct Stats {
+    size_t queue_depth;          // Requests waiting for a worker.
+    size_t max_queue_depth;      // High-water mark of |queue_depth|.
+    size_t active_dumps;         // Dumps currently being written.
+    uint64_t dumps_written;
+    uint64_t dumps_failed;
+    uint64_t requests_timed_out;  // Dropped while waiting for a worker.
+    uint64_t dumps_timed_out;    // Clients killed while being dumped.
+    uint64_t total_dump_usec;    // Sum of WriteMinidump() durations.
+    uint64_t max_dump_usec;
+    // Lookups of mapped files in the cache shared by all dumps.
+    uint64_t mapping_cache_hits;
+    uint64_t mapping_cache_misses;
+  };
+
+  // Fill |stats| with the current counters.  Safe to call from any thread.
+  void GetStats(Stats* stats);
+
+  // Number of threads writing dumps in parallel.  Must be called before
+  // Start().
+  void set_worker_count(int count) { worker_count_ = count > 0 ? count : 1; }
+
+  // Maximum number of received requests waiting for a worker.  When the
+  // queue is full the server stops reading the socket, so further
+  // clients stay blocked in their crash handler until a slot frees up.
+  // Must be called before Start().
+  void set_max_pending_requests(size_t max) {
+    max_pending_requests_ = max > 0 ? max : 1;
+  }
+
+  // Give up on a client this long after its request was received.  If
+  // the request is still waiting for a worker, it is dropped and the
+  // client released without a dump.  If its dump is still being written,
+  // the client is killed with SIGKILL: a worker blocked in ptrace on a
+  // wedged client cannot be interrupted otherwise.  The kill cuts the dump
+  // short, keeping whatever was written, and the worker reaps the client
+  // threads it had attached to.  The client is
+  // killed through a pidfd where the kernel supports them (Linux 5.3+), so
+  // a reused pid is never hit; older kernels fall back to kill().  The dump
+  // callback is not bounded.  0 (the default) waits forever.  Must be
+  // called before Start().
+  void set_request_timeout_ms(int timeout_ms) {
+    request_timeout_ms_ = timeout_ms > 0 ? timeout_ms : 0;
+  }
+
   // Create a "channel" that can be used by clients to report crashes
   // to a CrashGenerationServer.  |*server_fd| should be passed to
   // this class's constructor, and |*client_fd| should be passed to
@@ -90,16 +144,39 @@ public:
   static bool CreateReportChannel(int* server_fd, int* client_fd);
 
 private:
+  struct PendingRequest;
+
   // Run the server's event loop
   void Run();
 
   // Invoked when an child process (client) event occurs
   // Returning true => "keep running", false => "exit loop"
-  bool ClientEvent(short revents);
+  bool ClientEvent(uint32_t events);
 
   // Invoked when the controlling thread (main) event occurs
   // Returning true => "keep running", false => "exit loop"
-  bool ControlEvent(short revents);
+  bool ControlEvent(uint32_t events);
+
+  // Drop queued requests older than |request_timeout_ms_| and kill the
+  // clients of older dumps in progress.  Return the number of milliseconds
+  // until the next request expires (-1 if none).  Must be called with
+  // |queue_mutex_| held.
+  int ExpireRequestsLocked(uint64_t now_usec);
+
+  // Write the dump for |request| and release its client.
+  void HandleRequest(PendingRequest* request);
+
+  // Release the client of |request| without writing a dump.
+  static void DropRequest(PendingRequest* request);
+
+  // Send SIGKILL to the client of |request|.
+  static void KillClient(const PendingRequest* request);
+
+  // Worker thread loop: pop requests until the server stops.
+  void WorkerRun();
+
+  // Trampoline to |WorkerRun()|
+  static void* WorkerMain(void* arg);
 
   // Return a unique filename at which a minidump can be written
   bool MakeMinidumpFilename(string& outFilename);
@@ -125,6 +202,28 @@ private:
   int control_pipe_in_;
   int control_pipe_out_;
 
+  int worker_count_;
+  size_t max_pending_requests_;
+  int request_timeout_ms_;
+  std::vector<pthread_t> workers_;
+
+  // Guards everything below, shared between the server thread and the
+  // workers.
+  pthread_mutex_t queue_mutex_;
+  pthread_cond_t queue_cond_;
+  std::deque<PendingRequest*> queue_;
+  // Requests whose dump is being written.
+  std::vector<PendingRequest*> active_;
+  bool stopping_;
+  // True while the server thread has stopped reading the socket because
+  // the queue is full; the worker that frees a slot wakes it up.
+  bool throttled_;
+  Stats stats_;
+
+  // Build IDs and SONAMEs of the files mapped by clients: they mostly run
+  // the same binaries, which then only need to be read once.
+  MappingInfoCache mapping_cache_;
+
   // disable these
   CrashGenerationServer(const CrashGenerationServer&);
   CrashGenerationServer& operator=(const CrashGenerationServer&);
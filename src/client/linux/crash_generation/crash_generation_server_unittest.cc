@@ -0,0 +1,440 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// crash_generation_server_unittest.cc: Unit tests for
+// CrashGenerationServer's worker pool, queue and timeouts.
+
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "breakpad_googletest_includes.h"
+#include "client/linux/crash_generation/crash_generation_server.h"
+#include "client/linux/handler/exception_handler.h"
+#include "client/linux/handler/minidump_descriptor.h"
+#include "common/linux/eintr_wrapper.h"
+#include "common/tests/auto_tempdir.h"
+#include "common/using_std_string.h"
+#include "third_party/lss/linux_syscall_support.h"
+
+using google_breakpad::AutoTempDir;
+using google_breakpad::ClientInfo;
+using google_breakpad::CrashGenerationServer;
+using google_breakpad::ExceptionHandler;
+using google_breakpad::MinidumpDescriptor;
+
+namespace {
+
+// How long to wait for something that should happen promptly.
+const int kWaitMs = 10000;
+
+// Holds the dump callbacks of the server's workers until released, and
+// counts how many are held at once.
+class CallbackGate {
+ public:
+  CallbackGate()
+      : open_(false), release_count_(0), held_(0), max_held_(0), calls_(0) {
+    pthread_mutex_init(&mutex_, NULL);
+    pthread_cond_init(&cond_, NULL);
+  }
+
+  ~CallbackGate() {
+    pthread_cond_destroy(&cond_);
+    pthread_mutex_destroy(&mutex_);
+  }
+
+  // Open the gate once |count| callbacks are held together.
+  void OpenWhenHolding(int count) {
+    pthread_mutex_lock(&mutex_);
+    release_count_ = count;
+    pthread_mutex_unlock(&mutex_);
+  }
+
+  void Open() {
+    pthread_mutex_lock(&mutex_);
+    open_ = true;
+    pthread_cond_broadcast(&cond_);
+    pthread_mutex_unlock(&mutex_);
+  }
+
+  int max_held() {
+    pthread_mutex_lock(&mutex_);
+    int max_held = max_held_;
+    pthread_mutex_unlock(&mutex_);
+    return max_held;
+  }
+
+  int calls() {
+    pthread_mutex_lock(&mutex_);
+    int calls = calls_;
+    pthread_mutex_unlock(&mutex_);
+    return calls;
+  }
+
+  static void DumpCallback(void* context, const ClientInfo* client_info,
+                           const string* file_path) {
+    reinterpret_cast<CallbackGate*>(context)->Hold();
+  }
+
+ private:
+  // Wait until the gate opens, or give up after kWaitMs so that a broken
+  // server fails the test instead of hanging it.
+  void Hold() {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += kWaitMs / 1000;
+
+    pthread_mutex_lock(&mutex_);
+    ++calls_;
+    ++held_;
+    if (held_ > max_held_)
+      max_held_ = held_;
+    if (release_count_ && held_ >= release_count_) {
+      open_ = true;
+      pthread_cond_broadcast(&cond_);
+    }
+    while (!open_) {
+      if (pthread_cond_timedwait(&cond_, &mutex_, &deadline) == ETIMEDOUT)
+        break;
+    }
+    --held_;
+    pthread_mutex_unlock(&mutex_);
+  }
+
+  pthread_mutex_t mutex_;
+  pthread_cond_t cond_;
+  bool open_;
+  int release_count_;
+  int held_;
+  int max_held_;
+  int calls_;
+};
+
+// A client thread waiting for a CLONE_VFORK child cannot be stopped by the
+// SIGSTOP that PTRACE_ATTACH sends, so a dumper attaching to it waits until
+// the client is killed.  The child dies with that thread.
+int WedgedChildMain(void* arg) {
+  prctl(PR_SET_PDEATHSIG, SIGKILL);
+  for (;;)
+    pause();
+  return 0;
+}
+
+void* WedgedThreadMain(void* arg) {
+  *reinterpret_cast<volatile pid_t*>(arg) = sys_gettid();
+  static char stack[64 * 1024];
+  clone(WedgedChildMain, stack + sizeof(stack), CLONE_VM | CLONE_VFORK,
+        NULL);
+  return NULL;
+}
+
+// Return true once thread |tid| of this process is in uninterruptible
+// sleep.
+bool ThreadIsInUninterruptibleSleep(pid_t tid) {
+  char path[64];
+  snprintf(path, sizeof(path), "/proc/self/task/%d/stat", tid);
+  FILE* file = fopen(path, "r");
+  if (!file)
+    return false;
+  char line[512];
+  const bool read = fgets(line, sizeof(line), file) != NULL;
+  fclose(file);
+  const char* end_of_name = read ? strrchr(line, ')') : NULL;
+  return end_of_name && end_of_name[1] == ' ' && end_of_name[2] == 'D';
+}
+
+class CrashGenerationServerTest : public testing::Test {
+ protected:
+  CrashGenerationServerTest() : server_fd_(-1), client_fd_(-1) {}
+
+  void SetUp() {
+    ASSERT_TRUE(
+        CrashGenerationServer::CreateReportChannel(&server_fd_, &client_fd_));
+    dump_dir_ = temp_dir_.path();
+  }
+
+  void TearDown() {
+    close(server_fd_);
+    close(client_fd_);
+  }
+
+  // Fork a client that asks the server to dump it and exits once the
+  // server releases it.  A |wedged| client has a thread that the dumper
+  // can't stop.
+  pid_t StartClient(bool wedged) {
+    const pid_t child = fork();
+    if (child != 0)
+      return child;
+
+    close(server_fd_);
+    if (wedged) {
+      volatile pid_t tid = 0;
+      pthread_t thread;
+      if (pthread_create(&thread, NULL, WedgedThreadMain,
+                         const_cast<pid_t*>(&tid)))
+        _exit(1);
+      while (!tid || !ThreadIsInUninterruptibleSleep(tid))
+        sched_yield();
+    }
+    ExceptionHandler handler(MinidumpDescriptor(dump_dir_), NULL, NULL, NULL,
+                             false, client_fd_);
+    _exit(handler.WriteMinidump() ? 0 : 1);
+  }
+
+  // Wait for |client| to exit normally.
+  void WaitForClient(pid_t client) {
+    int status;
+    ASSERT_EQ(client, HANDLE_EINTR(waitpid(client, &status, __WNOTHREAD)));
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+  }
+
+  // Poll |server|'s statistics until |condition| holds for them.  Return
+  // false if it doesn't within kWaitMs.
+  template<typename Condition>
+  bool WaitForStats(CrashGenerationServer* server, Condition condition,
+                    CrashGenerationServer::Stats* stats) {
+    for (int waited_ms = 0; waited_ms < kWaitMs; waited_ms += 10) {
+      server->GetStats(stats);
+      if (condition(*stats))
+        return true;
+      usleep(10 * 1000);
+    }
+    return false;
+  }
+
+  // True if a request is waiting, unread, in the server's socket.
+  bool RequestPending() {
+    struct pollfd pfd = { server_fd_, POLLIN, 0 };
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+  }
+
+  int CountMinidumps() {
+    int count = 0;
+    DIR* dir = opendir(dump_dir_.c_str());
+    if (!dir)
+      return 0;
+    while (struct dirent* entry = readdir(dir)) {
+      const string name = entry->d_name;
+      if (name.size() > 4 && name.compare(name.size() - 4, 4, ".dmp") == 0)
+        ++count;
+    }
+    closedir(dir);
+    return count;
+  }
+
+  AutoTempDir temp_dir_;
+  string dump_dir_;
+  int server_fd_;
+  int client_fd_;
+};
+
+struct ActiveDumpsAtLeast {
+  explicit ActiveDumpsAtLeast(size_t count) : count(count) {}
+  bool operator()(const CrashGenerationServer::Stats& stats) const {
+    return stats.active_dumps >= count;
+  }
+  size_t count;
+};
+
+struct QueueDepthIs {
+  explicit QueueDepthIs(size_t depth) : depth(depth) {}
+  bool operator()(const CrashGenerationServer::Stats& stats) const {
+    return stats.queue_depth == depth;
+  }
+  size_t depth;
+};
+
+struct AllDone {
+  explicit AllDone(uint64_t dumps) : dumps(dumps) {}
+  bool operator()(const CrashGenerationServer::Stats& stats) const {
+    return stats.dumps_written + stats.dumps_failed == dumps &&
+           stats.active_dumps == 0 && stats.queue_depth == 0;
+  }
+  uint64_t dumps;
+};
+
+struct RequestsTimedOut {
+  explicit RequestsTimedOut(uint64_t count) : count(count) {}
+  bool operator()(const CrashGenerationServer::Stats& stats) const {
+    return stats.requests_timed_out == count;
+  }
+  uint64_t count;
+};
+
+}  // namespace
+
+TEST_F(CrashGenerationServerTest, DumpsClientsInParallel) {
+  const int kClients = 4;
+  CallbackGate gate;
+  // Every callback waits for the others: they only all return promptly if
+  // the dumps are handled at the same time.
+  gate.OpenWhenHolding(kClients);
+  CrashGenerationServer server(server_fd_, CallbackGate::DumpCallback, &gate,
+                               NULL, NULL, true, &dump_dir_);
+  server.set_worker_count(kClients);
+  ASSERT_TRUE(server.Start());
+
+  pid_t clients[kClients];
+  for (int i = 0; i < kClients; ++i)
+    clients[i] = StartClient(false);
+
+  CrashGenerationServer::Stats stats;
+  ASSERT_TRUE(WaitForStats(&server, AllDone(kClients), &stats));
+  for (int i = 0; i < kClients; ++i)
+    WaitForClient(clients[i]);
+  server.Stop();
+
+  EXPECT_EQ(kClients, gate.max_held());
+  EXPECT_EQ(kClients, CountMinidumps());
+  EXPECT_EQ(static_cast<uint64_t>(kClients), stats.dumps_written);
+  EXPECT_EQ(0U, stats.dumps_failed);
+  EXPECT_EQ(0U, stats.queue_depth);
+  EXPECT_GT(stats.max_dump_usec, 0U);
+  EXPECT_GE(stats.total_dump_usec, stats.max_dump_usec);
+}
+
+TEST_F(CrashGenerationServerTest, ThrottlesWhenQueueIsFull) {
+  CallbackGate gate;
+  CrashGenerationServer server(server_fd_, CallbackGate::DumpCallback, &gate,
+                               NULL, NULL, true, &dump_dir_);
+  server.set_worker_count(1);
+  server.set_max_pending_requests(1);
+  ASSERT_TRUE(server.Start());
+
+  // The first client keeps the only worker busy, the second fills the
+  // queue, and the third must stay in the socket.
+  CrashGenerationServer::Stats stats;
+  const pid_t first = StartClient(false);
+  ASSERT_TRUE(WaitForStats(&server, ActiveDumpsAtLeast(1), &stats));
+  const pid_t second = StartClient(false);
+  ASSERT_TRUE(WaitForStats(&server, QueueDepthIs(1), &stats));
+  const pid_t third = StartClient(false);
+  for (int waited_ms = 0; !RequestPending() && waited_ms < kWaitMs;
+       waited_ms += 10)
+    usleep(10 * 1000);
+  ASSERT_TRUE(RequestPending());
+
+  // Give the server a chance to misbehave.
+  usleep(200 * 1000);
+  EXPECT_TRUE(RequestPending());
+  server.GetStats(&stats);
+  EXPECT_EQ(1U, stats.queue_depth);
+  EXPECT_EQ(1U, stats.max_queue_depth);
+  EXPECT_EQ(1U, stats.active_dumps);
+
+  // Freeing the worker frees a queue slot, and the server reads again.
+  gate.Open();
+  ASSERT_TRUE(WaitForStats(&server, AllDone(3), &stats));
+  WaitForClient(first);
+  WaitForClient(second);
+  WaitForClient(third);
+  server.Stop();
+
+  EXPECT_FALSE(RequestPending());
+  EXPECT_EQ(3U, stats.dumps_written);
+  EXPECT_EQ(1U, stats.max_queue_depth);
+  EXPECT_EQ(3, CountMinidumps());
+}
+
+TEST_F(CrashGenerationServerTest, DropsRequestsThatWaitTooLong) {
+  CallbackGate gate;
+  CrashGenerationServer server(server_fd_, CallbackGate::DumpCallback, &gate,
+                               NULL, NULL, true, &dump_dir_);
+  server.set_worker_count(1);
+  server.set_request_timeout_ms(300);
+  ASSERT_TRUE(server.Start());
+
+  // The worker is held in the first client's callback, after its dump, so
+  // the second request waits in the queue until it expires.
+  CrashGenerationServer::Stats stats;
+  const pid_t first = StartClient(false);
+  ASSERT_TRUE(WaitForStats(&server, ActiveDumpsAtLeast(1), &stats));
+  const pid_t second = StartClient(false);
+  ASSERT_TRUE(WaitForStats(&server, RequestsTimedOut(1), &stats));
+  // The dropped client is released without a dump.
+  WaitForClient(second);
+
+  gate.Open();
+  ASSERT_TRUE(WaitForStats(&server, AllDone(1), &stats));
+  WaitForClient(first);
+  server.Stop();
+
+  EXPECT_EQ(1U, stats.dumps_written);
+  EXPECT_EQ(1U, stats.requests_timed_out);
+  EXPECT_EQ(0U, stats.dumps_timed_out);
+  EXPECT_EQ(0U, stats.queue_depth);
+  EXPECT_EQ(1, CountMinidumps());
+}
+
+TEST_F(CrashGenerationServerTest, KillsClientsThatDumpTooLong) {
+  CrashGenerationServer server(server_fd_, NULL, NULL, NULL, NULL, true,
+                               &dump_dir_);
+  server.set_worker_count(1);
+  server.set_request_timeout_ms(500);
+  ASSERT_TRUE(server.Start());
+
+  CrashGenerationServer::Stats stats;
+  const pid_t wedged = StartClient(true);
+  const bool done = WaitForStats(&server, AllDone(1), &stats);
+  if (!done)
+    kill(wedged, SIGKILL);  // Or Stop() would wait for the worker forever.
+  ASSERT_TRUE(done);
+  EXPECT_EQ(1U, stats.dumps_timed_out);
+  EXPECT_EQ(0U, stats.requests_timed_out);
+
+  // The client was killed.  The worker, which traced it from this process,
+  // may have reaped it already.
+  int status;
+  const pid_t waited = HANDLE_EINTR(waitpid(wedged, &status, __WNOTHREAD));
+  if (waited == wedged) {
+    EXPECT_TRUE(WIFSIGNALED(status));
+    EXPECT_EQ(SIGKILL, WTERMSIG(status));
+  } else {
+    EXPECT_EQ(ECHILD, errno);
+  }
+
+  // The worker is free for the next client.
+  const pid_t client = StartClient(false);
+  ASSERT_TRUE(WaitForStats(&server, AllDone(2), &stats));
+  WaitForClient(client);
+  server.Stop();
+  EXPECT_EQ(1U, stats.dumps_timed_out);
+}
@@ -0,0 +1,482 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// crash_path_benchmark.cc: Measure how long the ExceptionHandler takes
+// from signal delivery to a finished minidump.
+//
+// Each run forks a target process with a configurable number of threads,
+// stack depth, extra memory mappings and registered app memory blocks.
+// The target installs an ExceptionHandler, either writing the dump itself
+// or handing the crash to a CrashGenerationServer run by the benchmark,
+// and then crashes.  The phases of the dump (see dump_phase_timer.h) are
+// timed in a shared mapping that the target, its cloned dumping process
+// and the server all write to.  The results are written to stdout as a
+// JSON object.
+
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "client/linux/crash_generation/crash_generation_server.h"
+#include "client/linux/handler/exception_handler.h"
+#include "client/linux/handler/minidump_descriptor.h"
+#include "client/linux/minidump_writer/dump_phase_timer.h"
+#include "common/linux/eintr_wrapper.h"
+#include "common/scoped_ptr.h"
+#include "common/using_std_string.h"
+
+namespace {
+
+using google_breakpad::CrashGenerationServer;
+using google_breakpad::DumpPhase;
+using google_breakpad::DumpPhaseName;
+using google_breakpad::DumpPhaseTimes;
+using google_breakpad::ExceptionHandler;
+using google_breakpad::MinidumpDescriptor;
+using google_breakpad::kDumpPhaseCount;
+using google_breakpad::scoped_ptr;
+using std::vector;
+
+// Bytes of locals in each frame of a target thread's stack.
+const int kFrameBytes = 128;
+
+enum Mode {
+  kModeInProcess,
+  kModeServer,
+  kModeCount
+};
+
+const char* const kModeNames[kModeCount] = { "in_process", "server" };
+
+struct Options {
+  int threads;
+  int stack_depth;
+  int mappings;
+  int app_memory_blocks;
+  size_t app_memory_size;
+  int runs;
+  bool modes[kModeCount];
+};
+
+struct RunResult {
+  bool succeeded;
+  int64_t minidump_bytes;
+  DumpPhaseTimes times;
+};
+
+
+// State shared by the threads of the target process.
+struct Target {
+  int stack_depth;
+  pthread_barrier_t ready;
+  // The benchmark writes a byte to this pipe when the target should crash.
+  int go_fd;
+};
+
+volatile int* p_null = NULL;
+
+// Grow the stack by |depth| frames, then call |leaf|.
+void __attribute__((noinline)) Recurse(int depth, void (*leaf)(Target*),
+                                       Target* target) {
+  volatile char frame[kFrameBytes];
+  frame[0] = static_cast<char>(depth);
+  if (depth > 0)
+    Recurse(depth - 1, leaf, target);
+  else
+    leaf(target);
+  // Use the frame after the call, so that the call is not a tail call.
+  frame[1] = frame[0];
+}
+
+void IdleLeaf(Target* target) {
+  pthread_barrier_wait(&target->ready);
+  for (;;)
+    pause();
+}
+
+void CrashLeaf(Target* target) {
+  pthread_barrier_wait(&target->ready);
+  char go;
+  if (HANDLE_EINTR(read(target->go_fd, &go, 1)) != 1)
+    _exit(1);
+  *p_null = 1;
+}
+
+void* IdleThreadMain(void* arg) {
+  Target* target = reinterpret_cast<Target*>(arg);
+  Recurse(target->stack_depth, IdleLeaf, target);
+  return NULL;
+}
+
+// Set up the target process described by |options| and crash it once the
+// benchmark writes to |go_fd|.  Only returns if setting up failed.
+void RunTarget(const Options& options, Mode mode, const string& dump_dir,
+               int client_fd, int go_fd) {
+  // The target is expected to crash; don't leave core files behind.
+  struct rlimit no_core = { 0, 0 };
+  setrlimit(RLIMIT_CORE, &no_core);
+
+  // Alternate the protection of the extra mappings so that the kernel
+  // cannot merge neighbouring ones into a single entry.
+  const size_t page_size = getpagesize();
+  for (int i = 0; i < options.mappings; ++i) {
+    const int prot = i % 2 ? PROT_READ : PROT_READ | PROT_WRITE;
+    if (mmap(NULL, page_size, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) ==
+        MAP_FAILED) {
+      perror("mmap");
+      return;
+    }
+  }
+
+  ExceptionHandler* handler =
+      new ExceptionHandler(MinidumpDescriptor(dump_dir), NULL, NULL, NULL,
+                           true, mode == kModeServer ? client_fd : -1);
+  for (int i = 0; i < options.app_memory_blocks; ++i) {
+    char* block = new char[options.app_memory_size];
+    memset(block, i, options.app_memory_size);
+    handler->RegisterAppMemory(block, options.app_memory_size);
+  }
+
+  Target* target = new Target;
+  target->stack_depth = options.stack_depth;
+  target->go_fd = go_fd;
+  pthread_barrier_init(&target->ready, NULL, options.threads);
+  for (int i = 1; i < options.threads; ++i) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, IdleThreadMain, target)) {
+      perror("pthread_create");
+      return;
+    }
+  }
+  Recurse(options.stack_depth, CrashLeaf, target);
+}
+
+// Remove the minidumps in |dump_dir|, returning their total size.
+int64_t RemoveMinidumps(const string& dump_dir) {
+  int64_t bytes = 0;
+  DIR* dir = opendir(dump_dir.c_str());
+  if (!dir)
+    return 0;
+  while (struct dirent* entry = readdir(dir)) {
+    const string name = entry->d_name;
+    if (name.size() < 4 || name.compare(name.size() - 4, 4, ".dmp") != 0)
+      continue;
+    const string path = dump_dir + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0)
+      bytes += st.st_size;
+    unlink(path.c_str());
+  }
+  closedir(dir);
+  return bytes;
+}
+
+// Crash one target process in |mode| and fill |result| with the phase
+// times recorded in |times|.
+bool RunOnce(const Options& options, Mode mode, const string& dump_dir,
+             DumpPhaseTimes* times, RunResult* result) {
+  memset(times, 0, sizeof(*times));
+
+  int server_fd = -1;
+  int client_fd = -1;
+  if (mode == kModeServer &&
+      !CrashGenerationServer::CreateReportChannel(&server_fd, &client_fd)) {
+    perror("CreateReportChannel");
+    return false;
+  }
+  int go[2];
+  if (pipe(go)) {
+    perror("pipe");
+    return false;
+  }
+
+  // Fork before starting the server, so that the target does not inherit
+  // locks held by its threads.
+  const pid_t child = fork();
+  if (child == -1) {
+    perror("fork");
+    return false;
+  }
+  if (child == 0) {
+    close(go[1]);
+    if (server_fd != -1)
+      close(server_fd);
+    RunTarget(options, mode, dump_dir, client_fd, go[0]);
+    _exit(1);
+  }
+  close(go[0]);
+  if (client_fd != -1)
+    close(client_fd);
+
+  scoped_ptr<CrashGenerationServer> server;
+  if (mode == kModeServer) {
+    server.reset(new CrashGenerationServer(server_fd, NULL, NULL, NULL, NULL,
+                                           true, &dump_dir));
+    server->set_worker_count(1);
+    if (!server->Start()) {
+      fprintf(stderr, "Failed to start the crash generation server\n");
+      kill(child, SIGKILL);
+      int status;
+      HANDLE_EINTR(waitpid(child, &status, 0));
+      close(go[1]);
+      server.reset();
+      close(server_fd);
+      return false;
+    }
+  }
+
+  HANDLE_EINTR(write(go[1], "g", 1));
+  close(go[1]);
+  // In server mode a worker thread of this process ptraces the target, and
+  // waiting on it from another thread would steal the worker's ptrace
+  // stops: only wait for children of this thread.
+  int status;
+  HANDLE_EINTR(waitpid(child, &status, __WNOTHREAD));
+  server.reset();
+  if (server_fd != -1)
+    close(server_fd);
+
+  result->minidump_bytes = RemoveMinidumps(dump_dir);
+  result->succeeded = WIFSIGNALED(status) && result->minidump_bytes > 0;
+  result->times = *times;
+  return true;
+}
+
+// Duration of |phase| in microseconds, or -1 if it was not recorded.
+int64_t PhaseMicroseconds(const DumpPhaseTimes& times, int phase) {
+  if (!times.start_ns[phase] || times.end_ns[phase] < times.start_ns[phase])
+    return -1;
+  return (times.end_ns[phase] - times.start_ns[phase]) / 1000;
+}
+
+// Print |phase_us| as a JSON object.  Phase names need no escaping.
+void PrintPhases(const int64_t* phase_us) {
+  printf("{");
+  for (int phase = 0; phase < kDumpPhaseCount; ++phase) {
+    printf("%s\"%s\":", phase ? "," : "",
+           DumpPhaseName(static_cast<DumpPhase>(phase)));
+    if (phase_us[phase] < 0)
+      printf("null");
+    else
+      printf("%lld", static_cast<long long>(phase_us[phase]));
+  }
+  printf("}");
+}
+
+void Usage(const char* argv0, bool error) {
+  fprintf(error ? stderr : stdout,
+          "Usage: %s [options]\n"
+          "\n"
+          "Crash target processes and print the time spent in each phase\n"
+          "of writing their minidumps as JSON\n"
+          "\n"
+          "Options:\n"
+          "\n"
+          "  -t <count>  Threads in the target, including the crashing\n"
+          "              one (default 8)\n"
+          "  -d <depth>  Stack frames on each thread (default 64)\n"
+          "  -m <count>  Extra memory mappings in the target (default 256)\n"
+          "  -a <count>  App memory blocks registered with the handler\n"
+          "              (default 16); the crash server does not see them\n"
+          "  -s <bytes>  Size of each app memory block (default 4096)\n"
+          "  -r <count>  Crashes per mode (default 5)\n"
+          "  -M <mode>   Only run \"in_process\" or \"server\" dumps\n",
+          argv0);
+}
+
+bool ParseCount(const char* argv0, const char* arg, int min, int* count) {
+  char* end;
+  long value = strtol(arg, &end, 10);
+  if (*arg == '\0' || *end != '\0' || value < min || value > 1000000) {
+    fprintf(stderr, "%s: Invalid count: %s\n", argv0, arg);
+    return false;
+  }
+  *count = value;
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  options.threads = 8;
+  options.stack_depth = 64;
+  options.mappings = 256;
+  options.app_memory_blocks = 16;
+  options.app_memory_size = 4096;
+  options.runs = 5;
+  for (int mode = 0; mode < kModeCount; ++mode)
+    options.modes[mode] = true;
+
+  int ch;
+  int block_size;
+  while ((ch = getopt(argc, argv, "a:d:hm:M:r:s:t:")) != -1) {
+    bool valid = true;
+    switch (ch) {
+      case 'a':
+        valid = ParseCount(argv[0], optarg, 0, &options.app_memory_blocks);
+        break;
+      case 'd':
+        valid = ParseCount(argv[0], optarg, 0, &options.stack_depth);
+        break;
+      case 'h':
+        Usage(argv[0], false);
+        return 0;
+      case 'm':
+        valid = ParseCount(argv[0], optarg, 0, &options.mappings);
+        break;
+      case 'M': {
+        int mode = 0;
+        while (mode < kModeCount && strcmp(optarg, kModeNames[mode]) != 0)
+          ++mode;
+        if (mode == kModeCount) {
+          fprintf(stderr, "%s: Invalid mode: %s\n", argv[0], optarg);
+          valid = false;
+          break;
+        }
+        for (int i = 0; i < kModeCount; ++i)
+          options.modes[i] = i == mode;
+        break;
+      }
+      case 'r':
+        valid = ParseCount(argv[0], optarg, 1, &options.runs);
+        break;
+      case 's':
+        valid = ParseCount(argv[0], optarg, 1, &block_size);
+        options.app_memory_size = block_size;
+        break;
+      case 't':
+        valid = ParseCount(argv[0], optarg, 1, &options.threads);
+        break;
+      default:
+        valid = false;
+        break;
+    }
+    if (!valid) {
+      Usage(argv[0], true);
+      return 1;
+    }
+  }
+
+  const char* tmpdir = getenv("TMPDIR");
+  string dump_dir = string(tmpdir && *tmpdir ? tmpdir : "/tmp") +
+                    "/crash_path_benchmark.XXXXXX";
+  if (!mkdtemp(&dump_dir[0])) {
+    perror("mkdtemp");
+    return 1;
+  }
+
+  // The target process, the process it clones to write the dump and the
+  // crash server in this process all record into this mapping.
+  DumpPhaseTimes* times = reinterpret_cast<DumpPhaseTimes*>(
+      mmap(NULL, sizeof(DumpPhaseTimes), PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+  if (times == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+  google_breakpad::SetDumpPhaseTimes(times);
+
+  printf("{\"threads\":%d,\"stack_depth\":%d,\"mappings\":%d,"
+         "\"app_memory_blocks\":%d,\"app_memory_block_bytes\":%zu,"
+         "\"results\":[",
+         options.threads, options.stack_depth, options.mappings,
+         options.app_memory_blocks, options.app_memory_size);
+  bool first = true;
+
+  bool all_succeeded = true;
+  int64_t median_us[kModeCount][kDumpPhaseCount];
+  for (int mode = 0; mode < kModeCount; ++mode) {
+    if (!options.modes[mode])
+      continue;
+    vector<int64_t> samples[kDumpPhaseCount];
+    for (int run = 0; run < options.runs; ++run) {
+      RunResult result;
+      if (!RunOnce(options, static_cast<Mode>(mode), dump_dir, times,
+                   &result)) {
+        all_succeeded = false;
+        break;
+      }
+      int64_t phase_us[kDumpPhaseCount];
+      for (int phase = 0; phase < kDumpPhaseCount; ++phase) {
+        phase_us[phase] = PhaseMicroseconds(result.times, phase);
+        if (result.succeeded && phase_us[phase] >= 0)
+          samples[phase].push_back(phase_us[phase]);
+      }
+      all_succeeded = all_succeeded && result.succeeded;
+      printf("%s{\"mode\":\"%s\",\"run\":%d,\"succeeded\":%s,"
+             "\"minidump_bytes\":%lld,\"phases_us\":",
+             first ? "" : ",", kModeNames[mode], run,
+             result.succeeded ? "true" : "false",
+             static_cast<long long>(result.minidump_bytes));
+      PrintPhases(phase_us);
+      printf("}");
+      first = false;
+    }
+
+    for (int phase = 0; phase < kDumpPhaseCount; ++phase) {
+      vector<int64_t>& values = samples[phase];
+      median_us[mode][phase] = -1;
+      if (!values.empty()) {
+        std::nth_element(values.begin(), values.begin() + values.size() / 2,
+                         values.end());
+        median_us[mode][phase] = values[values.size() / 2];
+      }
+    }
+  }
+
+  // The median of each phase over the successful runs of each mode.
+  printf("],\"medians\":[");
+  first = true;
+  for (int mode = 0; mode < kModeCount; ++mode) {
+    if (!options.modes[mode])
+      continue;
+    printf("%s{\"mode\":\"%s\",\"phases_us\":", first ? "" : ",",
+           kModeNames[mode]);
+    PrintPhases(median_us[mode]);
+    printf("}");
+    first = false;
+  }
+  printf("]}\n");
+  rmdir(dump_dir.c_str());
+  return fflush(stdout) == 0 && !ferror(stdout) && all_succeeded ? 0 : 1;
+}
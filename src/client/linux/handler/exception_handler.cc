@@ -92,6 +92,7 @@
 #include "common/memory_allocator.h"
 #include "client/linux/log/log.h"
 #include "client/linux/microdump_writer/microdump_writer.h"
+#include "client/linux/minidump_writer/dump_phase_timer.h"
 #include "client/linux/minidump_writer/linux_dumper.h"
 #include "client/linux/minidump_writer/minidump_writer.h"
 #include "common/linux/eintr_wrapper.h"
@@ -326,6 +327,7 @@ void ExceptionHandler::RestoreHandlersLocked() {
 // Runs on the crashing thread.
 // static
 void ExceptionHandler::SignalHandler(int sig, siginfo_t* info, void* uc) {
+  DumpPhaseBegin(kDumpPhaseTotal);
 
   // Give the first chance handler a chance to recover from this signal
   //
@@ -430,6 +432,7 @@ int ExceptionHandler::ThreadEntry(void* arg) {
   // we're allowed to use ptrace
   thread_arg->handler->WaitForContinueSignal();
   sys_close(thread_arg->handler->fdes[0]);
+  DumpPhaseEnd(kDumpPhaseClone);
 
   return thread_arg->handler->DoDump(thread_arg->pid, thread_arg->context,
                                      thread_arg->context_size) == false;
@@ -478,7 +481,9 @@ bool ExceptionHandler::HandleSignal(int /*sig*/, siginfo_t* info, void* uc) {
       return true;
     }
   }
-  return GenerateDump(&g_crash_context_);
+  const bool dumped = GenerateDump(&g_crash_context_);
+  DumpPhaseEnd(kDumpPhaseTotal);
+  return dumped;
 }
 
 // This is a public interface to HandleSignal that allows the client to
@@ -535,6 +540,7 @@ bool ExceptionHandler::GenerateDump(CrashContext* context) {
     fdes[0] = fdes[1] = -1;
   }
 
+  DumpPhaseBegin(kDumpPhaseClone);
   const pid_t child = sys_clone(
       ThreadEntry, stack, CLONE_FS | CLONE_UNTRACED, &thread_arg, NULL, NULL,
       NULL);
@@ -605,6 +611,7 @@ bool ExceptionHandler::DoDump(pid_t crashing_process, const void* context,
   const uintptr_t principal_mapping_address =
       minidump_descriptor_.address_within_principal_mapping();
   const bool sanitize_stacks = minidump_descriptor_.sanitize_stacks();
+  const MinidumpCompression compression = minidump_descriptor_.compression();
   if (minidump_descriptor_.IsMicrodumpOnConsole()) {
     return google_breakpad::WriteMicrodump(
         crashing_process,
@@ -626,7 +633,8 @@ bool ExceptionHandler::DoDump(pid_t crashing_process, const void* context,
                                           app_memory_list_,
                                           may_skip_dump,
                                           principal_mapping_address,
-                                          sanitize_stacks);
+                                          sanitize_stacks,
+                                          compression);
   }
   return google_breakpad::WriteMinidump(minidump_descriptor_.path(),
                                         minidump_descriptor_.size_limit(),
@@ -637,7 +645,8 @@ bool ExceptionHandler::DoDump(pid_t crashing_process, const void* context,
                                         app_memory_list_,
                                         may_skip_dump,
                                         principal_mapping_address,
-                                        sanitize_stacks);
+                                        sanitize_stacks,
+                                        compression);
 }
 
 // static
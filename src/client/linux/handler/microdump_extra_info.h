@@ -40,11 +40,18 @@ struct MicrodumpExtraInfo {
   const char* gpu_fingerprint;
   const char* process_type;
 
+  // If true, stack contents are logged base64-encoded, with runs of zero
+  // bytes compressed, in "B" and "Z" records instead of hex "S" records.
+  // This roughly halves the log volume of a microdump, but needs a
+  // processor that understands the compact records.
+  bool compact_stack;
+
   MicrodumpExtraInfo()
       : build_fingerprint(NULL),
         product_info(NULL),
         gpu_fingerprint(NULL),
-        process_type(NULL) {}
+        process_type(NULL),
+        compact_stack(false) {}
 };
 
 }
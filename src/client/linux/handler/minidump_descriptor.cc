@@ -50,6 +50,7 @@ MinidumpDescriptor::MinidumpDescriptor(const MinidumpDescriptor& descriptor)
       skip_dump_if_principal_mapping_not_referenced_(
           descriptor.skip_dump_if_principal_mapping_not_referenced_),
       sanitize_stacks_(descriptor.sanitize_stacks_),
+      compression_(descriptor.compression_),
       microdump_extra_info_(descriptor.microdump_extra_info_) {
   // The copy constructor is not allowed to be called on a MinidumpDescriptor
   // with a valid path_, as getting its c_path_ would require the heap which
@@ -76,6 +77,7 @@ MinidumpDescriptor& MinidumpDescriptor::operator=(
   skip_dump_if_principal_mapping_not_referenced_ =
       descriptor.skip_dump_if_principal_mapping_not_referenced_;
   sanitize_stacks_ = descriptor.sanitize_stacks_;
+  compression_ = descriptor.compression_;
   microdump_extra_info_ = descriptor.microdump_extra_info_;
   return *this;
 }
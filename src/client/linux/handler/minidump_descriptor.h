@@ -37,6 +37,7 @@
 #include <cstdint>
 
 #include "client/linux/handler/microdump_extra_info.h"
+#include "client/linux/minidump_writer/minidump_compressor.h"
 #include "common/using_std_string.h"
 
 // This class describes how a crash dump should be generated, either:
@@ -56,7 +57,8 @@ class MinidumpDescriptor {
         fd_(-1),
         size_limit_(-1),
         address_within_principal_mapping_(0),
-        skip_dump_if_principal_mapping_not_referenced_(false) {}
+        skip_dump_if_principal_mapping_not_referenced_(false),
+        compression_(kMinidumpCompressionNone) {}
 
   explicit MinidumpDescriptor(const string& directory)
       : mode_(kWriteMinidumpToFile),
@@ -66,7 +68,8 @@ class MinidumpDescriptor {
         size_limit_(-1),
         address_within_principal_mapping_(0),
         skip_dump_if_principal_mapping_not_referenced_(false),
-        sanitize_stacks_(false) {
+        sanitize_stacks_(false),
+        compression_(kMinidumpCompressionNone) {
     assert(!directory.empty());
   }
 
@@ -77,7 +80,8 @@ class MinidumpDescriptor {
         size_limit_(-1),
         address_within_principal_mapping_(0),
         skip_dump_if_principal_mapping_not_referenced_(false),
-        sanitize_stacks_(false) {
+        sanitize_stacks_(false),
+        compression_(kMinidumpCompressionNone) {
     assert(fd != -1);
   }
 
@@ -87,7 +91,8 @@ class MinidumpDescriptor {
         size_limit_(-1),
         address_within_principal_mapping_(0),
         skip_dump_if_principal_mapping_not_referenced_(false),
-        sanitize_stacks_(false) {}
+        sanitize_stacks_(false),
+        compression_(kMinidumpCompressionNone) {}
 
   explicit MinidumpDescriptor(const MinidumpDescriptor& descriptor);
   MinidumpDescriptor& operator=(const MinidumpDescriptor& descriptor);
@@ -135,6 +140,11 @@ class MinidumpDescriptor {
     sanitize_stacks_ = sanitize_stacks;
   }
 
+  MinidumpCompression compression() const { return compression_; }
+  void set_compression(MinidumpCompression compression) {
+    compression_ = compression;
+  }
+
   MicrodumpExtraInfo* microdump_extra_info() {
     assert(IsMicrodumpOnConsole());
     return &microdump_extra_info_;
@@ -183,6 +193,12 @@ class MinidumpDescriptor {
   // register values, but elides strings and other program data.
   bool sanitize_stacks_;
 
+  // If not kMinidumpCompressionNone, the minidump is compressed once it has
+  // been written (minidump only).  The size limit applies to the
+  // uncompressed minidump.  When writing to an fd that is not open for
+  // reading as well as writing, the minidump is left uncompressed.
+  MinidumpCompression compression_;
+
   // The extra microdump data (e.g. product name/version, build
   // fingerprint, gpu fingerprint) that should be appended to the dump
   // (microdump only). Microdumps don't have the ability of appending
@@ -149,6 +149,7 @@ class MicrodumpWriter {
         sanitize_stack_(sanitize_stack),
         microdump_extra_info_(microdump_extra_info),
         log_line_(NULL),
+        log_line_length_(0),
         stack_copy_(NULL),
         stack_len_(0),
         stack_lower_bound_(0),
@@ -208,7 +209,7 @@ class MicrodumpWriter {
 
   // Stages the given string in the current line buffer.
   void LogAppend(const char* str) {
-    my_strlcat(log_line_, str, kLineBufferSize);
+    LogAppendChars(str, my_strlen(str));
   }
 
   // As above (required to take precedence over template specialization below).
@@ -219,14 +220,13 @@ class MicrodumpWriter {
   // Stages the hex repr. of the given int type in the current line buffer.
   template<typename T>
   void LogAppend(T value) {
-    // Make enough room to hex encode the largest int type + NUL.
+    // Make enough room to hex encode the largest int type.
     static const char HEX[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
                                'A', 'B', 'C', 'D', 'E', 'F'};
-    char hexstr[sizeof(T) * 2 + 1];
+    char hexstr[sizeof(T) * 2];
     for (int i = sizeof(T) * 2 - 1; i >= 0; --i, value >>= 4)
       hexstr[i] = HEX[static_cast<uint8_t>(value) & 0x0F];
-    hexstr[sizeof(T) * 2] = '\0';
-    LogAppend(hexstr);
+    LogAppendChars(hexstr, sizeof(hexstr));
   }
 
   // Stages the buffer content hex-encoded in the current line buffer.
@@ -236,10 +236,43 @@ class MicrodumpWriter {
       LogAppend(*ptr);
   }
 
+  // Stages the buffer content base64-encoded in the current line buffer.
+  void LogAppendBase64(const uint8_t* buf, size_t length) {
+    static const char kBase64[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    char quad[4];
+    for (size_t i = 0; i < length; i += 3) {
+      uint32_t bits = buf[i] << 16;
+      if (i + 1 < length)
+        bits |= buf[i + 1] << 8;
+      if (i + 2 < length)
+        bits |= buf[i + 2];
+      quad[0] = kBase64[(bits >> 18) & 0x3F];
+      quad[1] = kBase64[(bits >> 12) & 0x3F];
+      quad[2] = i + 1 < length ? kBase64[(bits >> 6) & 0x3F] : '=';
+      quad[3] = i + 2 < length ? kBase64[bits & 0x3F] : '=';
+      LogAppendChars(quad, sizeof(quad));
+    }
+  }
+
+  // Stages |length| characters from |str| in the current line buffer,
+  // truncating the line if it would overflow. Appending at the end of the
+  // staged text, rather than searching for it, keeps the cost of a line
+  // linear in its length.
+  void LogAppendChars(const char* str, size_t length) {
+    size_t room = kLineBufferSize - 1 - log_line_length_;
+    if (length > room)
+      length = room;
+    my_memcpy(log_line_ + log_line_length_, str, length);
+    log_line_length_ += length;
+    log_line_[log_line_length_] = '\0';
+  }
+
   // Writes out the current line buffer on the system log.
   void LogCommitLine() {
     LogLine(log_line_);
     log_line_[0] = 0;
+    log_line_length_ = 0;
   }
 
   CaptureResult CaptureCrashingThreadStack(int max_stack_len) {
@@ -394,6 +427,11 @@ class MicrodumpWriter {
     LogAppend(stack_len_);
     LogCommitLine();
 
+    if (microdump_extra_info_.compact_stack) {
+      DumpCompactThreadStack();
+      return;
+    }
+
     const size_t STACK_DUMP_CHUNK_SIZE = 384;
     for (size_t stack_off = 0; stack_off < stack_len_;
          stack_off += STACK_DUMP_CHUNK_SIZE) {
@@ -406,6 +444,49 @@ class MicrodumpWriter {
     }
   }
 
+  // Writes the stack as "B <address> <base64 bytes>" records or, where it
+  // comes out shorter, as "Z <address> <base64 packed bytes>" records. In
+  // the packed form a zero byte is followed by a count byte, and the pair
+  // stands for that many zero bytes; all other bytes stand for themselves.
+  void DumpCompactThreadStack() {
+    // A multiple of three, so that no chunk but the last needs padding.
+    const size_t STACK_DUMP_CHUNK_SIZE = 768;
+    uint8_t packed[STACK_DUMP_CHUNK_SIZE];
+    for (size_t stack_off = 0; stack_off < stack_len_;
+         stack_off += STACK_DUMP_CHUNK_SIZE) {
+      const uint8_t* chunk = stack_copy_ + stack_off;
+      const size_t chunk_len =
+          std::min(STACK_DUMP_CHUNK_SIZE, stack_len_ - stack_off);
+      // Give up packing as soon as it stops saving space.
+      size_t packed_len = 0;
+      for (size_t i = 0; i < chunk_len && packed_len < chunk_len; ) {
+        if (chunk[i] != 0) {
+          packed[packed_len++] = chunk[i++];
+          continue;
+        }
+        size_t run = 1;
+        while (run < 255 && i + run < chunk_len && chunk[i + run] == 0)
+          ++run;
+        if (packed_len + 2 > chunk_len) {
+          packed_len = chunk_len;
+          break;
+        }
+        packed[packed_len++] = 0;
+        packed[packed_len++] = static_cast<uint8_t>(run);
+        i += run;
+      }
+      const bool use_packed = packed_len < chunk_len;
+      LogAppend(use_packed ? "Z " : "B ");
+      LogAppend(stack_lower_bound_ + stack_off);
+      LogAppend(" ");
+      if (use_packed)
+        LogAppendBase64(packed, packed_len);
+      else
+        LogAppendBase64(chunk, chunk_len);
+      LogCommitLine();
+    }
+  }
+
   void DumpCPUState() {
     RawContextCPU cpu;
     my_memset(&cpu, 0, sizeof(RawContextCPU));
@@ -615,6 +696,7 @@ class MicrodumpWriter {
   bool sanitize_stack_;
   const MicrodumpExtraInfo microdump_extra_info_;
   char* log_line_;
+  size_t log_line_length_;
 
   // The local copy of crashed process stack memory, beginning at
   // |stack_lower_bound_|.
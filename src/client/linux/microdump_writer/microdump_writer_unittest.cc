@@ -151,12 +151,45 @@ void CrashAndGetMicrodump(const MappingList& mappings,
   close(fds[1]);
 }
 
+// Appends the bytes the base64 text |data| stands for to |result|. If
+// |zero_runs| is true, a decoded zero byte and the count byte after it
+// stand for that many zero bytes.
+void DecodeBase64(const string& data, bool zero_runs, string* result) {
+  static const string kBase64 =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  EXPECT_TRUE((data.size() & 3u) == 0u);
+  uint32_t bits = 0;
+  int num_bits = 0;
+  bool in_zero_run = false;
+  for (size_t i = 0; i < data.size() && data[i] != '='; ++i) {
+    size_t digit = kBase64.find(data[i]);
+    ASSERT_NE(string::npos, digit);
+    bits = (bits << 6) | digit;
+    num_bits += 6;
+    if (num_bits < 8)
+      continue;
+    num_bits -= 8;
+    char byte = static_cast<char>(bits >> num_bits);
+    if (in_zero_run) {
+      result->append(static_cast<uint8_t>(byte), '\0');
+      in_zero_run = false;
+    } else if (zero_runs && byte == 0) {
+      in_zero_run = true;
+    } else {
+      result->push_back(byte);
+    }
+  }
+}
+
 void ExtractMicrodumpStackContents(const string& microdump_content,
                                    string* result) {
   std::istringstream iss(microdump_content);
   result->clear();
   for (string line; std::getline(iss, line);) {
-    if (line.find("S ") == 0) {
+    if (line.find("S 0 ") == 0) {
+      // Skip the stack header.
+      continue;
+    } else if (line.find("S ") == 0) {
       std::istringstream stack_data(line);
       std::string key;
       std::string addr;
@@ -168,6 +201,13 @@ void ExtractMicrodumpStackContents(const string& microdump_content,
         std::string byte = data.substr(i, 2);
         result->push_back(static_cast<char>(strtoul(byte.c_str(), NULL, 16)));
       }
+    } else if (line.find("B ") == 0 || line.find("Z ") == 0) {
+      std::istringstream stack_data(line);
+      std::string key;
+      std::string addr;
+      std::string data;
+      stack_data >> key >> addr >> data;
+      DecodeBase64(data, key == "Z", result);
     }
   }
 }
@@ -352,6 +392,41 @@ TEST(MicrodumpWriterTest, StringPresentIfNotSanitized) {
   ASSERT_TRUE(MicrodumpStackContains(buf, kIdentifiableString));
 }
 
+TEST(MicrodumpWriterTest, CompactStackEncoding) {
+  MicrodumpExtraInfo microdump_extra_info(
+      MakeMicrodumpExtraInfo(NULL, NULL, NULL));
+  microdump_extra_info.compact_stack = true;
+
+  std::string buf;
+  MappingList no_mappings;
+
+  CrashAndGetMicrodump(no_mappings, microdump_extra_info, &buf, false, 0u,
+                       false);
+  ASSERT_TRUE(ContainsMicrodump(buf));
+  ASSERT_TRUE(MicrodumpStackContains(buf, kIdentifiableString));
+
+  // The only hex stack record is the header, and the compact records
+  // cover exactly the length it gives.
+  std::istringstream iss(buf);
+  size_t stack_len = 0;
+  size_t num_compact_lines = 0;
+  for (string line; std::getline(iss, line);) {
+    if (line.find("S ") == 0) {
+      ASSERT_EQ(0U, line.find("S 0 "));
+      std::istringstream header(line.substr(4));
+      std::string sp, lower_bound;
+      header >> sp >> lower_bound >> std::hex >> stack_len;
+    } else if (line.find("B ") == 0 || line.find("Z ") == 0) {
+      ++num_compact_lines;
+    }
+  }
+  ASSERT_NE(0U, stack_len);
+  ASSERT_NE(0U, num_compact_lines);
+  string stack;
+  ExtractMicrodumpStackContents(buf, &stack);
+  ASSERT_EQ(stack_len, stack.size());
+}
+
 // Ensure that output occurs if the interest region is set, and
 // does overlap something on the stack.
 TEST(MicrodumpWriterTest, OutputIfInteresting) {
@@ -0,0 +1,436 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// core_dump_reducer.cc: Implement google_breakpad::CoreDumpReducer.
+// See core_dump_reducer.h for details.
+
+#include "client/linux/minidump_writer/core_dump_reducer.h"
+
+#include <elf.h>
+#include <link.h>
+#include <string.h>
+#include <sys/procfs.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "client/linux/dump_writer_common/thread_info.h"
+#include "client/linux/minidump_writer/linux_core_dumper.h"
+#include "common/linux/eintr_wrapper.h"
+#include "common/memory_range.h"
+
+namespace google_breakpad {
+
+namespace {
+
+// Stack captured above the page holding the stack pointer, as in
+// LinuxDumper::GetStackInfo().
+const size_t kStackSize = 32 * 1024;
+
+// Memory captured around instruction pointers by the minidump writer.
+const size_t kIPMemorySize = 256;
+
+const size_t kBufferSize = 64 * 1024;
+
+bool HeaderOffsetLess(const ElfCoreDump::Phdr* a, const ElfCoreDump::Phdr* b) {
+  return a->p_offset < b->p_offset;
+}
+
+}  // namespace
+
+// static
+bool CoreDumpReducer::AddressLess(const Segment& a, const Segment& b) {
+  return a.header->p_vaddr < b.header->p_vaddr;
+}
+
+// static
+bool CoreDumpReducer::OffsetLess(const Segment* a, const Segment* b) {
+  return a->header->p_offset < b->header->p_offset;
+}
+
+// static
+bool CoreDumpReducer::RangeLess(const Range& a, const Range& b) {
+  return a.start < b.start;
+}
+
+CoreDumpReducer::CoreDumpReducer(size_t max_load_size)
+    : max_load_size_(max_load_size),
+      in_fd_(-1),
+      out_fd_(-1),
+      seekable_(false),
+      page_size_(getpagesize()),
+      kept_size_(0),
+      bytes_read_(0),
+      bytes_written_(0),
+      thread_count_(0),
+      error_(NULL),
+      buffer_(kBufferSize) {
+}
+
+bool CoreDumpReducer::Fail(const char* error) {
+  error_ = error;
+  return false;
+}
+
+bool CoreDumpReducer::Reduce(int in_fd, int out_fd) {
+  in_fd_ = in_fd;
+  out_fd_ = out_fd;
+  // Only skip by seeking if the input is a file read from its start.
+  seekable_ = lseek(in_fd_, 0, SEEK_CUR) == 0;
+  kept_size_ = 0;
+  bytes_read_ = 0;
+  bytes_written_ = 0;
+  thread_count_ = 0;
+  error_ = NULL;
+  segments_.clear();
+
+  Ehdr header;
+  if (!Read(&header, sizeof(header))) {
+    return Fail("Could not read the core dump header");
+  }
+  ElfCoreDump core(MemoryRange(&header, sizeof(header)));
+  if (!core.IsValid() || header.e_phentsize != sizeof(Phdr) ||
+      header.e_phnum == 0 || header.e_phnum == PN_XNUM) {
+    return Fail("Invalid or unsupported core dump header");
+  }
+
+  std::vector<Phdr> program_headers(header.e_phnum);
+  if (!SkipTo(header.e_phoff) ||
+      !Read(&program_headers[0], program_headers.size() * sizeof(Phdr))) {
+    return Fail("Could not read the core dump program headers");
+  }
+
+  // The data is read in file order: the notes, which tell what to keep,
+  // must come before the PT_LOAD segments.
+  std::vector<const Phdr*> with_data;
+  for (size_t i = 0; i < program_headers.size(); ++i) {
+    const Phdr* program = &program_headers[i];
+    if ((program->p_type == PT_NOTE || program->p_type == PT_LOAD) &&
+        program->p_filesz > 0) {
+      with_data.push_back(program);
+    }
+  }
+  std::stable_sort(with_data.begin(), with_data.end(), HeaderOffsetLess);
+
+  std::vector<const Phdr*> note_headers;
+  size_t notes_size = 0;
+  uint64_t data_end = bytes_read_;
+  for (size_t i = 0; i < with_data.size(); ++i) {
+    const Phdr* program = with_data[i];
+    if (program->p_offset < data_end) {
+      return Fail("Overlapping core dump segments");
+    }
+    data_end = program->p_offset + program->p_filesz;
+    if (program->p_type == PT_NOTE) {
+      if (!segments_.empty()) {
+        return Fail("PT_NOTE segment found after PT_LOAD data");
+      }
+      notes_size += program->p_filesz;
+      note_headers.push_back(program);
+    } else {
+      Segment segment;
+      segment.header = program;
+      segments_.push_back(segment);
+    }
+  }
+  if (note_headers.empty()) {
+    return Fail("PT_NOTE section not found");
+  }
+  if (notes_size > kMaxNotesSize) {
+    return Fail("Core dump notes are too large");
+  }
+
+  std::vector<uint8_t> notes(notes_size);
+  std::vector<Range> wanted;
+  Addr vdso_address = 0;
+  size_t notes_offset = 0;
+  for (size_t i = 0; i < note_headers.size(); ++i) {
+    const Phdr* program = note_headers[i];
+    if (!SkipTo(program->p_offset) ||
+        !Read(&notes[notes_offset], program->p_filesz)) {
+      return Fail("Could not read the core dump notes");
+    }
+    ParseNotes(MemoryRange(&notes[notes_offset], program->p_filesz), &wanted,
+               &vdso_address);
+    notes_offset += program->p_filesz;
+  }
+
+  // Decide what to keep, most important first.
+  std::sort(segments_.begin(), segments_.end(), AddressLess);
+  for (size_t i = 0; i < wanted.size(); ++i)
+    Keep(wanted[i].start, wanted[i].end);
+  if (vdso_address) {
+    Segment* vdso = FindSegment(vdso_address);
+    if (vdso) {
+      KeepInSegment(vdso, vdso->header->p_vaddr,
+                    vdso->header->p_vaddr + vdso->header->p_filesz);
+    }
+  }
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    Addr start = segments_[i].header->p_vaddr;
+    KeepInSegment(&segments_[i], start, start + page_size_);
+  }
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    const Phdr* program = segments_[i].header;
+    if (program->p_filesz <= kSmallSegmentSize) {
+      KeepInSegment(&segments_[i], program->p_vaddr,
+                    program->p_vaddr + program->p_filesz);
+    }
+  }
+  MergeKeptRanges();
+
+  std::vector<Segment*> in_file_order;
+  size_t range_count = 0;
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    in_file_order.push_back(&segments_[i]);
+    range_count += segments_[i].kept.size();
+  }
+  std::sort(in_file_order.begin(), in_file_order.end(), OffsetLess);
+
+  // Lay out the output: header, program headers, notes, then the kept
+  // ranges at page-aligned offsets.
+  size_t out_phnum = note_headers.size() + range_count;
+  if (out_phnum >= PN_XNUM) {
+    return Fail("Too many segments to keep");
+  }
+  std::vector<Phdr> out_headers;
+  out_headers.reserve(out_phnum);
+  uint64_t offset = sizeof(Ehdr) + out_phnum * sizeof(Phdr);
+  for (size_t i = 0; i < note_headers.size(); ++i) {
+    Phdr program = *note_headers[i];
+    program.p_offset = offset;
+    offset += program.p_filesz;
+    out_headers.push_back(program);
+  }
+  const uint64_t data_start = (offset + page_size_ - 1) & ~(page_size_ - 1);
+  offset = data_start;
+  for (size_t i = 0; i < in_file_order.size(); ++i) {
+    const Segment* segment = in_file_order[i];
+    for (size_t j = 0; j < segment->kept.size(); ++j) {
+      const Range& range = segment->kept[j];
+      Phdr program = *segment->header;
+      program.p_vaddr = range.start;
+      program.p_paddr = 0;
+      program.p_offset = offset;
+      program.p_filesz = program.p_memsz = range.end - range.start;
+      offset += program.p_filesz;
+      out_headers.push_back(program);
+    }
+  }
+
+  Ehdr out_header = header;
+  out_header.e_phoff = sizeof(Ehdr);
+  out_header.e_phnum = out_phnum;
+  out_header.e_shoff = 0;
+  out_header.e_shentsize = 0;
+  out_header.e_shnum = 0;
+  out_header.e_shstrndx = SHN_UNDEF;
+  if (!Write(&out_header, sizeof(out_header)) ||
+      !Write(&out_headers[0], out_headers.size() * sizeof(Phdr)) ||
+      !Write(&notes[0], notes.size()) ||
+      !Write(NULL, data_start - bytes_written_)) {
+    return Fail("Could not write the reduced core dump");
+  }
+
+  for (size_t i = 0; i < in_file_order.size(); ++i) {
+    const Segment* segment = in_file_order[i];
+    for (size_t j = 0; j < segment->kept.size(); ++j) {
+      const Range& range = segment->kept[j];
+      if (!SkipTo(segment->header->p_offset +
+                  (range.start - segment->header->p_vaddr)) ||
+          !Copy(range.end - range.start)) {
+        return Fail("Could not copy core dump data");
+      }
+    }
+  }
+  return true;
+}
+
+void CoreDumpReducer::ParseNotes(const MemoryRange& notes,
+                                 std::vector<Range>* wanted,
+                                 Addr* vdso_address) {
+  for (ElfCoreDump::Note note(notes); note.IsValid();
+       note = note.GetNextNote()) {
+    MemoryRange description = note.GetDescription();
+    switch (note.GetType()) {
+      case NT_PRSTATUS: {
+        if (description.length() != sizeof(elf_prstatus))
+          break;
+
+        elf_prstatus status;
+        memcpy(&status, description.data(), sizeof(status));
+        ThreadInfo info;
+        LinuxCoreDumper::ThreadInfoFromStatus(status, &info);
+        ++thread_count_;
+
+        Range stack;
+        stack.start = info.stack_pointer & ~(page_size_ - 1);
+        stack.end = stack.start + kStackSize;
+        wanted->push_back(stack);
+
+        Range code;
+        Addr ip = info.GetInstructionPointer();
+        code.start = ip > kIPMemorySize / 2 ? ip - kIPMemorySize / 2 : 0;
+        code.end = ip + kIPMemorySize / 2;
+        wanted->push_back(code);
+        break;
+      }
+      case NT_AUXV: {
+        size_t count = description.length() / sizeof(ElfW(auxv_t));
+        for (size_t i = 0; i < count; ++i) {
+          const ElfW(auxv_t)* entry =
+              description.GetArrayElement<ElfW(auxv_t)>(0, i);
+          if (entry && entry->a_type == AT_SYSINFO_EHDR)
+            *vdso_address = entry->a_un.a_val;
+        }
+        break;
+      }
+    }
+  }
+}
+
+void CoreDumpReducer::Keep(Addr start, Addr end) {
+  Segment* segment = FindSegment(start);
+  if (segment)
+    KeepInSegment(segment, start, end);
+}
+
+void CoreDumpReducer::KeepInSegment(Segment* segment, Addr start, Addr end) {
+  const Addr segment_start = segment->header->p_vaddr;
+  const Addr segment_end = segment_start + segment->header->p_filesz;
+  start &= ~(page_size_ - 1);
+  end = (end + page_size_ - 1) & ~(page_size_ - 1);
+  start = std::max(start, segment_start);
+  end = std::min(end, segment_end);
+  if (start >= end || kept_size_ + (end - start) > max_load_size_)
+    return;
+
+  Range range;
+  range.start = start;
+  range.end = end;
+  segment->kept.push_back(range);
+  kept_size_ += end - start;
+}
+
+CoreDumpReducer::Segment* CoreDumpReducer::FindSegment(Addr address) {
+  size_t low = 0, high = segments_.size();
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    if (segments_[middle].header->p_vaddr <= address)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  if (low == 0)
+    return NULL;
+  Segment* segment = &segments_[low - 1];
+  if (address - segment->header->p_vaddr >= segment->header->p_filesz)
+    return NULL;
+  return segment;
+}
+
+void CoreDumpReducer::MergeKeptRanges() {
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    std::vector<Range>& kept = segments_[i].kept;
+    if (kept.empty())
+      continue;
+    std::sort(kept.begin(), kept.end(), RangeLess);
+    size_t merged = 0;
+    for (size_t j = 1; j < kept.size(); ++j) {
+      if (kept[j].start <= kept[merged].end) {
+        kept[merged].end = std::max(kept[merged].end, kept[j].end);
+      } else {
+        kept[++merged] = kept[j];
+      }
+    }
+    kept.resize(merged + 1);
+  }
+}
+
+bool CoreDumpReducer::Read(void* buffer, size_t length) {
+  uint8_t* data = static_cast<uint8_t*>(buffer);
+  while (length > 0) {
+    ssize_t r = HANDLE_EINTR(read(in_fd_, data, length));
+    if (r <= 0)
+      return false;
+    data += r;
+    length -= r;
+    bytes_read_ += r;
+  }
+  return true;
+}
+
+bool CoreDumpReducer::SkipTo(uint64_t offset) {
+  if (offset < bytes_read_)
+    return false;
+  if (seekable_) {
+    if (lseek(in_fd_, offset, SEEK_SET) != static_cast<off_t>(offset))
+      return false;
+    bytes_read_ = offset;
+    return true;
+  }
+  while (bytes_read_ < offset) {
+    size_t chunk = std::min<uint64_t>(buffer_.size(), offset - bytes_read_);
+    if (!Read(&buffer_[0], chunk))
+      return false;
+  }
+  return true;
+}
+
+bool CoreDumpReducer::Write(const void* buffer, size_t length) {
+  if (!buffer)
+    memset(&buffer_[0], 0, buffer_.size());
+  const uint8_t* data = static_cast<const uint8_t*>(buffer);
+  while (length > 0) {
+    size_t chunk = length;
+    if (!buffer)
+      chunk = std::min(chunk, buffer_.size());
+    ssize_t r = HANDLE_EINTR(write(out_fd_, data ? data : &buffer_[0], chunk));
+    if (r <= 0)
+      return false;
+    if (data)
+      data += r;
+    length -= r;
+    bytes_written_ += r;
+  }
+  return true;
+}
+
+bool CoreDumpReducer::Copy(size_t length) {
+  while (length > 0) {
+    size_t chunk = std::min(length, buffer_.size());
+    if (!Read(&buffer_[0], chunk) || !Write(&buffer_[0], chunk))
+      return false;
+    length -= chunk;
+  }
+  return true;
+}
+
+}  // namespace google_breakpad
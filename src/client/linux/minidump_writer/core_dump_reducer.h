@@ -0,0 +1,175 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// core_dump_reducer.h: Define the google_breakpad::CoreDumpReducer class,
+// which reads an ELF core dump as a stream and writes a much smaller core
+// dump holding what LinuxCoreDumper needs to write a minidump.
+//
+// As a core_pattern pipe handler, core_handler gets the whole address space
+// of the crashed process on stdin.  Spooling it to disk before converting it
+// costs as much disk and time as the process is big.  CoreDumpReducer reads
+// the core dump once and keeps its notes but, of the PT_LOAD segments, only:
+//   - the stack of every thread and the memory around its instruction
+//     pointer, as captured by the minidump writer;
+//   - the whole linux-gate (vDSO) segment;
+//   - the first page of every segment, which holds the ELF and program
+//     headers of mapped modules;
+//   - small segments whole, which typically hold the data of the dynamic
+//     linker, while the output stays within a fixed budget.
+// The rest is skipped.  The output is a valid core dump whose PT_LOAD
+// segments cover the retained ranges; whatever else the dumper needs is
+// read from /proc/<pid>/mem, as with any core dump.
+//
+// Memory use is bounded by the size of the notes, and the output size by
+// the budget plus the notes, whatever the size of the process.
+//
+// This class uses the heap and libc, and is meant for core dump handlers,
+// not for the compromised context of a crashing process.
+
+#ifndef CLIENT_LINUX_MINIDUMP_WRITER_CORE_DUMP_REDUCER_H_
+#define CLIENT_LINUX_MINIDUMP_WRITER_CORE_DUMP_REDUCER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "common/linux/elf_core_dump.h"
+#include "common/memory_range.h"
+
+namespace google_breakpad {
+
+class CoreDumpReducer {
+ public:
+  // Default budget for the PT_LOAD data of the output.  Thread stacks and
+  // the memory around instruction pointers are kept first, and whole small
+  // segments last.
+  static const size_t kDefaultMaxLoadSize = 64 * 1024 * 1024;
+
+  // Segments up to this size are kept whole while the budget allows.
+  static const size_t kSmallSegmentSize = 64 * 1024;
+
+  // Core dumps with more notes than this are rejected.  A thread takes a
+  // few kilobytes of notes.
+  static const size_t kMaxNotesSize = 32 * 1024 * 1024;
+
+  explicit CoreDumpReducer(size_t max_load_size = kDefaultMaxLoadSize);
+
+  // Reads a core dump from |in_fd| and writes the reduced core dump to
+  // |out_fd|.  Both are accessed sequentially, so either can be a pipe.
+  // The input is not read past the last retained byte.  Returns false if
+  // the input can't be read, the output can't be written, or the core dump
+  // isn't laid out as the kernel writes them: headers, then notes, then
+  // the PT_LOAD segments.  On failure, error() describes what went wrong.
+  bool Reduce(int in_fd, int out_fd);
+
+  // A description of why the last call to Reduce() failed, or NULL if it
+  // succeeded.
+  const char* error() const { return error_; }
+
+  // Statistics about the last call to Reduce().
+  uint64_t bytes_read() const { return bytes_read_; }
+  uint64_t bytes_written() const { return bytes_written_; }
+  size_t thread_count() const { return thread_count_; }
+
+ private:
+  typedef ElfCoreDump::Addr Addr;
+  typedef ElfCoreDump::Ehdr Ehdr;
+  typedef ElfCoreDump::Phdr Phdr;
+
+  // A range of addresses, [start, end).
+  struct Range {
+    Addr start;
+    Addr end;
+  };
+
+  // A PT_LOAD segment of the input and the ranges of it to keep.
+  struct Segment {
+    const Phdr* header;
+    std::vector<Range> kept;
+  };
+
+  static bool AddressLess(const Segment& a, const Segment& b);
+  static bool OffsetLess(const Segment* a, const Segment* b);
+  static bool RangeLess(const Range& a, const Range& b);
+
+  // Records |error| as the reason Reduce() failed, and returns false.
+  bool Fail(const char* error);
+
+  // Reads the notes in |notes| to find the ranges to keep first, and the
+  // address of the vDSO.
+  void ParseNotes(const MemoryRange& notes, std::vector<Range>* wanted,
+                  Addr* vdso_address);
+
+  // Keeps the part of [start, end) that falls in the segment containing
+  // |start|, if the budget allows.  |segments_| must be sorted by address.
+  void Keep(Addr start, Addr end);
+  void KeepInSegment(Segment* segment, Addr start, Addr end);
+
+  // Returns the segment containing |address|, or NULL.
+  Segment* FindSegment(Addr address);
+
+  // Sorts and merges the kept ranges of every segment.
+  void MergeKeptRanges();
+
+  // Reads exactly |length| bytes from the input.
+  bool Read(void* buffer, size_t length);
+
+  // Discards the input up to |offset|.
+  bool SkipTo(uint64_t offset);
+
+  // Writes |length| bytes to the output, or as many zeroes if |buffer| is
+  // NULL.
+  bool Write(const void* buffer, size_t length);
+
+  // Copies |length| bytes from the input to the output.
+  bool Copy(size_t length);
+
+  const size_t max_load_size_;
+
+  int in_fd_;
+  int out_fd_;
+  bool seekable_;
+  size_t page_size_;
+  size_t kept_size_;
+  uint64_t bytes_read_;
+  uint64_t bytes_written_;
+  size_t thread_count_;
+  const char* error_;
+
+  // PT_LOAD segments of the input with data, sorted by address.
+  std::vector<Segment> segments_;
+
+  std::vector<uint8_t> buffer_;
+};
+
+}  // namespace google_breakpad
+
+#endif  // CLIENT_LINUX_MINIDUMP_WRITER_CORE_DUMP_REDUCER_H_
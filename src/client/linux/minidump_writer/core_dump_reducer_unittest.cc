@@ -0,0 +1,168 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// core_dump_reducer_unittest.cc:
+// Unit tests for google_breakpad::CoreDumpReducer.
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "breakpad_googletest_includes.h"
+#include "client/linux/minidump_writer/core_dump_reducer.h"
+#include "client/linux/minidump_writer/linux_core_dumper.h"
+#include "common/linux/eintr_wrapper.h"
+#include "common/linux/tests/crash_generator.h"
+#include "common/tests/auto_tempdir.h"
+#include "common/using_std_string.h"
+
+using namespace google_breakpad;
+
+namespace {
+
+// Reduce |core_path| into |reduced_path|, reading the core dump through a
+// pipe as a core_pattern handler does.
+bool ReduceThroughPipe(const string& core_path, const string& reduced_path,
+                       CoreDumpReducer* reducer) {
+  int fds[2];
+  if (pipe(fds) != 0)
+    return false;
+
+  pid_t child = fork();
+  if (child == 0) {
+    close(fds[0]);
+    int in = open(core_path.c_str(), O_RDONLY);
+    char buffer[4096];
+    ssize_t r;
+    while (in != -1 &&
+           (r = HANDLE_EINTR(read(in, buffer, sizeof(buffer)))) > 0) {
+      if (HANDLE_EINTR(write(fds[1], buffer, r)) != r)
+        break;
+    }
+    _exit(0);
+  }
+  close(fds[1]);
+
+  int out = open(reduced_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  bool result = out != -1 && reducer->Reduce(fds[0], out);
+  close(out);
+  // The reducer may stop reading early.
+  close(fds[0]);
+  int status;
+  HANDLE_EINTR(waitpid(child, &status, 0));
+  return result;
+}
+
+}  // namespace
+
+TEST(CoreDumpReducerTest, KeepsThreadsAndStacks) {
+  CrashGenerator crash_generator;
+  if (!crash_generator.HasDefaultCorePattern()) {
+    fprintf(stderr, "CoreDumpReducerTest.KeepsThreadsAndStacks test is "
+            "skipped due to non-default core pattern\n");
+    return;
+  }
+
+  const unsigned kNumOfThreads = 3;
+  const unsigned kCrashThread = 1;
+  const int kCrashSignal = SIGABRT;
+  pid_t child_pid;
+  ASSERT_TRUE(crash_generator.CreateChildCrash(kNumOfThreads, kCrashThread,
+                                               kCrashSignal, &child_pid));
+
+  const string core_file = crash_generator.GetCoreFilePath();
+  const string procfs_path = crash_generator.GetDirectoryOfProcFilesCopy();
+  struct stat core_stat;
+  if (stat(core_file.c_str(), &core_stat) != 0) {
+    fprintf(stderr, "CoreDumpReducerTest.KeepsThreadsAndStacks test is "
+            "skipped due to no core file being generated\n");
+    return;
+  }
+
+  AutoTempDir temp_dir;
+  const string reduced_file = temp_dir.path() + "/reduced_core";
+  CoreDumpReducer reducer;
+  ASSERT_TRUE(ReduceThroughPipe(core_file, reduced_file, &reducer));
+  EXPECT_EQ(kNumOfThreads, reducer.thread_count());
+  EXPECT_LT(reducer.bytes_written(), static_cast<uint64_t>(core_stat.st_size));
+
+  // The reduced core dump must give the same threads and stacks.
+  LinuxCoreDumper dumper(child_pid, core_file.c_str(), procfs_path.c_str());
+  LinuxCoreDumper reduced_dumper(child_pid, reduced_file.c_str(),
+                                 procfs_path.c_str());
+  ASSERT_TRUE(dumper.Init());
+  ASSERT_TRUE(reduced_dumper.Init());
+  EXPECT_EQ(dumper.crash_signal(), reduced_dumper.crash_signal());
+  EXPECT_EQ(dumper.crash_thread(), reduced_dumper.crash_thread());
+  ASSERT_EQ(dumper.threads().size(), reduced_dumper.threads().size());
+
+  for (size_t i = 0; i < dumper.threads().size(); ++i) {
+    ThreadInfo info;
+    ASSERT_TRUE(dumper.GetThreadInfoByIndex(i, &info));
+    const void* stack;
+    size_t stack_len;
+    ASSERT_TRUE(dumper.GetStackInfo(&stack, &stack_len, info.stack_pointer));
+
+    std::vector<uint8_t> expected(stack_len), actual(stack_len);
+    EXPECT_TRUE(dumper.CopyFromProcess(&expected[0], dumper.threads()[i],
+                                       stack, stack_len));
+    EXPECT_TRUE(reduced_dumper.CopyFromProcess(
+        &actual[0], reduced_dumper.threads()[i], stack, stack_len));
+    EXPECT_TRUE(expected == actual);
+  }
+}
+
+TEST(CoreDumpReducerTest, RejectsInvalidCoreDump) {
+  AutoTempDir temp_dir;
+  const string input_file = temp_dir.path() + "/not_a_core";
+  const string output_file = temp_dir.path() + "/output";
+  int in = open(input_file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  ASSERT_NE(-1, in);
+  const char kData[] = "\177ELF but not really a core dump, padded to be long "
+                       "enough to hold an ELF header for any word size.";
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(kData)),
+            write(in, kData, sizeof(kData)));
+  ASSERT_EQ(0, lseek(in, 0, SEEK_SET));
+
+  int out = open(output_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  ASSERT_NE(-1, out);
+  CoreDumpReducer reducer;
+  EXPECT_FALSE(reducer.Reduce(in, out));
+  EXPECT_TRUE(reducer.error() != NULL);
+  close(in);
+  close(out);
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// dump_phase_timer.cc: Record the phases of writing a minidump.
+//
+// See dump_phase_timer.h for documentation.
+
+#include "client/linux/minidump_writer/dump_phase_timer.h"
+
+#include <time.h>
+
+#include "third_party/lss/linux_syscall_support.h"
+
+namespace google_breakpad {
+
+namespace {
+
+DumpPhaseTimes* g_dump_phase_times = NULL;
+
+uint64_t NowNanoseconds() {
+  struct kernel_timespec ts;
+  if (sys_clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+    return 0;
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+}  // namespace
+
+void SetDumpPhaseTimes(DumpPhaseTimes* times) {
+  g_dump_phase_times = times;
+}
+
+DumpPhaseTimes* GetDumpPhaseTimes() {
+  return g_dump_phase_times;
+}
+
+const char* DumpPhaseName(DumpPhase phase) {
+  switch (phase) {
+    case kDumpPhaseTotal:
+      return "total";
+    case kDumpPhaseClone:
+      return "clone";
+    case kDumpPhaseEnumerateMappings:
+      return "enumerate_mappings";
+    case kDumpPhaseThreadsSuspend:
+      return "threads_suspend";
+    case kDumpPhaseThreadStacks:
+      return "thread_stacks";
+    case kDumpPhaseWriteStreams:
+      return "write_streams";
+    default:
+      return "unknown";
+  }
+}
+
+void DumpPhaseBegin(DumpPhase phase) {
+  if (g_dump_phase_times)
+    g_dump_phase_times->start_ns[phase] = NowNanoseconds();
+}
+
+void DumpPhaseEnd(DumpPhase phase) {
+  if (g_dump_phase_times)
+    g_dump_phase_times->end_ns[phase] = NowNanoseconds();
+}
+
+}  // namespace google_breakpad
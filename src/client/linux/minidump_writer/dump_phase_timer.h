@@ -0,0 +1,105 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// dump_phase_timer.h: Optional timestamps for the phases of writing a
+// minidump from the crash handler.
+//
+// Nothing is recorded unless a DumpPhaseTimes has been installed with
+// SetDumpPhaseTimes(), so the crash path pays one pointer test per phase
+// otherwise.  The crash path benchmark (handler/crash_path_benchmark.cc)
+// installs one in a MAP_SHARED mapping, which lets it see the timestamps
+// taken in the cloned dumping process and, for out-of-process dumps, in
+// the CrashGenerationServer.
+//
+// The functions here only make raw system calls, so they are safe to use
+// in a compromised context.  They are not synchronized: the recorded times
+// are only meaningful while a single dump is being written.
+
+#ifndef CLIENT_LINUX_MINIDUMP_WRITER_DUMP_PHASE_TIMER_H_
+#define CLIENT_LINUX_MINIDUMP_WRITER_DUMP_PHASE_TIMER_H_
+
+#include <stdint.h>
+
+#include "common/basictypes.h"
+
+namespace google_breakpad {
+
+enum DumpPhase {
+  // From the signal handler being entered to the dump being finished (or
+  // the crash server releasing the client).
+  kDumpPhaseTotal,
+  // From clone() of the dumping process until it starts running.
+  kDumpPhaseClone,
+  // Reading /proc/<pid>/maps and identifying the mapped files.
+  kDumpPhaseEnumerateMappings,
+  // Attaching to and stopping every thread of the crashed process.
+  kDumpPhaseThreadsSuspend,
+  // Copying the thread stacks and registers into the minidump.
+  kDumpPhaseThreadStacks,
+  // Writing the remaining streams to the minidump file.
+  kDumpPhaseWriteStreams,
+  kDumpPhaseCount
+};
+
+// CLOCK_MONOTONIC timestamps in nanoseconds.  A phase that did not run
+// has both timestamps 0.
+struct DumpPhaseTimes {
+  uint64_t start_ns[kDumpPhaseCount];
+  uint64_t end_ns[kDumpPhaseCount];
+};
+
+// Install |times| as the destination for phase timestamps, or stop
+// recording with NULL.  |times| is not cleared.
+void SetDumpPhaseTimes(DumpPhaseTimes* times);
+DumpPhaseTimes* GetDumpPhaseTimes();
+
+// Returns the name used for |phase| in benchmark output.
+const char* DumpPhaseName(DumpPhase phase);
+
+void DumpPhaseBegin(DumpPhase phase);
+void DumpPhaseEnd(DumpPhase phase);
+
+// Records |phase| for the lifetime of the object.
+class ScopedDumpPhase {
+ public:
+  explicit ScopedDumpPhase(DumpPhase phase) : phase_(phase) {
+    DumpPhaseBegin(phase_);
+  }
+  ~ScopedDumpPhase() { DumpPhaseEnd(phase_); }
+
+ private:
+  DumpPhase phase_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedDumpPhase);
+};
+
+}  // namespace google_breakpad
+
+#endif  // CLIENT_LINUX_MINIDUMP_WRITER_DUMP_PHASE_TIMER_H_
@@ -83,9 +83,6 @@ bool LinuxCoreDumper::BuildProcPath(char* path, pid_t pid,
 bool LinuxCoreDumper::CopyFromProcess(void* dest, pid_t child,
                                       const void* src, size_t length) {
   ElfCoreDump::Addr virtual_address = reinterpret_cast<ElfCoreDump::Addr>(src);
-  // TODO(benchan): Investigate whether the data to be copied could span
-  // across multiple segments in the core dump file. ElfCoreDump::CopyData
-  // and this method do not handle that case yet.
   if (!core_.CopyData(dest, virtual_address, length)) {
     // If the data segment is not found in the core dump, fill the result
     // with marker characters.
@@ -100,6 +97,30 @@ bool LinuxCoreDumper::GetThreadInfoByIndex(size_t index, ThreadInfo* info) {
     return false;
 
   *info = thread_infos_[index];
+  return true;
+}
+
+// static
+void LinuxCoreDumper::ThreadInfoFromStatus(const elf_prstatus& status,
+                                           ThreadInfo* info) {
+  memset(info, 0, sizeof(ThreadInfo));
+  info->tgid = status.pr_pgrp;
+  info->ppid = status.pr_ppid;
+#if defined(__mips__)
+#if defined(__ANDROID__)
+  for (int i = EF_R0; i <= EF_R31; i++)
+    info->mcontext.gregs[i - EF_R0] = status.pr_reg[i];
+#else  // __ANDROID__
+  for (int i = EF_REG0; i <= EF_REG31; i++)
+    info->mcontext.gregs[i - EF_REG0] = status.pr_reg[i];
+#endif  // __ANDROID__
+  info->mcontext.mdlo = status.pr_reg[EF_LO];
+  info->mcontext.mdhi = status.pr_reg[EF_HI];
+  info->mcontext.pc = status.pr_reg[EF_CP0_EPC];
+#else  // __mips__
+  memcpy(&info->regs, status.pr_reg, sizeof(info->regs));
+#endif  // __mips__
+
   const uint8_t* stack_pointer;
 #if defined(__i386)
   memcpy(&stack_pointer, &info->regs.esp, sizeof(info->regs.esp));
@@ -116,7 +137,6 @@ bool LinuxCoreDumper::GetThreadInfoByIndex(size_t index, ThreadInfo* info) {
 #error "This code hasn't been ported to your platform yet."
 #endif
   info->stack_pointer = reinterpret_cast<uintptr_t>(stack_pointer);
-  return true;
 }
 
 bool LinuxCoreDumper::IsPostMortem() const {
@@ -204,23 +224,7 @@ bool LinuxCoreDumper::EnumerateThreads() {
             reinterpret_cast<const elf_prstatus*>(description.data());
         pid_t pid = status->pr_pid;
         ThreadInfo info;
-        memset(&info, 0, sizeof(ThreadInfo));
-        info.tgid = status->pr_pgrp;
-        info.ppid = status->pr_ppid;
-#if defined(__mips__)
-#if defined(__ANDROID__)
-        for (int i = EF_R0; i <= EF_R31; i++)
-          info.mcontext.gregs[i - EF_R0] = status->pr_reg[i];
-#else  // __ANDROID__
-        for (int i = EF_REG0; i <= EF_REG31; i++)
-          info.mcontext.gregs[i - EF_REG0] = status->pr_reg[i];
-#endif  // __ANDROID__
-        info.mcontext.mdlo = status->pr_reg[EF_LO];
-        info.mcontext.mdhi = status->pr_reg[EF_HI];
-        info.mcontext.pc = status->pr_reg[EF_CP0_EPC];
-#else  // __mips__
-        memcpy(&info.regs, status->pr_reg, sizeof(info.regs));
-#endif  // __mips__
+        ThreadInfoFromStatus(*status, &info);
         if (first_thread) {
           crash_thread_ = pid;
           crash_signal_ = status->pr_info.si_signo;
@@ -34,6 +34,8 @@
 #ifndef CLIENT_LINUX_MINIDUMP_WRITER_LINUX_CORE_DUMPER_H_
 #define CLIENT_LINUX_MINIDUMP_WRITER_LINUX_CORE_DUMPER_H_
 
+#include <sys/procfs.h>
+
 #include "client/linux/minidump_writer/linux_dumper.h"
 #include "common/linux/elf_core_dump.h"
 #include "common/linux/memory_mapped_file.h"
@@ -97,6 +99,11 @@ class LinuxCoreDumper : public LinuxDumper {
   // always returns true.
   virtual bool ThreadsResume();
 
+  // Fills |info| with the registers, including the stack pointer, found in
+  // the NT_PRSTATUS note |status| of a core dump.
+  static void ThreadInfoFromStatus(const elf_prstatus& status,
+                                   ThreadInfo* info);
+
  protected:
   // Implements LinuxDumper::EnumerateThreads().
   // Enumerates all threads of the given process into |threads_|.
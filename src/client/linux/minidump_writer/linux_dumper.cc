@@ -45,6 +45,8 @@
 #include <string.h>
 
 #include "client/linux/minidump_writer/line_reader.h"
+#include "client/linux/minidump_writer/dump_phase_timer.h"
+#include "client/linux/minidump_writer/mapping_info_cache.h"
 #include "common/linux/elfutils.h"
 #include "common/linux/file_id.h"
 #include "common/linux/linux_libc_support.h"
@@ -285,6 +287,7 @@ LinuxDumper::LinuxDumper(pid_t pid, const char* root_prefix)
       crash_signal_(0),
       crash_signal_code_(0),
       crash_thread_(pid),
+      mapping_cache_(NULL),
       threads_(&allocator_, 8),
       mappings_(&allocator_),
       auxv_(&allocator_, AT_MAX + 1) {
@@ -298,7 +301,10 @@ LinuxDumper::~LinuxDumper() {
 }
 
 bool LinuxDumper::Init() {
-  return ReadAuxv() && EnumerateThreads() && EnumerateMappings();
+  if (!ReadAuxv() || !EnumerateThreads())
+    return false;
+  ScopedDumpPhase phase(kDumpPhaseEnumerateMappings);
+  return EnumerateMappings();
 }
 
 bool LinuxDumper::LateInit() {
@@ -341,12 +347,23 @@ LinuxDumper::ElfFileIdentifierForMapping(const MappingInfo& mapping,
     return false;
   bool filename_modified = HandleDeletedFileInMapping(filename);
 
-  MemoryMappedFile mapped_file(filename, mapping.offset);
-  if (!mapped_file.data() || mapped_file.size() < SELFMAG)
-    return false;
+  bool success;
+  if (mapping_cache_) {
+    MappingInfoCache::Entry entry;
+    success = mapping_cache_->Get(filename, mapping.offset, &entry) &&
+              !entry.identifier.empty();
+    if (success) {
+      identifier.insert(identifier.end(), entry.identifier.begin(),
+                        entry.identifier.end());
+    }
+  } else {
+    MemoryMappedFile mapped_file(filename, mapping.offset);
+    if (!mapped_file.data() || mapped_file.size() < SELFMAG)
+      return false;
 
-  bool success =
-      FileID::ElfFileIdentifierFromMappedFile(mapped_file.data(), identifier);
+    success = FileID::ElfFileIdentifierFromMappedFile(mapped_file.data(),
+                                                      identifier);
+  }
   if (success && member && filename_modified) {
     mappings_[mapping_id]->name[my_strlen(mapping.name) -
                                 sizeof(kDeletedSuffix) + 1] = '\0';
@@ -454,6 +471,16 @@ bool ElfFileSoName(const LinuxDumper& dumper,
   if (!dumper.GetMappingAbsolutePath(mapping, filename))
     return false;
 
+  if (dumper.mapping_cache()) {
+    MappingInfoCache::Entry entry;
+    if (!dumper.mapping_cache()->Get(filename, mapping.offset, &entry) ||
+        !entry.has_soname) {
+      return false;
+    }
+    my_strlcpy(soname, entry.soname.c_str(), soname_size);
+    return true;
+  }
+
   MemoryMappedFile mapped_file(filename, mapping.offset);
   if (!mapped_file.data() || mapped_file.size() < SELFMAG) {
     // mmap failed
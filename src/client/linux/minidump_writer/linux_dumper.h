@@ -58,6 +58,8 @@
 
 namespace google_breakpad {
 
+class MappingInfoCache;
+
 // Typedef for our parsing of the auxv variables in /proc/pid/auxv.
 #if defined(__i386) || defined(__ARM_EABI__) || \
  (defined(__mips__) && _MIPS_SIM == _ABIO32)
@@ -173,6 +175,13 @@ class LinuxDumper {
                                    unsigned int mapping_id,
                                    wasteful_vector<uint8_t>& identifier);
 
+  // Use |cache| to look up the ELF identifier and SONAME of mapped files
+  // instead of reading them every time.  |cache| is not owned and must
+  // outlive the dumper.  As MappingInfoCache uses the heap, this must not be
+  // set when dumping from a compromised context.
+  void set_mapping_cache(MappingInfoCache* cache) { mapping_cache_ = cache; }
+  MappingInfoCache* mapping_cache() const { return mapping_cache_; }
+
   void SetCrashInfoFromSigInfo(const siginfo_t& siginfo);
 
   uintptr_t crash_address() const { return crash_address_; }
@@ -255,6 +264,9 @@ class LinuxDumper {
 
   mutable PageAllocator allocator_;
 
+  // Optional cache of the ELF information of mapped files; not owned.
+  MappingInfoCache* mapping_cache_;
+
   // IDs of all the threads.
   wasteful_vector<pid_t> threads_;
 
@@ -101,6 +101,13 @@ static bool ResumeThread(pid_t pid) {
   return sys_ptrace(PTRACE_DETACH, pid, NULL, NULL) >= 0;
 }
 
+// Waits for a traced thread that was killed while attached to.  It stays a
+// zombie until its tracer, the calling thread, has collected its status.
+static void ReapThread(pid_t pid) {
+  while (sys_waitpid(pid, NULL, __WALL) < 0 && errno == EINTR) {
+  }
+}
+
 namespace google_breakpad {
 
 LinuxPtraceDumper::LinuxPtraceDumper(pid_t pid)
@@ -334,8 +341,23 @@ bool LinuxPtraceDumper::ThreadsResume() {
   if (!threads_suspended_)
     return false;
   bool good = true;
-  for (size_t i = 0; i < threads_.size(); ++i)
-    good &= ResumeThread(threads_[i]);
+  bool reap_leader = false;
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    if (ResumeThread(threads_[i]))
+      continue;
+    good = false;
+    // ESRCH means the thread has left its ptrace stop, which only SIGKILL
+    // does: reap it. The thread group leader is only reported once every
+    // other thread is gone, so it goes last.
+    if (errno != ESRCH)
+      continue;
+    if (threads_[i] == pid_)
+      reap_leader = true;
+    else
+      ReapThread(threads_[i]);
+  }
+  if (reap_leader)
+    ReapThread(pid_);
   threads_suspended_ = false;
   return good;
 }
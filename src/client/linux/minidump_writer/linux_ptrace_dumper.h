@@ -75,6 +75,8 @@ class LinuxPtraceDumper : public LinuxDumper {
 
   // Implements LinuxDumper::ThreadsResume().
   // Resumes all threads in the given process. Returns true on success.
+  // Threads killed while suspended are reaped instead, so that they do not
+  // linger as zombies of the calling thread.
   virtual bool ThreadsResume();
 
  protected:
@@ -0,0 +1,177 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// mapping_info_cache.cc: Implement google_breakpad::MappingInfoCache.
+//
+// See mapping_info_cache.h for documentation.
+
+#include "client/linux/minidump_writer/mapping_info_cache.h"
+
+#include <elf.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+#include "common/linux/elfutils.h"
+#include "common/linux/file_id.h"
+#include "common/linux/memory_mapped_file.h"
+#include "common/memory_allocator.h"
+
+namespace google_breakpad {
+
+bool MappingInfoCache::Key::operator<(const Key& other) const {
+  if (device != other.device)
+    return device < other.device;
+  if (inode != other.inode)
+    return inode < other.inode;
+  if (size != other.size)
+    return size < other.size;
+  if (mtime_sec != other.mtime_sec)
+    return mtime_sec < other.mtime_sec;
+  if (mtime_nsec != other.mtime_nsec)
+    return mtime_nsec < other.mtime_nsec;
+  return offset < other.offset;
+}
+
+bool MappingInfoCache::Key::operator==(const Key& other) const {
+  return !(*this < other) && !(other < *this);
+}
+
+MappingInfoCache::MappingInfoCache(size_t max_entries)
+    : max_entries_(max_entries > 0 ? max_entries : 1),
+      hits_(0),
+      misses_(0) {
+  pthread_mutex_init(&mutex_, NULL);
+}
+
+MappingInfoCache::~MappingInfoCache() {
+  pthread_mutex_destroy(&mutex_);
+}
+
+bool MappingInfoCache::Get(const char* path, size_t offset, Entry* entry) {
+  Key key;
+  if (!GetKey(path, offset, &key))
+    return false;
+
+  pthread_mutex_lock(&mutex_);
+  EntryMap::iterator it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second.second);
+    *entry = it->second.first;
+    ++hits_;
+    pthread_mutex_unlock(&mutex_);
+    return true;
+  }
+  ++misses_;
+  pthread_mutex_unlock(&mutex_);
+
+  // Read the file without holding the lock, so that other dumps can go on.
+  if (!ReadEntry(path, offset, entry))
+    return false;
+
+  // Only remember what was read if the file did not change meanwhile.
+  Key key_after;
+  if (GetKey(path, offset, &key_after) && key_after == key)
+    Insert(key, *entry);
+  return true;
+}
+
+size_t MappingInfoCache::size() {
+  pthread_mutex_lock(&mutex_);
+  size_t size = entries_.size();
+  pthread_mutex_unlock(&mutex_);
+  return size;
+}
+
+uint64_t MappingInfoCache::hits() {
+  pthread_mutex_lock(&mutex_);
+  uint64_t hits = hits_;
+  pthread_mutex_unlock(&mutex_);
+  return hits;
+}
+
+uint64_t MappingInfoCache::misses() {
+  pthread_mutex_lock(&mutex_);
+  uint64_t misses = misses_;
+  pthread_mutex_unlock(&mutex_);
+  return misses;
+}
+
+// static
+bool MappingInfoCache::GetKey(const char* path, size_t offset, Key* key) {
+  struct stat st;
+  if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+    return false;
+
+  key->device = st.st_dev;
+  key->inode = st.st_ino;
+  key->size = st.st_size;
+  key->mtime_sec = st.st_mtim.tv_sec;
+  key->mtime_nsec = st.st_mtim.tv_nsec;
+  key->offset = offset;
+  return true;
+}
+
+// static
+bool MappingInfoCache::ReadEntry(const char* path, size_t offset,
+                                 Entry* entry) {
+  MemoryMappedFile mapped_file(path, offset);
+  if (!mapped_file.data() || mapped_file.size() < SELFMAG)
+    return false;
+
+  PageAllocator allocator;
+  auto_wasteful_vector<uint8_t, kDefaultBuildIdSize> identifier(&allocator);
+  entry->identifier.clear();
+  if (FileID::ElfFileIdentifierFromMappedFile(mapped_file.data(),
+                                              identifier)) {
+    entry->identifier.assign(identifier.begin(), identifier.end());
+  }
+
+  char soname[NAME_MAX];
+  entry->has_soname =
+      ElfFileSoNameFromMappedFile(mapped_file.data(), soname, sizeof(soname));
+  entry->soname = entry->has_soname ? soname : "";
+  return true;
+}
+
+void MappingInfoCache::Insert(const Key& key, const Entry& entry) {
+  pthread_mutex_lock(&mutex_);
+  // Another thread may have read the same file meanwhile.
+  if (entries_.find(key) == entries_.end()) {
+    lru_.push_front(key);
+    entries_[key] = std::make_pair(entry, lru_.begin());
+    if (entries_.size() > max_entries_) {
+      entries_.erase(lru_.back());
+      lru_.pop_back();
+    }
+  }
+  pthread_mutex_unlock(&mutex_);
+}
+
+}  // namespace google_breakpad
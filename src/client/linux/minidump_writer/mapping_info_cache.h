@@ -0,0 +1,134 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// mapping_info_cache.h: Define the google_breakpad::MappingInfoCache class,
+// which remembers the ELF identifier and SONAME of mapped files across
+// minidumps.
+//
+// Reading these means mapping every module of the dumped process and
+// walking its ELF headers and notes.  A process that writes many minidumps,
+// such as a crash server, mostly sees the same binaries over and over, so it
+// can hand a MappingInfoCache to the dumper and skip that work for files it
+// has already seen.
+//
+// Entries are keyed by the file's device, inode, size and modification time
+// (and the offset it is mapped at), so a file that is replaced or modified
+// gets a new entry rather than a stale one.
+//
+// Unlike the rest of the dumper, this class uses the heap and libc: it must
+// not be used from a compromised context.  It is thread safe.
+
+#ifndef CLIENT_LINUX_MINIDUMP_WRITER_MAPPING_INFO_CACHE_H_
+#define CLIENT_LINUX_MINIDUMP_WRITER_MAPPING_INFO_CACHE_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common/using_std_string.h"
+
+namespace google_breakpad {
+
+class MappingInfoCache {
+ public:
+  // What is known about a mapped file.
+  struct Entry {
+    Entry() : has_soname(false) {}
+
+    // ELF identifier, as computed by FileID::ElfFileIdentifierFromMappedFile;
+    // empty if it could not be computed.
+    std::vector<uint8_t> identifier;
+
+    // DT_SONAME, if the file has one.
+    bool has_soname;
+    string soname;
+  };
+
+  static const size_t kDefaultMaxEntries = 4096;
+
+  // The least recently used entries are dropped beyond |max_entries|.
+  explicit MappingInfoCache(size_t max_entries = kDefaultMaxEntries);
+  ~MappingInfoCache();
+
+  // Fill |entry| with the information for the file at |path|, mapped at
+  // |offset|.  It is computed and remembered if the file has not been seen
+  // before, or has changed since.  Returns false if the file can't be read.
+  bool Get(const char* path, size_t offset, Entry* entry);
+
+  size_t size();
+  uint64_t hits();
+  uint64_t misses();
+
+ private:
+  struct Key {
+    dev_t device;
+    ino_t inode;
+    off_t size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    size_t offset;
+
+    bool operator<(const Key& other) const;
+    bool operator==(const Key& other) const;
+  };
+
+  typedef std::list<Key> LRUList;
+  typedef std::map<Key, std::pair<Entry, LRUList::iterator> > EntryMap;
+
+  // Identify the file at |path| as it is now.
+  static bool GetKey(const char* path, size_t offset, Key* key);
+
+  // Read |entry| from the file at |path|.
+  static bool ReadEntry(const char* path, size_t offset, Entry* entry);
+
+  void Insert(const Key& key, const Entry& entry);
+
+  const size_t max_entries_;
+
+  pthread_mutex_t mutex_;
+  EntryMap entries_;
+  // Most recently used first.
+  LRUList lru_;
+  uint64_t hits_;
+  uint64_t misses_;
+
+  // Disallow copying.
+  MappingInfoCache(const MappingInfoCache&);
+  MappingInfoCache& operator=(const MappingInfoCache&);
+};
+
+}  // namespace google_breakpad
+
+#endif  // CLIENT_LINUX_MINIDUMP_WRITER_MAPPING_INFO_CACHE_H_
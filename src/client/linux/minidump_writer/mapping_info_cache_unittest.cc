@@ -0,0 +1,89 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// mapping_info_cache_unittest.cc: Unit tests for MappingInfoCache.
+
+#include <string.h>
+
+#include "breakpad_googletest_includes.h"
+#include "client/linux/minidump_writer/mapping_info_cache.h"
+
+using google_breakpad::MappingInfoCache;
+
+namespace {
+
+// Any ELF file will do; this one is always there.
+const char kSelf[] = "/proc/self/exe";
+
+}  // namespace
+
+TEST(MappingInfoCacheTest, ReadsOnce) {
+  MappingInfoCache cache;
+  MappingInfoCache::Entry first, second;
+  ASSERT_TRUE(cache.Get(kSelf, 0, &first));
+  EXPECT_FALSE(first.identifier.empty());
+  EXPECT_EQ(1U, cache.misses());
+  EXPECT_EQ(0U, cache.hits());
+
+  ASSERT_TRUE(cache.Get(kSelf, 0, &second));
+  EXPECT_EQ(1U, cache.misses());
+  EXPECT_EQ(1U, cache.hits());
+  EXPECT_EQ(1U, cache.size());
+  EXPECT_TRUE(first.identifier == second.identifier);
+  EXPECT_EQ(first.has_soname, second.has_soname);
+  EXPECT_EQ(first.soname, second.soname);
+}
+
+TEST(MappingInfoCacheTest, RejectsNonRegularFiles) {
+  MappingInfoCache cache;
+  MappingInfoCache::Entry entry;
+  EXPECT_FALSE(cache.Get("/dev/null", 0, &entry));
+  EXPECT_FALSE(cache.Get("/proc/self", 0, &entry));
+  EXPECT_FALSE(cache.Get("/nonexistent/file", 0, &entry));
+  EXPECT_EQ(0U, cache.size());
+}
+
+TEST(MappingInfoCacheTest, EvictsLeastRecentlyUsed) {
+  MappingInfoCache cache(2);
+  MappingInfoCache::Entry entry;
+  ASSERT_TRUE(cache.Get(kSelf, 0, &entry));
+  ASSERT_TRUE(cache.Get(kSelf, 4096, &entry));
+  // Touch offset 0 so that 4096 is the oldest entry.
+  ASSERT_TRUE(cache.Get(kSelf, 0, &entry));
+  ASSERT_TRUE(cache.Get(kSelf, 8192, &entry));
+  EXPECT_EQ(2U, cache.size());
+  EXPECT_EQ(3U, cache.misses());
+  EXPECT_EQ(1U, cache.hits());
+
+  ASSERT_TRUE(cache.Get(kSelf, 0, &entry));
+  EXPECT_EQ(2U, cache.hits());
+  ASSERT_TRUE(cache.Get(kSelf, 4096, &entry));
+  EXPECT_EQ(4U, cache.misses());
+}
@@ -0,0 +1,220 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// minidump_compressor.cc: Compression of a written minidump.
+//
+// See minidump_compressor.h for documentation.
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "client/linux/minidump_writer/minidump_compressor.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
+#include "common/linux/linux_libc_support.h"
+#include "common/memory_allocator.h"
+#include "third_party/lss/linux_syscall_support.h"
+
+namespace google_breakpad {
+
+#if defined(HAVE_LIBZ)
+
+namespace {
+
+// Size of the chunks read from the uncompressed minidump.
+const size_t kChunkSize = 64 * 1024;
+
+// 15 bits of window, +16 to have zlib write a gzip header and trailer.
+const int kGzipWindowBits = 15 + 16;
+
+// The default memLevel; deflate needs about (1 << (memLevel + 9)) bytes.
+const int kMemLevel = 8;
+
+// zlib allocation hooks.  The allocator is private to
+// Deflate(), so rounding every request up keeps all the
+// returned blocks suitably aligned.  Memory is released when the allocator
+// goes out of scope.
+void* ZAlloc(void* opaque, uInt items, uInt size) {
+  PageAllocator* allocator = static_cast<PageAllocator*>(opaque);
+  const size_t bytes = (static_cast<size_t>(items) * size + 15) & ~15;
+  return allocator->Alloc(bytes);
+}
+
+void ZFree(void*, void*) {}
+
+bool ReadFully(int fd, uint8_t* buffer, size_t count, size_t offset) {
+  while (count) {
+    const ssize_t r = sys_pread64(fd, buffer, count, offset);
+    if (r <= 0)
+      return false;
+    buffer += r;
+    count -= r;
+    offset += r;
+  }
+  return true;
+}
+
+bool WriteFully(int fd, const uint8_t* buffer, size_t count, size_t offset) {
+  while (count) {
+    const ssize_t r = sys_pwrite64(fd, buffer, count, offset);
+    if (r <= 0)
+      return false;
+    buffer += r;
+    count -= r;
+    offset += r;
+  }
+  return true;
+}
+
+// Compress the first |size| bytes of |in_fd| into |out_fd| at |out_offset|
+// and set |*compressed_size| to the length of the stream.  The two may be
+// the same file as long as the output starts after the input.
+bool Deflate(int in_fd, size_t size, int out_fd, size_t out_offset,
+             size_t* compressed_size) {
+  PageAllocator allocator;
+  z_stream stream;
+  my_memset(&stream, 0, sizeof(stream));
+  stream.zalloc = ZAlloc;
+  stream.zfree = ZFree;
+  stream.opaque = &allocator;
+  // Favour speed: the process is waiting for us, and most of the gain comes
+  // from the long runs of zeros in stacks and memory regions anyway.
+  if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, kGzipWindowBits,
+                   kMemLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return false;
+  }
+
+  uint8_t* input = static_cast<uint8_t*>(allocator.Alloc(kChunkSize));
+  uint8_t* output = static_cast<uint8_t*>(allocator.Alloc(kChunkSize));
+  if (!input || !output) {
+    deflateEnd(&stream);
+    return false;
+  }
+
+  size_t read_offset = 0;
+  size_t write_offset = out_offset;
+  bool success = false;
+  while (true) {
+    if (stream.avail_in == 0 && read_offset < size) {
+      const size_t count =
+          size - read_offset < kChunkSize ? size - read_offset : kChunkSize;
+      if (!ReadFully(in_fd, input, count, read_offset))
+        break;
+      read_offset += count;
+      stream.next_in = input;
+      stream.avail_in = count;
+    }
+
+    stream.next_out = output;
+    stream.avail_out = kChunkSize;
+    const int result =
+        deflate(&stream, read_offset == size ? Z_FINISH : Z_NO_FLUSH);
+    if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+      break;
+    const size_t produced = kChunkSize - stream.avail_out;
+    if (!WriteFully(out_fd, output, produced, write_offset))
+      break;
+    write_offset += produced;
+
+    if (result == Z_STREAM_END) {
+      success = true;
+      break;
+    }
+  }
+
+  deflateEnd(&stream);
+  if (success)
+    *compressed_size = write_offset - out_offset;
+  return success;
+}
+
+}  // namespace
+
+bool CompressMinidumpToFile(int in_fd, size_t size, int out_fd,
+                            size_t* compressed_size) {
+  return Deflate(in_fd, size, out_fd, 0, compressed_size);
+}
+
+bool CompressMinidumpInPlace(int fd, size_t size, size_t* minidump_size) {
+  *minidump_size = size;
+  size_t compressed_size;
+  if ((sys_fcntl(fd, F_GETFL, 0) & O_ACCMODE) != O_RDWR ||
+      !Deflate(fd, size, fd, size, &compressed_size) ||
+      compressed_size >= size) {
+    return true;
+  }
+
+  // The compressed stream is shorter than the plain minidump, so copying it
+  // to the start of the file never overwrites what is left to copy.
+  PageAllocator allocator;
+  uint8_t* buffer = static_cast<uint8_t*>(allocator.Alloc(kChunkSize));
+  if (!buffer)
+    return true;
+  for (size_t offset = 0; offset < compressed_size; offset += kChunkSize) {
+    const size_t count = compressed_size - offset < kChunkSize ?
+        compressed_size - offset : kChunkSize;
+    if (!ReadFully(fd, buffer, count, size + offset)) {
+      // Until the first chunk is written the plain minidump is intact.
+      if (offset == 0)
+        return true;
+      *minidump_size = 0;
+      return false;
+    }
+    if (!WriteFully(fd, buffer, count, offset)) {
+      *minidump_size = 0;
+      return false;
+    }
+  }
+  *minidump_size = compressed_size;
+  return true;
+}
+
+#else  // !HAVE_LIBZ
+
+bool CompressMinidumpToFile(int, size_t, int, size_t*) {
+  return false;
+}
+
+bool CompressMinidumpInPlace(int, size_t size, size_t* minidump_size) {
+  *minidump_size = size;
+  return true;
+}
+
+#endif  // HAVE_LIBZ
+
+}  // namespace google_breakpad
@@ -0,0 +1,76 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// minidump_compressor.h: Compression of a written minidump.
+//
+// The minidump writer seeks back to fill in headers and directories, so the
+// dump cannot be compressed while it is being written.  Instead, once the
+// dump is complete, it is read back and written out again as a gzip stream,
+// either to a separate file or past the end of the plain dump.  The plain
+// dump is only given up once the compressed one is complete.  This only
+// needs a fixed amount of memory, taken from a PageAllocator, and no heap, so
+// it is safe to use in a compromised context.
+
+#ifndef CLIENT_LINUX_MINIDUMP_WRITER_MINIDUMP_COMPRESSOR_H_
+#define CLIENT_LINUX_MINIDUMP_WRITER_MINIDUMP_COMPRESSOR_H_
+
+#include <stddef.h>
+
+namespace google_breakpad {
+
+enum MinidumpCompression {
+  kMinidumpCompressionNone = 0,
+  // The whole minidump file is a gzip stream (RFC 1952).  Minidump::Open()
+  // in the processor reads such files transparently.
+  kMinidumpCompressionGzip
+};
+
+// Compress the first |size| bytes of |in_fd|, which hold a complete
+// minidump, to the start of |out_fd|, setting |*compressed_size| to the
+// length of the compressed stream.  |in_fd| is only read.  Returns false if
+// compression failed or breakpad was built without zlib.
+bool CompressMinidumpToFile(int in_fd, size_t size, int out_fd,
+                            size_t* compressed_size);
+
+// Compress the first |size| bytes of |fd|, which hold a complete minidump,
+// within the same file.  The compressed stream is first written after the
+// plain minidump and only then moved to the start of the file.  |fd| must be
+// open for reading and writing.
+//
+// On return the first |*minidump_size| bytes of |fd| hold the minidump: the
+// compressed one if compression succeeded, the plain one otherwise.  The
+// caller is responsible for truncating the file to that length.  Returns
+// false only if moving the compressed stream failed partway, which leaves
+// neither minidump intact.
+bool CompressMinidumpInPlace(int fd, size_t size, size_t* minidump_size);
+
+}  // namespace google_breakpad
+
+#endif  // CLIENT_LINUX_MINIDUMP_WRITER_MINIDUMP_COMPRESSOR_H_
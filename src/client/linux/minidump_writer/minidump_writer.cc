@@ -68,9 +68,11 @@
 #include "client/linux/dump_writer_common/ucontext_reader.h"
 #include "client/linux/handler/exception_handler.h"
 #include "client/linux/minidump_writer/cpu_set.h"
+#include "client/linux/minidump_writer/dump_phase_timer.h"
 #include "client/linux/minidump_writer/line_reader.h"
 #include "client/linux/minidump_writer/linux_dumper.h"
 #include "client/linux/minidump_writer/linux_ptrace_dumper.h"
+#include "client/linux/minidump_writer/minidump_compressor.h"
 #include "client/linux/minidump_writer/proc_cpuinfo_reader.h"
 #include "client/minidump_file_writer.h"
 #include "common/linux/file_id.h"
@@ -84,19 +86,30 @@ namespace {
 using google_breakpad::AppMemoryList;
 using google_breakpad::auto_wasteful_vector;
 using google_breakpad::ExceptionHandler;
+using google_breakpad::CompressMinidumpInPlace;
+using google_breakpad::CompressMinidumpToFile;
 using google_breakpad::CpuSet;
+using google_breakpad::DumpPhaseBegin;
+using google_breakpad::DumpPhaseEnd;
 using google_breakpad::kDefaultBuildIdSize;
+using google_breakpad::kDumpPhaseThreadStacks;
+using google_breakpad::kDumpPhaseThreadsSuspend;
+using google_breakpad::kDumpPhaseWriteStreams;
+using google_breakpad::kMinidumpCompressionNone;
 using google_breakpad::LineReader;
 using google_breakpad::LinuxDumper;
 using google_breakpad::LinuxPtraceDumper;
 using google_breakpad::MDTypeHelper;
 using google_breakpad::MappingEntry;
 using google_breakpad::MappingInfo;
+using google_breakpad::MappingInfoCache;
 using google_breakpad::MappingList;
+using google_breakpad::MinidumpCompression;
 using google_breakpad::MinidumpFileWriter;
 using google_breakpad::PageAllocator;
 using google_breakpad::ProcCpuInfoReader;
 using google_breakpad::RawContextCPU;
+using google_breakpad::ScopedDumpPhase;
 using google_breakpad::ThreadInfo;
 using google_breakpad::TypedMDRVA;
 using google_breakpad::UContextReader;
@@ -158,7 +171,10 @@ class MinidumpWriter {
     if (!dumper_->Init())
       return false;
 
-    if (!dumper_->ThreadsSuspend() || !dumper_->LateInit())
+    DumpPhaseBegin(kDumpPhaseThreadsSuspend);
+    const bool suspended = dumper_->ThreadsSuspend();
+    DumpPhaseEnd(kDumpPhaseThreadsSuspend);
+    if (!suspended || !dumper_->LateInit())
       return false;
 
     if (skip_stacks_if_mapping_unreferenced_) {
@@ -245,10 +261,15 @@ class MinidumpWriter {
     unsigned dir_index = 0;
     MDRawDirectory dirent;
 
-    if (!WriteThreadListStream(&dirent))
+    DumpPhaseBegin(kDumpPhaseThreadStacks);
+    const bool wrote_threads = WriteThreadListStream(&dirent);
+    DumpPhaseEnd(kDumpPhaseThreadStacks);
+    if (!wrote_threads)
       return false;
     dir.CopyIndex(dir_index++, &dirent);
 
+    ScopedDumpPhase write_streams_phase(kDumpPhaseWriteStreams);
+
     if (!WriteMappings(&dirent))
       return false;
     dir.CopyIndex(dir_index++, &dirent);
@@ -315,6 +336,44 @@ class MinidumpWriter {
     return true;
   }
 
+  // Rewrite the minidump produced by Dump() in compressed form.  The plain
+  // minidump is only replaced once the compressed one is complete, so if
+  // compression fails it is kept and the dump still succeeds.
+  bool Compress() {
+    const int file = minidump_writer_.file();
+    const size_t size = minidump_writer_.position();
+    if (path_) {
+      // Compress into a new file next to the minidump, then rename it over
+      // the plain one.
+      char temp_path[PATH_MAX];
+      if (my_strlcpy(temp_path, path_, sizeof(temp_path)) >=
+              sizeof(temp_path) ||
+          my_strlcat(temp_path, ".gz-tmp", sizeof(temp_path)) >=
+              sizeof(temp_path)) {
+        return true;
+      }
+      const int temp_file =
+          sys_open(temp_path, O_WRONLY | O_CREAT | O_EXCL, 0600);
+      if (temp_file < 0)
+        return true;
+      size_t compressed_size;
+      const bool compressed =
+          CompressMinidumpToFile(file, size, temp_file, &compressed_size);
+      if (sys_close(temp_file) != 0 || !compressed ||
+          rename(temp_path, path_) != 0) {
+        sys_unlink(temp_path);
+      }
+      return true;
+    }
+
+    // A file descriptor supplied by the caller can't be replaced.
+    size_t minidump_size;
+    const bool intact = CompressMinidumpInPlace(file, size, &minidump_size);
+    // Drop the compressed stream left after the plain minidump if it was
+    // not used.
+    return minidump_writer_.Truncate(minidump_size) && intact;
+  }
+
   bool FillThreadStack(MDRawThread* thread, uintptr_t stack_pointer,
                        uintptr_t pc, int max_stack_len, uint8_t** stack_copy) {
     *stack_copy = NULL;
@@ -1368,8 +1427,11 @@ bool WriteMinidumpImpl(const char* minidump_path,
                        const AppMemoryList& appmem,
                        bool skip_stacks_if_mapping_unreferenced,
                        uintptr_t principal_mapping_address,
-                       bool sanitize_stacks) {
+                       bool sanitize_stacks,
+                       MinidumpCompression compression,
+                       MappingInfoCache* mapping_cache) {
   LinuxPtraceDumper dumper(crashing_process);
+  dumper.set_mapping_cache(mapping_cache);
   const ExceptionHandler::CrashContext* context = NULL;
   if (blob) {
     if (blob_size != sizeof(ExceptionHandler::CrashContext))
@@ -1385,7 +1447,9 @@ bool WriteMinidumpImpl(const char* minidump_path,
   writer.set_minidump_size_limit(minidump_size_limit);
   if (!writer.Init())
     return false;
-  return writer.Dump();
+  if (!writer.Dump())
+    return false;
+  return compression == kMinidumpCompressionNone || writer.Compress();
 }
 
 }  // namespace
@@ -1396,41 +1460,33 @@ bool WriteMinidump(const char* minidump_path, pid_t crashing_process,
                    const void* blob, size_t blob_size,
                    bool skip_stacks_if_mapping_unreferenced,
                    uintptr_t principal_mapping_address,
-                   bool sanitize_stacks) {
+                   bool sanitize_stacks,
+                   MinidumpCompression compression) {
   return WriteMinidumpImpl(minidump_path, -1, -1,
                            crashing_process, blob, blob_size,
                            MappingList(), AppMemoryList(),
                            skip_stacks_if_mapping_unreferenced,
                            principal_mapping_address,
-                           sanitize_stacks);
+                           sanitize_stacks, compression, NULL);
 }
 
 bool WriteMinidump(int minidump_fd, pid_t crashing_process,
                    const void* blob, size_t blob_size,
                    bool skip_stacks_if_mapping_unreferenced,
                    uintptr_t principal_mapping_address,
-                   bool sanitize_stacks) {
+                   bool sanitize_stacks,
+                   MinidumpCompression compression) {
   return WriteMinidumpImpl(NULL, minidump_fd, -1,
                            crashing_process, blob, blob_size,
                            MappingList(), AppMemoryList(),
                            skip_stacks_if_mapping_unreferenced,
                            principal_mapping_address,
-                           sanitize_stacks);
+                           sanitize_stacks, compression, NULL);
 }
 
 bool WriteMinidump(const char* minidump_path, pid_t process,
                    pid_t process_blamed_thread) {
-  LinuxPtraceDumper dumper(process);
-  // MinidumpWriter will set crash address
-  dumper.set_crash_signal(MD_EXCEPTION_CODE_LIN_DUMP_REQUESTED);
-  dumper.set_crash_thread(process_blamed_thread);
-  MappingList mapping_list;
-  AppMemoryList app_memory_list;
-  MinidumpWriter writer(minidump_path, -1, NULL, mapping_list,
-                        app_memory_list, false, 0, false, &dumper);
-  if (!writer.Init())
-    return false;
-  return writer.Dump();
+  return WriteMinidump(minidump_path, process, process_blamed_thread, NULL);
 }
 
 bool WriteMinidump(const char* minidump_path, pid_t crashing_process,
@@ -1439,13 +1495,14 @@ bool WriteMinidump(const char* minidump_path, pid_t crashing_process,
                    const AppMemoryList& appmem,
                    bool skip_stacks_if_mapping_unreferenced,
                    uintptr_t principal_mapping_address,
-                   bool sanitize_stacks) {
+                   bool sanitize_stacks,
+                   MinidumpCompression compression) {
   return WriteMinidumpImpl(minidump_path, -1, -1, crashing_process,
                            blob, blob_size,
                            mappings, appmem,
                            skip_stacks_if_mapping_unreferenced,
                            principal_mapping_address,
-                           sanitize_stacks);
+                           sanitize_stacks, compression, NULL);
 }
 
 bool WriteMinidump(int minidump_fd, pid_t crashing_process,
@@ -1454,13 +1511,14 @@ bool WriteMinidump(int minidump_fd, pid_t crashing_process,
                    const AppMemoryList& appmem,
                    bool skip_stacks_if_mapping_unreferenced,
                    uintptr_t principal_mapping_address,
-                   bool sanitize_stacks) {
+                   bool sanitize_stacks,
+                   MinidumpCompression compression) {
   return WriteMinidumpImpl(NULL, minidump_fd, -1, crashing_process,
                            blob, blob_size,
                            mappings, appmem,
                            skip_stacks_if_mapping_unreferenced,
                            principal_mapping_address,
-                           sanitize_stacks);
+                           sanitize_stacks, compression, NULL);
 }
 
 bool WriteMinidump(const char* minidump_path, off_t minidump_size_limit,
@@ -1470,13 +1528,14 @@ bool WriteMinidump(const char* minidump_path, off_t minidump_size_limit,
                    const AppMemoryList& appmem,
                    bool skip_stacks_if_mapping_unreferenced,
                    uintptr_t principal_mapping_address,
-                   bool sanitize_stacks) {
+                   bool sanitize_stacks,
+                   MinidumpCompression compression) {
   return WriteMinidumpImpl(minidump_path, -1, minidump_size_limit,
                            crashing_process, blob, blob_size,
                            mappings, appmem,
                            skip_stacks_if_mapping_unreferenced,
                            principal_mapping_address,
-                           sanitize_stacks);
+                           sanitize_stacks, compression, NULL);
 }
 
 bool WriteMinidump(int minidump_fd, off_t minidump_size_limit,
@@ -1486,13 +1545,14 @@ bool WriteMinidump(int minidump_fd, off_t minidump_size_limit,
                    const AppMemoryList& appmem,
                    bool skip_stacks_if_mapping_unreferenced,
                    uintptr_t principal_mapping_address,
-                   bool sanitize_stacks) {
+                   bool sanitize_stacks,
+                   MinidumpCompression compression) {
   return WriteMinidumpImpl(NULL, minidump_fd, minidump_size_limit,
                            crashing_process, blob, blob_size,
                            mappings, appmem,
                            skip_stacks_if_mapping_unreferenced,
                            principal_mapping_address,
-                           sanitize_stacks);
+                           sanitize_stacks, compression, NULL);
 }
 
 bool WriteMinidump(const char* filename,
@@ -1506,4 +1566,31 @@ bool WriteMinidump(const char* filename,
   return writer.Dump();
 }
 
+bool WriteMinidump(const char* minidump_path, pid_t crashing_process,
+                   const void* blob, size_t blob_size,
+                   MappingInfoCache* mapping_cache) {
+  return WriteMinidumpImpl(minidump_path, -1, -1,
+                           crashing_process, blob, blob_size,
+                           MappingList(), AppMemoryList(),
+                           false, 0, false, kMinidumpCompressionNone,
+                           mapping_cache);
+}
+
+bool WriteMinidump(const char* minidump_path, pid_t process,
+                   pid_t process_blamed_thread,
+                   MappingInfoCache* mapping_cache) {
+  LinuxPtraceDumper dumper(process);
+  dumper.set_mapping_cache(mapping_cache);
+  // MinidumpWriter will set crash address
+  dumper.set_crash_signal(MD_EXCEPTION_CODE_LIN_DUMP_REQUESTED);
+  dumper.set_crash_thread(process_blamed_thread);
+  MappingList mapping_list;
+  AppMemoryList app_memory_list;
+  MinidumpWriter writer(minidump_path, -1, NULL, mapping_list,
+                        app_memory_list, false, 0, false, &dumper);
+  if (!writer.Init())
+    return false;
+  return writer.Dump();
+}
+
 }  // namespace google_breakpad
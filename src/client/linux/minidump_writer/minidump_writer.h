@@ -40,11 +40,13 @@
 #include <utility>
 
 #include "client/linux/minidump_writer/linux_dumper.h"
+#include "client/linux/minidump_writer/minidump_compressor.h"
 #include "google_breakpad/common/minidump_format.h"
 
 namespace google_breakpad {
 
 class ExceptionHandler;
+class MappingInfoCache;
 
 #if defined(__aarch64__)
 typedef struct fpsimd_context fpstate_t;
@@ -76,19 +78,26 @@ typedef std::list<AppMemory> AppMemoryList;
 //   crashing_process: the pid of the crashing process. This must be trusted.
 //   blob: a blob of data from the crashing process. See exception_handler.h
 //   blob_size: the length of |blob|, in bytes
+//   compression: if not kMinidumpCompressionNone, the minidump is compressed
+//     once it has been written.  If that fails, for instance because
+//     |minidump_fd| is not open for reading, the plain minidump is kept.
 //
 // Returns true iff successful.
 bool WriteMinidump(const char* minidump_path, pid_t crashing_process,
                    const void* blob, size_t blob_size,
                    bool skip_stacks_if_mapping_unreferenced = false,
                    uintptr_t principal_mapping_address = 0,
-                   bool sanitize_stacks = false);
+                   bool sanitize_stacks = false,
+                   MinidumpCompression compression =
+                       kMinidumpCompressionNone);
 // Same as above but takes an open file descriptor instead of a path.
 bool WriteMinidump(int minidump_fd, pid_t crashing_process,
                    const void* blob, size_t blob_size,
                    bool skip_stacks_if_mapping_unreferenced = false,
                    uintptr_t principal_mapping_address = 0,
-                   bool sanitize_stacks = false);
+                   bool sanitize_stacks = false,
+                   MinidumpCompression compression =
+                       kMinidumpCompressionNone);
 
 // Alternate form of WriteMinidump() that works with processes that
 // are not expected to have crashed.  If |process_blamed_thread| is
@@ -106,14 +115,18 @@ bool WriteMinidump(const char* minidump_path, pid_t crashing_process,
                    const AppMemoryList& appdata,
                    bool skip_stacks_if_mapping_unreferenced = false,
                    uintptr_t principal_mapping_address = 0,
-                   bool sanitize_stacks = false);
+                   bool sanitize_stacks = false,
+                   MinidumpCompression compression =
+                       kMinidumpCompressionNone);
 bool WriteMinidump(int minidump_fd, pid_t crashing_process,
                    const void* blob, size_t blob_size,
                    const MappingList& mappings,
                    const AppMemoryList& appdata,
                    bool skip_stacks_if_mapping_unreferenced = false,
                    uintptr_t principal_mapping_address = 0,
-                   bool sanitize_stacks = false);
+                   bool sanitize_stacks = false,
+                   MinidumpCompression compression =
+                       kMinidumpCompressionNone);
 
 // These overloads also allow passing a file size limit for the minidump.
 bool WriteMinidump(const char* minidump_path, off_t minidump_size_limit,
@@ -123,7 +136,9 @@ bool WriteMinidump(const char* minidump_path, off_t minidump_size_limit,
                    const AppMemoryList& appdata,
                    bool skip_stacks_if_mapping_unreferenced = false,
                    uintptr_t principal_mapping_address = 0,
-                   bool sanitize_stacks = false);
+                   bool sanitize_stacks = false,
+                   MinidumpCompression compression =
+                       kMinidumpCompressionNone);
 bool WriteMinidump(int minidump_fd, off_t minidump_size_limit,
                    pid_t crashing_process,
                    const void* blob, size_t blob_size,
@@ -131,13 +146,26 @@ bool WriteMinidump(int minidump_fd, off_t minidump_size_limit,
                    const AppMemoryList& appdata,
                    bool skip_stacks_if_mapping_unreferenced = false,
                    uintptr_t principal_mapping_address = 0,
-                   bool sanitize_stacks = false);
+                   bool sanitize_stacks = false,
+                   MinidumpCompression compression =
+                       kMinidumpCompressionNone);
 
 bool WriteMinidump(const char* filename,
                    const MappingList& mappings,
                    const AppMemoryList& appdata,
                    LinuxDumper* dumper);
 
+// These overloads look up the identifiers and names of the process's modules
+// in |mapping_cache|, instead of reading every mapped file, and add to it
+// the files that it doesn't know yet.  As the cache uses the heap, they must
+// not be called from a compromised context.
+bool WriteMinidump(const char* minidump_path, pid_t crashing_process,
+                   const void* blob, size_t blob_size,
+                   MappingInfoCache* mapping_cache);
+bool WriteMinidump(const char* minidump_path, pid_t process,
+                   pid_t process_blamed_thread,
+                   MappingInfoCache* mapping_cache);
+
 }  // namespace google_breakpad
 
 #endif  // CLIENT_LINUX_MINIDUMP_WRITER_MINIDUMP_WRITER_H_
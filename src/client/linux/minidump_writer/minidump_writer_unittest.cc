@@ -27,6 +27,10 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
 #include <fcntl.h>
 #include <poll.h>
 #include <sys/stat.h>
@@ -122,6 +126,109 @@ TEST(MinidumpWriterTest, SetupWithFD) {
   IGNORE_EINTR(waitpid(child, nullptr, 0));
 }
 
+#if defined(HAVE_LIBZ)
+// Test that a compressed minidump is smaller than the plain one and can
+// still be read by the processor.
+TEST(MinidumpWriterTest, CompressedMinidump) {
+  int fds[2];
+  ASSERT_NE(-1, pipe(fds));
+
+  const pid_t child = fork();
+  if (child == 0) {
+    close(fds[1]);
+    char b;
+    IGNORE_RET(HANDLE_EINTR(read(fds[0], &b, sizeof(b))));
+    close(fds[0]);
+    syscall(__NR_exit_group);
+  }
+  close(fds[0]);
+
+  ExceptionHandler::CrashContext context;
+  memset(&context, 0, sizeof(context));
+  // Set a non-zero tid to avoid tripping asserts.
+  context.tid = child;
+
+  AutoTempDir temp_dir;
+  string plain = temp_dir.path() + kMDWriterUnitTestFileName;
+  string compressed = plain + "-compressed";
+  ASSERT_TRUE(WriteMinidump(plain.c_str(), child, &context, sizeof(context)));
+  ASSERT_TRUE(WriteMinidump(compressed.c_str(), child, &context,
+                            sizeof(context), MappingList(), AppMemoryList(),
+                            false, 0, false, kMinidumpCompressionGzip));
+  close(fds[1]);
+  IGNORE_EINTR(waitpid(child, nullptr, 0));
+
+  struct stat plain_st, compressed_st;
+  ASSERT_EQ(0, stat(plain.c_str(), &plain_st));
+  ASSERT_EQ(0, stat(compressed.c_str(), &compressed_st));
+  ASSERT_GT(compressed_st.st_size, 0);
+  ASSERT_LT(compressed_st.st_size, plain_st.st_size);
+
+  Minidump minidump(compressed);
+  ASSERT_TRUE(minidump.Read());
+  MinidumpThreadList* thread_list = minidump.GetThreadList();
+  ASSERT_TRUE(thread_list);
+  ASSERT_EQ(1U, thread_list->thread_count());
+}
+
+// Test that compressing a minidump written to a caller's fd happens in
+// place, and that the plain minidump is kept when the fd can't be read.
+TEST(MinidumpWriterTest, CompressedMinidumpToFd) {
+  int fds[2];
+  ASSERT_NE(-1, pipe(fds));
+
+  const pid_t child = fork();
+  if (child == 0) {
+    close(fds[1]);
+    char b;
+    IGNORE_RET(HANDLE_EINTR(read(fds[0], &b, sizeof(b))));
+    close(fds[0]);
+    syscall(__NR_exit_group);
+  }
+  close(fds[0]);
+
+  ExceptionHandler::CrashContext context;
+  memset(&context, 0, sizeof(context));
+  // Set a non-zero tid to avoid tripping asserts.
+  context.tid = child;
+
+  AutoTempDir temp_dir;
+  string plain = temp_dir.path() + kMDWriterUnitTestFileName;
+  string read_write = plain + "-rw";
+  string write_only = plain + "-wo";
+  ASSERT_TRUE(WriteMinidump(plain.c_str(), child, &context, sizeof(context)));
+  int fd = open(read_write.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  ASSERT_NE(-1, fd);
+  ASSERT_TRUE(WriteMinidump(fd, child, &context, sizeof(context),
+                            MappingList(), AppMemoryList(),
+                            false, 0, false, kMinidumpCompressionGzip));
+  close(fd);
+  fd = open(write_only.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0600);
+  ASSERT_NE(-1, fd);
+  ASSERT_TRUE(WriteMinidump(fd, child, &context, sizeof(context),
+                            MappingList(), AppMemoryList(),
+                            false, 0, false, kMinidumpCompressionGzip));
+  close(fd);
+  close(fds[1]);
+  IGNORE_EINTR(waitpid(child, nullptr, 0));
+
+  struct stat plain_st, read_write_st, write_only_st;
+  ASSERT_EQ(0, stat(plain.c_str(), &plain_st));
+  ASSERT_EQ(0, stat(read_write.c_str(), &read_write_st));
+  ASSERT_EQ(0, stat(write_only.c_str(), &write_only_st));
+  ASSERT_GT(read_write_st.st_size, 0);
+  ASSERT_LT(read_write_st.st_size, plain_st.st_size);
+  ASSERT_EQ(plain_st.st_size, write_only_st.st_size);
+
+  Minidump compressed(read_write);
+  ASSERT_TRUE(compressed.Read());
+  ASSERT_TRUE(compressed.GetThreadList());
+  Minidump uncompressed(write_only);
+  ASSERT_TRUE(uncompressed.Read());
+  ASSERT_TRUE(uncompressed.GetThreadList());
+}
+#endif  // HAVE_LIBZ
+
 // Test that mapping info can be specified when writing a minidump,
 // and that it ends up in the module list of the minidump.
 TEST(MinidumpWriterTest, MappingInfo) {
@@ -104,7 +104,9 @@ MinidumpFileWriter::~MinidumpFileWriter() {
 bool MinidumpFileWriter::Open(const char* path) {
   assert(file_ == -1);
 #if defined(__linux__) && __linux__
-  file_ = sys_open(path, O_WRONLY | O_CREAT | O_EXCL, 0600);
+  // Opened for reading too, so that the minidump can be compressed in place
+  // once written.
+  file_ = sys_open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
 #else
   file_ = open(path, O_WRONLY | O_CREAT | O_EXCL, 0600);
 #endif
@@ -145,6 +147,21 @@ bool MinidumpFileWriter::Close() {
   return result;
 }
 
+bool MinidumpFileWriter::Truncate(MDRVA position) {
+  assert(file_ != -1);
+  assert(position <= position_);
+#if defined(__ANDROID__)
+  if (NeedsFTruncateWorkAround())
+    return false;
+#endif
+  if (ftruncate(file_, position))
+    return false;
+
+  position_ = position;
+  size_ = position;
+  return true;
+}
+
 bool MinidumpFileWriter::CopyStringToMDString(const wchar_t* str,
                                               unsigned int length,
                                               TypedMDRVA<MDString>* mdstring) {
@@ -116,6 +116,15 @@ public:
   // Return the current position for writing to the minidump
   inline MDRVA position() const { return position_; }
 
+  // Return the file descriptor the minidump is written to.
+  inline int file() const { return file_; }
+
+  // Discard everything from |position| on.  This is meant for after the
+  // written data has been rewritten in place in a shorter form, e.g.
+  // compressed; nothing can be written afterwards.
+  // Return true on success, or false on failure.
+  bool Truncate(MDRVA position);
+
  private:
   friend class UntypedMDRVA;
 
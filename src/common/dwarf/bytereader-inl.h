@@ -94,26 +94,36 @@ inline uint64_t ByteReader::ReadEightBytes(const uint8_t* buffer) const {
 // Read an unsigned LEB128 number.  Each byte contains 7 bits of
 // information, plus one bit saying whether the number continues or
 // not.
+//
+// Almost every LEB128 number in DWARF fits in one or two bytes, so
+// handle those without entering the loop.
 
 inline uint64_t ByteReader::ReadUnsignedLEB128(const uint8_t* buffer,
                                              size_t* len) const {
-  uint64_t result = 0;
-  size_t num_read = 0;
-  unsigned int shift = 0;
-  uint8_t byte;
+  uint64_t byte = buffer[0];
+  if (!(byte & 0x80)) {
+    *len = 1;
+    return byte;
+  }
+  uint64_t result = (byte & 0x7f) | (static_cast<uint64_t>(buffer[1]) << 7);
+  if (!(buffer[1] & 0x80)) {
+    *len = 2;
+    return result;
+  }
+  result &= 0x3fff;
 
+  size_t num_read = 2;
+  unsigned int shift = 14;
   do {
-    byte = *buffer++;
-    num_read++;
-
-    result |= (static_cast<uint64_t>(byte & 0x7f)) << shift;
-
+    byte = buffer[num_read++];
+    // Bits beyond the 64th are dropped, rather than shifted by an
+    // undefined amount.
+    if (shift < 64)
+      result |= (byte & 0x7f) << shift;
     shift += 7;
-
   } while (byte & 0x80);
 
   *len = num_read;
-
   return result;
 }
 
@@ -122,22 +132,27 @@ inline uint64_t ByteReader::ReadUnsignedLEB128(const uint8_t* buffer,
 
 inline int64_t ByteReader::ReadSignedLEB128(const uint8_t* buffer,
                                           size_t* len) const {
-  int64_t result = 0;
+  uint64_t byte = buffer[0];
+  if (!(byte & 0x80)) {
+    *len = 1;
+    // Bit 6 of the single byte is the sign bit.
+    return static_cast<int64_t>(byte) - ((byte & 0x40) ? 0x80 : 0);
+  }
+
+  uint64_t result = 0;
   unsigned int shift = 0;
   size_t num_read = 0;
-  uint8_t byte;
-
   do {
-      byte = *buffer++;
-      num_read++;
-      result |= (static_cast<uint64_t>(byte & 0x7f) << shift);
-      shift += 7;
+    byte = buffer[num_read++];
+    if (shift < 64)
+      result |= (byte & 0x7f) << shift;
+    shift += 7;
   } while (byte & 0x80);
 
   if ((shift < 8 * sizeof (result)) && (byte & 0x40))
-    result |= -((static_cast<int64_t>(1)) << shift);
+    result |= -((static_cast<uint64_t>(1)) << shift);
   *len = num_read;
-  return result;
+  return static_cast<int64_t>(result);
 }
 
 inline uint64_t ByteReader::ReadOffset(const uint8_t* buffer) const {
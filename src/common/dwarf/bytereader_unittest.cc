@@ -88,6 +88,40 @@ TEST_F(Reader, SimpleConstructor) {
   EXPECT_EQ(0xfec319c9, reader.ReadAddress(data + 35));
 }
 
+// Check the LEB128 readers at each boundary between encoded lengths.
+TEST_F(Reader, LEB128Lengths) {
+  ByteReader reader(ENDIANNESS_LITTLE);
+  const uint64_t kUnsigned[] = {
+    0, 1, 0x7f, 0x80, 0x3fff, 0x4000, 0x1fffff, 0x200000,
+    0xffffffffffffffffULL
+  };
+  const size_t kUnsignedSizes[] = { 1, 1, 1, 2, 2, 3, 3, 4, 10 };
+  for (size_t i = 0; i < sizeof(kUnsigned) / sizeof(kUnsigned[0]); i++) {
+    CFISection section(kLittleEndian, 4);
+    section.ULEB128(kUnsigned[i]).D8(0xff);
+    ASSERT_TRUE(section.GetContents(&contents));
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(contents.data());
+    size_t leb128_size;
+    EXPECT_EQ(kUnsigned[i], reader.ReadUnsignedLEB128(data, &leb128_size));
+    EXPECT_EQ(kUnsignedSizes[i], leb128_size);
+  }
+
+  const int64_t kSigned[] = {
+    0, 1, -1, 0x3f, -0x40, 0x40, -0x41, 0x1fff, -0x2000, 0x2000, -0x2001,
+    -0x7fffffffffffffffLL - 1
+  };
+  const size_t kSignedSizes[] = { 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 10 };
+  for (size_t i = 0; i < sizeof(kSigned) / sizeof(kSigned[0]); i++) {
+    CFISection section(kLittleEndian, 4);
+    section.LEB128(kSigned[i]).D8(0xff);
+    ASSERT_TRUE(section.GetContents(&contents));
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(contents.data());
+    size_t leb128_size;
+    EXPECT_EQ(kSigned[i], reader.ReadSignedLEB128(data, &leb128_size));
+    EXPECT_EQ(kSignedSizes[i], leb128_size);
+  }
+}
+
 TEST_F(Reader, ValidEncodings) {
   ByteReader reader(ENDIANNESS_LITTLE);
   EXPECT_TRUE(reader.ValidEncoding(
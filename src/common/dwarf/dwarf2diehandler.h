@@ -296,6 +296,8 @@ class DIEDispatcher: public Dwarf2Handler {
                             uint8_t offset_size, uint64_t cu_length,
                             uint8_t dwarf_version);
   bool StartDIE(uint64_t offset, enum DwarfTag tag);
+  // A DIE we don't visit has no handler, so neither do its children.
+  bool SkipsChildrenOfSkippedDIEs() { return true; }
   void ProcessAttributeUnsigned(uint64_t offset,
                                 enum DwarfAttribute attr,
                                 enum DwarfForm form,
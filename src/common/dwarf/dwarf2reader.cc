@@ -37,6 +37,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <stack>
@@ -69,7 +70,8 @@ CompilationUnit::CompilationUnit(const string& path,
                                  const SectionMap& sections, uint64_t offset,
                                  ByteReader* reader, Dwarf2Handler* handler)
     : path_(path), offset_from_section_start_(offset), reader_(reader),
-      sections_(sections), handler_(handler), abbrevs_(),
+      sections_(sections), handler_(handler), abbrevs_(NULL),
+      owned_abbrevs_(), abbrev_cache_(NULL), dies_end_(NULL),
       string_buffer_(NULL), string_buffer_length_(0),
       line_string_buffer_(NULL), line_string_buffer_length_(0),
       str_offsets_buffer_(NULL), str_offsets_buffer_length_(0),
@@ -103,6 +105,69 @@ void CompilationUnit::SetSplitDwarf(const uint8_t* addr_buffer,
   skeleton_dwo_id_ = dwo_id;
 }
 
+namespace {
+
+// Add FORM to the size analysis of ABBREV: if FORM's size doesn't
+// depend on the attribute's data, count it in the appropriate field;
+// otherwise, clear ABBREV's fixed_size flag.
+void AnalyzeAbbrevForm(enum DwarfForm form, CompilationUnit::Abbrev* abbrev) {
+  switch (form) {
+    case DW_FORM_flag_present:
+    case DW_FORM_implicit_const:
+      return;
+    case DW_FORM_addrx1:
+    case DW_FORM_data1:
+    case DW_FORM_flag:
+    case DW_FORM_ref1:
+    case DW_FORM_strx1:
+      abbrev->fixed_bytes += 1;
+      return;
+    case DW_FORM_addrx2:
+    case DW_FORM_ref2:
+    case DW_FORM_data2:
+    case DW_FORM_strx2:
+      abbrev->fixed_bytes += 2;
+      return;
+    case DW_FORM_addrx3:
+    case DW_FORM_strx3:
+      abbrev->fixed_bytes += 3;
+      return;
+    case DW_FORM_addrx4:
+    case DW_FORM_ref4:
+    case DW_FORM_data4:
+    case DW_FORM_strx4:
+    case DW_FORM_ref_sup4:
+      abbrev->fixed_bytes += 4;
+      return;
+    case DW_FORM_ref8:
+    case DW_FORM_data8:
+    case DW_FORM_ref_sig8:
+    case DW_FORM_ref_sup8:
+      abbrev->fixed_bytes += 8;
+      return;
+    case DW_FORM_data16:
+      abbrev->fixed_bytes += 16;
+      return;
+    case DW_FORM_addr:
+      abbrev->address_forms++;
+      return;
+    case DW_FORM_ref_addr:
+      abbrev->ref_addr_forms++;
+      return;
+    case DW_FORM_strp:
+    case DW_FORM_line_strp:
+    case DW_FORM_strp_sup:
+    case DW_FORM_sec_offset:
+      abbrev->offset_forms++;
+      return;
+    default:
+      abbrev->fixed_size = false;
+      return;
+  }
+}
+
+}  // namespace
+
 // Read a DWARF2/3 abbreviation section.
 // Each abbrev consists of a abbreviation number, a tag, a byte
 // specifying whether the tag has children, and a list of
@@ -120,14 +185,21 @@ void CompilationUnit::ReadAbbrevs() {
       GetSectionByName(sections_, ".debug_abbrev");
   assert(iter != sections_.end());
 
-  abbrevs_ = new std::vector<Abbrev>;
-  abbrevs_->resize(1);
+  // If another compilation unit has already parsed this table, use it.
+  const uint8_t* abbrev_section = iter->second.first;
+  if (abbrev_cache_) {
+    abbrevs_ = abbrev_cache_->Find(abbrev_section, header_.abbrev_offset);
+    if (abbrevs_)
+      return;
+  }
+
+  std::unique_ptr<AbbrevTable> abbrevs(new AbbrevTable);
+  abbrevs->resize(1);
 
   // The only way to check whether we are reading over the end of the
   // buffer would be to first compute the size of the leb128 data by
   // reading it, then go back and read it again.
-  const uint8_t* abbrev_start = iter->second.first +
-                                      header_.abbrev_offset;
+  const uint8_t* abbrev_start = abbrev_section + header_.abbrev_offset;
   const uint8_t* abbrevptr = abbrev_start;
 #ifndef NDEBUG
   const uint64_t abbrev_length = iter->second.second - header_.abbrev_offset;
@@ -154,6 +226,13 @@ void CompilationUnit::ReadAbbrevs() {
 
     assert(abbrevptr < abbrev_start + abbrev_length);
 
+    abbrev.has_sibling = false;
+    abbrev.fixed_size = true;
+    abbrev.fixed_bytes = 0;
+    abbrev.address_forms = 0;
+    abbrev.offset_forms = 0;
+    abbrev.ref_addr_forms = 0;
+
     while (1) {
       const uint64_t nametemp = reader_->ReadUnsignedLEB128(abbrevptr, &len);
       abbrevptr += len;
@@ -173,23 +252,111 @@ void CompilationUnit::ReadAbbrevs() {
                            static_cast<enum DwarfForm>(formtemp),
                            value);
       abbrev.attributes.push_back(abbrev_attr);
+      if (abbrev_attr.attr_ == DW_AT_sibling)
+        abbrev.has_sibling = true;
+      AnalyzeAbbrevForm(abbrev_attr.form_, &abbrev);
     }
-    assert(abbrev.number == abbrevs_->size());
-    abbrevs_->push_back(abbrev);
+    assert(abbrev.number == abbrevs->size());
+    abbrevs->push_back(abbrev);
+  }
+
+  if (abbrev_cache_) {
+    abbrevs_ = abbrev_cache_->Insert(abbrev_section, header_.abbrev_offset,
+                                     abbrevs.release());
+  } else {
+    owned_abbrevs_ = std::move(abbrevs);
+    abbrevs_ = owned_abbrevs_.get();
   }
 }
 
 // Skips a single DIE's attributes.
 const uint8_t* CompilationUnit::SkipDIE(const uint8_t* start,
-                                        const Abbrev& abbrev) {
+                                        const Abbrev& abbrev,
+                                        const uint8_t** sibling) {
+  const bool want_sibling = sibling && abbrev.has_sibling;
+  if (abbrev.fixed_size && !want_sibling)
+    return start + FixedDIESize(abbrev);
+
+  const uint8_t* die_start = start;
   for (AttributeList::const_iterator i = abbrev.attributes.begin();
        i != abbrev.attributes.end();
        i++)  {
+    if (want_sibling && i->attr_ == DW_AT_sibling) {
+      *sibling = ReadSiblingReference(start, i->form_);
+      // There's no need to walk the rest of a fixed-size DIE.
+      if (abbrev.fixed_size)
+        return die_start + FixedDIESize(abbrev);
+    }
     start = SkipAttribute(start, i->form_);
   }
   return start;
 }
 
+// Skips a DIE and all its descendants.  Where a DIE has a DW_AT_sibling
+// attribute, we jump directly to the sibling; otherwise, we walk the
+// children's abbreviation codes, which is cheap for DIEs whose
+// attributes all have fixed sizes.
+const uint8_t* CompilationUnit::SkipDIETree(const uint8_t* start,
+                                            const Abbrev& abbrev) {
+  const uint8_t* sibling = NULL;
+  start = SkipDIE(start, abbrev, &sibling);
+  if (!abbrev.has_children)
+    return start;
+  if (sibling && sibling >= start && sibling <= dies_end_)
+    return sibling;
+
+  // The number of DIEs whose children we're still skipping.
+  size_t depth = 1;
+  while (depth > 0 && start < dies_end_) {
+    size_t len;
+    const uint64_t abbrev_num = reader_->ReadUnsignedLEB128(start, &len);
+    start += len;
+    if (abbrev_num == 0) {
+      depth--;
+      continue;
+    }
+    const Abbrev& child = abbrevs_->at(static_cast<size_t>(abbrev_num));
+    sibling = NULL;
+    start = SkipDIE(start, child, &sibling);
+    if (!child.has_children)
+      continue;
+    if (sibling && sibling >= start && sibling <= dies_end_)
+      start = sibling;
+    else
+      depth++;
+  }
+  return start;
+}
+
+// Reads the data of a DW_AT_sibling attribute.
+const uint8_t* CompilationUnit::ReadSiblingReference(const uint8_t* start,
+                                                     enum DwarfForm form) {
+  uint64_t offset;
+  size_t len;
+  switch (form) {
+    case DW_FORM_ref1:
+      offset = reader_->ReadOneByte(start);
+      break;
+    case DW_FORM_ref2:
+      offset = reader_->ReadTwoBytes(start);
+      break;
+    case DW_FORM_ref4:
+      offset = reader_->ReadFourBytes(start);
+      break;
+    case DW_FORM_ref8:
+      offset = reader_->ReadEightBytes(start);
+      break;
+    case DW_FORM_ref_udata:
+      offset = reader_->ReadUnsignedLEB128(start, &len);
+      break;
+    default:
+      return NULL;
+  }
+  if (offset >= buffer_length_)
+    return NULL;
+  return buffer_ + offset;
+}
+
 // Skips a single attribute form's data.
 const uint8_t* CompilationUnit::SkipAttribute(const uint8_t* start,
                                               enum DwarfForm form) {
@@ -738,9 +905,15 @@ void CompilationUnit::ProcessDIEs() {
   else
     lengthstart += 4;
 
+  dies_end_ = lengthstart + header_.length;
+
+  // If the handler skips whole subtrees, we can pass over a skipped
+  // DIE's children without reporting them.
+  const bool skip_trees = handler_->SkipsChildrenOfSkippedDIEs();
+
   std::stack<uint64_t> die_stack;
-  
-  while (dieptr < (lengthstart + header_.length)) {
+
+  while (dieptr < dies_end_) {
     // We give the user the absolute offset from the beginning of
     // debug_info, since they need it to deal with ref_addr forms.
     uint64_t absolute_offset = (dieptr - buffer_) + offset_from_section_start_;
@@ -764,6 +937,11 @@ void CompilationUnit::ProcessDIEs() {
     const Abbrev& abbrev = abbrevs_->at(static_cast<size_t>(abbrev_num));
     const enum DwarfTag tag = abbrev.tag;
     if (!handler_->StartDIE(absolute_offset, tag)) {
+      if (skip_trees && abbrev.has_children) {
+        dieptr = SkipDIETree(dieptr, abbrev);
+        handler_->EndDIE(absolute_offset);
+        continue;
+      }
       dieptr = SkipDIE(dieptr, abbrev);
     } else {
       dieptr = ProcessDIE(absolute_offset, dieptr, abbrev);
@@ -777,6 +955,24 @@ void CompilationUnit::ProcessDIEs() {
   }
 }
 
+const CompilationUnit::AbbrevTable* AbbrevTableCache::Find(
+    const uint8_t* section, uint64_t offset) {
+  TableMap::const_iterator it = tables_.find(TableKey(section, offset));
+  if (it == tables_.end()) {
+    misses_++;
+    return NULL;
+  }
+  hits_++;
+  return it->second.get();
+}
+
+const CompilationUnit::AbbrevTable* AbbrevTableCache::Insert(
+    const uint8_t* section, uint64_t offset,
+    CompilationUnit::AbbrevTable* table) {
+  tables_[TableKey(section, offset)].reset(table);
+  return table;
+}
+
 // Check for a valid ELF file and return the Address size.
 // Returns 0 if not a valid ELF file.
 inline int GetElfWidth(const ElfReader& elf) {
@@ -1585,11 +1781,37 @@ void LineInfo::ReadLines() {
   uint64_t pending_address = 0;
   uint32_t pending_file_num = 0, pending_line_num = 0, pending_column_num = 0;
 
+  // Most of a line program is special opcodes. Look up what each one
+  // does, rather than dividing by line_range every time. (A zero
+  // line_range is malformed; leave that to ProcessOneOpcode.)
+  const bool use_special_table = header_.line_range != 0;
+  int64_t special_address_advance[256];
+  int32_t special_line_advance[256];
+  if (use_special_table) {
+    for (int opcode = header_.opcode_base; opcode < 256; opcode++) {
+      int adjusted = opcode - header_.opcode_base;
+      special_address_advance[opcode] =
+          (adjusted / header_.line_range) * header_.min_insn_length;
+      special_line_advance[opcode] =
+          (adjusted % header_.line_range) + header_.line_base;
+    }
+  }
+
   while (lineptr < lengthstart + header_.total_length) {
     size_t oplength;
-    bool add_row = ProcessOneOpcode(reader_, handler_, header_,
-                                    lineptr, &lsm, &oplength, (uintptr)-1,
-                                    NULL);
+    bool add_row;
+    uint8_t opcode = *lineptr;
+    if (use_special_table && opcode >= header_.opcode_base) {
+      lsm.address += special_address_advance[opcode];
+      lsm.line_num += special_line_advance[opcode];
+      lsm.basic_block = true;
+      oplength = 1;
+      add_row = true;
+    } else {
+      add_row = ProcessOneOpcode(reader_, handler_, header_,
+                                 lineptr, &lsm, &oplength, (uintptr)-1,
+                                 NULL);
+    }
     if (add_row) {
       if (have_pending_line)
         handler_->AddLine(pending_address, lsm.address - pending_address,
@@ -3020,16 +3242,51 @@ bool CallFrameInfo::ReadFDEFields(FDE* fde) {
   return true;
 }
   
-bool CallFrameInfo::Start() {
+void CallFrameInfo::SplitEntries(size_t parts,
+                                 std::vector<size_t>* boundaries) {
+  const uint8_t* buffer_end = buffer_ + buffer_length_;
+
+  // Find the start of each entry, reading only the initial lengths.
+  // Stop at an .eh_frame terminator, or at any entry whose extent we
+  // can't determine: Start stops parsing there too, so everything after
+  // belongs to the final run.
+  std::vector<size_t> entries;
+  const uint8_t* cursor = buffer_;
+  while (cursor < buffer_end) {
+    entries.push_back(cursor - buffer_);
+    size_t length_size;
+    if (buffer_end - cursor < 4)
+      break;
+    uint64_t length = reader_->ReadInitialLength(cursor, &length_size);
+    if (length_size > size_t(buffer_end - cursor))
+      break;
+    cursor += length_size;
+    if ((length == 0 && eh_frame_) || length > size_t(buffer_end - cursor))
+      break;
+    cursor += length;
+  }
+
+  boundaries->clear();
+  if (parts > entries.size())
+    parts = entries.size();
+  for (size_t i = 0; i < parts; i++)
+    boundaries->push_back(entries[i * entries.size() / parts]);
+  if (boundaries->empty())
+    boundaries->push_back(0);
+  boundaries->push_back(buffer_length_);
+}
+
+bool CallFrameInfo::Start(size_t begin, size_t end) {
   const uint8_t* buffer_end = buffer_ + buffer_length_;
+  const uint8_t* range_end = buffer_ + std::min(end, buffer_length_);
   const uint8_t* cursor;
   bool all_ok = true;
   const uint8_t* entry_end;
   bool ok;
 
-  // Traverse all the entries in buffer_, skipping CIEs and offering
-  // FDEs to the handler.
-  for (cursor = buffer_; cursor < buffer_end;
+  // Traverse all the entries in our range of buffer_, skipping CIEs
+  // and offering FDEs to the handler.
+  for (cursor = buffer_ + begin; cursor < range_end;
        cursor = entry_end, all_ok = all_ok && ok) {
     FDE fde;
 
@@ -58,6 +58,7 @@
 
 namespace dwarf2reader {
 struct LineStateMachine;
+class AbbrevTableCache;
 class Dwarf2Handler;
 class LineInfoHandler;
 class DwpReader;
@@ -353,6 +354,14 @@ class Dwarf2Handler {
   // section. Return false if you would like to skip this DIE.
   virtual bool StartDIE(uint64_t offset, enum DwarfTag tag) { return false; }
 
+  // Return true if skipping a DIE also means skipping all of its
+  // descendants.  When this returns true, the reader passes over the
+  // children of a DIE for which StartDIE returned false without
+  // calling StartDIE or EndDIE for any of them, jumping straight to
+  // the DIE's DW_AT_sibling when it has one.  EndDIE is still called
+  // for the skipped DIE itself.
+  virtual bool SkipsChildrenOfSkippedDIEs() { return false; }
+
   // Called when we have an attribute with unsigned data to give to our
   // handler. The attribute is for the DIE at OFFSET from the beginning of the
   // .debug_info section. Its name is ATTR, its form is FORM, and its value is
@@ -462,9 +471,40 @@ class CompilationUnit {
   // ByteReader, and a Dwarf2Handler class to call callbacks in.
   CompilationUnit(const string& path, const SectionMap& sections,
                   uint64_t offset, ByteReader* reader, Dwarf2Handler* handler);
-  virtual ~CompilationUnit() {
-    if (abbrevs_) delete abbrevs_;
-  }
+  virtual ~CompilationUnit() { }
+
+  // This struct represents a single DWARF2/3 abbreviation
+  // The abbreviation tells how to read a DWARF2/3 DIE, and consist of a
+  // tag and a list of attributes, as well as the data form of each attribute.
+  struct Abbrev {
+    uint64_t number;
+    enum DwarfTag tag;
+    bool has_children;
+    AttributeList attributes;
+
+    // True if one of the attributes is DW_AT_sibling.
+    bool has_sibling;
+
+    // True if every attribute's form has a size that doesn't depend on
+    // the DIE's data.  In that case the attributes occupy FIXED_BYTES
+    // bytes, plus ADDRESS_FORMS addresses, OFFSET_FORMS offsets and
+    // REF_ADDR_FORMS DW_FORM_ref_addr values, whose sizes depend only
+    // on the compilation unit header.
+    bool fixed_size;
+    uint64_t fixed_bytes;
+    uint32_t address_forms;
+    uint32_t offset_forms;
+    uint32_t ref_addr_forms;
+  };
+
+  // A set of abbreviations, indexed by abbreviation number, which
+  // means that element 0 is not valid.
+  typedef std::vector<Abbrev> AbbrevTable;
+
+  // Share parsed abbreviation tables with the other compilation units
+  // using CACHE, rather than parsing this unit's table privately.  CACHE
+  // must outlive this CompilationUnit.
+  void SetAbbrevTableCache(AbbrevTableCache* cache) { abbrev_cache_ = cache; }
 
   // Initialize a compilation unit from a .dwo or .dwp file.
   // In this case, we need the .debug_addr section from the
@@ -486,16 +526,6 @@ class CompilationUnit {
 
  private:
 
-  // This struct represents a single DWARF2/3 abbreviation
-  // The abbreviation tells how to read a DWARF2/3 DIE, and consist of a
-  // tag and a list of attributes, as well as the data form of each attribute.
-  struct Abbrev {
-    uint64_t number;
-    enum DwarfTag tag;
-    bool has_children;
-    AttributeList attributes;
-  };
-
   // A DWARF2/3 compilation unit header.  This is not the same size as
   // in the actual file, as the one in the file may have a 32 bit or
   // 64 bit length.
@@ -632,8 +662,34 @@ class CompilationUnit {
   void ProcessDIEs();
 
   // Skips the die with attributes specified in ABBREV starting at
-  // START, and return the new place to position the stream to.
-  const uint8_t* SkipDIE(const uint8_t* start, const Abbrev& abbrev);
+  // START, and return the new place to position the stream to.  If
+  // SIBLING is non-NULL and the DIE has a DW_AT_sibling attribute
+  // referring into this compilation unit, set *SIBLING to the DIE it
+  // refers to.
+  const uint8_t* SkipDIE(const uint8_t* start, const Abbrev& abbrev,
+                         const uint8_t** sibling = NULL);
+
+  // Skips the die with attributes specified in ABBREV starting at
+  // START along with all of its descendants, and return the new place
+  // to position the stream to.
+  const uint8_t* SkipDIETree(const uint8_t* start, const Abbrev& abbrev);
+
+  // Return the size of the attributes of a DIE whose abbreviation
+  // ABBREV has fixed_size set.
+  uint64_t FixedDIESize(const Abbrev& abbrev) const {
+    const uint64_t ref_addr_size = header_.version == 2 ?
+        reader_->AddressSize() : reader_->OffsetSize();
+    return abbrev.fixed_bytes +
+        abbrev.address_forms * reader_->AddressSize() +
+        abbrev.offset_forms * reader_->OffsetSize() +
+        abbrev.ref_addr_forms * ref_addr_size;
+  }
+
+  // Return the DIE referred to by a DW_AT_sibling attribute of FORM
+  // whose data starts at START, or NULL if FORM isn't a reference
+  // into this compilation unit.
+  const uint8_t* ReadSiblingReference(const uint8_t* start,
+                                      enum DwarfForm form);
 
   // Skips the attribute starting at START, with FORM, and return the
   // new place to position the stream to.
@@ -671,8 +727,16 @@ class CompilationUnit {
 
   // Set of DWARF2/3 abbreviations for this compilation unit.  Indexed
   // by abbreviation number, which means that abbrevs_[0] is not
-  // valid.
-  std::vector<Abbrev>* abbrevs_;
+  // valid.  This points either to owned_abbrevs_ or into abbrev_cache_.
+  const AbbrevTable* abbrevs_;
+  std::unique_ptr<AbbrevTable> owned_abbrevs_;
+
+  // The cache of abbreviation tables shared with other compilation
+  // units, or NULL.
+  AbbrevTableCache* abbrev_cache_;
+
+  // The end of this compilation unit's DIEs.
+  const uint8_t* dies_end_;
 
   // String section buffer and length, if we have a string section.
   // This is here to avoid doing a section lookup for strings in
@@ -741,6 +805,43 @@ class CompilationUnit {
 #endif
 };
 
+// A cache of parsed abbreviation tables, for sharing between the
+// CompilationUnits of a single file.  Some toolchains, and post-link
+// tools such as dwz, have many compilation units share a single
+// abbreviation table; the cache parses each table only once, however
+// many units refer to it.  Tables are keyed by the
+// .debug_abbrev section's address and the table's offset within it, so
+// a single cache may serve several sections.  This class is not
+// thread-safe.
+class AbbrevTableCache {
+ public:
+  AbbrevTableCache() : hits_(0), misses_(0) { }
+
+  // Return the table at OFFSET in the abbreviation section starting at
+  // SECTION, or NULL if there is none in the cache.
+  const CompilationUnit::AbbrevTable* Find(const uint8_t* section,
+                                           uint64_t offset);
+
+  // Add TABLE, the table at OFFSET in the abbreviation section starting
+  // at SECTION, to the cache, taking ownership of it.  Return TABLE.
+  const CompilationUnit::AbbrevTable* Insert(
+      const uint8_t* section, uint64_t offset,
+      CompilationUnit::AbbrevTable* table);
+
+  // The number of Find calls that found, or did not find, a table.
+  uint64_t hits() const { return hits_; }
+  uint64_t misses() const { return misses_; }
+
+ private:
+  typedef std::pair<const uint8_t*, uint64_t> TableKey;
+  typedef std::map<TableKey,
+                   std::unique_ptr<CompilationUnit::AbbrevTable> > TableMap;
+
+  TableMap tables_;
+  uint64_t hits_;
+  uint64_t misses_;
+};
+
 // A Reader for a .dwp file.  Supports the fetching of DWARF debug
 // info for a given dwo_id.
 //
@@ -1068,7 +1169,21 @@ class CallFrameInfo {
   // Parse the entries in BUFFER, reporting what we find to HANDLER.
   // Return true if we reach the end of the section successfully, or
   // false if we encounter an error.
-  bool Start();
+  bool Start() { return Start(0, buffer_length_); }
+
+  // Parse only the entries that begin at offsets from BEGIN up to END
+  // in BUFFER, where BEGIN is the offset of an entry.  FDEs may still
+  // refer to CIEs anywhere in BUFFER.  Return true if we reach END
+  // successfully, or false if we encounter an error.
+  bool Start(size_t begin, size_t end);
+
+  // Divide the entries in BUFFER into at most PARTS runs of consecutive
+  // entries, each with roughly the same number of entries, so that
+  // separate CallFrameInfo instances can parse them in parallel using
+  // Start(BEGIN, END).  Set *BOUNDARIES to the offset at which each run
+  // begins, followed by BUFFER_LENGTH.  Parsing the runs in order
+  // reports exactly what a single call to Start() would have.
+  void SplitEntries(size_t parts, std::vector<size_t>* boundaries);
 
   // Return the textual name of KIND. For error reporting.
   static const char* KindName(EntryKind kind);
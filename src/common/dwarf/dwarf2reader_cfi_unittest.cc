@@ -449,6 +449,66 @@ TEST_F(CFI, TwoFDEsTwoCIEs) {
   EXPECT_TRUE(parser.Start());
 }
 
+// Splitting the entries into runs, and parsing each run separately,
+// should report the same entries as parsing the whole section.
+TEST_F(CFI, SplitEntries) {
+  CFISection section(kLittleEndian, 8);
+  Label cie1, cie2, fde1, fde2;
+  section
+      .Mark(&cie1)
+      .CIEHeader(0x694d5d45, 0x4233221b, 0xbf45e65a, 3, "")
+      .FinishEntry()
+      .Mark(&fde1)
+      .FDEHeader(cie2, 0x778b27dfe5871f05ULL, 0x324ace3448070926ULL)
+      .FinishEntry()
+      .Mark(&fde2)
+      .FDEHeader(cie1, 0xf6054ca18b10bf5fULL, 0x45fdb970d8bca342ULL)
+      .FinishEntry()
+      .Mark(&cie2)
+      .CIEHeader(0xfba3fad7, 0x6287e1fd, 0x61d2c581, 2, "")
+      .FinishEntry();
+
+  {
+    InSequence s;
+    EXPECT_CALL(handler,
+                Entry(_, 0x778b27dfe5871f05ULL, 0x324ace3448070926ULL, 2,
+                      "", 0x61d2c581))
+        .WillOnce(Return(true));
+    EXPECT_CALL(handler, End()).WillOnce(Return(true));
+    EXPECT_CALL(handler,
+                Entry(_, 0xf6054ca18b10bf5fULL, 0x45fdb970d8bca342ULL, 3,
+                      "", 0xbf45e65a))
+        .WillOnce(Return(true));
+    EXPECT_CALL(handler, End()).WillOnce(Return(true));
+  }
+
+  string contents;
+  EXPECT_TRUE(section.GetContents(&contents));
+  ByteReader byte_reader(ENDIANNESS_LITTLE);
+  byte_reader.SetAddressSize(8);
+  CallFrameInfo parser(reinterpret_cast<const uint8_t*>(contents.data()),
+                       contents.size(),
+                       &byte_reader, &handler, &reporter);
+
+  // Asking for more runs than there are entries gives one per entry.
+  vector<size_t> boundaries;
+  parser.SplitEntries(10, &boundaries);
+  ASSERT_EQ(5U, boundaries.size());
+  EXPECT_EQ(0U, boundaries[0]);
+  EXPECT_EQ(fde1.Value(), boundaries[1]);
+  EXPECT_EQ(fde2.Value(), boundaries[2]);
+  EXPECT_EQ(cie2.Value(), boundaries[3]);
+  EXPECT_EQ(contents.size(), boundaries[4]);
+
+  parser.SplitEntries(2, &boundaries);
+  ASSERT_EQ(3U, boundaries.size());
+  EXPECT_EQ(0U, boundaries[0]);
+  EXPECT_EQ(fde2.Value(), boundaries[1]);
+  EXPECT_EQ(contents.size(), boundaries[2]);
+  EXPECT_TRUE(parser.Start(boundaries[0], boundaries[1]));
+  EXPECT_TRUE(parser.Start(boundaries[1], boundaries[2]));
+}
+
 // An FDE whose CIE specifies a version we don't recognize.
 TEST_F(CFI, BadVersion) {
   CFISection section(kBigEndian, 4);
@@ -2169,6 +2229,50 @@ TEST_F(EHFrame, Terminator) {
   ParseEHFrameSection(&section);
 }
 
+// Runs of .eh_frame entries end at the terminator; everything after it
+// belongs to the final run, which stops parsing there.
+TEST_F(EHFrame, SplitEntriesAtTerminator) {
+  Label cie, fde, terminator;
+  section
+      .Mark(&cie)
+      .CIEHeader(9968, 2466, 67, 1, "")
+      .FinishEntry()
+      .Mark(&fde)
+      .FDEHeader(cie, 0x848037a1, 0x7b30475e)
+      .FinishEntry()
+      .Mark(&terminator)
+      .D32(0)                           // Terminate the sequence.
+      // This FDE should be ignored.
+      .FDEHeader(cie, 0xf19629fe, 0x439fb09b)
+      .FinishEntry();
+
+  EXPECT_CALL(handler, Entry(_, 0x848037a1, 0x7b30475e, 1, "", 67))
+      .InSequence(s).WillOnce(Return(true));
+  EXPECT_CALL(handler, End())
+      .InSequence(s).WillOnce(Return(true));
+  EXPECT_CALL(reporter, EarlyEHTerminator(_))
+      .InSequence(s).WillOnce(Return());
+
+  string contents;
+  EXPECT_TRUE(section.GetContents(&contents));
+  ByteReader byte_reader(ENDIANNESS_BIG);
+  byte_reader.SetAddressSize(section.AddressSize());
+  byte_reader.SetCFIDataBase(encoded_pointer_bases.cfi,
+                             reinterpret_cast<const uint8_t*>(contents.data()));
+  CallFrameInfo parser(reinterpret_cast<const uint8_t*>(contents.data()),
+                       contents.size(),
+                       &byte_reader, &handler, &reporter, true);
+  vector<size_t> boundaries;
+  parser.SplitEntries(10, &boundaries);
+  ASSERT_EQ(4U, boundaries.size());
+  EXPECT_EQ(cie.Value(), boundaries[0]);
+  EXPECT_EQ(fde.Value(), boundaries[1]);
+  EXPECT_EQ(terminator.Value(), boundaries[2]);
+  EXPECT_EQ(contents.size(), boundaries[3]);
+  for (size_t i = 0; i + 1 < boundaries.size(); i++)
+    EXPECT_TRUE(parser.Start(boundaries[i], boundaries[i + 1]));
+}
+
 // The parser should recognize the Linux Standards Base 'z' augmentations.
 TEST_F(EHFrame, SimpleFDE) {
   DwarfPointerEncoding lsda_encoding =
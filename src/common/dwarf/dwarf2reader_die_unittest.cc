@@ -104,6 +104,7 @@ class MockDwarf2Handler: public Dwarf2Handler {
                                                enum DwarfForm form,
                                                uint64_t signature));
   MOCK_METHOD1(EndDIE, void(uint64_t offset));
+  MOCK_METHOD0(SkipsChildrenOfSkippedDIEs, bool());
 };
 
 struct DIEFixture {
@@ -122,6 +123,8 @@ struct DIEFixture {
     EXPECT_CALL(handler, ProcessAttributeBuffer(_, _, _, _, _)).Times(0);
     EXPECT_CALL(handler, ProcessAttributeString(_, _, _, _)).Times(0);
     EXPECT_CALL(handler, EndDIE(_)).Times(0);
+    EXPECT_CALL(handler, SkipsChildrenOfSkippedDIEs())
+        .WillRepeatedly(Return(false));
   }
 
   // Return a reference to a section map whose .debug_info section refers
@@ -521,6 +524,202 @@ INSTANTIATE_TEST_CASE_P(
                       DwarfHeaderParams(kBigEndian,    8, 4, 4),
                       DwarfHeaderParams(kBigEndian,    8, 4, 8)));
 
+struct DwarfSkipping: public DwarfFormsFixture,
+                      public TestWithParam<DwarfHeaderParams> {
+  // Build a compilation unit whose root DIE has three children: a
+  // structure type with a DW_AT_sibling attribute, a lexical block
+  // without one, and a subprogram. The structure and block both have
+  // children, including a nested structure inside the block.
+  void BuildTree() {
+    const DwarfHeaderParams& params = GetParam();
+    Label abbrev_table = abbrevs.Here();
+    abbrevs.Abbrev(1, dwarf2reader::DW_TAG_compile_unit,
+                   dwarf2reader::DW_children_yes)
+        .Attribute(dwarf2reader::DW_AT_name, dwarf2reader::DW_FORM_string)
+        .EndAbbrev()
+        .Abbrev(2, dwarf2reader::DW_TAG_structure_type,
+                dwarf2reader::DW_children_yes)
+        .Attribute(dwarf2reader::DW_AT_sibling, dwarf2reader::DW_FORM_ref4)
+        .Attribute(dwarf2reader::DW_AT_byte_size, dwarf2reader::DW_FORM_data1)
+        .EndAbbrev()
+        .Abbrev(3, dwarf2reader::DW_TAG_member, dwarf2reader::DW_children_no)
+        .Attribute(dwarf2reader::DW_AT_name, dwarf2reader::DW_FORM_strp)
+        .Attribute(dwarf2reader::DW_AT_type, dwarf2reader::DW_FORM_ref_addr)
+        .Attribute(dwarf2reader::DW_AT_data_member_location,
+                   dwarf2reader::DW_FORM_data2)
+        .EndAbbrev()
+        .Abbrev(4, dwarf2reader::DW_TAG_lexical_block,
+                dwarf2reader::DW_children_yes)
+        .Attribute(dwarf2reader::DW_AT_low_pc, dwarf2reader::DW_FORM_addr)
+        .Attribute(dwarf2reader::DW_AT_name, dwarf2reader::DW_FORM_string)
+        .EndAbbrev()
+        .Abbrev(5, dwarf2reader::DW_TAG_subprogram,
+                dwarf2reader::DW_children_no)
+        .Attribute(dwarf2reader::DW_AT_name, dwarf2reader::DW_FORM_string)
+        .EndAbbrev()
+        .EndTable();
+
+    info.set_format_size(params.format_size);
+    info.set_endianness(params.endianness);
+    info.Header(params.version, abbrev_table, params.address_size)
+        .ULEB128(1)
+        .AppendCString("cu");
+
+    Label struct_sibling, nested_sibling;
+    info.ULEB128(2).D32(struct_sibling).D8(16);
+    Member(params);
+    Member(params);
+    info.D8(0);
+    struct_sibling = info.Here();
+
+    info.ULEB128(4);
+    Address(params, 0x1000);
+    info.AppendCString("block");
+    Member(params);
+    info.ULEB128(2).D32(nested_sibling).D8(8);
+    Member(params);
+    info.D8(0);
+    nested_sibling = info.Here();
+    info.D8(0);
+
+    info.ULEB128(5).AppendCString("function");
+    info.D8(0);
+    info.Finish();
+  }
+
+  // Append a member DIE, whose attributes are all fixed-size.
+  void Member(const DwarfHeaderParams& params) {
+    info.ULEB128(3);
+    info.SectionOffset(0x10);
+    if (params.version == 2)
+      Address(params, 0x20);
+    else
+      info.SectionOffset(0x20);
+    info.D16(4);
+  }
+
+  void Address(const DwarfHeaderParams& params, uint64_t address) {
+    if (params.address_size == 4)
+      info.D32(address);
+    else
+      info.D64(address);
+  }
+
+  // Expect the compilation unit's root DIE and its attribute, in
+  // sequence S.
+  void ExpectRoot() {
+    ExpectBeginCompilationUnit(GetParam(), dwarf2reader::DW_TAG_compile_unit);
+    EXPECT_CALL(handler, ProcessAttributeString(_, dwarf2reader::DW_AT_name,
+                                                dwarf2reader::DW_FORM_string,
+                                                "cu"))
+        .InSequence(s)
+        .WillOnce(Return());
+  }
+
+  void ExpectFunction() {
+    EXPECT_CALL(handler, StartDIE(_, dwarf2reader::DW_TAG_subprogram))
+        .InSequence(s)
+        .WillOnce(Return(true));
+    EXPECT_CALL(handler, ProcessAttributeString(_, dwarf2reader::DW_AT_name,
+                                                dwarf2reader::DW_FORM_string,
+                                                "function"))
+        .InSequence(s)
+        .WillOnce(Return());
+    EXPECT_CALL(handler, EndDIE(_))
+        .InSequence(s)
+        .WillOnce(Return());
+  }
+};
+
+// A handler that skips whole trees should see only the roots of the
+// trees it skips.
+TEST_P(DwarfSkipping, SkipsTrees) {
+  BuildTree();
+
+  EXPECT_CALL(handler, SkipsChildrenOfSkippedDIEs())
+      .WillRepeatedly(Return(true));
+  ExpectRoot();
+  EXPECT_CALL(handler, StartDIE(_, dwarf2reader::DW_TAG_structure_type))
+      .InSequence(s)
+      .WillOnce(Return(false));
+  EXPECT_CALL(handler, EndDIE(_))
+      .InSequence(s)
+      .WillOnce(Return());
+  EXPECT_CALL(handler, StartDIE(_, dwarf2reader::DW_TAG_lexical_block))
+      .InSequence(s)
+      .WillOnce(Return(false));
+  EXPECT_CALL(handler, EndDIE(_))
+      .InSequence(s)
+      .WillOnce(Return());
+  ExpectFunction();
+  ExpectEndCompilationUnit();
+
+  ParseCompilationUnit(GetParam());
+}
+
+// Other handlers still see every DIE.
+TEST_P(DwarfSkipping, VisitsChildrenOfSkippedDIEs) {
+  BuildTree();
+
+  ExpectRoot();
+  EXPECT_CALL(handler, StartDIE(_, dwarf2reader::DW_TAG_structure_type))
+      .Times(2)
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(handler, StartDIE(_, dwarf2reader::DW_TAG_member))
+      .Times(4)
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(handler, StartDIE(_, dwarf2reader::DW_TAG_lexical_block))
+      .WillOnce(Return(false));
+  EXPECT_CALL(handler, EndDIE(_))
+      .Times(7)
+      .WillRepeatedly(Return());
+  ExpectFunction();
+  ExpectEndCompilationUnit();
+
+  ParseCompilationUnit(GetParam());
+}
+
+// Compilation units sharing an AbbrevTableCache parse their common
+// abbreviation table only once.
+TEST_P(DwarfSkipping, SharedAbbrevTable) {
+  BuildTree();
+
+  EXPECT_CALL(handler, StartCompilationUnit(0, _, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(handler, StartDIE(_, dwarf2reader::DW_TAG_compile_unit))
+      .Times(2)
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(handler, EndDIE(_))
+      .Times(2)
+      .WillRepeatedly(Return());
+  EXPECT_CALL(handler, SkipsChildrenOfSkippedDIEs())
+      .WillRepeatedly(Return(true));
+
+  ByteReader byte_reader(GetParam().endianness == kLittleEndian ?
+                         ENDIANNESS_LITTLE : ENDIANNESS_BIG);
+  const SectionMap& sections = MakeSectionMap();
+  dwarf2reader::AbbrevTableCache cache;
+  for (int i = 0; i < 2; i++) {
+    CompilationUnit parser("", sections, 0, &byte_reader, &handler);
+    parser.SetAbbrevTableCache(&cache);
+    EXPECT_EQ(parser.Start(), info_contents.size());
+  }
+  EXPECT_EQ(1U, cache.hits());
+  EXPECT_EQ(1U, cache.misses());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    HeaderVariants, DwarfSkipping,
+    ::testing::Values(DwarfHeaderParams(kLittleEndian, 4, 2, 4),
+                      DwarfHeaderParams(kLittleEndian, 4, 3, 8),
+                      DwarfHeaderParams(kLittleEndian, 4, 4, 8),
+                      DwarfHeaderParams(kLittleEndian, 8, 2, 8),
+                      DwarfHeaderParams(kLittleEndian, 8, 4, 4),
+                      DwarfHeaderParams(kBigEndian,    4, 2, 8),
+                      DwarfHeaderParams(kBigEndian,    4, 4, 4),
+                      DwarfHeaderParams(kBigEndian,    8, 4, 8)));
+
 class MockRangeListHandler: public dwarf2reader::RangeListHandler {
  public:
   MOCK_METHOD(void, AddRange, (uint64_t begin, uint64_t end));
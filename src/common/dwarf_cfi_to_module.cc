@@ -261,7 +261,10 @@ bool DwarfCFIToModule::ValExpressionRule(uint64_t address, int reg,
 }
 
 bool DwarfCFIToModule::End() {
-  module_->AddStackFrameEntry(entry_);
+  if (module_)
+    module_->AddStackFrameEntry(entry_);
+  else
+    entries_->push_back(entry_);
   entry_ = NULL;
   return true;
 }
@@ -132,9 +132,23 @@ class DwarfCFIToModule: public CallFrameInfo::Handler {
   // process.
   DwarfCFIToModule(Module* module, const vector<string>& register_names,
                    Reporter* reporter)
-      : module_(module), register_names_(register_names), reporter_(reporter),
-        entry_(NULL), return_address_(-1), cfa_name_(".cfa"), ra_name_(".ra") {
+      : module_(module), entries_(NULL), register_names_(register_names),
+        reporter_(reporter), entry_(NULL), return_address_(-1),
+        cfa_name_(".cfa"), ra_name_(".ra") {
   }
+
+  // As above, but append the entries to ENTRIES, in the order the
+  // parser reports them, instead of adding them to a module.  The
+  // caller takes ownership of the entries.  This lets several handlers
+  // convert parts of the same section in parallel.
+  DwarfCFIToModule(vector<Module::StackFrameEntry*>* entries,
+                   const vector<string>& register_names,
+                   Reporter* reporter)
+      : module_(NULL), entries_(entries), register_names_(register_names),
+        reporter_(reporter), entry_(NULL), return_address_(-1),
+        cfa_name_(".cfa"), ra_name_(".ra") {
+  }
+
   virtual ~DwarfCFIToModule() { delete entry_; }
 
   virtual bool Entry(size_t offset, uint64_t address, uint64_t length,
@@ -160,8 +174,10 @@ class DwarfCFIToModule: public CallFrameInfo::Handler {
   // Record RULE for register REG at ADDRESS.
   void Record(Module::Address address, int reg, const string& rule);
 
-  // The module to which we should add entries.
+  // The module to which we should add entries, or NULL if we should
+  // append them to entries_ instead.
   Module* module_;
+  vector<Module::StackFrameEntry*>* entries_;
 
   // Map from register numbers to register names.
   const vector<string>& register_names_;
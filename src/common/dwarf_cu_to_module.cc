@@ -42,6 +42,7 @@
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <algorithm>
 #include <numeric>
@@ -76,56 +77,158 @@ using std::vector;
 //
 // A Specification holds information gathered from a declaration DIE that
 // we may need if we find a DW_AT_specification link pointing to it.
+//
+// A file may have millions of these, so they hold pointers to strings in
+// the file's StringPool rather than strings of their own.
 struct DwarfCUToModule::Specification {
+  Specification() : qualified_name(""), enclosing_name(""),
+                    unqualified_name("") { }
+
   // The qualified name that can be found by demangling DW_AT_MIPS_linkage_name.
-  string qualified_name;
+  const char* qualified_name;
 
   // The name of the enclosing scope, or the empty string if there is none.
-  string enclosing_name;
+  const char* enclosing_name;
 
   // The name for the specification DIE itself, without any enclosing
   // name components.
-  string unqualified_name;
+  const char* unqualified_name;
 };
 
 // An abstract origin -- base definition of an inline function.
 struct AbstractOrigin {
-  AbstractOrigin() : name() {}
-  explicit AbstractOrigin(const string& name) : name(name) {}
+  AbstractOrigin() : name(NULL) {}
+  explicit AbstractOrigin(const char* name) : name(name) {}
 
-  string name;
+  // The name, held in the file's StringPool, or NULL if there is none.
+  const char* name;
 };
 
-typedef map<uint64_t, AbstractOrigin> AbstractOriginByOffset;
+// A set of NUL-terminated strings, holding one copy of each distinct
+// string. The text is packed into large blocks that are freed only with
+// the pool, so the pointers Intern returns are valid for its lifetime.
+class DwarfCUToModule::StringPool {
+ public:
+  StringPool() : block_(NULL), block_left_(0) { }
+  ~StringPool() {
+    for (vector<char*>::iterator it = blocks_.begin();
+         it != blocks_.end(); ++it)
+      delete [] *it;
+  }
+
+  // Return the pool's copy of STR, adding it if it is not already present.
+  const char* Intern(const char* str) {
+    unordered_set<Entry, EntryHash>::iterator it = strings_.find(Entry(str));
+    if (it != strings_.end())
+      return it->str;
+    size_t size = strlen(str) + 1;
+    char* copy;
+    if (size > kBlockSize / 4) {
+      // Give long strings blocks of their own, rather than wasting the
+      // rest of the current block.
+      copy = new char[size];
+      blocks_.push_back(copy);
+    } else {
+      if (size > block_left_) {
+        block_ = new char[kBlockSize];
+        block_left_ = kBlockSize;
+        blocks_.push_back(block_);
+      }
+      copy = block_;
+      block_ += size;
+      block_left_ -= size;
+    }
+    memcpy(copy, str, size);
+    strings_.insert(Entry(copy));
+    return copy;
+  }
+
+ private:
+  static const size_t kBlockSize = 64 * 1024;
+
+  // An element of strings_, compared by the text it points to.
+  struct Entry {
+    explicit Entry(const char* str) : str(str) { }
+    bool operator==(const Entry& other) const {
+      return strcmp(str, other.str) == 0;
+    }
+    const char* str;
+  };
+  struct EntryHash {
+    size_t operator()(const Entry& entry) const {
+      // FNV-1a.
+      size_t hash = 2166136261U;
+      for (const char* p = entry.str; *p; p++)
+        hash = (hash ^ static_cast<unsigned char>(*p)) * 16777619U;
+      return hash;
+    }
+  };
+
+  unordered_set<Entry, EntryHash> strings_;
+
+  // Every block we have allocated, and the unused tail of the current one.
+  vector<char*> blocks_;
+  char* block_;
+  size_t block_left_;
+};
+
+// A map from DIE offsets to VALUEs. The handlers record DIEs in increasing
+// offset order, almost without exception, so this keeps its entries in a
+// vector sorted by offset: appending is the common case, and each entry
+// costs a fraction of what a std::map node would.
+template<typename Value>
+class DwarfCUToModule::OffsetMap {
+ public:
+  // Set the value for OFFSET to VALUE.
+  void Set(uint64_t offset, const Value& value) {
+    if (entries_.empty() || entries_.back().first < offset) {
+      entries_.push_back(Entry(offset, value));
+      return;
+    }
+    typename vector<Entry>::iterator it =
+        std::lower_bound(entries_.begin(), entries_.end(),
+                         Entry(offset, Value()), CompareOffsets);
+    if (it != entries_.end() && it->first == offset)
+      it->second = value;
+    else
+      entries_.insert(it, Entry(offset, value));
+  }
+
+  // Return the value for OFFSET, or NULL if there is none. The pointer is
+  // valid only until the next call to Set or Clear.
+  const Value* Find(uint64_t offset) const {
+    typename vector<Entry>::const_iterator it =
+        std::lower_bound(entries_.begin(), entries_.end(),
+                         Entry(offset, Value()), CompareOffsets);
+    if (it == entries_.end() || it->first != offset)
+      return NULL;
+    return &it->second;
+  }
+
+  void Clear() { entries_.clear(); }
+
+ private:
+  typedef pair<uint64_t, Value> Entry;
+  static bool CompareOffsets(const Entry& a, const Entry& b) {
+    return a.first < b.first;
+  }
+
+  vector<Entry> entries_;
+};
 
 // Data global to the DWARF-bearing file that is private to the
 // DWARF-to-Module process.
 struct DwarfCUToModule::FilePrivate {
-  // A set of strings used in this CU. Before storing a string in one of
-  // our data structures, insert it into this set, and then use the string
-  // from the set.
-  //
-  // In some STL implementations, strings are reference-counted internally,
-  // meaning that simply using strings from this set, even if passed by
-  // value, assigned, or held directly in structures and containers
-  // (map<string, ...>, for example), causes those strings to share a
-  // single instance of each distinct piece of text. GNU's libstdc++ uses
-  // reference counts, and I believe MSVC did as well, at some point.
-  // However, C++ '11 implementations are moving away from reference
-  // counting.
-  //
-  // In other implementations, string assignments copy the string's text,
-  // so this set will actually hold yet another copy of the string (although
-  // everything will still work). To improve memory consumption portably,
-  // we will probably need to use pointers to strings held in this set.
-  unordered_set<string> common_strings;
+  // The names held by specifications and origins. Each distinct name is
+  // stored once, however many DIEs share it.
+  StringPool strings;
 
   // A map from offsets of DIEs within the .debug_info section to
   // Specifications describing those DIEs. Specification references can
   // cross compilation unit boundaries.
   SpecificationByOffset specifications;
 
-  AbstractOriginByOffset origins;
+  OffsetMap<AbstractOrigin> origins;
 };
 
 DwarfCUToModule::FileContext::FileContext(const string& filename,
@@ -134,6 +237,7 @@ DwarfCUToModule::FileContext::FileContext(const string& filename,
     : filename_(filename),
       module_(module),
       handle_inter_cu_refs_(handle_inter_cu_refs),
+      demangle_cache_(NULL),
       file_private_(new FilePrivate()) {
 }
 
@@ -156,7 +260,7 @@ DwarfCUToModule::FileContext::section_map() const {
 
 void DwarfCUToModule::FileContext::ClearSpecifications() {
   if (!handle_inter_cu_refs_)
-    file_private_->specifications.clear();
+    file_private_->specifications.Clear();
 }
 
 bool DwarfCUToModule::FileContext::IsUnhandledInterCUReference(
@@ -296,7 +400,7 @@ class DwarfCUToModule::GenericDIEHandler: public dwarf2reader::DIEHandler {
         parent_context_(parent_context),
         offset_(offset),
         declaration_(false),
-        specification_(NULL),
+        has_specification_(false),
         forward_ref_die_offset_(0) { }
 
   // Derived classes' ProcessAttributeUnsigned can defer to this to
@@ -332,22 +436,15 @@ class DwarfCUToModule::GenericDIEHandler: public dwarf2reader::DIEHandler {
   DIEContext* parent_context_;
   uint64_t offset_;
 
-  // Place the name in the global set of strings. Even though this looks
-  // like a copy, all the major string implementations use reference
-  // counting internally, so the effect is to have all the data structures
-  // share copies of strings whenever possible.
-  // FIXME: Should this return something like a string_ref to avoid the
-  // assumption about how strings are implemented?
-  string AddStringToPool(const string& str);
-
   // If this DIE has a DW_AT_declaration attribute, this is its value.
   // It is false on DIEs with no DW_AT_declaration attribute.
   bool declaration_;
 
-  // If this DIE has a DW_AT_specification attribute, this is the
-  // Specification structure for the DIE the attribute refers to.
-  // Otherwise, this is NULL.
-  Specification* specification_;
+  // If this DIE has a DW_AT_specification attribute, HAS_SPECIFICATION_ is
+  // true and SPECIFICATION_ is a copy of the Specification for the DIE the
+  // attribute refers to.
+  bool has_specification_;
+  Specification specification_;
 
   // If this DIE has a DW_AT_specification or DW_AT_abstract_origin and it is a
   // forward reference, no Specification will be available. Track the reference
@@ -395,11 +492,11 @@ void DwarfCUToModule::GenericDIEHandler::ProcessAttributeReference(
       // here, but it's better to leave the real work to our
       // EndAttribute member function, at which point we know we have
       // seen all the DIE's attributes.
-      SpecificationByOffset* specifications =
-          &file_context->file_private_->specifications;
-      SpecificationByOffset::iterator spec = specifications->find(data);
-      if (spec != specifications->end()) {
-        specification_ = &spec->second;
+      const Specification* spec =
+          file_context->file_private_->specifications.Find(data);
+      if (spec) {
+        has_specification_ = true;
+        specification_ = *spec;
       } else if (data > offset_) {
         forward_ref_die_offset_ = data;
       } else {
@@ -411,28 +508,24 @@ void DwarfCUToModule::GenericDIEHandler::ProcessAttributeReference(
   }
 }
 
-string DwarfCUToModule::GenericDIEHandler::AddStringToPool(const string& str) {
-  pair<unordered_set<string>::iterator, bool> result =
-    cu_context_->file_context->file_private_->common_strings.insert(str);
-  return *result.first;
-}
-
 void DwarfCUToModule::GenericDIEHandler::ProcessAttributeString(
     enum DwarfAttribute attr,
     enum DwarfForm form,
     const string& data) {
   switch (attr) {
     case dwarf2reader::DW_AT_name:
-      name_attribute_ = AddStringToPool(data);
+      name_attribute_ = data;
       break;
     case dwarf2reader::DW_AT_MIPS_linkage_name:
     case dwarf2reader::DW_AT_linkage_name: {
       string demangled;
-      Language::DemangleResult result =
+      DemangleCache* cache = cu_context_->file_context->demangle_cache_;
+      Language::DemangleResult result = cache ?
+          cache->Demangle(cu_context_->language, data, &demangled) :
           cu_context_->language->DemangleName(data, &demangled);
       switch (result) {
         case Language::kDemangleSuccess:
-          demangled_name_ = AddStringToPool(demangled);
+          demangled_name_.swap(demangled);
           break;
 
         case Language::kDemangleFailure:
@@ -440,7 +533,7 @@ void DwarfCUToModule::GenericDIEHandler::ProcessAttributeString(
           // fallthrough
         case Language::kDontDemangle:
           demangled_name_.clear();
-          raw_name_ = AddStringToPool(data);
+          raw_name_ = data;
           break;
       }
       break;
@@ -453,60 +546,59 @@ string DwarfCUToModule::GenericDIEHandler::ComputeQualifiedName() {
   // Use the demangled name, if one is available. Demangled names are
   // preferable to those inferred from the DWARF structure because they
   // include argument types.
-  const string* qualified_name = NULL;
+  const char* qualified_name = NULL;
   if (!demangled_name_.empty()) {
     // Found it is this DIE.
-    qualified_name = &demangled_name_;
-  } else if (specification_ && !specification_->qualified_name.empty()) {
+    qualified_name = demangled_name_.c_str();
+  } else if (has_specification_ && *specification_.qualified_name) {
     // Found it on the specification.
-    qualified_name = &specification_->qualified_name;
+    qualified_name = specification_.qualified_name;
   }
 
-  const string* unqualified_name = NULL;
-  const string* enclosing_name;
+  const char* unqualified_name = NULL;
+  const char* enclosing_name = NULL;
   if (!qualified_name) {
     // Find the unqualified name. If the DIE has its own DW_AT_name
     // attribute, then use that; otherwise, check the specification.
     if (!name_attribute_.empty())
-      unqualified_name = &name_attribute_;
-    else if (specification_)
-      unqualified_name = &specification_->unqualified_name;
+      unqualified_name = name_attribute_.c_str();
+    else if (has_specification_)
+      unqualified_name = specification_.unqualified_name;
     else if (!raw_name_.empty())
-      unqualified_name = &raw_name_;
+      unqualified_name = raw_name_.c_str();
 
     // Find the name of the enclosing context. If this DIE has a
     // specification, it's the specification's enclosing context that
     // counts; otherwise, use this DIE's context.
-    if (specification_)
-      enclosing_name = &specification_->enclosing_name;
+    if (has_specification_)
+      enclosing_name = specification_.enclosing_name;
     else
-      enclosing_name = &parent_context_->name;
+      enclosing_name = parent_context_->name.c_str();
   }
 
-  // Prepare the return value before upcoming mutations possibly invalidate the
-  // existing pointers.
   string return_value;
   if (qualified_name) {
-    return_value = *qualified_name;
+    return_value = qualified_name;
   } else if (unqualified_name && enclosing_name) {
     // Combine the enclosing name and unqualified name to produce our
     // own fully-qualified name.
-    return_value = cu_context_->language->MakeQualifiedName(*enclosing_name,
-                                                            *unqualified_name);
+    return_value = cu_context_->language->MakeQualifiedName(enclosing_name,
+                                                            unqualified_name);
   }
 
   // If this DIE was marked as a declaration, record its names in the
   // specification table.
   if ((declaration_ && qualified_name) ||
       (unqualified_name && enclosing_name)) {
+    FilePrivate* file_private = cu_context_->file_context->file_private_.get();
     Specification spec;
     if (qualified_name) {
-      spec.qualified_name = *qualified_name;
+      spec.qualified_name = file_private->strings.Intern(qualified_name);
     } else {
-      spec.enclosing_name = *enclosing_name;
-      spec.unqualified_name = *unqualified_name;
+      spec.enclosing_name = file_private->strings.Intern(enclosing_name);
+      spec.unqualified_name = file_private->strings.Intern(unqualified_name);
     }
-    cu_context_->file_context->file_private_->specifications[offset_] = spec;
+    file_private->specifications.Set(offset_, spec);
   }
 
   return return_value;
@@ -520,7 +612,7 @@ class DwarfCUToModule::FuncHandler: public GenericDIEHandler {
       : GenericDIEHandler(cu_context, parent_context, offset),
         low_pc_(0), high_pc_(0), high_pc_form_(dwarf2reader::DW_FORM_addr),
         ranges_form_(dwarf2reader::DW_FORM_sec_offset), ranges_data_(0),
-        abstract_origin_(NULL), inline_(false) { }
+        inline_(false) { }
 
   void ProcessAttributeUnsigned(enum DwarfAttribute attr,
                                 enum DwarfForm form,
@@ -543,7 +635,7 @@ class DwarfCUToModule::FuncHandler: public GenericDIEHandler {
   DwarfForm high_pc_form_; // DW_AT_high_pc can be length or address.
   DwarfForm ranges_form_; // DW_FORM_sec_offset or DW_FORM_rnglistx
   uint64_t ranges_data_; // DW_AT_ranges
-  const AbstractOrigin* abstract_origin_;
+  AbstractOrigin abstract_origin_;
   bool inline_;
 };
 
@@ -594,11 +686,10 @@ void DwarfCUToModule::FuncHandler::ProcessAttributeReference(
     uint64_t data) {
   switch (attr) {
     case dwarf2reader::DW_AT_abstract_origin: {
-      const AbstractOriginByOffset& origins =
-          cu_context_->file_context->file_private_->origins;
-      AbstractOriginByOffset::const_iterator origin = origins.find(data);
-      if (origin != origins.end()) {
-        abstract_origin_ = &(origin->second);
+      const AbstractOrigin* origin =
+          cu_context_->file_context->file_private_->origins.Find(data);
+      if (origin) {
+        abstract_origin_ = *origin;
       } else if (data > offset_) {
         forward_ref_die_offset_ = data;
       } else {
@@ -615,8 +706,8 @@ void DwarfCUToModule::FuncHandler::ProcessAttributeReference(
 bool DwarfCUToModule::FuncHandler::EndAttributes() {
   // Compute our name, and record a specification, if appropriate.
   name_ = ComputeQualifiedName();
-  if (name_.empty() && abstract_origin_) {
-    name_ = abstract_origin_->name;
+  if (name_.empty() && abstract_origin_.name) {
+    name_ = abstract_origin_.name;
   }
   return true;
 }
@@ -715,8 +806,9 @@ void DwarfCUToModule::FuncHandler::Finish() {
       }
     }
   } else if (inline_) {
-    AbstractOrigin origin(name_);
-    cu_context_->file_context->file_private_->origins[offset_] = origin;
+    FilePrivate* file_private = cu_context_->file_context->file_private_.get();
+    AbstractOrigin origin(file_private->strings.Intern(name_.c_str()));
+    file_private->origins.Set(offset_, origin);
   }
 }
 
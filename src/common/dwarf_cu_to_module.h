@@ -91,6 +91,11 @@ class DwarfCUToModule: public dwarf2reader::RootDIEHandler {
     // Clear the section map for testing.
     void ClearSectionMapForTest();
 
+    // Demangle linkage names through CACHE, which may be shared with
+    // other users and must outlive this FileContext. By default, each
+    // name is demangled as it is found.
+    void SetDemangleCache(DemangleCache* cache) { demangle_cache_ = cache; }
+
     const dwarf2reader::SectionMap& section_map() const;
 
    private:
@@ -118,6 +123,9 @@ class DwarfCUToModule: public dwarf2reader::RootDIEHandler {
     // True if we are handling references between compilation units.
     const bool handle_inter_cu_refs_;
 
+    // The cache to demangle names through, or NULL.
+    DemangleCache* demangle_cache_;
+
     // Inter-compilation unit data used internally by the handlers.
     scoped_ptr<FilePrivate> file_private_;
   };
@@ -292,12 +300,14 @@ class DwarfCUToModule: public dwarf2reader::RootDIEHandler {
   struct CUContext;
   struct DIEContext;
   struct Specification;
+  class StringPool;
+  template<typename Value> class OffsetMap;
   class GenericDIEHandler;
   class FuncHandler;
   class NamedScopeHandler;
 
   // A map from section offsets to specifications.
-  typedef map<uint64_t, Specification> SpecificationByOffset;
+  typedef OffsetMap<Specification> SpecificationByOffset;
 
   // Set this compilation unit's source language to LANGUAGE.
   void SetLanguage(DwarfLanguage language);
@@ -778,6 +778,34 @@ TEST_F(SimpleCU, AbstractOriginNotInlined) {
                0x2805c4531be6ca0eULL, 0x686b52155a8d4d2cULL);
 }
 
+// Abstract origins are recorded when their DIEs finish, so they need not
+// arrive in offset order, and a later record for an offset replaces an
+// earlier one.
+TEST_F(SimpleCU, AbstractOriginsOutOfOrder) {
+  PushLine(0x1000, 0x10, "line-file", 1);
+  PushLine(0x2000, 0x10, "line-file", 2);
+  PushLine(0x3000, 0x10, "line-file", 3);
+
+  StartCU();
+  AbstractInstanceDIE(&root_handler_, 0x300,
+                      dwarf2reader::DW_INL_inlined, 0, "third");
+  AbstractInstanceDIE(&root_handler_, 0x100,
+                      dwarf2reader::DW_INL_inlined, 0, "stale");
+  AbstractInstanceDIE(&root_handler_, 0x200,
+                      dwarf2reader::DW_INL_inlined, 0, "second");
+  AbstractInstanceDIE(&root_handler_, 0x100,
+                      dwarf2reader::DW_INL_inlined, 0, "first");
+  DefineInlineInstanceDIE(&root_handler_, "", 0x200, 0x2000, 0x10);
+  DefineInlineInstanceDIE(&root_handler_, "", 0x100, 0x1000, 0x10);
+  DefineInlineInstanceDIE(&root_handler_, "", 0x300, 0x3000, 0x10);
+  root_handler_.Finish();
+
+  TestFunctionCount(3);
+  TestFunction(0, "first", 0x1000, 0x10);
+  TestFunction(1, "second", 0x2000, 0x10);
+  TestFunction(2, "third", 0x3000, 0x10);
+}
+
 TEST_F(SimpleCU, UnknownAbstractOrigin) {
   EXPECT_CALL(reporter_, UnknownAbstractOrigin(_, 1ULL)).WillOnce(Return());
   EXPECT_CALL(reporter_, UnnamedFunction(0x11c70f94c6e87ccdLL))
@@ -1571,6 +1599,89 @@ TEST_F(Specifications, InterCU) {
   EXPECT_STREQ("class_A::member_func_B", functions[0]->name.c_str());
 }
 
+// Specifications referenced across compilation units, recorded out of
+// offset order, with names that are repeated or too long to share a block
+// of the file's string pool.
+TEST_F(Specifications, InterCUOutOfOrder) {
+  Module m("module-name", "module-os", "module-arch", "module-id");
+  DwarfCUToModule::FileContext fc("dwarf-filename", &m, true);
+  EXPECT_CALL(reporter_, UncoveredFunction(_)).WillRepeatedly(Return());
+  MockLineToModuleHandler lr;
+  EXPECT_CALL(lr, ReadProgram(_,_,_,_,_,_,_,_)).Times(0);
+
+  // Kludge: satisfy reporter_'s expectation.
+  reporter_.SetCUName("compilation-unit-name");
+
+  const string long_name(100000, 'x');
+
+  // First CU.  Declares a class with a very long name, and a function.
+  {
+    DwarfCUToModule root1_handler(&fc, &lr, nullptr, &reporter_);
+    ASSERT_TRUE(root1_handler.StartCompilationUnit(0, 1, 2, 3, 3));
+    ASSERT_TRUE(root1_handler.StartRootDIE(1,
+                                           dwarf2reader::DW_TAG_compile_unit));
+    ASSERT_TRUE(root1_handler.EndAttributes());
+    DeclarationDIE(&root1_handler, 0x3000,
+                   dwarf2reader::DW_TAG_class_type, long_name, "");
+    DeclarationDIE(&root1_handler, 0x4000,
+                   dwarf2reader::DW_TAG_subprogram, "stale_name", "");
+    root1_handler.Finish();
+  }
+
+  // Second CU, at lower offsets.  Declares two functions with the same
+  // name and a member of the long-named class, and redeclares the
+  // function at 0x4000.
+  {
+    DwarfCUToModule root2_handler(&fc, &lr, nullptr, &reporter_);
+    ASSERT_TRUE(root2_handler.StartCompilationUnit(0, 1, 2, 3, 3));
+    ASSERT_TRUE(root2_handler.StartRootDIE(1,
+                                           dwarf2reader::DW_TAG_compile_unit));
+    ASSERT_TRUE(root2_handler.EndAttributes());
+    DeclarationDIE(&root2_handler, 0x1000,
+                   dwarf2reader::DW_TAG_subprogram, "same_name", "");
+    DeclarationDIE(&root2_handler, 0x1800,
+                   dwarf2reader::DW_TAG_subprogram, "same_name", "");
+    DIEHandler* class_handler
+      = StartSpecifiedDIE(&root2_handler, dwarf2reader::DW_TAG_class_type,
+                          0x3000);
+    DeclarationDIE(class_handler, 0x2000,
+                   dwarf2reader::DW_TAG_subprogram, "member", "");
+    class_handler->Finish();
+    delete class_handler;
+    DeclarationDIE(&root2_handler, 0x4000,
+                   dwarf2reader::DW_TAG_subprogram, "fresh_name", "");
+    root2_handler.Finish();
+  }
+
+  // Third CU.  Defines all the functions.
+  {
+    DwarfCUToModule root3_handler(&fc, &lr, nullptr, &reporter_);
+    ASSERT_TRUE(root3_handler.StartCompilationUnit(0, 1, 2, 3, 3));
+    ASSERT_TRUE(root3_handler.StartRootDIE(1,
+                                           dwarf2reader::DW_TAG_compile_unit));
+    ASSERT_TRUE(root3_handler.EndAttributes());
+    DefinitionDIE(&root3_handler, dwarf2reader::DW_TAG_subprogram,
+                  0x1000, "", 0x10000, 0x100);
+    DefinitionDIE(&root3_handler, dwarf2reader::DW_TAG_subprogram,
+                  0x1800, "", 0x20000, 0x100);
+    DefinitionDIE(&root3_handler, dwarf2reader::DW_TAG_subprogram,
+                  0x2000, "", 0x30000, 0x100);
+    DefinitionDIE(&root3_handler, dwarf2reader::DW_TAG_subprogram,
+                  0x4000, "", 0x40000, 0x100);
+    root3_handler.Finish();
+  }
+
+  vector<Module::Function*> functions;
+  m.GetFunctions(&functions, functions.end());
+  sort(functions.begin(), functions.end(),
+       Module::Function::CompareByAddress);
+  ASSERT_EQ(4U, functions.size());
+  EXPECT_EQ("same_name", functions[0]->name);
+  EXPECT_EQ("same_name", functions[1]->name);
+  EXPECT_EQ(long_name + "::member", functions[2]->name);
+  EXPECT_EQ("fresh_name", functions[3]->name);
+}
+
 TEST_F(Specifications, UnhandledInterCU) {
   Module m("module-name", "module-os", "module-arch", "module-id");
   DwarfCUToModule::FileContext fc("dwarf-filename", &m, false);
@@ -127,6 +127,8 @@ class DwarfLineToModule: public dwarf2reader::LineInfoHandler {
         lines_(lines),
         highest_file_number_(-1),
         omitted_line_end_(0),
+        last_file_num_(0),
+        last_file_(NULL),
         warned_bad_file_number_(false),
         warned_bad_directory_number_(false) { }
   
@@ -178,6 +180,12 @@ class DwarfLineToModule: public dwarf2reader::LineInfoHandler {
   // AddLine calls.
   uint64_t omitted_line_end_;
 
+  // The file number of the last line we added, and its Module::File, so
+  // that runs of lines from the same file need not search files_. If
+  // LAST_FILE_ is NULL, there is no such line.
+  uint32_t last_file_num_;
+  Module::File* last_file_;
+
   // True if we've warned about:
   bool warned_bad_file_number_; // bad file numbers
   bool warned_bad_directory_number_; // bad directory numbers
@@ -123,6 +123,25 @@ TEST(SimpleModule, Many) {
   EXPECT_EQ(0x75047044, lines[4].number);
 }
 
+// A file number redefined between lines must take effect for the
+// lines that follow.
+TEST(SimpleModule, RedefinedFile) {
+  Module m("name", "os", "architecture", "id");
+  vector<Module::Line> lines;
+  DwarfLineToModule h(&m, "/", &lines);
+
+  h.DefineFile("file1", 1, 0, 0, 0);
+  h.AddLine(0x1000, 0x10, 1, 10, 0);
+  h.AddLine(0x1010, 0x10, 1, 11, 0);
+  h.DefineFile("file2", 1, 0, 0, 0);
+  h.AddLine(0x1020, 0x10, 1, 12, 0);
+
+  ASSERT_EQ(3U, lines.size());
+  EXPECT_STREQ("/file1", lines[0].file->name.c_str());
+  EXPECT_STREQ("/file1", lines[1].file->name.c_str());
+  EXPECT_STREQ("/file2", lines[2].file->name.c_str());
+}
+
 TEST(Filenames, Absolute) {
   Module m("name", "os", "architecture", "id");
   vector<Module::Line> lines;
@@ -44,7 +44,9 @@
 #include <rust_demangle.h>
 #endif
 
+#include <algorithm>
 #include <limits>
+#include <utility>
 
 namespace {
 
@@ -210,6 +212,116 @@ class AssemblerLanguage: public Language {
 
 AssemblerLanguage AssemblerLanguageSingleton;
 
+struct DemangleCache::Batch {
+  const Language* language;
+  const std::vector<string>* names;
+  std::vector<Entry>* entries;
+
+  // The index of the next name to demangle; take it under LOCK.
+  pthread_mutex_t lock;
+  size_t next;
+};
+
+DemangleCache::DemangleCache() : hits_(0), misses_(0) {
+  pthread_mutex_init(&mutex_, NULL);
+}
+
+DemangleCache::~DemangleCache() {
+  pthread_mutex_destroy(&mutex_);
+}
+
+Language::DemangleResult DemangleCache::Demangle(const Language* language,
+                                                 const string& mangled,
+                                                 string* demangled) {
+  pthread_mutex_lock(&mutex_);
+  EntryMap& entries = entries_[language];
+  EntryMap::const_iterator it = entries.find(mangled);
+  if (it != entries.end()) {
+    hits_++;
+    Language::DemangleResult result = it->second.result;
+    demangled->assign(it->second.demangled);
+    pthread_mutex_unlock(&mutex_);
+    return result;
+  }
+  misses_++;
+  pthread_mutex_unlock(&mutex_);
+
+  // Demangle without holding the lock. If another thread demangles the
+  // same name meanwhile, both get the same answer, and the first stays.
+  Entry entry;
+  entry.result = language->DemangleName(mangled, &entry.demangled);
+  demangled->assign(entry.demangled);
+  pthread_mutex_lock(&mutex_);
+  entries_[language].insert(std::make_pair(mangled, entry));
+  pthread_mutex_unlock(&mutex_);
+  return entry.result;
+}
+
+size_t DemangleCache::hits() const {
+  pthread_mutex_lock(&mutex_);
+  size_t hits = hits_;
+  pthread_mutex_unlock(&mutex_);
+  return hits;
+}
+
+size_t DemangleCache::misses() const {
+  pthread_mutex_lock(&mutex_);
+  size_t misses = misses_;
+  pthread_mutex_unlock(&mutex_);
+  return misses;
+}
+
+void* DemangleCache::DemangleBatch(void* arg) {
+  Batch* batch = static_cast<Batch*>(arg);
+  // Take names in chunks, to keep contention for the lock down.
+  const size_t kChunk = 256;
+  while (true) {
+    pthread_mutex_lock(&batch->lock);
+    size_t begin = batch->next;
+    batch->next += kChunk;
+    pthread_mutex_unlock(&batch->lock);
+    if (begin >= batch->names->size())
+      break;
+    size_t end = std::min(begin + kChunk, batch->names->size());
+    for (size_t i = begin; i < end; i++) {
+      Entry& entry = (*batch->entries)[i];
+      entry.result = batch->language->DemangleName((*batch->names)[i],
+                                                   &entry.demangled);
+    }
+  }
+  return NULL;
+}
+
+void DemangleCache::Prefetch(const Language* language,
+                             const std::vector<string>& names,
+                             int threads) {
+  std::vector<Entry> entries(names.size());
+  Batch batch;
+  batch.language = language;
+  batch.names = &names;
+  batch.entries = &entries;
+  pthread_mutex_init(&batch.lock, NULL);
+  batch.next = 0;
+
+  std::vector<pthread_t> workers;
+  for (int i = 1; i < threads; i++) {
+    pthread_t worker;
+    if (pthread_create(&worker, NULL, DemangleBatch, &batch) != 0)
+      break;
+    workers.push_back(worker);
+  }
+  DemangleBatch(&batch);
+  for (size_t i = 0; i < workers.size(); i++)
+    pthread_join(workers[i], NULL);
+  pthread_mutex_destroy(&batch.lock);
+
+  pthread_mutex_lock(&mutex_);
+  EntryMap& cached = entries_[language];
+  for (size_t i = 0; i < names.size(); i++)
+    cached.insert(std::make_pair(names[i], entries[i]));
+  pthread_mutex_unlock(&mutex_);
+}
+
 const Language * const Language::CPlusPlus = &CPPLanguageSingleton;
 const Language * const Language::Java = &JavaLanguageSingleton;
 const Language * const Language::Swift = &SwiftLanguageSingleton;
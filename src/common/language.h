@@ -38,7 +38,12 @@
 #ifndef COMMON_LINUX_LANGUAGE_H__
 #define COMMON_LINUX_LANGUAGE_H__
 
+#include <pthread.h>
+
+#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "common/using_std_string.h"
 
@@ -100,6 +105,51 @@ class Language {
                         * const Assembler;
 };
 
+// A cache of demangled names, shared by everything that demangles names
+// from one file. The same mangled names turn up in compilation unit
+// after compilation unit, and demangling them is expensive, so this
+// demangles each distinct name only once. It can also demangle a batch
+// of names on several threads ahead of time. A DemangleCache may be used
+// from several threads at once.
+class DemangleCache {
+ public:
+  DemangleCache();
+  ~DemangleCache();
+
+  // Demangle MANGLED as LANGUAGE->DemangleName would, returning the same
+  // result and setting *DEMANGLED the same way, but reuse the result of
+  // any earlier request for the same language and name.
+  Language::DemangleResult Demangle(const Language* language,
+                                    const string& mangled,
+                                    string* demangled);
+
+  // Demangle each of NAMES with LANGUAGE, using up to THREADS threads,
+  // and cache the results for later calls to Demangle.
+  void Prefetch(const Language* language, const std::vector<string>& names,
+                int threads);
+
+  // The number of requests answered from the cache, and the number that
+  // had to demangle a name.
+  size_t hits() const;
+  size_t misses() const;
+
+ private:
+  struct Entry {
+    Language::DemangleResult result;
+    string demangled;
+  };
+  typedef std::unordered_map<string, Entry> EntryMap;
+
+  // A batch of names being demangled by Prefetch's threads.
+  struct Batch;
+  static void* DemangleBatch(void* arg);
+
+  // The cached results for each language, keyed by mangled name.
+  std::map<const Language*, EntryMap> entries_;
+  mutable pthread_mutex_t mutex_;
+  size_t hits_, misses_;
+};
+
 } // namespace google_breakpad
 
 #endif  // COMMON_LINUX_LANGUAGE_H__
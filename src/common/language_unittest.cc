@@ -0,0 +1,103 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// language_unittest.cc: Unit tests for google_breakpad::DemangleCache.
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "breakpad_googletest_includes.h"
+#include "common/language.h"
+#include "common/using_std_string.h"
+
+using google_breakpad::DemangleCache;
+using google_breakpad::Language;
+
+namespace {
+
+TEST(DemangleCache, MatchesLanguage) {
+  const char* const kNames[] = {
+    "_ZN3foo3barEv", "_ZNK3foo3bazEi", "not_mangled", "_Zbogus",
+  };
+  DemangleCache cache;
+  for (size_t i = 0; i < sizeof(kNames) / sizeof(kNames[0]); i++) {
+    string expected, demangled;
+    Language::DemangleResult expected_result =
+        Language::CPlusPlus->DemangleName(kNames[i], &expected);
+    EXPECT_EQ(expected_result,
+              cache.Demangle(Language::CPlusPlus, kNames[i], &demangled));
+    EXPECT_EQ(expected, demangled);
+  }
+  EXPECT_EQ(0U, cache.hits());
+  EXPECT_EQ(4U, cache.misses());
+}
+
+TEST(DemangleCache, Reuses) {
+  DemangleCache cache;
+  string demangled;
+  EXPECT_EQ(Language::kDemangleSuccess,
+            cache.Demangle(Language::CPlusPlus, "_ZN3foo3barEv", &demangled));
+  EXPECT_EQ("foo::bar()", demangled);
+  demangled.clear();
+  EXPECT_EQ(Language::kDemangleSuccess,
+            cache.Demangle(Language::CPlusPlus, "_ZN3foo3barEv", &demangled));
+  EXPECT_EQ("foo::bar()", demangled);
+  EXPECT_EQ(1U, cache.hits());
+  EXPECT_EQ(1U, cache.misses());
+
+  // Results are kept separately for each language.
+  EXPECT_EQ(Language::kDontDemangle,
+            cache.Demangle(Language::Java, "_ZN3foo3barEv", &demangled));
+  EXPECT_EQ(2U, cache.misses());
+}
+
+TEST(DemangleCache, Prefetch) {
+  std::vector<string> names;
+  for (int i = 0; i < 1000; i++) {
+    char name[32];
+    snprintf(name, sizeof(name), "_ZN3foo4f%03dEv", i);
+    names.push_back(name);
+  }
+  DemangleCache cache;
+  cache.Prefetch(Language::CPlusPlus, names, 4);
+  for (size_t i = 0; i < names.size(); i++) {
+    string expected, demangled;
+    Language::CPlusPlus->DemangleName(names[i], &expected);
+    EXPECT_EQ(Language::kDemangleSuccess,
+              cache.Demangle(Language::CPlusPlus, names[i], &demangled));
+    EXPECT_EQ(expected, demangled);
+  }
+  EXPECT_EQ(names.size(), cache.hits());
+  EXPECT_EQ(0U, cache.misses());
+}
+
+}  // namespace
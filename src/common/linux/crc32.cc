@@ -29,6 +29,8 @@
 
 #include "common/linux/crc32.h"
 
+#include <pthread.h>
+
 namespace google_breakpad {
 
 // This implementation is based on the sample implementation in RFC 1952.
@@ -37,12 +39,11 @@ namespace google_breakpad {
 // See RFC 1952, or http://en.wikipedia.org/wiki/Cyclic_redundancy_check
 static const uint32_t kCrc32Polynomial = 0xEDB88320;
 static uint32_t kCrc32Table[256] = { 0 };
+static pthread_once_t crc32_table_once = PTHREAD_ONCE_INIT;
 
 #define arraysize(f) (sizeof(f) / sizeof(*f))
 
-static void EnsureCrc32TableInited() {
-  if (kCrc32Table[arraysize(kCrc32Table) - 1])
-    return;  // already inited
+static void InitCrc32Table() {
   for (uint32_t i = 0; i < arraysize(kCrc32Table); ++i) {
     uint32_t c = i;
     for (size_t j = 0; j < 8; ++j) {
@@ -57,7 +58,8 @@ static void EnsureCrc32TableInited() {
 }
 
 uint32_t UpdateCrc32(uint32_t start, const void* buf, size_t len) {
-  EnsureCrc32TableInited();
+  // dump_syms may compute checksums on several threads at once.
+  pthread_once(&crc32_table_once, InitCrc32Table);
 
   uint32_t c = start ^ 0xFFFFFFFF;
   const uint8_t* u = static_cast<const uint8_t*>(buf);
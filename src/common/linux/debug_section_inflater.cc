@@ -0,0 +1,299 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// debug_section_inflater.cc: Implement google_breakpad::DebugSectionInflater.
+// See debug_section_inflater.h for details.
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>  // Must come first
+#endif
+
+#include "common/linux/debug_section_inflater.h"
+
+#include <elf.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+// Older C libraries don't define these.
+#ifndef SHF_COMPRESSED
+#define SHF_COMPRESSED (1 << 11)
+#endif
+#ifndef ELFCOMPRESS_ZLIB
+#define ELFCOMPRESS_ZLIB 1
+#endif
+
+namespace google_breakpad {
+
+namespace {
+
+// Sizes of Elf32_Chdr and Elf64_Chdr.
+const size_t kChdr32Size = 12;
+const size_t kChdr64Size = 24;
+
+// Deflate can't compress data by more than about 1032:1.
+const uint64_t kMaxDeflateRatio = 1032;
+
+// Read the |size|-byte integer at |data|.
+uint64_t ReadInteger(const uint8_t* data, size_t size, bool big_endian) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; ++i) {
+    size_t shift = big_endian ? (size - 1 - i) * 8 : i * 8;
+    value |= static_cast<uint64_t>(data[i]) << shift;
+  }
+  return value;
+}
+
+}  // namespace
+
+DebugSectionInflater::DebugSectionInflater() : next_(0) {
+  pthread_mutex_init(&mutex_, NULL);
+}
+
+DebugSectionInflater::~DebugSectionInflater() {
+  for (size_t i = 0; i < sections_.size(); ++i)
+    delete sections_[i];
+  pthread_mutex_destroy(&mutex_);
+}
+
+// static
+bool DebugSectionInflater::IsCompressed(const string& name, uint64_t flags,
+                                        string* dwarf_name) {
+  static const char kZdebugPrefix[] = ".zdebug";
+  if (flags & SHF_COMPRESSED) {
+    *dwarf_name = name;
+    return true;
+  }
+  if (name.compare(0, sizeof(kZdebugPrefix) - 1, kZdebugPrefix) == 0) {
+    *dwarf_name = "." + name.substr(2);
+    return true;
+  }
+  return false;
+}
+
+// static
+bool DebugSectionInflater::ParseHeader(const string& name, uint64_t flags,
+                                       const uint8_t* contents, uint64_t size,
+                                       bool big_endian, int elf_class,
+                                       string* dwarf_name,
+                                       const uint8_t** data,
+                                       uint64_t* data_size,
+                                       uint64_t* uncompressed_size) {
+  if (!IsCompressed(name, flags, dwarf_name))
+    return false;
+
+  if (flags & SHF_COMPRESSED) {
+    // Elf32_Chdr is ch_type, ch_size and ch_addralign, all 32-bit.
+    // Elf64_Chdr is ch_type and ch_reserved, 32-bit, then ch_size and
+    // ch_addralign, 64-bit.
+    const bool is_64 = elf_class == ELFCLASS64;
+    const size_t header_size = is_64 ? kChdr64Size : kChdr32Size;
+    if (size < header_size) {
+      fprintf(stderr, "%s: compressed section header is truncated\n",
+              name.c_str());
+      return false;
+    }
+    uint64_t type = ReadInteger(contents, 4, big_endian);
+    if (type != ELFCOMPRESS_ZLIB) {
+      fprintf(stderr, "%s: unsupported section compression type %llu\n",
+              name.c_str(), static_cast<unsigned long long>(type));
+      return false;
+    }
+    *uncompressed_size = is_64 ? ReadInteger(contents + 8, 8, big_endian)
+                               : ReadInteger(contents + 4, 4, big_endian);
+    *data = contents + header_size;
+    *data_size = size - header_size;
+  } else {
+    // A .zdebug section: "ZLIB", then the size, big-endian whatever the
+    // byte order of the file.
+    static const size_t kZdebugHeaderSize = 12;
+    if (size < kZdebugHeaderSize || memcmp(contents, "ZLIB", 4) != 0) {
+      fprintf(stderr, "%s: missing ZLIB header\n", name.c_str());
+      return false;
+    }
+    *uncompressed_size = ReadInteger(contents + 4, 8, true);
+    *data = contents + kZdebugHeaderSize;
+    *data_size = size - kZdebugHeaderSize;
+  }
+
+  // Don't trust a corrupt header with the size to allocate.
+  if (*uncompressed_size / kMaxDeflateRatio > *data_size) {
+    fprintf(stderr, "%s: invalid uncompressed size %llu\n", name.c_str(),
+            static_cast<unsigned long long>(*uncompressed_size));
+    return false;
+  }
+  return true;
+}
+
+void DebugSectionInflater::Add(const string& dwarf_name, const uint8_t* data,
+                               uint64_t data_size,
+                               uint64_t uncompressed_size) {
+  Section* section = new Section;
+  section->name = dwarf_name;
+  section->data = data;
+  section->data_size = data_size;
+  section->size = uncompressed_size;
+  section->inflated = false;
+  sections_.push_back(section);
+}
+
+bool DebugSectionInflater::Inflate(unsigned max_threads) {
+  // Start with the largest sections, so that the last ones to finish are
+  // short ones.
+  queue_.clear();
+  for (size_t i = 0; i < sections_.size(); ++i) {
+    if (!sections_[i]->inflated)
+      queue_.push_back(sections_[i]);
+  }
+  std::stable_sort(queue_.begin(), queue_.end(), LargerSection);
+  next_ = 0;
+
+  if (max_threads == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    max_threads = cpus > 0 ? cpus : 1;
+  }
+  size_t thread_count = std::min<size_t>(max_threads, queue_.size());
+
+  // This thread is one of the workers.
+  std::vector<pthread_t> threads;
+  for (size_t i = 1; i < thread_count; ++i) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, WorkerMain, this) != 0)
+      break;
+    threads.push_back(thread);
+  }
+  WorkerMain(this);
+  for (size_t i = 0; i < threads.size(); ++i)
+    pthread_join(threads[i], NULL);
+
+  bool all_inflated = true;
+  for (size_t i = 0; i < queue_.size(); ++i) {
+    if (!queue_[i]->inflated)
+      all_inflated = false;
+  }
+  queue_.clear();
+  return all_inflated;
+}
+
+bool DebugSectionInflater::Get(const string& dwarf_name,
+                               const uint8_t** contents,
+                               uint64_t* size) const {
+  for (size_t i = 0; i < sections_.size(); ++i) {
+    const Section* section = sections_[i];
+    if (section->inflated && section->name == dwarf_name) {
+      *contents = section->contents.get();
+      *size = section->size;
+      return true;
+    }
+  }
+  return false;
+}
+
+// static
+bool DebugSectionInflater::LargerSection(const Section* a, const Section* b) {
+  return a->size > b->size;
+}
+
+// static
+void* DebugSectionInflater::WorkerMain(void* arg) {
+  DebugSectionInflater* inflater = static_cast<DebugSectionInflater*>(arg);
+  while (Section* section = inflater->NextSection()) {
+    section->inflated = InflateSection(section);
+    if (!section->inflated) {
+      section->contents.reset();
+      fprintf(stderr, "%s: failed to inflate compressed section\n",
+              section->name.c_str());
+    }
+  }
+  return NULL;
+}
+
+DebugSectionInflater::Section* DebugSectionInflater::NextSection() {
+  pthread_mutex_lock(&mutex_);
+  Section* section = next_ < queue_.size() ? queue_[next_++] : NULL;
+  pthread_mutex_unlock(&mutex_);
+  return section;
+}
+
+// static
+bool DebugSectionInflater::InflateSection(Section* section) {
+#ifdef HAVE_LIBZ
+  if (section->size > SIZE_MAX)
+    return false;
+  section->contents.reset(new uint8_t[section->size]);
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit(&stream) != Z_OK)
+    return false;
+
+  // zlib counts bytes in uInt, so feed it large sections piecewise.
+  const uint8_t* in = section->data;
+  uint64_t in_left = section->data_size;
+  uint8_t* out = section->contents.get();
+  uint64_t out_left = section->size;
+  // inflate rejects a NULL next_out even when there is no room to write,
+  // so an empty section needs a valid pointer before the first call.
+  stream.next_out = out;
+  int result = Z_OK;
+  while (result == Z_OK) {
+    if (stream.avail_in == 0 && in_left > 0) {
+      uInt chunk = static_cast<uInt>(std::min<uint64_t>(in_left, UINT_MAX));
+      stream.next_in = const_cast<Bytef*>(in);
+      stream.avail_in = chunk;
+      in += chunk;
+      in_left -= chunk;
+    }
+    if (stream.avail_out == 0 && out_left > 0) {
+      uInt chunk = static_cast<uInt>(std::min<uint64_t>(out_left, UINT_MAX));
+      stream.next_out = out;
+      stream.avail_out = chunk;
+      out += chunk;
+      out_left -= chunk;
+    }
+    result = inflate(&stream, Z_NO_FLUSH);
+  }
+  inflateEnd(&stream);
+  return result == Z_STREAM_END && stream.avail_out == 0 && out_left == 0;
+#else
+  fprintf(stderr, "%s: dump_syms was built without zlib\n",
+          section->name.c_str());
+  return false;
+#endif
+}
+
+}  // namespace google_breakpad
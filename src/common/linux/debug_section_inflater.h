@@ -0,0 +1,130 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// debug_section_inflater.h: Define the google_breakpad::DebugSectionInflater
+// class, which inflates compressed ELF debug sections.
+//
+// Toolchains can compress debug sections with zlib, either with
+// SHF_COMPRESSED set on the section and an ElfN_Chdr before the data
+// (--compress-debug-sections=zlib-gabi), or as GNU .zdebug_* sections
+// starting with "ZLIB" and the big-endian uncompressed size
+// (--compress-debug-sections=zlib-gnu).  The DWARF readers want the
+// uncompressed bytes: DebugSectionInflater inflates the sections of a file,
+// several at a time, into buffers it keeps for as long as the readers need
+// them.
+
+#ifndef COMMON_LINUX_DEBUG_SECTION_INFLATER_H_
+#define COMMON_LINUX_DEBUG_SECTION_INFLATER_H_
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/using_std_string.h"
+
+namespace google_breakpad {
+
+class DebugSectionInflater {
+ public:
+  DebugSectionInflater();
+  ~DebugSectionInflater();
+
+  // Return true if the section named |name|, with |flags| as its sh_flags,
+  // is compressed, and set |*dwarf_name| to the name of its uncompressed
+  // form: ".zdebug_info" is ".debug_info".
+  static bool IsCompressed(const string& name, uint64_t flags,
+                           string* dwarf_name);
+
+  // If |contents|, of |size| bytes, is the data of a compressed section
+  // named |name|, with |flags| as its sh_flags, set |*dwarf_name| to the
+  // name of the uncompressed section (".zdebug_info" is ".debug_info"), and
+  // |*data|, |*data_size| and |*uncompressed_size| to the zlib stream and
+  // the size it inflates to, and return true.  Return false if the section
+  // isn't compressed, or isn't compressed in a supported way, in which case
+  // a warning is printed.  |big_endian| and |elf_class| describe the file.
+  static bool ParseHeader(const string& name, uint64_t flags,
+                          const uint8_t* contents, uint64_t size,
+                          bool big_endian, int elf_class, string* dwarf_name,
+                          const uint8_t** data, uint64_t* data_size,
+                          uint64_t* uncompressed_size);
+
+  // Queue the section |dwarf_name|, whose zlib stream is |data|, of
+  // |data_size| bytes, and inflates to |uncompressed_size| bytes.  |data|
+  // must stay valid until Inflate() returns.
+  void Add(const string& dwarf_name, const uint8_t* data, uint64_t data_size,
+           uint64_t uncompressed_size);
+
+  // Inflate the queued sections, using up to |max_threads| threads, or one
+  // per CPU if |max_threads| is 0.  Sections that fail to inflate are
+  // dropped with a warning.  Return false if any did.
+  bool Inflate(unsigned max_threads = 0);
+
+  // If the section |dwarf_name| was inflated, set |*contents| and |*size|
+  // to its uncompressed data, owned by this object, and return true.
+  bool Get(const string& dwarf_name, const uint8_t** contents,
+           uint64_t* size) const;
+
+  bool empty() const { return sections_.empty(); }
+
+ private:
+  struct Section {
+    string name;
+    const uint8_t* data;
+    uint64_t data_size;
+    uint64_t size;
+    std::unique_ptr<uint8_t[]> contents;
+    bool inflated;
+  };
+
+  static bool LargerSection(const Section* a, const Section* b);
+
+  // Inflate the sections handed out by NextSection() until there are none.
+  static void* WorkerMain(void* arg);
+  Section* NextSection();
+  static bool InflateSection(Section* section);
+
+  std::vector<Section*> sections_;
+
+  // Sections to inflate, largest first, and the next one to hand out.
+  std::vector<Section*> queue_;
+  size_t next_;
+  pthread_mutex_t mutex_;
+
+  DebugSectionInflater(const DebugSectionInflater&);
+  void operator=(const DebugSectionInflater&);
+};
+
+}  // namespace google_breakpad
+
+#endif  // COMMON_LINUX_DEBUG_SECTION_INFLATER_H_
@@ -0,0 +1,255 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// debug_section_inflater_unittest.cc:
+// Unit tests for google_breakpad::DebugSectionInflater.
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>  // Must come first
+#endif
+
+#include <elf.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+#include "breakpad_googletest_includes.h"
+#include "common/linux/debug_section_inflater.h"
+#include "common/using_std_string.h"
+
+using google_breakpad::DebugSectionInflater;
+using std::vector;
+
+namespace {
+
+#ifndef SHF_COMPRESSED
+const uint64_t SHF_COMPRESSED = 1 << 11;
+#endif
+
+void AppendInteger(vector<uint8_t>* bytes, uint64_t value, size_t size,
+                   bool big_endian) {
+  for (size_t i = 0; i < size; ++i) {
+    size_t shift = big_endian ? (size - 1 - i) * 8 : i * 8;
+    bytes->push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+vector<uint8_t> MakeData(size_t size, uint8_t seed) {
+  vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<uint8_t>(seed + i % 251 + i / 4096);
+  return data;
+}
+
+#ifdef HAVE_LIBZ
+vector<uint8_t> Deflate(const vector<uint8_t>& data) {
+  uLongf size = compressBound(data.size());
+  vector<uint8_t> compressed(size);
+  EXPECT_EQ(Z_OK, compress(&compressed[0], &size, &data[0], data.size()));
+  compressed.resize(size);
+  return compressed;
+}
+#endif
+
+}  // namespace
+
+TEST(DebugSectionInflaterTest, IsCompressed) {
+  string dwarf_name;
+  EXPECT_FALSE(DebugSectionInflater::IsCompressed(".debug_info", 0,
+                                                  &dwarf_name));
+  EXPECT_TRUE(DebugSectionInflater::IsCompressed(".debug_info",
+                                                 SHF_COMPRESSED,
+                                                 &dwarf_name));
+  EXPECT_EQ(".debug_info", dwarf_name);
+  EXPECT_TRUE(DebugSectionInflater::IsCompressed(".zdebug_line", 0,
+                                                 &dwarf_name));
+  EXPECT_EQ(".debug_line", dwarf_name);
+}
+
+TEST(DebugSectionInflaterTest, RejectsBadHeaders) {
+  string dwarf_name;
+  const uint8_t* data;
+  uint64_t data_size, size;
+
+  // Unsupported compression type (ELFCOMPRESS_ZSTD).
+  vector<uint8_t> section;
+  AppendInteger(&section, 2, 4, false);
+  AppendInteger(&section, 0, 4, false);
+  AppendInteger(&section, 100, 8, false);
+  AppendInteger(&section, 1, 8, false);
+  section.resize(64);
+  EXPECT_FALSE(DebugSectionInflater::ParseHeader(
+      ".debug_info", SHF_COMPRESSED, &section[0], section.size(), false,
+      ELFCLASS64, &dwarf_name, &data, &data_size, &size));
+
+  // Truncated header.
+  EXPECT_FALSE(DebugSectionInflater::ParseHeader(
+      ".debug_info", SHF_COMPRESSED, &section[0], 8, false, ELFCLASS64,
+      &dwarf_name, &data, &data_size, &size));
+
+  // .zdebug section without its magic.
+  EXPECT_FALSE(DebugSectionInflater::ParseHeader(
+      ".zdebug_info", 0, &section[0], section.size(), false, ELFCLASS64,
+      &dwarf_name, &data, &data_size, &size));
+
+  // An uncompressed size deflate can't produce from the data.
+  section.clear();
+  section.insert(section.end(), "ZLIB", "ZLIB" + 4);
+  AppendInteger(&section, 1ULL << 40, 8, true);
+  section.resize(64);
+  EXPECT_FALSE(DebugSectionInflater::ParseHeader(
+      ".zdebug_info", 0, &section[0], section.size(), false, ELFCLASS64,
+      &dwarf_name, &data, &data_size, &size));
+}
+
+#ifdef HAVE_LIBZ
+TEST(DebugSectionInflaterTest, InflatesSections) {
+  const vector<uint8_t> info = MakeData(1 << 20, 1);
+  const vector<uint8_t> line = MakeData(10000, 2);
+  const vector<uint8_t> str = MakeData(3000, 3);
+  const vector<uint8_t> deflated_info = Deflate(info);
+  const vector<uint8_t> deflated_line = Deflate(line);
+  const vector<uint8_t> deflated_str = Deflate(str);
+
+  // .debug_info: SHF_COMPRESSED, ELFCLASS64, little-endian.
+  vector<uint8_t> info_section;
+  AppendInteger(&info_section, ELFCOMPRESS_ZLIB, 4, false);
+  AppendInteger(&info_section, 0, 4, false);
+  AppendInteger(&info_section, info.size(), 8, false);
+  AppendInteger(&info_section, 1, 8, false);
+  info_section.insert(info_section.end(), deflated_info.begin(),
+                      deflated_info.end());
+
+  // .debug_line: SHF_COMPRESSED, ELFCLASS32, big-endian.
+  vector<uint8_t> line_section;
+  AppendInteger(&line_section, ELFCOMPRESS_ZLIB, 4, true);
+  AppendInteger(&line_section, line.size(), 4, true);
+  AppendInteger(&line_section, 1, 4, true);
+  line_section.insert(line_section.end(), deflated_line.begin(),
+                      deflated_line.end());
+
+  // .zdebug_str.
+  vector<uint8_t> str_section(deflated_str.size() + 12);
+  memcpy(&str_section[0], "ZLIB", 4);
+  vector<uint8_t> str_size;
+  AppendInteger(&str_size, str.size(), 8, true);
+  memcpy(&str_section[4], &str_size[0], 8);
+  memcpy(&str_section[12], &deflated_str[0], deflated_str.size());
+
+  struct {
+    const char* name;
+    uint64_t flags;
+    const vector<uint8_t>* section;
+    bool big_endian;
+    int elf_class;
+  } sections[] = {
+    { ".debug_info", SHF_COMPRESSED, &info_section, false, ELFCLASS64 },
+    { ".debug_line", SHF_COMPRESSED, &line_section, true, ELFCLASS32 },
+    { ".zdebug_str", 0, &str_section, false, ELFCLASS64 },
+  };
+
+  DebugSectionInflater inflater;
+  EXPECT_TRUE(inflater.empty());
+  for (size_t i = 0; i < sizeof(sections) / sizeof(sections[0]); ++i) {
+    string dwarf_name;
+    const uint8_t* data;
+    uint64_t data_size, size;
+    ASSERT_TRUE(DebugSectionInflater::ParseHeader(
+        sections[i].name, sections[i].flags, &(*sections[i].section)[0],
+        sections[i].section->size(), sections[i].big_endian,
+        sections[i].elf_class, &dwarf_name, &data, &data_size, &size));
+    inflater.Add(dwarf_name, data, data_size, size);
+  }
+  EXPECT_FALSE(inflater.empty());
+  EXPECT_TRUE(inflater.Inflate(2));
+
+  const uint8_t* contents;
+  uint64_t size;
+  ASSERT_TRUE(inflater.Get(".debug_info", &contents, &size));
+  ASSERT_EQ(info.size(), size);
+  EXPECT_EQ(0, memcmp(&info[0], contents, size));
+  ASSERT_TRUE(inflater.Get(".debug_line", &contents, &size));
+  ASSERT_EQ(line.size(), size);
+  EXPECT_EQ(0, memcmp(&line[0], contents, size));
+  ASSERT_TRUE(inflater.Get(".debug_str", &contents, &size));
+  ASSERT_EQ(str.size(), size);
+  EXPECT_EQ(0, memcmp(&str[0], contents, size));
+  EXPECT_FALSE(inflater.Get(".debug_abbrev", &contents, &size));
+}
+
+TEST(DebugSectionInflaterTest, DropsCorruptSections) {
+  const vector<uint8_t> data = MakeData(5000, 4);
+  vector<uint8_t> deflated = Deflate(data);
+
+  DebugSectionInflater inflater;
+  // Wrong size.
+  inflater.Add(".debug_info", &deflated[0], deflated.size(), data.size() + 1);
+  // Truncated stream.
+  inflater.Add(".debug_line", &deflated[0], deflated.size() / 2, data.size());
+  // Fine.
+  inflater.Add(".debug_str", &deflated[0], deflated.size(), data.size());
+  EXPECT_FALSE(inflater.Inflate());
+
+  const uint8_t* contents;
+  uint64_t size;
+  EXPECT_FALSE(inflater.Get(".debug_info", &contents, &size));
+  EXPECT_FALSE(inflater.Get(".debug_line", &contents, &size));
+  ASSERT_TRUE(inflater.Get(".debug_str", &contents, &size));
+  EXPECT_EQ(0, memcmp(&data[0], contents, size));
+}
+
+TEST(DebugSectionInflaterTest, InflatesEmptySections) {
+  const vector<uint8_t> empty;
+  uLongf deflated_size = compressBound(0);
+  vector<uint8_t> deflated(deflated_size);
+  ASSERT_EQ(Z_OK, compress(&deflated[0], &deflated_size, NULL, 0));
+  deflated.resize(deflated_size);
+  const vector<uint8_t> data = MakeData(100, 5);
+  const vector<uint8_t> deflated_data = Deflate(data);
+
+  DebugSectionInflater inflater;
+  inflater.Add(".debug_ranges", &deflated[0], deflated.size(), 0);
+  // A stream that holds data, for a section that claims to be empty.
+  inflater.Add(".debug_loc", &deflated_data[0], deflated_data.size(), 0);
+  EXPECT_FALSE(inflater.Inflate());
+
+  const uint8_t* contents;
+  uint64_t size = 1;
+  ASSERT_TRUE(inflater.Get(".debug_ranges", &contents, &size));
+  EXPECT_EQ(0U, size);
+  EXPECT_FALSE(inflater.Get(".debug_loc", &contents, &size));
+}
+#endif  // HAVE_LIBZ
@@ -43,6 +43,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -50,6 +51,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <set>
 #include <string>
@@ -62,7 +65,9 @@
 #include "common/dwarf_cu_to_module.h"
 #include "common/dwarf_line_to_module.h"
 #include "common/dwarf_range_list_handler.h"
+#include "common/language.h"
 #include "common/linux/crc32.h"
+#include "common/linux/debug_section_inflater.h"
 #include "common/linux/eintr_wrapper.h"
 #include "common/linux/elfutils.h"
 #include "common/linux/elfutils-inl.h"
@@ -81,11 +86,14 @@
 // This namespace contains helper functions.
 namespace {
 
+using google_breakpad::DebugSectionInflater;
+using google_breakpad::DemangleCache;
 using google_breakpad::DumpOptions;
 using google_breakpad::DwarfCFIToModule;
 using google_breakpad::DwarfCUToModule;
 using google_breakpad::DwarfLineToModule;
 using google_breakpad::DwarfRangeListHandler;
+using google_breakpad::ELFSymbolFunctionNames;
 using google_breakpad::ElfClass;
 using google_breakpad::ElfClass32;
 using google_breakpad::ElfClass64;
@@ -286,6 +294,8 @@ bool LoadDwarf(const string& dwarf_filename,
                const typename ElfClass::Ehdr* elf_header,
                const bool big_endian,
                bool handle_inter_cu_refs,
+               const DebugSectionInflater& inflater,
+               DemangleCache* demangle_cache,
                Module* module) {
   typedef typename ElfClass::Shdr Shdr;
 
@@ -297,6 +307,7 @@ bool LoadDwarf(const string& dwarf_filename,
   DwarfCUToModule::FileContext file_context(dwarf_filename,
                                             module,
                                             handle_inter_cu_refs);
+  file_context.SetDemangleCache(demangle_cache);
 
   // Build a map of the ELF file's sections.
   const Shdr* sections =
@@ -310,7 +321,17 @@ bool LoadDwarf(const string& dwarf_filename,
                   section->sh_name;
     const uint8_t* contents = GetOffset<ElfClass, uint8_t>(elf_header,
                                                            section->sh_offset);
-    file_context.AddSectionToSectionMap(name, contents, section->sh_size);
+    uint64_t size = section->sh_size;
+    // Compressed sections are replaced by their inflated data, or left out
+    // if they could not be inflated.
+    string dwarf_name;
+    if (DebugSectionInflater::IsCompressed(name, section->sh_flags,
+                                           &dwarf_name)) {
+      if (!inflater.Get(dwarf_name, &contents, &size))
+        continue;
+      name = dwarf_name;
+    }
+    file_context.AddSectionToSectionMap(name, contents, size);
   }
 
   // .debug_ranges and .debug_rnglists reader
@@ -327,6 +348,8 @@ bool LoadDwarf(const string& dwarf_filename,
   // .debug_info section.
   assert(debug_info_section.first);
   uint64_t debug_info_length = debug_info_section.second;
+  // Compilation units may share abbreviation tables; parse each only once.
+  dwarf2reader::AbbrevTableCache abbrev_cache;
   for (uint64_t offset = 0; offset < debug_info_length;) {
     // Make a handler for the root DIE that populates MODULE with the
     // data that was found.
@@ -341,6 +364,7 @@ bool LoadDwarf(const string& dwarf_filename,
                                          offset,
                                          &byte_reader,
                                          &die_dispatcher);
+    reader.SetAbbrevTableCache(&abbrev_cache);
     // Process the entire compilation unit; get the offset of the next.
     offset += reader.Start();
   }
@@ -376,11 +400,77 @@ bool DwarfCFIRegisterNames(const typename ElfClass::Ehdr* elf_header,
   }
 }
 
+// The smallest amount of CFI data worth giving a thread of its own.
+const size_t kMinCFIBytesPerThread = 256 * 1024;
+
+// Everything needed to parse a CFI section, shared by the threads
+// parsing runs of its entries.
+struct CFISection {
+  string file;
+  const char* name;
+  const uint8_t* contents;
+  size_t size;
+  bool eh_frame;
+  dwarf2reader::Endianness endianness;
+  uint8_t address_size;
+  uint64_t address;
+  bool has_data_base;
+  uint64_t data_base;
+  bool has_text_base;
+  uint64_t text_base;
+  const std::vector<string>* register_names;
+};
+
+// A run of consecutive entries in a CFISection, and the stack frame
+// entries converted from them, in section order.
+struct CFIRun {
+  const CFISection* section;
+  size_t begin, end;
+  std::vector<Module::StackFrameEntry*> entries;
+};
+
+// Set up READER to parse SECTION's entries.
+void InitCFIByteReader(const CFISection& section,
+                       dwarf2reader::ByteReader* reader) {
+  reader->SetAddressSize(section.address_size);
+
+  // Provide the base addresses for .eh_frame encoded pointers, if
+  // possible.
+  reader->SetCFIDataBase(section.address, section.contents);
+  if (section.has_data_base)
+    reader->SetDataBase(section.data_base);
+  if (section.has_text_base)
+    reader->SetTextBase(section.text_base);
+}
+
+// Convert the entries in the CFIRun at ARG.  The parser changes its
+// ByteReader's settings as it goes, so each run has a reader of its
+// own.  Suitable for use as a pthread start routine.
+void* ParseCFIRun(void* arg) {
+  CFIRun* run = static_cast<CFIRun*>(arg);
+  const CFISection& section = *run->section;
+  dwarf2reader::ByteReader byte_reader(section.endianness);
+  InitCFIByteReader(section, &byte_reader);
+
+  DwarfCFIToModule::Reporter module_reporter(section.file, section.name);
+  DwarfCFIToModule handler(&run->entries, *section.register_names,
+                           &module_reporter);
+  dwarf2reader::CallFrameInfo::Reporter dwarf_reporter(section.file,
+                                                       section.name);
+  dwarf2reader::CallFrameInfo parser(section.contents, section.size,
+                                     &byte_reader, &handler, &dwarf_reporter,
+                                     section.eh_frame);
+  parser.Start(run->begin, run->end);
+  return NULL;
+}
+
 template<typename ElfClass>
 bool LoadDwarfCFI(const string& dwarf_filename,
                   const typename ElfClass::Ehdr* elf_header,
                   const char* section_name,
-                  const typename ElfClass::Shdr* section,
+                  const uint8_t* cfi,
+                  size_t cfi_size,
+                  typename ElfClass::Addr cfi_address,
                   const bool eh_frame,
                   const typename ElfClass::Shdr* got_section,
                   const typename ElfClass::Shdr* text_section,
@@ -396,35 +486,63 @@ bool LoadDwarfCFI(const string& dwarf_filename,
     return false;
   }
 
-  const dwarf2reader::Endianness endianness = big_endian ?
+  CFISection section;
+  section.file = dwarf_filename;
+  section.name = section_name;
+  section.contents = cfi;
+  section.size = cfi_size;
+  section.eh_frame = eh_frame;
+  section.endianness = big_endian ?
       dwarf2reader::ENDIANNESS_BIG : dwarf2reader::ENDIANNESS_LITTLE;
+  section.address_size = ElfClass::kAddrSize;
+  section.address = cfi_address;
+  section.has_data_base = got_section != NULL;
+  section.data_base = got_section ? got_section->sh_addr : 0;
+  section.has_text_base = text_section != NULL;
+  section.text_base = text_section ? text_section->sh_addr : 0;
+  section.register_names = &register_names;
+
+  // Divide the section into runs of entries to convert in parallel.
+  // Converting the runs separately and then adding their entries in
+  // section order produces exactly the entries a single pass would.
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  size_t thread_count = std::min<size_t>(cpus > 0 ? cpus : 1,
+                                         cfi_size / kMinCFIBytesPerThread);
+  std::vector<size_t> boundaries;
+  {
+    dwarf2reader::ByteReader byte_reader(section.endianness);
+    InitCFIByteReader(section, &byte_reader);
+    dwarf2reader::CallFrameInfo::Reporter dwarf_reporter(dwarf_filename,
+                                                         section_name);
+    dwarf2reader::CallFrameInfo splitter(cfi, cfi_size, &byte_reader, NULL,
+                                         &dwarf_reporter, eh_frame);
+    splitter.SplitEntries(std::max<size_t>(thread_count, 1), &boundaries);
+  }
 
-  // Find the call frame information and its size.
-  const uint8_t* cfi =
-      GetOffset<ElfClass, uint8_t>(elf_header, section->sh_offset);
-  size_t cfi_size = section->sh_size;
-
-  // Plug together the parser, handler, and their entourages.
-  DwarfCFIToModule::Reporter module_reporter(dwarf_filename, section_name);
-  DwarfCFIToModule handler(module, register_names, &module_reporter);
-  dwarf2reader::ByteReader byte_reader(endianness);
+  std::vector<CFIRun> runs(boundaries.size() - 1);
+  for (size_t i = 0; i < runs.size(); ++i) {
+    runs[i].section = &section;
+    runs[i].begin = boundaries[i];
+    runs[i].end = boundaries[i + 1];
+  }
 
-  byte_reader.SetAddressSize(ElfClass::kAddrSize);
+  // This thread converts the first run.
+  std::vector<pthread_t> threads(runs.size());
+  std::vector<bool> started(runs.size(), false);
+  for (size_t i = 1; i < runs.size(); ++i)
+    started[i] = pthread_create(&threads[i], NULL, ParseCFIRun, &runs[i]) == 0;
+  ParseCFIRun(&runs[0]);
+  for (size_t i = 1; i < runs.size(); ++i) {
+    if (started[i])
+      pthread_join(threads[i], NULL);
+    else
+      ParseCFIRun(&runs[i]);
+  }
 
-  // Provide the base addresses for .eh_frame encoded pointers, if
-  // possible.
-  byte_reader.SetCFIDataBase(section->sh_addr, cfi);
-  if (got_section)
-    byte_reader.SetDataBase(got_section->sh_addr);
-  if (text_section)
-    byte_reader.SetTextBase(text_section->sh_addr);
-
-  dwarf2reader::CallFrameInfo::Reporter dwarf_reporter(dwarf_filename,
-                                                       section_name);
-  dwarf2reader::CallFrameInfo parser(cfi, cfi_size,
-                                     &byte_reader, &handler, &dwarf_reporter,
-                                     eh_frame);
-  parser.Start();
+  for (size_t i = 0; i < runs.size(); ++i) {
+    for (size_t j = 0; j < runs[i].entries.size(); ++j)
+      module->AddStackFrameEntry(runs[i].entries[j]);
+  }
   return true;
 }
 
@@ -647,6 +765,56 @@ class LoadSymbolsInfo {
                                       // between calls to LoadSymbols().
 };
 
+// Inflate the compressed debug sections of ELF_HEADER that OPTIONS call
+// for into INFLATER.
+template<typename ElfClass>
+void InflateDebugSections(const string& obj_file,
+                          const typename ElfClass::Ehdr* elf_header,
+                          const bool big_endian,
+                          const DumpOptions& options,
+                          DebugSectionInflater* inflater) {
+  typedef typename ElfClass::Shdr Shdr;
+
+  const Shdr* sections =
+      GetOffset<ElfClass, Shdr>(elf_header, elf_header->e_shoff);
+  const Shdr* section_names = sections + elf_header->e_shstrndx;
+  const char* names =
+      GetOffset<ElfClass, char>(elf_header, section_names->sh_offset);
+  for (int i = 0; i < elf_header->e_shnum; i++) {
+    const Shdr* section = &sections[i];
+    string name = names + section->sh_name;
+    string dwarf_name;
+    if (section->sh_type == SHT_NOBITS ||
+        !DebugSectionInflater::IsCompressed(name, section->sh_flags,
+                                            &dwarf_name) ||
+        dwarf_name.compare(0, strlen(".debug_"), ".debug_") != 0) {
+      continue;
+    }
+
+    // Only .debug_frame is needed for CFI, and all but it for the rest.
+    const bool is_cfi = dwarf_name == ".debug_frame";
+    if ((options.symbol_data == ONLY_CFI && !is_cfi) ||
+        (options.symbol_data == NO_CFI && is_cfi)) {
+      continue;
+    }
+
+    const uint8_t* data;
+    uint64_t data_size, uncompressed_size;
+    if (DebugSectionInflater::ParseHeader(
+            name, section->sh_flags,
+            GetOffset<ElfClass, uint8_t>(elf_header, section->sh_offset),
+            section->sh_size, big_endian, ElfClass::kClass, &dwarf_name,
+            &data, &data_size, &uncompressed_size)) {
+      inflater->Add(dwarf_name, data, data_size, uncompressed_size);
+    }
+  }
+
+  if (!inflater->empty() && !inflater->Inflate()) {
+    fprintf(stderr, "%s: some compressed debug sections could not be "
+            "inflated\n", obj_file.c_str());
+  }
+}
+
 template<typename ElfClass>
 bool LoadSymbols(const string& obj_file,
                  const bool big_endian,
@@ -682,6 +850,13 @@ bool LoadSymbols(const string& obj_file,
   bool found_debug_info_section = false;
   bool found_usable_info = false;
 
+  // The compressed debug sections, inflated up front and in parallel.  The
+  // DWARF readers use their inflated data in place of the section contents.
+  DebugSectionInflater inflater;
+  InflateDebugSections<ElfClass>(obj_file, elf_header, big_endian, options,
+                                 &inflater);
+  string dwarf_name;
+
   if (options.symbol_data != ONLY_CFI) {
 #ifndef NO_STABS_SUPPORT
     // Look for STABS debugging information, and load it if present.
@@ -704,6 +879,32 @@ bool LoadSymbols(const string& obj_file,
     }
 #endif  // NO_STABS_SUPPORT
 
+    // Demangle the names in the symbol table, if there is one, on all
+    // CPUs up front. Most of the linkage names in the DWARF data are
+    // among them, so this leaves little demangling for the serial pass
+    // over the DWARF data, and none for the same name twice.
+    DemangleCache demangle_cache;
+    const Shdr* symtab_section =
+        FindElfSectionByName<ElfClass>(".symtab", SHT_SYMTAB,
+                                       sections, names, names_end,
+                                       elf_header->e_shnum);
+    const Shdr* strtab_section =
+        FindElfSectionByName<ElfClass>(".strtab", SHT_STRTAB,
+                                       sections, names, names_end,
+                                       elf_header->e_shnum);
+    if (symtab_section && strtab_section) {
+      vector<string> symbol_names;
+      ELFSymbolFunctionNames(
+          GetOffset<ElfClass, uint8_t>(elf_header, symtab_section->sh_offset),
+          symtab_section->sh_size,
+          GetOffset<ElfClass, uint8_t>(elf_header, strtab_section->sh_offset),
+          strtab_section->sh_size,
+          big_endian, ElfClass::kAddrSize, &symbol_names);
+      long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+      demangle_cache.Prefetch(google_breakpad::Language::CPlusPlus,
+                              symbol_names, cpus > 0 ? cpus : 1);
+    }
+
     // Look for DWARF debugging information, and load it if present.
     const Shdr* dwarf_section =
       FindElfSectionByName<ElfClass>(".debug_info", SHT_PROGBITS,
@@ -719,26 +920,30 @@ bool LoadSymbols(const string& obj_file,
                                        elf_header->e_shnum);
     }
 
-    if (dwarf_section) {
+    // A compressed .debug_info is only usable if it was inflated; a
+    // .zdebug_info section can only be found that way.
+    const uint8_t* inflated_contents;
+    uint64_t inflated_size;
+    if (dwarf_section &&
+        DebugSectionInflater::IsCompressed(".debug_info",
+                                           dwarf_section->sh_flags,
+                                           &dwarf_name)) {
+      dwarf_section = NULL;
+    }
+    if (dwarf_section ||
+        inflater.Get(".debug_info", &inflated_contents, &inflated_size)) {
       found_debug_info_section = true;
       found_usable_info = true;
       info->LoadedSection(".debug_info");
       if (!LoadDwarf<ElfClass>(obj_file, elf_header, big_endian,
-                               options.handle_inter_cu_refs, module)) {
+                               options.handle_inter_cu_refs, inflater,
+                               &demangle_cache, module)) {
         fprintf(stderr, "%s: \".debug_info\" section found, but failed to load "
                 "DWARF debugging information\n", obj_file.c_str());
       }
     }
 
     // See if there are export symbols available.
-    const Shdr* symtab_section =
-        FindElfSectionByName<ElfClass>(".symtab", SHT_SYMTAB,
-                                       sections, names, names_end,
-                                       elf_header->e_shnum);
-    const Shdr* strtab_section =
-        FindElfSectionByName<ElfClass>(".strtab", SHT_STRTAB,
-                                       sections, names, names_end,
-                                       elf_header->e_shnum);
     if (symtab_section && strtab_section) {
       info->LoadedSection(".symtab");
 
@@ -755,7 +960,8 @@ bool LoadSymbols(const string& obj_file,
                              strtab_section->sh_size,
                              big_endian,
                              ElfClass::kAddrSize,
-                             module);
+                             module,
+                             &demangle_cache);
       found_usable_info = found_usable_info || result;
     } else {
       // Look in dynsym only if full symbol table was not available.
@@ -806,15 +1012,30 @@ bool LoadSymbols(const string& obj_file,
                                         elf_header->e_shnum);
     }
 
-    if (dwarf_cfi_section) {
+    // As with .debug_info, use the inflated data of a compressed section.
+    const uint8_t* debug_frame = NULL;
+    uint64_t debug_frame_size = 0;
+    if (!inflater.Get(".debug_frame", &debug_frame, &debug_frame_size) &&
+        dwarf_cfi_section &&
+        !DebugSectionInflater::IsCompressed(".debug_frame",
+                                            dwarf_cfi_section->sh_flags,
+                                            &dwarf_name)) {
+      debug_frame = GetOffset<ElfClass, uint8_t>(elf_header,
+                                                 dwarf_cfi_section->sh_offset);
+      debug_frame_size = dwarf_cfi_section->sh_size;
+    }
+
+    if (debug_frame) {
       // Ignore the return value of this function; even without call frame
       // information, the other debugging information could be perfectly
       // useful.
       info->LoadedSection(".debug_frame");
       bool result =
           LoadDwarfCFI<ElfClass>(obj_file, elf_header, ".debug_frame",
-                                 dwarf_cfi_section, false, 0, 0, big_endian,
-                                 module);
+                                 debug_frame, debug_frame_size,
+                                 dwarf_cfi_section ?
+                                     dwarf_cfi_section->sh_addr : 0,
+                                 false, 0, 0, big_endian, module);
       found_usable_info = found_usable_info || result;
     }
 
@@ -839,7 +1060,10 @@ bool LoadSymbols(const string& obj_file,
       // As above, ignore the return value of this function.
       bool result =
           LoadDwarfCFI<ElfClass>(obj_file, elf_header, ".eh_frame",
-                                 eh_frame_section, true,
+                                 GetOffset<ElfClass, uint8_t>(
+                                     elf_header, eh_frame_section->sh_offset),
+                                 eh_frame_section->sh_size,
+                                 eh_frame_section->sh_addr, true,
                                  got_section, text_section, big_endian, module);
       found_usable_info = found_usable_info || result;
     }
@@ -996,6 +1220,8 @@ bool ReadSymbolDataElfClass(const typename ElfClass::Ehdr* elf_header,
                                        module)) {
     return false;
   }
+  module->SetFunctionMemoryBudget(options.function_memory_budget);
+  module->SetShareCFIRules(options.share_cfi_rules);
 
   // Figure out what endianness this file is.
   bool big_endian;
@@ -1034,6 +1260,55 @@ bool ReadSymbolDataElfClass(const typename ElfClass::Ehdr* elf_header,
   return true;
 }
 
+// Load the ELF file at LOAD_PATH, and set MODULE to a new Module holding
+// only its header information. Report any error and return false.
+bool InitModule(const string& load_path,
+                const string& obj_file,
+                const string& obj_os,
+                scoped_ptr<Module>& module) {
+  MmapWrapper map_wrapper;
+  void* elf_header = NULL;
+  if (!LoadELF(load_path, &map_wrapper, &elf_header)) {
+    fprintf(stderr, "Could not load ELF file: %s\n", obj_file.c_str());
+    return false;
+  }
+
+  int elfclass = ElfClass(elf_header);
+  if (elfclass == ELFCLASS32) {
+    if (!InitModuleForElfClass<ElfClass32>(
+        reinterpret_cast<const Elf32_Ehdr*>(elf_header), obj_file, obj_os,
+        module)) {
+      fprintf(stderr, "Failed to load ELF module: %s\n", obj_file.c_str());
+      return false;
+    }
+  } else if (elfclass == ELFCLASS64) {
+    if (!InitModuleForElfClass<ElfClass64>(
+        reinterpret_cast<const Elf64_Ehdr*>(elf_header), obj_file, obj_os,
+        module)) {
+      fprintf(stderr, "Failed to load ELF module: %s\n", obj_file.c_str());
+      return false;
+    }
+  } else {
+    fprintf(stderr, "Unsupported module file: %s\n", obj_file.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Create the directory PATH, and any of its parents that are missing.
+// Return true if PATH is a directory afterwards.
+bool MakeDirectories(const string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0)
+    return S_ISDIR(st.st_mode);
+  size_t slash = path.find_last_of('/');
+  if (slash != string::npos && slash > 0 &&
+      !MakeDirectories(path.substr(0, slash)))
+    return false;
+  // Another dump may have created PATH since we checked.
+  return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
 }  // namespace
 
 namespace google_breakpad {
@@ -1088,40 +1363,73 @@ bool WriteSymbolFileHeader(const string& load_path,
                            const string& obj_file,
                            const string& obj_os,
                            std::ostream& sym_stream) {
-  MmapWrapper map_wrapper;
-  void* elf_header = NULL;
-  if (!LoadELF(load_path, &map_wrapper, &elf_header)) {
-    fprintf(stderr, "Could not load ELF file: %s\n", obj_file.c_str());
+  scoped_ptr<Module> module;
+  if (!InitModule(load_path, obj_file, obj_os, module))
     return false;
-  }
+  return module->Write(sym_stream, ALL_SYMBOL_DATA);
+}
 
-  if (!IsValidElf(elf_header)) {
-    fprintf(stderr, "Not a valid ELF file: %s\n", obj_file.c_str());
+bool WriteSymbolFileToStore(const string& load_path,
+                            const string& obj_os,
+                            const std::vector<string>& debug_dirs,
+                            const DumpOptions& options,
+                            const string& store_path,
+                            string* sym_path,
+                            bool* skipped) {
+  *skipped = false;
+  scoped_ptr<Module> header;
+  if (!InitModule(load_path, load_path, obj_os, header))
+    return false;
+
+  const string& id = header->identifier();
+  if (id.find_first_not_of('0') == string::npos) {
+    fprintf(stderr, "%s: no build ID to store symbols under\n",
+            load_path.c_str());
     return false;
   }
+  string directory = store_path + "/" + header->name() + "/" + id;
+  *sym_path = directory + "/" + header->name() + ".sym";
 
-  int elfclass = ElfClass(elf_header);
-  scoped_ptr<Module> module;
-  if (elfclass == ELFCLASS32) {
-    if (!InitModuleForElfClass<ElfClass32>(
-        reinterpret_cast<const Elf32_Ehdr*>(elf_header), obj_file, obj_os,
-        module)) {
-      fprintf(stderr, "Failed to load ELF module: %s\n", obj_file.c_str());
-      return false;
-    }
-  } else if (elfclass == ELFCLASS64) {
-    if (!InitModuleForElfClass<ElfClass64>(
-        reinterpret_cast<const Elf64_Ehdr*>(elf_header), obj_file, obj_os,
-        module)) {
-      fprintf(stderr, "Failed to load ELF module: %s\n", obj_file.c_str());
-      return false;
-    }
-  } else {
-    fprintf(stderr, "Unsupported module file: %s\n", obj_file.c_str());
+  struct stat st;
+  if (stat(sym_path->c_str(), &st) == 0) {
+    *skipped = true;
+    return true;
+  }
+
+  if (!MakeDirectories(directory)) {
+    fprintf(stderr, "Failed to create directory '%s': %s\n",
+            directory.c_str(), strerror(errno));
     return false;
   }
 
-  return module->Write(sym_stream, ALL_SYMBOL_DATA);
+  // Write to a temporary file beside the final one and rename it into
+  // place, so that the store never holds a partial symbol file, even if
+  // several dumps of the same binary race.
+  string temp_path = *sym_path + ".XXXXXX";
+  int temp_fd = mkstemp(&temp_path[0]);
+  if (temp_fd < 0) {
+    fprintf(stderr, "Failed to create '%s': %s\n",
+            temp_path.c_str(), strerror(errno));
+    return false;
+  }
+  fchmod(temp_fd, 0644);
+  close(temp_fd);
+
+  std::ofstream sym_stream(temp_path.c_str());
+  bool result = WriteSymbolFile(load_path, load_path, obj_os, debug_dirs,
+                                options, sym_stream);
+  sym_stream.close();
+  if (!result || sym_stream.fail()) {
+    unlink(temp_path.c_str());
+    return false;
+  }
+  if (rename(temp_path.c_str(), sym_path->c_str()) != 0) {
+    fprintf(stderr, "Failed to rename '%s' to '%s': %s\n",
+            temp_path.c_str(), sym_path->c_str(), strerror(errno));
+    unlink(temp_path.c_str());
+    return false;
+  }
+  return true;
 }
 
 bool ReadSymbolData(const string& load_path,
@@ -49,11 +49,21 @@ class Module;
 struct DumpOptions {
   DumpOptions(SymbolData symbol_data, bool handle_inter_cu_refs)
       : symbol_data(symbol_data),
-        handle_inter_cu_refs(handle_inter_cu_refs) {
+        handle_inter_cu_refs(handle_inter_cu_refs),
+        function_memory_budget(0),
+        share_cfi_rules(false) {
   }
 
   SymbolData symbol_data;
   bool handle_inter_cu_refs;
+
+  // If non-zero, the approximate number of bytes of function and line
+  // data to hold in memory; see Module::SetFunctionMemoryBudget.
+  size_t function_memory_budget;
+
+  // If true, write each CFI rule set that several records use only once,
+  // and have the records refer to it; see Module::SetShareCFIRules.
+  bool share_cfi_rules;
 };
 
 // Find all the debugging information in OBJ_FILE, an ELF executable
@@ -78,6 +88,21 @@ bool WriteSymbolFileHeader(const string& load_path,
                            const string& obj_os,
                            std::ostream& sym_stream);
 
+// Write the symbol file for the ELF file at LOAD_PATH into the symbol
+// store rooted at STORE_PATH, as <debug_file>/<id>/<debug_file>.sym, the
+// layout SimpleSymbolSupplier reads, and set *SYM_PATH to that file's
+// path. If the file already exists, leave it alone and set *SKIPPED to
+// true, without reading LOAD_PATH's debugging information. Return true
+// on success; if an error occurs, report it and return false. This may
+// be called from several threads at once.
+bool WriteSymbolFileToStore(const string& load_path,
+                            const string& obj_os,
+                            const std::vector<string>& debug_dirs,
+                            const DumpOptions& options,
+                            const string& store_path,
+                            string* sym_path,
+                            bool* skipped);
+
 // As above, but simply return the debugging information in MODULE
 // instead of writing it to a stream. The caller owns the resulting
 // Module object and must delete it when finished.
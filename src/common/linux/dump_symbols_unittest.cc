@@ -36,6 +36,7 @@
 #include <link.h>
 #include <stdio.h>
 
+#include <fstream>
 #include <sstream>
 #include <vector>
 
@@ -45,6 +46,7 @@
 #include "common/linux/dump_symbols.h"
 #include "common/linux/synth_elf.h"
 #include "common/module.h"
+#include "common/tests/auto_tempdir.h"
 #include "common/using_std_string.h"
 
 namespace google_breakpad {
@@ -205,4 +207,67 @@ TYPED_TEST(DumpSymbols, SimpleBuildID) {
   delete module;
 }
 
+TYPED_TEST(DumpSymbols, WriteToStore) {
+  ELF elf(TypeParam::kMachine, TypeParam::kClass, kLittleEndian);
+  Section text(kLittleEndian);
+  text.Append(4096, 0);
+  elf.AddSection(".text", text, SHT_PROGBITS);
+
+  const uint8_t kExpectedIdentifierBytes[] =
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+     0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+     0x10, 0x11, 0x12, 0x13};
+  Notes notes(kLittleEndian);
+  notes.AddNote(NT_GNU_BUILD_ID, "GNU", kExpectedIdentifierBytes,
+                sizeof(kExpectedIdentifierBytes));
+  elf.AddSection(".note.gnu.build-id", notes, SHT_NOTE);
+
+  StringTable table(kLittleEndian);
+  SymbolTable syms(kLittleEndian, TypeParam::kAddrSize, table);
+  syms.AddSymbol("superfunc",
+                   (typename TypeParam::Addr)0x1000,
+                   (typename TypeParam::Addr)0x10,
+                 ELF32_ST_INFO(STB_GLOBAL, STT_FUNC),
+                 SHN_UNDEF + 1);
+  int index = elf.AddSection(".dynstr", table, SHT_STRTAB);
+  elf.AddSection(".dynsym", syms,
+                 SHT_DYNSYM,          // type
+                 SHF_ALLOC,           // flags
+                 0,                   // addr
+                 index,               // link
+                 sizeof(typename TypeParam::Sym));  // entsize
+
+  elf.Finish();
+  string contents;
+  ASSERT_TRUE(elf.GetContents(&contents));
+  AutoTempDir temp_dir;
+  string binary = temp_dir.path() + "/foo";
+  {
+    std::ofstream binary_stream(binary.c_str());
+    binary_stream << contents;
+    ASSERT_TRUE(binary_stream.good());
+  }
+
+  string store = temp_dir.path() + "/store";
+  DumpOptions options(ALL_SYMBOL_DATA, true);
+  string sym_path;
+  bool skipped = true;
+  ASSERT_TRUE(WriteSymbolFileToStore(binary, "Linux", vector<string>(),
+                                     options, store, &sym_path, &skipped));
+  EXPECT_FALSE(skipped);
+  EXPECT_EQ(store + "/foo/030201000504070608090A0B0C0D0E0F0/foo.sym",
+            sym_path);
+
+  std::ifstream sym_stream(sym_path.c_str());
+  string first_line;
+  std::getline(sym_stream, first_line);
+  EXPECT_EQ(string("MODULE Linux ") + TypeParam::kMachineName
+            + " 030201000504070608090A0B0C0D0E0F0 foo", first_line);
+
+  // A second run finds the symbol file already in the store.
+  ASSERT_TRUE(WriteSymbolFileToStore(binary, "Linux", vector<string>(),
+                                     options, store, &sym_path, &skipped));
+  EXPECT_TRUE(skipped);
+}
+
 }  // namespace google_breakpad
@@ -36,6 +36,8 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <algorithm>
+
 namespace google_breakpad {
 
 // Implementation of ElfCoreDump::Note.
@@ -96,10 +98,14 @@ size_t ElfCoreDump::Note::AlignedSize(size_t size) {
 
 // Implementation of ElfCoreDump.
 
-ElfCoreDump::ElfCoreDump() : proc_mem_fd_(-1) {}
+ElfCoreDump::ElfCoreDump()
+    : load_segments_indexed_(false), last_load_segment_(0), proc_mem_fd_(-1) {}
 
 ElfCoreDump::ElfCoreDump(const MemoryRange& content)
-    : content_(content), proc_mem_fd_(-1) {}
+    : content_(content),
+      load_segments_indexed_(false),
+      last_load_segment_(0),
+      proc_mem_fd_(-1) {}
 
 ElfCoreDump::~ElfCoreDump() {
   if (proc_mem_fd_ != -1) {
@@ -110,6 +116,9 @@ ElfCoreDump::~ElfCoreDump() {
 
 void ElfCoreDump::SetContent(const MemoryRange& content) {
   content_ = content;
+  load_segments_.clear();
+  load_segments_indexed_ = false;
+  last_load_segment_ = 0;
 }
 
 void ElfCoreDump::SetProcMem(int fd) {
@@ -160,28 +169,81 @@ unsigned ElfCoreDump::GetProgramHeaderCount() const {
   return header ? header->e_phnum : 0;
 }
 
-bool ElfCoreDump::CopyData(void* buffer, Addr virtual_address, size_t length) {
+void ElfCoreDump::IndexLoadSegments() {
+  load_segments_.clear();
   for (unsigned i = 0, n = GetProgramHeaderCount(); i < n; ++i) {
     const Phdr* program = GetProgramHeader(i);
-    if (program->p_type != PT_LOAD)
+    if (!program || program->p_type != PT_LOAD || program->p_filesz == 0)
       continue;
 
-    size_t offset_in_segment = virtual_address - program->p_vaddr;
-    if (virtual_address >= program->p_vaddr &&
-        offset_in_segment < program->p_filesz) {
-      const void* data =
-          content_.GetData(program->p_offset + offset_in_segment, length);
-      if (data) {
-        memcpy(buffer, data, length);
-        return true;
-      }
-    }
+    LoadSegment segment;
+    segment.start = program->p_vaddr;
+    segment.end = program->p_vaddr + program->p_filesz;
+    segment.offset = program->p_offset;
+    if (segment.end > segment.start)
+      load_segments_.push_back(segment);
+  }
+  std::sort(load_segments_.begin(), load_segments_.end());
+  load_segments_indexed_ = true;
+  last_load_segment_ = 0;
+}
+
+ptrdiff_t ElfCoreDump::FindLoadSegment(Addr address) {
+  if (last_load_segment_ < load_segments_.size()) {
+    const LoadSegment& last = load_segments_[last_load_segment_];
+    if (address >= last.start && address < last.end)
+      return last_load_segment_;
+  }
+
+  // Find the last segment starting at or before |address|.
+  size_t low = 0, high = load_segments_.size();
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    if (load_segments_[middle].start <= address)
+      low = middle + 1;
+    else
+      high = middle;
   }
+  if (low == 0 || address >= load_segments_[low - 1].end)
+    return -1;
+  last_load_segment_ = low - 1;
+  return last_load_segment_;
+}
+
+bool ElfCoreDump::CopyData(void* buffer, Addr virtual_address, size_t length) {
+  if (!load_segments_indexed_)
+    IndexLoadSegments();
+
+  uint8_t* dest = static_cast<uint8_t*>(buffer);
+  ptrdiff_t index = FindLoadSegment(virtual_address);
+  while (length > 0 && index >= 0 &&
+         static_cast<size_t>(index) < load_segments_.size()) {
+    const LoadSegment& segment = load_segments_[index];
+    if (virtual_address < segment.start || virtual_address >= segment.end)
+      break;
+
+    size_t offset_in_segment = virtual_address - segment.start;
+    size_t chunk = std::min<Addr>(length, segment.end - virtual_address);
+    const void* data =
+        content_.GetData(segment.offset + offset_in_segment, chunk);
+    if (!data)
+      break;
+
+    memcpy(dest, data, chunk);
+    dest += chunk;
+    virtual_address += chunk;
+    length -= chunk;
+    // Data spanning several segments continues in the next one, if it is
+    // adjacent.
+    ++index;
+  }
+  if (length == 0)
+    return true;
 
   /* fallback: if available, read from /proc/<pid>/mem */
   if (proc_mem_fd_ != -1) {
     off_t offset = virtual_address;
-    ssize_t r = pread(proc_mem_fd_, buffer, length, offset);
+    ssize_t r = pread(proc_mem_fd_, dest, length, offset);
     if (r < ssize_t(length)) {
       return false;
     }
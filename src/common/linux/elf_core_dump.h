@@ -38,6 +38,8 @@
 #include <link.h>
 #include <stddef.h>
 
+#include <vector>
+
 #include "common/memory_range.h"
 
 namespace google_breakpad {
@@ -133,8 +135,12 @@ class ElfCoreDump {
 
   // Copies |length| bytes of data starting at |virtual_address| in the core
   // dump to |buffer|. |buffer| should be a valid pointer to a buffer of at
-  // least |length| bytes. Returns true if the data to be copied is found in
-  // the core dump, or false otherwise.
+  // least |length| bytes. The data may span several adjacent PT_LOAD
+  // segments. Returns true if the data to be copied is found in the core
+  // dump, or false otherwise.
+  //
+  // The PT_LOAD segments are indexed on the first call, so that each call
+  // takes logarithmic time in the number of segments.
   bool CopyData(void* buffer, Addr virtual_address, size_t length);
 
   // Returns the first note found in the note section of the core dump, or
@@ -145,9 +151,37 @@ class ElfCoreDump {
   void SetProcMem(const int fd);
 
  private:
+  // The file data of a PT_LOAD segment: virtual addresses [start, end)
+  // are stored at |offset| in the core dump.
+  struct LoadSegment {
+    Addr start;
+    Addr end;
+    size_t offset;
+
+    bool operator<(const LoadSegment& other) const {
+      return start < other.start;
+    }
+  };
+
+  // Fills |load_segments_|, sorted by address.
+  void IndexLoadSegments();
+
+  // Returns the index in |load_segments_| of the segment containing
+  // |address|, or -1.
+  ptrdiff_t FindLoadSegment(Addr address);
+
   // Core dump content.
   MemoryRange content_;
 
+  // PT_LOAD segments with data, and whether they have been indexed since
+  // |content_| was set.
+  std::vector<LoadSegment> load_segments_;
+  bool load_segments_indexed_;
+
+  // Index of the segment in which the last lookup succeeded.  Consecutive
+  // reads, e.g. of a stack, tend to hit the same segment.
+  size_t last_load_segment_;
+
   // Descriptor for /proc/<pid>/mem.
   int proc_mem_fd_;
 };
@@ -33,6 +33,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "breakpad_googletest_includes.h"
 #include "common/linux/elf_core_dump.h"
@@ -263,3 +264,71 @@ TEST(ElfCoreDumpTest, ValidCoreFile) {
   EXPECT_EQ(num_pr_fpvalid, num_nt_prxfpreg);
 #endif
 }
+
+TEST(ElfCoreDumpTest, CopyData) {
+  // A core dump with three PT_LOAD segments, out of address order: two
+  // adjacent ones at [0x1000, 0x3000) and one at [0x5000, 0x6000).  Each
+  // byte of data holds the low bits of its page number plus its offset.
+  const size_t kPageSize = 0x1000;
+  const ElfCoreDump::Addr kAddresses[] = { 0x5000, 0x2000, 0x1000 };
+  const size_t kNumSegments = sizeof(kAddresses) / sizeof(kAddresses[0]);
+  const size_t kDataOffset = kPageSize;
+  std::vector<uint8_t> content(kDataOffset + kNumSegments * kPageSize);
+
+  ElfCoreDump::Ehdr* header =
+      reinterpret_cast<ElfCoreDump::Ehdr*>(&content[0]);
+  header->e_ident[0] = ELFMAG0;
+  header->e_ident[1] = ELFMAG1;
+  header->e_ident[2] = ELFMAG2;
+  header->e_ident[3] = ELFMAG3;
+  header->e_ident[4] = ElfCoreDump::kClass;
+  header->e_version = EV_CURRENT;
+  header->e_type = ET_CORE;
+  header->e_phoff = sizeof(ElfCoreDump::Ehdr);
+  header->e_phentsize = sizeof(ElfCoreDump::Phdr);
+  header->e_phnum = kNumSegments;
+  ElfCoreDump::Phdr* programs = reinterpret_cast<ElfCoreDump::Phdr*>(
+      &content[sizeof(ElfCoreDump::Ehdr)]);
+  for (size_t i = 0; i < kNumSegments; ++i) {
+    programs[i].p_type = PT_LOAD;
+    programs[i].p_vaddr = kAddresses[i];
+    programs[i].p_offset = kDataOffset + i * kPageSize;
+    programs[i].p_filesz = programs[i].p_memsz = kPageSize;
+    for (size_t j = 0; j < kPageSize; ++j) {
+      content[programs[i].p_offset + j] =
+          static_cast<uint8_t>((kAddresses[i] >> 12) + j);
+    }
+  }
+
+  ElfCoreDump core(MemoryRange(&content[0], content.size()));
+  ASSERT_TRUE(core.IsValid());
+
+  uint8_t buffer[2 * 0x1000];
+  ASSERT_TRUE(core.CopyData(buffer, 0x1010, 16));
+  EXPECT_EQ(static_cast<uint8_t>(1 + 0x10), buffer[0]);
+  EXPECT_EQ(static_cast<uint8_t>(1 + 0x1f), buffer[15]);
+
+  ASSERT_TRUE(core.CopyData(buffer, 0x5ff0, 16));
+  EXPECT_EQ(static_cast<uint8_t>(5 + 0xf0), buffer[0]);
+
+  // Spanning the two adjacent segments.
+  ASSERT_TRUE(core.CopyData(buffer, 0x1ff8, 16));
+  EXPECT_EQ(static_cast<uint8_t>(1 + 0xff8), buffer[0]);
+  EXPECT_EQ(static_cast<uint8_t>(1 + 0xfff), buffer[7]);
+  EXPECT_EQ(static_cast<uint8_t>(2 + 0), buffer[8]);
+  ASSERT_TRUE(core.CopyData(buffer, 0x1000, sizeof(buffer)));
+  EXPECT_EQ(static_cast<uint8_t>(2 + 0xfff), buffer[sizeof(buffer) - 1]);
+
+  // Outside of the segments, or running into a gap.
+  EXPECT_FALSE(core.CopyData(buffer, 0x0ff8, 16));
+  EXPECT_FALSE(core.CopyData(buffer, 0x2ff8, 16));
+  EXPECT_FALSE(core.CopyData(buffer, 0x4000, 16));
+  EXPECT_FALSE(core.CopyData(buffer, 0x6000, 1));
+
+  // Data set later replaces the index.
+  programs[0].p_vaddr = 0x7000;
+  core.SetContent(MemoryRange(&content[0], content.size()));
+  EXPECT_FALSE(core.CopyData(buffer, 0x5000, 16));
+  ASSERT_TRUE(core.CopyData(buffer, 0x7000, 16));
+  EXPECT_EQ(static_cast<uint8_t>(5 + 0), buffer[0]);
+}
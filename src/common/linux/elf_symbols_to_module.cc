@@ -36,9 +36,11 @@
 #include "common/linux/elf_symbols_to_module.h"
 
 #include <cxxabi.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "common/byte_cursor.h"
+#include "common/language.h"
 #include "common/module.h"
 
 namespace google_breakpad {
@@ -136,40 +138,63 @@ const char* SymbolString(ptrdiff_t offset, ByteBuffer& strings) {
   return reinterpret_cast<const char*>(strings.start + offset);
 }
 
+// Return a ByteBuffer covering the STRING_SIZE bytes of symbol names at
+// STRING_SECTION, ending at its last null character.
+ByteBuffer SymbolStrings(const uint8_t* string_section, size_t string_size) {
+  // Ensure that the string section is null-terminated.
+  if (string_section[string_size - 1] != '\0') {
+    const void* null_terminator = memrchr(string_section, '\0', string_size);
+    string_size = reinterpret_cast<const uint8_t*>(null_terminator)
+      - string_section;
+  }
+  return ByteBuffer(string_section, string_size);
+}
+
+// Demangle NAME as ELFSymbolsToModule always has: with __cxa_demangle,
+// whatever NAME looks like. Leave NAME unchanged if that fails.
+void DemangleSymbolName(string* name) {
+#if !defined(__ANDROID__)  // Android NDK doesn't provide abi::__cxa_demangle.
+  int status = 0;
+  char* demangled =
+      abi::__cxa_demangle(name->c_str(), NULL, NULL, &status);
+  if (demangled) {
+    if (status == 0)
+      *name = demangled;
+    free(demangled);
+  }
+#endif
+}
+
 bool ELFSymbolsToModule(const uint8_t* symtab_section,
                         size_t symtab_size,
                         const uint8_t* string_section,
                         size_t string_size,
                         const bool big_endian,
                         size_t value_size,
-                        Module* module) {
+                        Module* module,
+                        DemangleCache* demangle_cache) {
   ByteBuffer symbols(symtab_section, symtab_size);
-  // Ensure that the string section is null-terminated.
-  if (string_section[string_size - 1] != '\0') {
-    const void* null_terminator = memrchr(string_section, '\0', string_size);
-    string_size = reinterpret_cast<const uint8_t*>(null_terminator)
-      - string_section;
-  }
-  ByteBuffer strings(string_section, string_size);
+  ByteBuffer strings = SymbolStrings(string_section, string_size);
 
   // The iterator walking the symbol table.
   ELFSymbolIterator iterator(&symbols, big_endian, value_size);
 
+  string demangled;
   while(!iterator->at_end) {
     if (ELF32_ST_TYPE(iterator->info) == STT_FUNC &&
         iterator->shndx != SHN_UNDEF) {
       Module::Extern* ext = new Module::Extern(iterator->value);
       ext->name = SymbolString(iterator->name_offset, strings);
-#if !defined(__ANDROID__)  // Android NDK doesn't provide abi::__cxa_demangle.
-      int status = 0;
-      char* demangled =
-          abi::__cxa_demangle(ext->name.c_str(), NULL, NULL, &status);
-      if (demangled) {
-        if (status == 0)
-          ext->name = demangled;
-        free(demangled);
-      }
-#endif
+      // The cache only covers names that look mangled to the C++
+      // language; __cxa_demangle gets the final word on the rest.
+      Language::DemangleResult result = demangle_cache ?
+          demangle_cache->Demangle(Language::CPlusPlus, ext->name,
+                                   &demangled) :
+          Language::kDontDemangle;
+      if (result == Language::kDemangleSuccess)
+        ext->name = demangled;
+      else if (result == Language::kDontDemangle)
+        DemangleSymbolName(&ext->name);
       module->AddExtern(ext);
     }
     ++iterator;
@@ -177,4 +202,21 @@ bool ELFSymbolsToModule(const uint8_t* symtab_section,
   return true;
 }
 
+void ELFSymbolFunctionNames(const uint8_t* symtab_section,
+                            size_t symtab_size,
+                            const uint8_t* string_section,
+                            size_t string_size,
+                            const bool big_endian,
+                            size_t value_size,
+                            std::vector<string>* names) {
+  ByteBuffer symbols(symtab_section, symtab_size);
+  ByteBuffer strings = SymbolStrings(string_section, string_size);
+  for (ELFSymbolIterator iterator(&symbols, big_endian, value_size);
+       !iterator->at_end; ++iterator) {
+    if (ELF32_ST_TYPE(iterator->info) == STT_FUNC &&
+        iterator->shndx != SHN_UNDEF)
+      names->push_back(SymbolString(iterator->name_offset, strings));
+  }
+}
+
 }  // namespace google_breakpad
@@ -40,17 +40,37 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <string>
+#include <vector>
+
+#include "common/using_std_string.h"
+
 namespace google_breakpad {
 
+class DemangleCache;
 class Module;
 
+// Add an Extern to MODULE for each function symbol in the ELF symbol
+// table SYMTAB_SECTION, whose names are in STRING_SECTION. If
+// DEMANGLE_CACHE is non-NULL, demangle C++ names through it.
 bool ELFSymbolsToModule(const uint8_t* symtab_section,
                         size_t symtab_size,
                         const uint8_t* string_section,
                         size_t string_size,
                         const bool big_endian,
                         size_t value_size,
-                        Module* module);
+                        Module* module,
+                        DemangleCache* demangle_cache = NULL);
+
+// Append to NAMES the name of each function symbol that
+// ELFSymbolsToModule would add for the same symbol table.
+void ELFSymbolFunctionNames(const uint8_t* symtab_section,
+                            size_t symtab_size,
+                            const uint8_t* string_section,
+                            size_t string_size,
+                            const bool big_endian,
+                            size_t value_size,
+                            std::vector<string>* names);
 
 }  // namespace google_breakpad
 
@@ -39,6 +39,8 @@
 #include <string.h>
 
 #include <iostream>
+#include <queue>
+#include <sstream>
 #include <utility>
 
 namespace google_breakpad {
@@ -46,6 +48,269 @@ namespace google_breakpad {
 using std::dec;
 using std::hex;
 
+namespace {
+
+// Functions spilled to temporary files are stored as a length-prefixed
+// record per function.  Integers are unsigned LEB128; addresses and
+// line numbers are stored as deltas from the previous value, zigzag
+// encoded so that small negative deltas stay small too.
+void PutUnsigned(uint64_t value, string* record) {
+  while (value >= 0x80) {
+    record->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  record->push_back(static_cast<char>(value));
+}
+
+void PutSigned(uint64_t delta, string* record) {
+  const int64_t value = static_cast<int64_t>(delta);
+  PutUnsigned((static_cast<uint64_t>(value) << 1) ^ (value >> 63), record);
+}
+
+// Decodes the fields of a single spilled function record.
+class RecordReader {
+ public:
+  explicit RecordReader(const string& record)
+      : cursor_(record.data()), end_(record.data() + record.size()),
+        ok_(true) { }
+
+  uint64_t Unsigned() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (cursor_ == end_)
+        break;
+      const uint8_t byte = static_cast<uint8_t>(*cursor_++);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return value;
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  uint64_t Signed() {
+    const uint64_t value = Unsigned();
+    return (value >> 1) ^ (0 - (value & 1));
+  }
+
+  string Bytes(uint64_t length) {
+    if (length > static_cast<uint64_t>(end_ - cursor_)) {
+      ok_ = false;
+      return string();
+    }
+    string bytes(cursor_, length);
+    cursor_ += length;
+    return bytes;
+  }
+
+  // True if every field read so far was well-formed, and the record
+  // has been consumed exactly.
+  bool Finished() const { return ok_ && cursor_ == end_; }
+  bool ok() const { return ok_; }
+
+ private:
+  const char* cursor_;
+  const char* end_;
+  bool ok_;
+};
+
+// Read a length-prefixed record from FILE into RECORD.  Return false
+// at the end of the file or on error, setting *ERROR in the latter case.
+bool ReadRecord(FILE* file, string* record, bool* error) {
+  uint64_t length = 0;
+  int c = EOF;
+  for (int shift = 0; shift < 64; shift += 7) {
+    c = getc(file);
+    if (c == EOF)
+      break;
+    length |= static_cast<uint64_t>(c & 0x7f) << shift;
+    if (!(c & 0x80))
+      break;
+  }
+  if (c == EOF || (c & 0x80)) {
+    // Running out of data before the first byte is the normal end of
+    // the run; anywhere else, the run is damaged.
+    if (length != 0 || c != EOF || ferror(file))
+      *error = true;
+    return false;
+  }
+  record->resize(length);
+  if (length && fread(&(*record)[0], 1, length, file) != length) {
+    *error = true;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+// Merges the runs of spilled functions with those still in memory,
+// yielding each function in FunctionCompare order.  Where several
+// functions compare equal, only the one added first is produced, as if
+// they had all been inserted into a single FunctionSet.
+class Module::FunctionMerger {
+ public:
+  explicit FunctionMerger(Module* module)
+      : module_(module), sources_(module->function_runs_.size() + 1),
+        queue_(SourceCompare(&sources_)), last_(kNone), error_(false) {
+    for (size_t i = 0; i < module->function_runs_.size(); i++) {
+      sources_[i].run = module->function_runs_[i];
+      rewind(sources_[i].run);
+    }
+    Source& memory = sources_.back();
+    memory.run = NULL;
+    memory.next = module->functions_.begin();
+    for (size_t i = 0; i < sources_.size(); i++) {
+      if (Advance(i))
+        queue_.push(i);
+    }
+  }
+
+  ~FunctionMerger() {
+    for (size_t i = 0; i < sources_.size(); i++) {
+      if (sources_[i].run)
+        delete sources_[i].current;
+    }
+  }
+
+  // Return the next function, or NULL if there are no more or an error
+  // occurred.  The function remains valid until the next call.
+  Function* Next() {
+    if (last_ != kNone) {
+      if (Advance(last_))
+        queue_.push(last_);
+      last_ = kNone;
+    }
+    if (error_ || queue_.empty())
+      return NULL;
+    last_ = queue_.top();
+    queue_.pop();
+    Function* function = sources_[last_].current;
+
+    // Drop any later duplicates of FUNCTION.
+    FunctionCompare less;
+    while (!queue_.empty() &&
+           !less(function, sources_[queue_.top()].current)) {
+      const size_t duplicate = queue_.top();
+      queue_.pop();
+      if (Advance(duplicate))
+        queue_.push(duplicate);
+    }
+    return error_ ? NULL : function;
+  }
+
+  // Return true if reading a run failed.
+  bool error() const { return error_; }
+
+ private:
+  static const size_t kNone = static_cast<size_t>(-1);
+
+  // A run of spilled functions, or, if RUN is NULL, the functions in
+  // memory.
+  struct Source {
+    Source() : run(NULL), current(NULL) { }
+    FILE* run;
+    FunctionSet::const_iterator next;
+    Function* current;
+  };
+
+  // Orders sources for a max-heap so that the top is the source whose
+  // current function comes first, preferring earlier sources on ties.
+  class SourceCompare {
+   public:
+    explicit SourceCompare(const vector<Source>* sources)
+        : sources_(sources) { }
+    bool operator()(size_t a, size_t b) const {
+      const Function* x = (*sources_)[a].current;
+      const Function* y = (*sources_)[b].current;
+      FunctionCompare less;
+      if (less(y, x))
+        return true;
+      if (less(x, y))
+        return false;
+      return a > b;
+    }
+
+   private:
+    const vector<Source>* sources_;
+  };
+
+  // Make the source at INDEX refer to its next function, freeing the
+  // current one if it came from a run.  Return false if the source is
+  // exhausted.
+  bool Advance(size_t index) {
+    Source& source = sources_[index];
+    if (!source.run) {
+      if (source.next == module_->functions_.end()) {
+        source.current = NULL;
+        return false;
+      }
+      source.current = *source.next++;
+      return true;
+    }
+    delete source.current;
+    source.current = ReadFunction(source.run);
+    return source.current != NULL;
+  }
+
+  // Read the next function from RUN; return NULL at the end of the run
+  // or on error.
+  Function* ReadFunction(FILE* run) {
+    if (!ReadRecord(run, &record_, &error_))
+      return NULL;
+    RecordReader reader(record_);
+    const Address address = reader.Unsigned();
+    const string name = reader.Bytes(reader.Unsigned());
+    Function* function = new Function(name, address);
+    function->parameter_size = reader.Unsigned();
+
+    uint64_t count = reader.Unsigned();
+    Address previous = address;
+    for (uint64_t i = 0; i < count && reader.ok(); i++) {
+      const Address range_address = previous + reader.Signed();
+      function->ranges.push_back(Range(range_address, reader.Unsigned()));
+      previous = range_address;
+    }
+
+    count = reader.Unsigned();
+    const vector<File*>& files = module_->spilled_files_;
+    previous = address;
+    int number = 0;
+    for (uint64_t i = 0; i < count && reader.ok(); i++) {
+      Line line;
+      line.address = previous + reader.Signed();
+      line.size = reader.Unsigned();
+      line.number = number + static_cast<int>(reader.Signed());
+      const uint64_t file = reader.Unsigned();
+      line.file = file < files.size() ? files[file] : NULL;
+      if (!line.file)
+        break;
+      function->lines.push_back(line);
+      previous = line.address;
+      number = line.number;
+    }
+
+    if (!reader.Finished()) {
+      error_ = true;
+      delete function;
+      return NULL;
+    }
+    return function;
+  }
+
+  Module* module_;
+  vector<Source> sources_;
+  std::priority_queue<size_t, vector<size_t>, SourceCompare> queue_;
+
+  // The source of the function most recently returned by Next, or kNone.
+  size_t last_;
+
+  // Scratch space for reading records.
+  string record_;
+
+  bool error_;
+};
+
 
 Module::Module(const string& name, const string& os,
                const string& architecture, const string& id,
@@ -55,7 +320,10 @@ Module::Module(const string& name, const string& os,
     architecture_(architecture),
     id_(id),
     code_id_(code_id),
-    load_address_(0) { }
+    load_address_(0),
+    function_memory_budget_(0),
+    function_memory_usage_(0),
+    share_cfi_rules_(false) { }
 
 Module::~Module() {
   for (FileByNameMap::iterator it = files_.begin(); it != files_.end(); ++it)
@@ -70,6 +338,10 @@ Module::~Module() {
   }
   for (ExternSet::iterator it = externs_.begin(); it != externs_.end(); ++it)
     delete *it;
+  for (vector<FILE*>::iterator it = function_runs_.begin();
+       it != function_runs_.end(); ++it) {
+    fclose(*it);
+  }
 }
 
 void Module::SetLoadAddress(Address address) {
@@ -80,6 +352,14 @@ void Module::SetAddressRanges(const vector<Range>& ranges) {
   address_ranges_ = ranges;
 }
 
+void Module::SetFunctionMemoryBudget(size_t budget) {
+  function_memory_budget_ = budget;
+}
+
+void Module::SetShareCFIRules(bool share) {
+  share_cfi_rules_ = share;
+}
+
 void Module::AddFunction(Function* function) {
   // FUNC lines must not hold an empty name, so catch the problem early if
   // callers try to add one.
@@ -121,6 +401,10 @@ void Module::AddFunction(Function* function) {
     // Free the duplicate that was not inserted because this Module
     // now owns it.
     delete function;
+  } else if (ret.second && function_memory_budget_) {
+    function_memory_usage_ += FunctionMemoryUsage(*function);
+    if (function_memory_usage_ > function_memory_budget_)
+      SpillFunctions();
   }
 }
 
@@ -212,9 +496,8 @@ void Module::AssignSourceIds() {
 
   // Next, mark all files actually cited by our functions' line number
   // info, by setting each one's source id to zero.
-  for (FunctionSet::const_iterator func_it = functions_.begin();
-       func_it != functions_.end(); ++func_it) {
-    Function* func = *func_it;
+  FunctionMerger merger(this);
+  while (Function* func = merger.Next()) {
     for (vector<Line>::iterator line_it = func->lines.begin();
          line_it != func->lines.end(); ++line_it)
       line_it->file->source_id = 0;
@@ -238,6 +521,118 @@ bool Module::ReportError() {
   return false;
 }
 
+size_t Module::FunctionMemoryUsage(const Function& function) {
+  // Count the function, its set node, and its vectors' and name's storage.
+  return sizeof(Function) + 4 * sizeof(void*) +
+      function.name.capacity() +
+      function.ranges.capacity() * sizeof(Range) +
+      function.lines.capacity() * sizeof(Line);
+}
+
+bool Module::SpillFunctions() {
+  FILE* run = tmpfile();
+  if (!run) {
+    fprintf(stderr, "error creating temporary file for functions: %s\n",
+            strerror(errno));
+    function_memory_budget_ = 0;
+    return false;
+  }
+
+  string record;
+  string length;
+  for (FunctionSet::const_iterator func_it = functions_.begin();
+       func_it != functions_.end(); ++func_it) {
+    const Function* func = *func_it;
+    record.clear();
+    PutUnsigned(func->address, &record);
+    PutUnsigned(func->name.size(), &record);
+    record.append(func->name);
+    PutUnsigned(func->parameter_size, &record);
+
+    PutUnsigned(func->ranges.size(), &record);
+    Address previous = func->address;
+    for (vector<Range>::const_iterator range_it = func->ranges.begin();
+         range_it != func->ranges.end(); ++range_it) {
+      PutSigned(range_it->address - previous, &record);
+      PutUnsigned(range_it->size, &record);
+      previous = range_it->address;
+    }
+
+    PutUnsigned(func->lines.size(), &record);
+    previous = func->address;
+    int number = 0;
+    for (vector<Line>::const_iterator line_it = func->lines.begin();
+         line_it != func->lines.end(); ++line_it) {
+      PutSigned(line_it->address - previous, &record);
+      PutUnsigned(line_it->size, &record);
+      PutSigned(static_cast<int64_t>(line_it->number) - number, &record);
+      std::pair<map<const File*, uint64_t>::iterator, bool> file =
+          spilled_file_indices_.insert(
+              std::make_pair(line_it->file, spilled_files_.size()));
+      if (file.second)
+        spilled_files_.push_back(line_it->file);
+      PutUnsigned(file.first->second, &record);
+      previous = line_it->address;
+      number = line_it->number;
+    }
+
+    length.clear();
+    PutUnsigned(record.size(), &length);
+    if (fwrite(length.data(), 1, length.size(), run) != length.size() ||
+        fwrite(record.data(), 1, record.size(), run) != record.size())
+      break;
+  }
+
+  if (fflush(run) != 0 || ferror(run)) {
+    fprintf(stderr, "error writing temporary file for functions: %s\n",
+            strerror(errno));
+    fclose(run);
+    function_memory_budget_ = 0;
+    return false;
+  }
+
+  function_runs_.push_back(run);
+  for (FunctionSet::iterator func_it = functions_.begin();
+       func_it != functions_.end(); ++func_it) {
+    delete *func_it;
+  }
+  functions_.clear();
+  function_memory_usage_ = 0;
+  return true;
+}
+
+bool Module::WriteFunction(const Function& func, std::ostream& stream) {
+  vector<Line>::const_iterator line_it = func.lines.begin();
+  for (auto range_it = func.ranges.cbegin();
+       range_it != func.ranges.cend(); ++range_it) {
+    stream << "FUNC " << hex
+           << (range_it->address - load_address_) << " "
+           << range_it->size << " "
+           << func.parameter_size << " "
+           << func.name << dec << "\n";
+
+    if (!stream.good())
+      return false;
+
+    while ((line_it != func.lines.end()) &&
+           (line_it->address >= range_it->address) &&
+           (line_it->address < (range_it->address + range_it->size))) {
+      stream << hex
+             << (line_it->address - load_address_) << " "
+             << line_it->size << " "
+             << dec
+             << line_it->number << " "
+             << line_it->file->source_id << "\n";
+
+      if (!stream.good())
+        return false;
+
+      ++line_it;
+    }
+  }
+  return true;
+}
+
 bool Module::WriteRuleMap(const RuleMap& rule_map, std::ostream& stream) {
   for (RuleMap::const_iterator it = rule_map.begin();
        it != rule_map.end(); ++it) {
@@ -248,6 +643,81 @@ bool Module::WriteRuleMap(const RuleMap& rule_map, std::ostream& stream) {
   return stream.good();
 }
 
+bool Module::WriteSharedCFIRules(std::ostream& stream) {
+  // Render every record's rule set, in record order. RULE_SETS maps each
+  // distinct rule set to the number of records using it, and to one more
+  // than its index in the table, or zero if it is to be written inline.
+  typedef map<string, std::pair<size_t, size_t> > RuleSetTable;
+  RuleSetTable rule_sets;
+  vector<RuleSetTable::iterator> record_rules;
+  std::ostringstream rule_stream;
+  for (vector<StackFrameEntry*>::const_iterator frame_it =
+           stack_frame_entries_.begin();
+       frame_it != stack_frame_entries_.end(); ++frame_it) {
+    StackFrameEntry* entry = *frame_it;
+    const RuleMap* rule_map = &entry->initial_rules;
+    RuleChangeMap::const_iterator delta_it = entry->rule_changes.begin();
+    while (true) {
+      rule_stream.str(string());
+      WriteRuleMap(*rule_map, rule_stream);
+      RuleSetTable::iterator rule_set = rule_sets.insert(
+          std::make_pair(rule_stream.str(), std::make_pair(0, 0))).first;
+      rule_set->second.first++;
+      record_rules.push_back(rule_set);
+      if (delta_it == entry->rule_changes.end())
+        break;
+      rule_map = &delta_it->second;
+      ++delta_it;
+    }
+  }
+
+  // Define the rule sets used more than once, numbered in the order of
+  // their first use. Rule sets used only once, and empty ones, are
+  // cheaper written inline.
+  size_t next_index = 0;
+  for (vector<RuleSetTable::iterator>::const_iterator it =
+           record_rules.begin();
+       it != record_rules.end(); ++it) {
+    std::pair<size_t, size_t>& uses = (*it)->second;
+    if (uses.first < 2 || uses.second != 0 || (*it)->first.empty())
+      continue;
+    uses.second = ++next_index;
+    stream << "STACK CFI RULES " << hex << uses.second - 1 << dec << " "
+           << (*it)->first << "\n";
+    if (!stream.good())
+      return false;
+  }
+
+  vector<RuleSetTable::iterator>::const_iterator rules_it =
+      record_rules.begin();
+  for (vector<StackFrameEntry*>::const_iterator frame_it =
+           stack_frame_entries_.begin();
+       frame_it != stack_frame_entries_.end(); ++frame_it) {
+    StackFrameEntry* entry = *frame_it;
+    stream << "STACK CFI INIT " << hex
+           << (entry->address - load_address_) << " "
+           << entry->size << " ";
+    RuleChangeMap::const_iterator delta_it = entry->rule_changes.begin();
+    while (true) {
+      size_t index = (*rules_it)->second.second;
+      if (index)
+        stream << "@" << index - 1;
+      else
+        stream << (*rules_it)->first;
+      stream << dec << "\n";
+      if (!stream.good())
+        return false;
+      ++rules_it;
+      if (delta_it == entry->rule_changes.end())
+        break;
+      stream << "STACK CFI " << hex << (delta_it->first - load_address_)
+             << " ";
+      ++delta_it;
+    }
+  }
+  return true;
+}
+
 bool Module::AddressIsInModule(Address address) const {
   if (address_ranges_.empty()) {
     return true;
@@ -286,37 +756,14 @@ bool Module::Write(std::ostream& stream, SymbolData symbol_data) {
     }
 
     // Write out functions and their lines.
-    for (FunctionSet::const_iterator func_it = functions_.begin();
-         func_it != functions_.end(); ++func_it) {
-      Function* func = *func_it;
-      vector<Line>::iterator line_it = func->lines.begin();
-      for (auto range_it = func->ranges.cbegin();
-           range_it != func->ranges.cend(); ++range_it) {
-        stream << "FUNC " << hex
-               << (range_it->address - load_address_) << " "
-               << range_it->size << " "
-               << func->parameter_size << " "
-               << func->name << dec << "\n";
-
-        if (!stream.good())
-          return ReportError();
-
-        while ((line_it != func->lines.end()) &&
-               (line_it->address >= range_it->address) &&
-               (line_it->address < (range_it->address + range_it->size))) {
-          stream << hex
-                 << (line_it->address - load_address_) << " "
-                 << line_it->size << " "
-                 << dec
-                 << line_it->number << " "
-                 << line_it->file->source_id << "\n";
-
-          if (!stream.good())
-            return ReportError();
-
-          ++line_it;
-        }
-      }
+    FunctionMerger merger(this);
+    while (Function* func = merger.Next()) {
+      if (!WriteFunction(*func, stream))
+        return ReportError();
+    }
+    if (merger.error()) {
+      errno = EIO;
+      return ReportError();
     }
 
     // Write out 'PUBLIC' records.
@@ -329,7 +776,10 @@ bool Module::Write(std::ostream& stream, SymbolData symbol_data) {
     }
   }
 
-  if (symbol_data != NO_CFI) {
+  if (symbol_data != NO_CFI && share_cfi_rules_) {
+    if (!WriteSharedCFIRules(stream))
+      return ReportError();
+  } else if (symbol_data != NO_CFI) {
     // Write out 'STACK CFI INIT' and 'STACK CFI' records.
     vector<StackFrameEntry*>::const_iterator frame_it;
     for (frame_it = stack_frame_entries_.begin();
@@ -38,6 +38,8 @@
 #ifndef COMMON_LINUX_MODULE_H__
 #define COMMON_LINUX_MODULE_H__
 
+#include <stdio.h>
+
 #include <iostream>
 #include <limits>
 #include <map>
@@ -213,6 +215,24 @@ class Module {
   // this method is called.
   void SetAddressRanges(const vector<Range>& ranges);
 
+  // Limit the memory used to hold this module's functions and their
+  // source lines to roughly BUDGET bytes.  Whenever the functions added
+  // exceed the budget, the module writes them to a temporary file as a
+  // sorted run, in a compact delta-encoded form, and frees them; Write
+  // merges the runs back together, and produces exactly the output it
+  // would have if everything had stayed in memory.  A budget of zero,
+  // the default, keeps everything in memory.  Set the budget before
+  // adding any functions.
+  void SetFunctionMemoryBudget(size_t budget);
+
+  // If SHARE is true, have Write define each register rule set that
+  // more than one 'STACK CFI INIT' or 'STACK CFI' record uses just once,
+  // in a 'STACK CFI RULES' record, and have those records refer to it
+  // by index. This makes symbol files with many similar functions much
+  // smaller, but older processors cannot use the CFI in them. The
+  // default is false.
+  void SetShareCFIRules(bool share);
+
   // Add FUNCTION to the module. FUNCTION's name must not be empty.
   // This module owns all Function objects added with this function:
   // destroying the module destroys them as well.
@@ -249,7 +269,8 @@ class Module {
   // VEC. The pointed-to Functions are still owned by this module.
   // (Since this is effectively a copy of the function list, this is
   // mostly useful for testing; other uses should probably get a more
-  // appropriate interface.)
+  // appropriate interface.)  Functions that have been written to a
+  // temporary file to respect the memory budget are not included.
   void GetFunctions(vector<Function*>* vec, vector<Function*>::iterator i);
 
   // Insert pointers to the externs added to this module at I in
@@ -301,15 +322,36 @@ class Module {
   string code_identifier() const { return code_id_; }
 
  private:
+  class FunctionMerger;
+
   // Report an error that has occurred writing the symbol file, using
   // errno to find the appropriate cause.  Return false.
   static bool ReportError();
 
+  // Write FUNC and its lines to STREAM as 'FUNC' records and line
+  // records.  Return true if all goes well; if an error occurs, return
+  // false, and leave errno set.
+  bool WriteFunction(const Function& func, std::ostream& stream);
+
+  // Return an estimate of the memory FUNCTION occupies in this module.
+  static size_t FunctionMemoryUsage(const Function& function);
+
+  // Write the functions held in memory to a new temporary file, as a
+  // run sorted by FunctionCompare, and free them.  Return true on
+  // success; on failure, report it, stop spilling, and return false.
+  bool SpillFunctions();
+
   // Write RULE_MAP to STREAM, in the form appropriate for 'STACK CFI'
   // records, without a final newline. Return true if all goes well;
   // if an error occurs, return false, and leave errno set.
   static bool WriteRuleMap(const RuleMap& rule_map, std::ostream& stream);
 
+  // Write the 'STACK CFI INIT' and 'STACK CFI' records for all stack
+  // frame entries to STREAM, sharing rule sets as described for
+  // SetShareCFIRules. Return true if all goes well; if an error occurs,
+  // return false, and leave errno set.
+  bool WriteSharedCFIRules(std::ostream& stream);
+
   // Returns true of the specified address resides with an specified address
   // range, or if no ranges have been specified.
   bool AddressIsInModule(Address address) const;
@@ -348,10 +390,29 @@ class Module {
   FileByNameMap files_;    // This module's source files.
   FunctionSet functions_;  // This module's functions.
 
+  // The memory budget for functions_, or zero if unlimited; and an
+  // estimate of the memory functions_ currently occupies.
+  size_t function_memory_budget_;
+  size_t function_memory_usage_;
+
+  // Temporary files holding the runs of functions spilled to respect
+  // function_memory_budget_, in the order they were written.  A
+  // function in an earlier run was added before any in a later run,
+  // or in functions_.
+  vector<FILE*> function_runs_;
+
+  // The files referred to by the lines of spilled functions, indexed
+  // by the numbers the runs use to refer to them, and the reverse map.
+  vector<File*> spilled_files_;
+  map<const File*, uint64_t> spilled_file_indices_;
+
   // The module owns all the call frame info entries that have been
   // added to it.
   vector<StackFrameEntry*> stack_frame_entries_;
 
+  // True if Write should share common CFI rule sets.
+  bool share_cfi_rules_;
+
   // The module owns all the externs that have been added to it;
   // destroying the module frees the Externs these point to.
   ExternSet externs_;
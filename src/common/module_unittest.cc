@@ -393,6 +393,53 @@ TEST(Construct, AddFrames) {
   EXPECT_THAT(entries[2]->rule_changes, ContainerEq(entry3_changes));
 }
 
+TEST(Write, SharedCFIRules) {
+  stringstream s;
+  Module m(MODULE_NAME, MODULE_OS, MODULE_ARCH, MODULE_ID);
+  m.SetShareCFIRules(true);
+
+  Module::StackFrameEntry* entry1 = new Module::StackFrameEntry();
+  entry1->address = 0x1000;
+  entry1->size = 0x20;
+  entry1->initial_rules[".cfa"] = "$esp 4 +";
+  entry1->initial_rules[".ra"] = ".cfa 4 - ^";
+  entry1->rule_changes[0x1001][".cfa"] = "$esp 8 +";
+  entry1->rule_changes[0x1004][".cfa"] = "$ebp 8 +";
+  m.AddStackFrameEntry(entry1);
+
+  Module::StackFrameEntry* entry2 = new Module::StackFrameEntry();
+  entry2->address = 0x1020;
+  entry2->size = 0x10;
+  entry2->initial_rules[".cfa"] = "$esp 4 +";
+  entry2->initial_rules[".ra"] = ".cfa 4 - ^";
+  entry2->rule_changes[0x1021][".cfa"] = "$esp 8 +";
+  m.AddStackFrameEntry(entry2);
+
+  Module::StackFrameEntry* entry3 = new Module::StackFrameEntry();
+  entry3->address = 0x1030;
+  entry3->size = 0x8;
+  m.AddStackFrameEntry(entry3);
+
+  Module::StackFrameEntry* entry4 = new Module::StackFrameEntry();
+  entry4->address = 0x1038;
+  entry4->size = 0x8;
+  m.AddStackFrameEntry(entry4);
+
+  m.Write(s, ALL_SYMBOL_DATA);
+  string contents = s.str();
+  EXPECT_STREQ("MODULE os-name architecture id-string name with spaces\n"
+               "STACK CFI RULES 0 .cfa: $esp 4 + .ra: .cfa 4 - ^\n"
+               "STACK CFI RULES 1 .cfa: $esp 8 +\n"
+               "STACK CFI INIT 1000 20 @0\n"
+               "STACK CFI 1001 @1\n"
+               "STACK CFI 1004 .cfa: $ebp 8 +\n"
+               "STACK CFI INIT 1020 10 @0\n"
+               "STACK CFI 1021 @1\n"
+               "STACK CFI INIT 1030 8 \n"
+               "STACK CFI INIT 1038 8 \n",
+               contents.c_str());
+}
+
 TEST(Construct, UniqueFiles) {
   Module m(MODULE_NAME, MODULE_OS, MODULE_ARCH, MODULE_ID);
   Module::File* file1 = m.FindFile("foo");
@@ -614,3 +661,55 @@ TEST(Write, OutOfRangeAddresses) {
                s.str().c_str());
 
 }
+
+// Add some functions with lines to M, including duplicates and a file
+// cited only by a duplicate that should be dropped.
+static void AddSpillTestFunctions(Module* m) {
+  Module::File* file1 = m->FindFile("file1.cc");
+  Module::File* file2 = m->FindFile("file2.cc");
+  Module::File* unused = m->FindFile("unused.cc");
+  for (int i = 0; i < 50; i++) {
+    // Add the functions in an order unrelated to their addresses.
+    const Module::Address address = 0x1000 + ((i * 37) % 50) * 0x100;
+    Module::Function* function = new Module::Function("function", address);
+    function->ranges.push_back(Module::Range(address, 0x80));
+    function->ranges.push_back(Module::Range(address - 0x800, 0x10));
+    function->parameter_size = i;
+    for (int j = 0; j < 8; j++) {
+      Module::Line line = { address + j * 0x10, 0x10,
+                            j % 2 ? file1 : file2, 1000 - i * 10 + j };
+      function->lines.push_back(line);
+    }
+    m->AddFunction(function);
+
+    // Same address and name as an earlier function: dropped.
+    Module::Function* duplicate = generate_duplicate_function("dup");
+    Module::Line line = { duplicate->address, 1, i ? unused : file1, i };
+    duplicate->lines.push_back(line);
+    duplicate->parameter_size = i;
+    m->AddFunction(duplicate);
+  }
+}
+
+TEST(Write, SpilledFunctions) {
+  Module in_memory(MODULE_NAME, MODULE_OS, MODULE_ARCH, MODULE_ID);
+  AddSpillTestFunctions(&in_memory);
+  stringstream expected;
+  ASSERT_TRUE(in_memory.Write(expected, ALL_SYMBOL_DATA));
+
+  // A budget this small spills every few functions.
+  Module spilled(MODULE_NAME, MODULE_OS, MODULE_ARCH, MODULE_ID);
+  spilled.SetFunctionMemoryBudget(1024);
+  AddSpillTestFunctions(&spilled);
+  vector<Module::Function*> functions;
+  spilled.GetFunctions(&functions, functions.end());
+  EXPECT_LT(functions.size(), 51U);
+
+  // The runs can be read back more than once.
+  for (int i = 0; i < 2; i++) {
+    stringstream s;
+    ASSERT_TRUE(spilled.Write(s, ALL_SYMBOL_DATA));
+    EXPECT_EQ(expected.str(), s.str());
+  }
+  EXPECT_EQ(string::npos, expected.str().find("unused.cc"));
+}
@@ -60,6 +60,7 @@
 #include "common/dwarf_line_to_module.h"
 #include "common/dwarf_range_list_handler.h"
 #include "common/module.h"
+#include "common/pecoff/pdata_to_module.h"
 #include "common/scoped_ptr.h"
 #ifndef NO_STABS_SUPPORT
 #include "common/stabs_reader.h"
@@ -76,6 +77,7 @@ using google_breakpad::DwarfCUToModule;
 using google_breakpad::DwarfLineToModule;
 using google_breakpad::DwarfRangeListHandler;
 using google_breakpad::Module;
+using google_breakpad::PdataToModule;
 #ifndef NO_STABS_SUPPORT
 using google_breakpad::StabsToModule;
 #endif
@@ -382,6 +384,43 @@ bool LoadDwarfCFI(const string& dwarf_filename,
   return true;
 }
 
+// The bytes of a mapped object file, addressed by RVA.
+template<typename ObjectFileReader>
+class ObjectFileImage : public PdataToModule::Image {
+ public:
+  explicit ObjectFileImage(typename ObjectFileReader::ObjectFileBase header)
+      : header_(header) { }
+
+  const uint8_t* Bytes(uint32_t rva, uint32_t size) const {
+    return ObjectFileReader::GetRVAPointer(header_, rva, size);
+  }
+
+ private:
+  typename ObjectFileReader::ObjectFileBase header_;
+};
+
+// Add STACK CFI records for the functions in the x86_64 exception table
+// that have no DWARF CFI. Return false if there is no exception table.
+template<typename ObjectFileReader>
+bool LoadPdata(const string& obj_file,
+               const typename ObjectFileReader::ObjectFileBase header,
+               Module* module) {
+  typename ObjectFileReader::Offset rva, size;
+  if (!ObjectFileReader::GetExceptionTable(header, &rva, &size))
+    return false;
+
+  ObjectFileImage<ObjectFileReader> image(header);
+  PdataToModule converter(&image, ObjectFileReader::GetLoadingAddress(header),
+                          module);
+  size_t unsupported;
+  converter.Process(rva, size, &unsupported);
+  if (unsupported)
+    fprintf(stderr, "%s: unwind data for %zu functions in the exception"
+            " table could not be converted to STACK CFI\n",
+            obj_file.c_str(), unsupported);
+  return true;
+}
+
 bool LoadFile(const string& obj_file, MmapWrapper* map_wrapper,
              const void** header) {
   int obj_fd = open(obj_file.c_str(), O_RDONLY);
@@ -465,10 +504,12 @@ template<typename ObjectFileReader>
 class LoadSymbolsInfo {
  public:
   typedef typename ObjectFileReader::Addr Addr;
+  typedef typename ObjectFileReader::ObjectFileBase ObjectFileBase;
 
   explicit LoadSymbolsInfo(const std::vector<string>& dbg_dirs) :
     debug_dirs_(dbg_dirs),
-    has_loading_addr_(false) {}
+    has_loading_addr_(false),
+    image_(NULL) {}
 
   // Keeps track of which sections have been loaded so sections don't
   // accidentally get loaded twice from two different files.
@@ -511,6 +552,22 @@ class LoadSymbolsInfo {
     debuglink_file_ = file;
   }
 
+  // The file passed to the first call to LoadSymbols(), which stays
+  // mapped until all of them are done.
+  bool has_image() const {
+    return image_ != NULL;
+  }
+  ObjectFileBase image() const {
+    return image_;
+  }
+  const string& image_file() const {
+    return image_file_;
+  }
+  void set_image(ObjectFileBase image, const string& filename) {
+    image_ = image;
+    image_file_ = filename;
+  }
+
  private:
   const std::vector<string>& debug_dirs_; // Directories in which to
                                           // search for the debug file.
@@ -527,6 +584,10 @@ class LoadSymbolsInfo {
 
   std::set<string> loaded_sections_;  // Tracks the Loaded sections
                                       // between calls to LoadSymbols().
+
+  ObjectFileBase image_;  // The file from the first call to LoadSymbols().
+
+  string image_file_;  // The name of IMAGE_.
 };
 
 template<typename ObjectFileReader>
@@ -618,6 +679,20 @@ bool LoadSymbols(const string& obj_file,
                                  got_section, text_section, big_endian, module);
       found_usable_info = found_usable_info || result;
     }
+
+    // x86_64 images describe how to unwind every non-leaf function in
+    // their exception table. Only the image itself is sure to have one,
+    // but functions that have DWARF CFI should keep it, so convert the
+    // table once the last file with DWARF CFI in it has been read.
+    if (strcmp(ObjectFileReader::Architecture(header), "x86_64") == 0) {
+      if (!info->has_image())
+        info->set_image(header, obj_file);
+      if (found_debug_info_section || !read_gnu_debug_link) {
+        bool result = LoadPdata<ObjectFileReader>(info->image_file(),
+                                                  info->image(), module);
+        found_usable_info = found_usable_info || result;
+      }
+    }
   }
 
   if (!found_debug_info_section) {
@@ -0,0 +1,361 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// pdata_to_module.cc: Implementation of PdataToModule. See
+// pdata_to_module.h for details.
+//
+// The unwind data layout is described in Microsoft's "x64 exception
+// handling" documentation: each 12-byte RUNTIME_FUNCTION gives the RVAs
+// of a function's start, end, and UNWIND_INFO; an UNWIND_INFO is a
+// four-byte header followed by an array of two-byte unwind code slots,
+// listed in the reverse of the order the prolog executes them.
+
+#include "common/pecoff/pdata_to_module.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+#include "common/using_std_string.h"
+
+namespace google_breakpad {
+
+namespace {
+
+// Unwind code operations.
+enum {
+  UWOP_PUSH_NONVOL = 0,
+  UWOP_ALLOC_LARGE = 1,
+  UWOP_ALLOC_SMALL = 2,
+  UWOP_SET_FPREG = 3,
+  UWOP_SAVE_NONVOL = 4,
+  UWOP_SAVE_NONVOL_FAR = 5,
+  UWOP_EPILOG = 6,            // UWOP_SAVE_XMM in version 1.
+  UWOP_SPARE_CODE = 7,        // UWOP_SAVE_XMM_FAR in version 1.
+  UWOP_SAVE_XMM128 = 8,
+  UWOP_SAVE_XMM128_FAR = 9,
+  UWOP_PUSH_MACHFRAME = 10
+};
+
+const uint8_t kUnwindFlagChainInfo = 0x4;
+
+// The size of a RUNTIME_FUNCTION entry.
+const uint32_t kRuntimeFunctionSize = 12;
+
+// How many chained UNWIND_INFO records to follow before giving up.
+const int kMaxChainDepth = 32;
+
+// The general-purpose registers, in the order unwind codes number them.
+const char* const kRegisterNames[16] = {
+  "$rax", "$rcx", "$rdx", "$rbx", "$rsp", "$rbp", "$rsi", "$rdi",
+  "$r8",  "$r9",  "$r10", "$r11", "$r12", "$r13", "$r14", "$r15"
+};
+const uint8_t kRSP = 4;
+
+uint16_t Read16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+uint32_t Read32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Return the postfix expression for the value of BASE plus OFFSET.
+string Sum(const string& base, int64_t offset) {
+  std::ostringstream expression;
+  if (offset < 0)
+    expression << base << " " << -offset << " -";
+  else
+    expression << base << " " << offset << " +";
+  return expression.str();
+}
+
+// Return the rule for a register saved OFFSET bytes from the CFA.
+string SavedAt(int64_t offset) {
+  std::ostringstream expression;
+  expression << ".cfa " << offset << " + ^";
+  return expression.str();
+}
+
+}  // namespace
+
+size_t PdataToModule::Process(uint32_t rva, uint32_t size,
+                              size_t* unsupported) {
+  *unsupported = 0;
+
+  covered_.clear();
+  std::vector<Module::StackFrameEntry*> existing;
+  module_->GetStackFrameEntries(&existing);
+  for (size_t i = 0; i < existing.size(); i++) {
+    covered_.push_back(std::make_pair(existing[i]->address,
+                                      existing[i]->address +
+                                      existing[i]->size));
+  }
+  std::sort(covered_.begin(), covered_.end());
+
+  size_t count = size / kRuntimeFunctionSize;
+  const uint8_t* table = image_->Bytes(rva, count * kRuntimeFunctionSize);
+  if (!table)
+    return 0;
+
+  size_t added = 0;
+  for (size_t i = 0; i < count; i++) {
+    const uint8_t* function = table + i * kRuntimeFunctionSize;
+    uint32_t begin = Read32(function);
+    uint32_t end = Read32(function + 4);
+    uint32_t unwind_info = Read32(function + 8);
+    if (begin >= end) {
+      ++*unsupported;
+      continue;
+    }
+
+    Module::Address address = load_address_ + begin;
+    Module::Address limit = load_address_ + end;
+    std::vector<std::pair<Module::Address, Module::Address> >::const_iterator
+        next = std::upper_bound(covered_.begin(), covered_.end(),
+                                std::make_pair(address, limit));
+    if ((next != covered_.end() && next->first < limit) ||
+        (next != covered_.begin() && (next - 1)->second > address))
+      continue;
+
+    // An odd UnwindData field refers to another RUNTIME_FUNCTION, whose
+    // unwind data this code shares; its prolog lies outside this range,
+    // so all of that prolog has already run here.
+    Prolog prolog;
+    bool ok;
+    if (unwind_info & 1) {
+      const uint8_t* primary = image_->Bytes(unwind_info & ~1U,
+                                             kRuntimeFunctionSize);
+      ok = primary &&
+           ReadUnwindInfo(Read32(primary + 8), kMaxChainDepth, true, &prolog);
+    } else {
+      ok = ReadUnwindInfo(unwind_info, kMaxChainDepth, false, &prolog);
+    }
+
+    Module::StackFrameEntry* entry = new Module::StackFrameEntry;
+    entry->address = address;
+    entry->size = end - begin;
+    if (!ok || !AddRules(prolog, entry)) {
+      delete entry;
+      ++*unsupported;
+      continue;
+    }
+    module_->AddStackFrameEntry(entry);
+    added++;
+  }
+
+  return added;
+}
+
+bool PdataToModule::ReadUnwindInfo(uint32_t rva, int depth, bool inherited,
+                                   Prolog* prolog) {
+  const uint8_t* header = image_->Bytes(rva, 4);
+  if (!header)
+    return false;
+  uint8_t version = header[0] & 0x7;
+  uint8_t flags = header[0] >> 3;
+  uint8_t slot_count = header[2];
+  uint8_t frame = header[3];
+  if (version != 1 && version != 2)
+    return false;
+
+  // Chained unwind info follows the slots, padded to an even count.
+  uint32_t slots_size = ((slot_count + 1) & ~1) * 2;
+  bool chained = flags & kUnwindFlagChainInfo;
+  const uint8_t* slots = image_->Bytes(
+      rva + 4, slots_size + (chained ? kRuntimeFunctionSize : 0));
+  if (!slots)
+    return false;
+
+  std::vector<Operation> operations;
+  for (size_t i = 0; i < slot_count;) {
+    Operation operation;
+    operation.code_offset = slots[i * 2];
+    operation.code = slots[i * 2 + 1] & 0xf;
+    operation.info = slots[i * 2 + 1] >> 4;
+    operation.operand = 0;
+
+    size_t used = 1;
+    switch (operation.code) {
+      case UWOP_PUSH_NONVOL:
+        break;
+      case UWOP_ALLOC_LARGE:
+        if (operation.info == 0) {
+          used = 2;
+        } else if (operation.info == 1) {
+          used = 3;
+        } else {
+          return false;
+        }
+        break;
+      case UWOP_ALLOC_SMALL:
+        operation.operand = operation.info * 8 + 8;
+        break;
+      case UWOP_SET_FPREG:
+        // The frame register belongs to the UNWIND_INFO that sets it,
+        // which need not be the one the function starts with.
+        if ((frame & 0xf) == 0)
+          return false;
+        operation.info = frame & 0xf;
+        operation.operand = (frame >> 4) * 16;
+        break;
+      case UWOP_SAVE_NONVOL:
+      case UWOP_EPILOG:
+      case UWOP_SAVE_XMM128:
+        used = 2;
+        break;
+      case UWOP_SAVE_NONVOL_FAR:
+      case UWOP_SPARE_CODE:
+      case UWOP_SAVE_XMM128_FAR:
+        used = 3;
+        break;
+      default:
+        // UWOP_PUSH_MACHFRAME marks an interrupt or exception handler,
+        // whose caller's state is in a machine frame STACK CFI cannot
+        // describe.
+        return false;
+    }
+    if (i + used > slot_count)
+      return false;
+
+    if (operation.code == UWOP_ALLOC_LARGE && used == 2)
+      operation.operand = Read16(slots + (i + 1) * 2) * 8;
+    else if (operation.code == UWOP_ALLOC_LARGE)
+      operation.operand = Read32(slots + (i + 1) * 2);
+    else if (operation.code == UWOP_SAVE_NONVOL)
+      operation.operand = Read16(slots + (i + 1) * 2) * 8;
+    else if (operation.code == UWOP_SAVE_NONVOL_FAR)
+      operation.operand = Read32(slots + (i + 1) * 2);
+
+    operations.push_back(operation);
+    i += used;
+  }
+  std::reverse(operations.begin(), operations.end());
+
+  std::vector<Operation>& destination =
+      inherited ? prolog->inherited : prolog->own;
+  destination.insert(destination.begin(),
+                     operations.begin(), operations.end());
+
+  if (chained) {
+    if (depth == 0)
+      return false;
+    uint32_t parent = Read32(slots + slots_size + 8);
+    return ReadUnwindInfo(parent, depth - 1, true, prolog);
+  }
+  return true;
+}
+
+bool PdataToModule::AddRules(const Prolog& prolog,
+                             Module::StackFrameEntry* entry) {
+  std::vector<Operation> operations(prolog.inherited);
+  operations.insert(operations.end(), prolog.own.begin(), prolog.own.end());
+
+  // Saved register offsets are relative to the stack pointer once the
+  // fixed allocation is complete, or to the value the stack pointer had
+  // when the frame register was established, if there is one. Measure
+  // both down from the CFA, which is just above the return address.
+  uint64_t depth = 8;
+  uint64_t save_base = 0;
+  for (size_t i = 0; i < operations.size(); i++) {
+    const Operation& operation = operations[i];
+    if (operation.code == UWOP_PUSH_NONVOL)
+      depth += 8;
+    else if (operation.code == UWOP_ALLOC_LARGE ||
+             operation.code == UWOP_ALLOC_SMALL)
+      depth += operation.operand;
+    else if (operation.code == UWOP_SET_FPREG && !save_base)
+      save_base = depth;
+  }
+  if (!save_base)
+    save_base = depth;
+
+  entry->initial_rules[".cfa"] = Sum("$rsp", 8);
+  entry->initial_rules[".ra"] = SavedAt(-8);
+
+  depth = 8;
+  bool frame_pointer = false;
+  for (size_t i = 0; i < operations.size(); i++) {
+    const Operation& operation = operations[i];
+    Module::RuleMap changes;
+    switch (operation.code) {
+      case UWOP_PUSH_NONVOL:
+        depth += 8;
+        if (!frame_pointer)
+          changes[".cfa"] = Sum("$rsp", depth);
+        if (operation.info != kRSP)
+          changes[kRegisterNames[operation.info]] =
+              SavedAt(-static_cast<int64_t>(depth));
+        break;
+      case UWOP_ALLOC_LARGE:
+      case UWOP_ALLOC_SMALL:
+        depth += operation.operand;
+        if (!frame_pointer)
+          changes[".cfa"] = Sum("$rsp", depth);
+        break;
+      case UWOP_SET_FPREG:
+        frame_pointer = true;
+        changes[".cfa"] = Sum(kRegisterNames[operation.info],
+                              static_cast<int64_t>(depth) -
+                              static_cast<int64_t>(operation.operand));
+        break;
+      case UWOP_SAVE_NONVOL:
+      case UWOP_SAVE_NONVOL_FAR:
+        // Prologs often save registers in the caller's parameter home
+        // area, above the return address.
+        if (operation.info != kRSP)
+          changes[kRegisterNames[operation.info]] =
+              SavedAt(static_cast<int64_t>(operation.operand) -
+                      static_cast<int64_t>(save_base));
+        break;
+      default:
+        // Epilog markers and XMM register saves have no STACK CFI
+        // counterpart; the Breakpad x86_64 unwinder recovers only the
+        // general-purpose registers.
+        break;
+    }
+    if (changes.empty())
+      continue;
+
+    // Inherited operations have all run by the time the code starts;
+    // this function's own take effect after their instructions.
+    Module::RuleMap* rules = &entry->initial_rules;
+    if (i >= prolog.inherited.size() && operation.code_offset != 0) {
+      if (operation.code_offset >= entry->size)
+        continue;
+      rules = &entry->rule_changes[entry->address + operation.code_offset];
+    }
+    for (Module::RuleMap::const_iterator it = changes.begin();
+         it != changes.end(); ++it)
+      (*rules)[it->first] = it->second;
+  }
+  return true;
+}
+
+}  // namespace google_breakpad
@@ -0,0 +1,114 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// pdata_to_module.h: Define the PdataToModule class, which translates
+// the x86_64 exception table of a PE/COFF image (the RUNTIME_FUNCTION
+// entries in .pdata and the UNWIND_INFO records they refer to, usually
+// in .xdata) into Breakpad STACK CFI records in a
+// google_breakpad::Module.
+
+#ifndef COMMON_PECOFF_PDATA_TO_MODULE_H__
+#define COMMON_PECOFF_PDATA_TO_MODULE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+#include "common/module.h"
+
+namespace google_breakpad {
+
+// A class that reads x86_64 Windows unwind data and adds the equivalent
+// STACK CFI records to a Module. Only the prolog is described: x86_64
+// epilogs follow a fixed form that Windows unwinders recognize from the
+// instructions themselves, and the unwind data has no record of them.
+class PdataToModule {
+ public:
+  // The bytes of an image, addressed by relative virtual address.
+  class Image {
+   public:
+    virtual ~Image() { }
+
+    // Return a pointer to the SIZE bytes of the image starting at RVA,
+    // or NULL if they are not all present in the file.
+    virtual const uint8_t* Bytes(uint32_t rva, uint32_t size) const = 0;
+  };
+
+  // Create a converter that reads unwind data from IMAGE and adds
+  // entries to MODULE. LOAD_ADDRESS is the image's preferred base
+  // address, which the STACK CFI addresses are relative to.
+  PdataToModule(const Image* image, uint64_t load_address, Module* module)
+      : image_(image), load_address_(load_address), module_(module) { }
+
+  // Translate the RUNTIME_FUNCTION table of SIZE bytes at RVA. Functions
+  // that already have STACK CFI in the module (from DWARF CFI, say) are
+  // left alone. Set *UNSUPPORTED to the number of functions whose unwind
+  // data could not be read or expressed. Return the number of entries
+  // added.
+  size_t Process(uint32_t rva, uint32_t size, size_t* unsupported);
+
+ private:
+  // An unwind code, in the order the prolog executes it.
+  struct Operation {
+    uint8_t code_offset;  // Offset of the end of the instruction.
+    uint8_t code;         // The UWOP_* operation.
+    uint8_t info;         // The register the operation concerns.
+    uint32_t operand;     // Allocation size, save offset, or frame offset.
+  };
+
+  // The unwind data for one function, with the prologs of any parent
+  // functions it is chained to.
+  struct Prolog {
+    std::vector<Operation> inherited;  // Already run when the code starts.
+    std::vector<Operation> own;        // Run by this function's prolog.
+  };
+
+  // Read the UNWIND_INFO at RVA, following chained entries no more than
+  // DEPTH further. Prepend its operations to PROLOG->inherited if
+  // INHERITED, or store them in PROLOG->own. Return false if the data is
+  // malformed or uses an operation that STACK CFI cannot express.
+  bool ReadUnwindInfo(uint32_t rva, int depth, bool inherited, Prolog* prolog);
+
+  // Fill in the rules of ENTRY, whose address and size are set, from
+  // PROLOG. Return false if the prolog cannot be expressed.
+  bool AddRules(const Prolog& prolog, Module::StackFrameEntry* entry);
+
+  const Image* image_;
+  uint64_t load_address_;
+  Module* module_;
+
+  // The address ranges the module already has STACK CFI for, sorted.
+  std::vector<std::pair<Module::Address, Module::Address> > covered_;
+};
+
+}  // namespace google_breakpad
+
+#endif  // COMMON_PECOFF_PDATA_TO_MODULE_H__
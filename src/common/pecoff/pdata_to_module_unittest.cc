@@ -0,0 +1,321 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// pdata_to_module_unittest.cc: Unit tests for google_breakpad::PdataToModule.
+
+#include <string>
+#include <vector>
+
+#include "breakpad_googletest_includes.h"
+#include "common/module.h"
+#include "common/pecoff/pdata_to_module.h"
+#include "common/test_assembler.h"
+#include "common/using_std_string.h"
+
+using google_breakpad::Module;
+using google_breakpad::PdataToModule;
+using google_breakpad::test_assembler::kLittleEndian;
+using google_breakpad::test_assembler::Label;
+using google_breakpad::test_assembler::Section;
+using std::vector;
+using testing::Test;
+
+namespace {
+
+// An image whose relative virtual addresses are simply offsets into a
+// test_assembler section.
+class SectionImage : public PdataToModule::Image {
+ public:
+  explicit SectionImage(const string& contents) : contents_(contents) { }
+  const uint8_t* Bytes(uint32_t rva, uint32_t size) const {
+    if (rva > contents_.size() || size > contents_.size() - rva)
+      return NULL;
+    return reinterpret_cast<const uint8_t*>(contents_.data()) + rva;
+  }
+
+ private:
+  string contents_;
+};
+
+const uint64_t kLoadAddress = 0x140000000ULL;
+
+// Unwind code operations and registers, as the unwind data numbers them.
+enum {
+  PUSH_NONVOL = 0, ALLOC_LARGE = 1, ALLOC_SMALL = 2, SET_FPREG = 3,
+  SAVE_NONVOL = 4, SAVE_NONVOL_FAR = 5, SAVE_XMM128 = 8, PUSH_MACHFRAME = 10
+};
+enum { RBX = 3, RBP = 5, RSI = 6, RDI = 7, R12 = 12 };
+
+class PdataFixture : public Test {
+ public:
+  PdataFixture()
+      : module("a", "windows", "x86_64", "id"), image(kLittleEndian),
+        pdata(kLittleEndian), unwind(kLittleEndian),
+        functions(0) {
+    image.start() = 0;
+  }
+
+  // Append a RUNTIME_FUNCTION entry for [BEGIN, END) using UNWIND_INFO.
+  void Function(uint32_t begin, uint32_t end, const Label& unwind_info) {
+    pdata.D32(begin).D32(end).D32(unwind_info);
+    functions++;
+  }
+
+  // Append an UNWIND_INFO header at LABEL to UNWIND.
+  void UnwindInfo(Label label, uint8_t flags, uint8_t prolog_size,
+                  uint8_t slot_count, uint8_t frame_register = 0,
+                  uint8_t frame_offset = 0) {
+    unwind.Mark(&label);
+    unwind.D8(1 | (flags << 3)).D8(prolog_size).D8(slot_count)
+          .D8(frame_register | (frame_offset << 4));
+  }
+
+  // Append an unwind code slot to UNWIND.
+  void Code(uint8_t offset, uint8_t operation, uint8_t info) {
+    unwind.D8(offset).D8(operation | (info << 4));
+  }
+
+  size_t Process() {
+    unwind.start() = pdata.Size();
+    image.Append(pdata);
+    image.Append(unwind);
+    string contents;
+    EXPECT_TRUE(image.GetContents(&contents));
+    SectionImage section_image(contents);
+    PdataToModule converter(&section_image, kLoadAddress, &module);
+    size_t added = converter.Process(0, functions * 12, &unsupported);
+    module.GetStackFrameEntries(&entries);
+    return added;
+  }
+
+  Module module;
+  Section image, pdata, unwind;
+  size_t functions;
+  size_t unsupported;
+  vector<Module::StackFrameEntry*> entries;
+};
+
+class Simple : public PdataFixture { };
+
+TEST_F(Simple, PushesAndAllocation) {
+  // push rbp; push rbx; sub rsp, 0x28
+  Label info;
+  Function(0x1000, 0x1080, info);
+  UnwindInfo(info, 0, 6, 3);
+  Code(6, ALLOC_SMALL, (0x28 - 8) / 8);
+  Code(2, PUSH_NONVOL, RBX);
+  Code(1, PUSH_NONVOL, RBP);
+  unwind.D16(0);
+
+  EXPECT_EQ(1U, Process());
+  EXPECT_EQ(0U, unsupported);
+  ASSERT_EQ(1U, entries.size());
+  Module::StackFrameEntry* entry = entries[0];
+  EXPECT_EQ(kLoadAddress + 0x1000, entry->address);
+  EXPECT_EQ(0x80U, entry->size);
+  EXPECT_EQ("$rsp 8 +", entry->initial_rules[".cfa"]);
+  EXPECT_EQ(".cfa -8 + ^", entry->initial_rules[".ra"]);
+  ASSERT_EQ(3U, entry->rule_changes.size());
+  Module::RuleMap& push_rbp = entry->rule_changes[kLoadAddress + 0x1001];
+  EXPECT_EQ("$rsp 16 +", push_rbp[".cfa"]);
+  EXPECT_EQ(".cfa -16 + ^", push_rbp["$rbp"]);
+  Module::RuleMap& push_rbx = entry->rule_changes[kLoadAddress + 0x1002];
+  EXPECT_EQ("$rsp 24 +", push_rbx[".cfa"]);
+  EXPECT_EQ(".cfa -24 + ^", push_rbx["$rbx"]);
+  Module::RuleMap& alloc = entry->rule_changes[kLoadAddress + 0x1006];
+  EXPECT_EQ(1U, alloc.size());
+  EXPECT_EQ("$rsp 64 +", alloc[".cfa"]);
+}
+
+TEST_F(Simple, FramePointer) {
+  // push rbp; sub rsp, 0x20; lea rbp, [rsp+0x20]; mov [rbp-0x10], rsi
+  Label info;
+  Function(0x2000, 0x2100, info);
+  UnwindInfo(info, 0, 15, 5, RBP, 2);
+  Code(15, SAVE_NONVOL, RSI);
+  unwind.D16(0x10 / 8);
+  Code(10, SET_FPREG, 0);
+  Code(5, ALLOC_SMALL, (0x20 - 8) / 8);
+  Code(1, PUSH_NONVOL, RBP);
+  unwind.D16(0);
+
+  EXPECT_EQ(1U, Process());
+  ASSERT_EQ(1U, entries.size());
+  Module::StackFrameEntry* entry = entries[0];
+  EXPECT_EQ("$rsp 48 +",
+            entry->rule_changes[kLoadAddress + 0x2005][".cfa"]);
+  EXPECT_EQ("$rbp 16 +",
+            entry->rule_changes[kLoadAddress + 0x200a][".cfa"]);
+  // The save offset is from the frame pointer less the frame offset,
+  // which is the stack pointer's value when the frame was set up.
+  EXPECT_EQ(".cfa -32 + ^",
+            entry->rule_changes[kLoadAddress + 0x200f]["$rsi"]);
+}
+
+TEST_F(Simple, HomeAreaSave) {
+  // mov [rsp+8], rbx; push rdi; sub rsp, 0x20
+  Label info;
+  Function(0x1000, 0x1040, info);
+  UnwindInfo(info, 0, 10, 4);
+  Code(10, ALLOC_SMALL, (0x20 - 8) / 8);
+  Code(6, PUSH_NONVOL, RDI);
+  Code(5, SAVE_NONVOL, RBX);
+  unwind.D16(0x30 / 8);
+
+  EXPECT_EQ(1U, Process());
+  ASSERT_EQ(1U, entries.size());
+  Module::StackFrameEntry* entry = entries[0];
+  EXPECT_EQ(".cfa 0 + ^", entry->rule_changes[kLoadAddress + 0x1005]["$rbx"]);
+  EXPECT_EQ(".cfa -16 + ^",
+            entry->rule_changes[kLoadAddress + 0x1006]["$rdi"]);
+  EXPECT_EQ("$rsp 48 +", entry->rule_changes[kLoadAddress + 0x100a][".cfa"]);
+}
+
+TEST_F(Simple, LargeOperations) {
+  // push r12; sub rsp, 0x1000; mov [rsp+0x800], rdi; sub rsp, 0x100000
+  // (out of order for a real prolog, but exercising each encoding).
+  Label info;
+  Function(0x3000, 0x3100, info);
+  UnwindInfo(info, 0, 30, 9);
+  Code(30, SAVE_NONVOL_FAR, RDI);
+  unwind.D32(0x800);
+  Code(22, ALLOC_LARGE, 1);
+  unwind.D32(0x100000);
+  Code(10, ALLOC_LARGE, 0);
+  unwind.D16(0x1000 / 8);
+  Code(2, PUSH_NONVOL, R12);
+  unwind.D16(0);
+
+  EXPECT_EQ(1U, Process());
+  ASSERT_EQ(1U, entries.size());
+  Module::StackFrameEntry* entry = entries[0];
+  EXPECT_EQ("$rsp 16 +", entry->rule_changes[kLoadAddress + 0x3002][".cfa"]);
+  EXPECT_EQ(".cfa -16 + ^", entry->rule_changes[kLoadAddress + 0x3002]["$r12"]);
+  EXPECT_EQ("$rsp 4112 +",
+            entry->rule_changes[kLoadAddress + 0x300a][".cfa"]);
+  EXPECT_EQ("$rsp 1052688 +",
+            entry->rule_changes[kLoadAddress + 0x3016][".cfa"]);
+  EXPECT_EQ(".cfa -1050640 + ^",
+            entry->rule_changes[kLoadAddress + 0x301e]["$rdi"]);
+}
+
+TEST_F(Simple, SkipsXMMSaves) {
+  Label info;
+  Function(0x1000, 0x1040, info);
+  UnwindInfo(info, 0, 9, 3);
+  Code(9, SAVE_XMM128, 6);
+  unwind.D16(0);
+  Code(4, ALLOC_SMALL, 3);
+  unwind.D16(0);
+
+  EXPECT_EQ(1U, Process());
+  ASSERT_EQ(1U, entries.size());
+  ASSERT_EQ(1U, entries[0]->rule_changes.size());
+  EXPECT_EQ("$rsp 40 +",
+            entries[0]->rule_changes[kLoadAddress + 0x1004][".cfa"]);
+}
+
+TEST_F(Simple, Chained) {
+  // The parent pushes rbx and allocates; the chained fragment saves rsi
+  // in its own prolog.
+  Label parent, child;
+  Function(0x1000, 0x1020, parent);
+  Function(0x1100, 0x1140, child);
+  UnwindInfo(parent, 0, 6, 2);
+  Code(5, ALLOC_SMALL, 3);
+  Code(1, PUSH_NONVOL, RBX);
+  UnwindInfo(child, 0x4, 5, 2);
+  Code(5, SAVE_NONVOL, RSI);
+  unwind.D16(0x8 / 8);
+  unwind.D32(0x1000).D32(0x1020).D32(parent);
+
+  EXPECT_EQ(2U, Process());
+  ASSERT_EQ(2U, entries.size());
+  Module::StackFrameEntry* entry = entries[1];
+  EXPECT_EQ(kLoadAddress + 0x1100, entry->address);
+  EXPECT_EQ("$rsp 48 +", entry->initial_rules[".cfa"]);
+  EXPECT_EQ(".cfa -16 + ^", entry->initial_rules["$rbx"]);
+  EXPECT_EQ(".cfa -40 + ^",
+            entry->rule_changes[kLoadAddress + 0x1105]["$rsi"]);
+}
+
+TEST_F(Simple, ChainLoop) {
+  Label info;
+  Function(0x1000, 0x1020, info);
+  UnwindInfo(info, 0x4, 0, 0);
+  unwind.D32(0x1000).D32(0x1020).D32(info);
+
+  EXPECT_EQ(0U, Process());
+  EXPECT_EQ(1U, unsupported);
+}
+
+TEST_F(Simple, MachineFrame) {
+  Label info;
+  Function(0x1000, 0x1020, info);
+  UnwindInfo(info, 0, 0, 1);
+  Code(0, PUSH_MACHFRAME, 0);
+  unwind.D16(0);
+
+  EXPECT_EQ(0U, Process());
+  EXPECT_EQ(1U, unsupported);
+  EXPECT_TRUE(entries.empty());
+}
+
+TEST_F(Simple, Truncated) {
+  Label info;
+  Function(0x1000, 0x1020, info);
+  UnwindInfo(info, 0, 6, 4);
+  Code(6, ALLOC_LARGE, 1);
+
+  EXPECT_EQ(0U, Process());
+  EXPECT_EQ(1U, unsupported);
+}
+
+TEST_F(Simple, KeepsExistingCFI) {
+  Module::StackFrameEntry* dwarf = new Module::StackFrameEntry;
+  dwarf->address = kLoadAddress + 0x1000;
+  dwarf->size = 0x20;
+  dwarf->initial_rules[".cfa"] = "$rsp 8 +";
+  module.AddStackFrameEntry(dwarf);
+
+  Label info;
+  Function(0x1000, 0x1020, info);
+  Function(0x1020, 0x1040, info);
+  UnwindInfo(info, 0, 1, 1);
+  Code(1, PUSH_NONVOL, RBP);
+  unwind.D16(0);
+
+  EXPECT_EQ(1U, Process());
+  EXPECT_EQ(0U, unsupported);
+  ASSERT_EQ(2U, entries.size());
+  EXPECT_EQ(dwarf, entries[0]);
+  EXPECT_EQ(kLoadAddress + 0x1020, entries[1]->address);
+}
+
+}  // namespace
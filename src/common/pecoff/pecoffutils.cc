@@ -458,12 +458,48 @@ PeCoffObjectFileReader<PeCoffClassTraits>::GetDataDirectoryEntry(
   uint32_t data_directory_size = peOptionalHeader->mNumberOfRvaAndSizes;
 
   // locate the required directory entry, if present
-  if (data_directory_size < entry)
+  if (data_directory_size <= entry)
     return NULL;
 
   return &data_directory[entry];
 }
 
+template<typename PeCoffClassTraits>
+const uint8_t*
+PeCoffObjectFileReader<PeCoffClassTraits>::GetRVAPointer(
+    ObjectFileBase obj_base,
+    Offset rva,
+    Offset size) {
+  const PeSectionHeader* section_table = GetSectionTable(obj_base);
+  for (int s = 0; s < GetNumberOfSections(obj_base); s++) {
+    const PeSectionHeader* section = &(section_table[s]);
+
+    if ((rva >= section->mVirtualAddress) &&
+        (rva - section->mVirtualAddress < section->mSizeOfRawData) &&
+        (size <= section->mSizeOfRawData - (rva - section->mVirtualAddress)))
+      return GetSectionPointer(obj_base, (Section)section) +
+          (rva - section->mVirtualAddress);
+  }
+
+  return NULL;
+}
+
+template<typename PeCoffClassTraits>
+bool PeCoffObjectFileReader<PeCoffClassTraits>::GetExceptionTable(
+    ObjectFileBase obj_base,
+    Offset* rva,
+    Offset* size) {
+  const PeDataDirectory* data_directory_exception_entry =
+      GetDataDirectoryEntry(obj_base, PE_EXCEPTION_TABLE);
+  if (!data_directory_exception_entry ||
+      data_directory_exception_entry->mSize == 0)
+    return false;
+
+  *rva = data_directory_exception_entry->mVirtualAddress;
+  *size = data_directory_exception_entry->mSize;
+  return true;
+}
+
 template<typename PeCoffClassTraits>
 const uint8_t*
 PeCoffObjectFileReader<PeCoffClassTraits>::ConvertRVAToPointer(
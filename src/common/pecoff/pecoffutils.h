@@ -115,6 +115,16 @@ class PeCoffObjectFileReader {
   // Get name of a section
   static const char* GetSectionName(ObjectFileBase obj_base,Section section);
 
+  // Convert the SIZE bytes at relative virtual address RVA into a pointer
+  // to the mapped file, or NULL if they are not all in one section's
+  // file data.
+  static const uint8_t* GetRVAPointer(ObjectFileBase obj_base, Offset rva,
+                                      Offset size);
+
+  // Find the exception table (the .pdata RUNTIME_FUNCTION entries), if any.
+  static bool GetExceptionTable(ObjectFileBase obj_base, Offset* rva,
+                                Offset* size);
+
   // Find any linked section
   static const Section FindLinkedSection(ObjectFileBase obj_base,
                                          Section section) {
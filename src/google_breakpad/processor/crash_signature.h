@@ -0,0 +1,145 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// crash_signature.h: Compute a cheap signature for the crash in a minidump.
+//
+// CrashSignatureGenerator is meant to run ahead of MinidumpProcessor, so
+// that a crash whose signature matches one that has already been triaged
+// can skip full processing.  It walks a single thread: the one the exception
+// stream names, from the exception context, or, in a dump without an
+// exception, the thread that requested the dump.  The walk stops at the
+// frames that make up the signature.  Symbol
+// files, if a SymbolSupplier is given, are loaded without their FILE and
+// line records: the walk uses STACK CFI and STACK WIN records, with FUNC
+// and PUBLIC records to vet stack-scanned return addresses, and frame
+// pointers and stack scanning where there are no symbols at all.  No frame
+// is symbolized beyond its function name.
+//
+// The signature is a 64-bit FNV-1a hash of the base name of each frame's
+// module and the frame's module-relative offset, so it does not depend on
+// where modules were loaded or on which host computed it.
+
+#ifndef GOOGLE_BREAKPAD_PROCESSOR_CRASH_SIGNATURE_H__
+#define GOOGLE_BREAKPAD_PROCESSOR_CRASH_SIGNATURE_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common/basictypes.h"
+#include "common/scoped_ptr.h"
+#include "common/using_std_string.h"
+#include "google_breakpad/common/breakpad_types.h"
+#include "google_breakpad/processor/basic_source_line_resolver.h"
+#include "google_breakpad/processor/process_result.h"
+#include "google_breakpad/processor/stack_frame_symbolizer.h"
+
+namespace google_breakpad {
+
+class CodeModules;
+class Minidump;
+class SymbolSupplier;
+
+struct CrashSignatureFrame {
+  // The base name of the code file of the module containing the frame's
+  // instruction, or empty if the instruction is in no known module.
+  string module;
+
+  // The frame's instruction, relative to the base of |module|.  For a frame
+  // outside any module this is the absolute instruction address, which is
+  // not part of the hash.
+  uint64_t offset;
+};
+
+struct CrashSignature {
+  CrashSignature() : hash(0), thread_id(0) {}
+
+  uint64_t hash;
+
+  // The thread that was walked.
+  uint32_t thread_id;
+
+  // The frames that make up |hash|, innermost first.
+  std::vector<CrashSignatureFrame> frames;
+};
+
+class CrashSignatureGenerator {
+ public:
+  // The number of frames that make up a signature by default.
+  static const int kDefaultFrameCount = 10;
+
+  // |supplier| may be NULL, in which case no symbols are loaded.  Does not
+  // take ownership of |supplier|.
+  explicit CrashSignatureGenerator(SymbolSupplier* supplier);
+  ~CrashSignatureGenerator();
+
+  // The number of innermost frames of the crashing thread that make up
+  // the signature.  0 means the whole stack.
+  void set_frame_count(int frame_count) { frame_count_ = frame_count; }
+  int frame_count() const { return frame_count_; }
+
+  // Computes the signature of the crash in |minidump_file| or |dump|,
+  // which must already have been Read.  Returns PROCESS_OK on success.
+  // As with MinidumpProcessor, symbol data loaded for a module is kept
+  // for later dumps, but only for dumps of the same build: it is dropped
+  // when a later dump has a module with the same code file and a different
+  // debug identifier.
+  ProcessResult Generate(const string& minidump_file,
+                         CrashSignature* signature);
+  ProcessResult Generate(Minidump* dump, CrashSignature* signature);
+
+  // Returns |hash| as 16 hex digits.
+  static string HashString(uint64_t hash);
+
+ private:
+  // Unloads the symbols of every module in |modules| whose code file has
+  // symbols loaded for a different debug identifier.
+  void UnloadStaleSymbols(const CodeModules* modules);
+
+  // Records the debug identifier of every module in |modules| that has
+  // symbols loaded.
+  void RecordLoadedSymbols(const CodeModules* modules);
+
+  // Wraps the caller's SymbolSupplier, dropping the records the walk does
+  // not need.  NULL if no SymbolSupplier was given.
+  scoped_ptr<SymbolSupplier> supplier_;
+  BasicSourceLineResolver resolver_;
+  StackFrameSymbolizer frame_symbolizer_;
+  int frame_count_;
+
+  // The debug identifier each code file in |resolver_| was loaded for.
+  // |resolver_| keys modules by code file alone.
+  std::map<string, string> loaded_debug_identifiers_;
+
+  DISALLOW_COPY_AND_ASSIGN(CrashSignatureGenerator);
+};
+
+}  // namespace google_breakpad
+
+#endif  // GOOGLE_BREAKPAD_PROCESSOR_CRASH_SIGNATURE_H__
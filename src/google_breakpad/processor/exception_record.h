@@ -62,6 +62,12 @@ class ExceptionParameter {
 // flags, address, parameters.
 class ExceptionRecord {
  public:
+  ExceptionRecord()
+      : code_(0),
+        flags_(0),
+        nested_exception_record_address_(0),
+        address_(0) {}
+
   // Accessors. See the data declarations below.
   uint32_t code() const { return code_; }
   const string& code_description() const { return code_description_; }
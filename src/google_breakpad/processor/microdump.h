@@ -39,7 +39,10 @@
 #ifndef GOOGLE_BREAKPAD_PROCESSOR_MICRODUMP_H__
 #define GOOGLE_BREAKPAD_PROCESSOR_MICRODUMP_H__
 
+#include <stddef.h>
+
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/scoped_ptr.h"
@@ -112,8 +115,18 @@ class MicrodumpMemoryRegion : public MemoryRegion {
 class Microdump {
  public:
   explicit Microdump(const string& contents);
+  // Parse the first microdump in the SIZE bytes at DATA, which need not
+  // be NUL-terminated. The text is read in place, and not retained.
+  Microdump(const char* data, size_t size);
   virtual ~Microdump() {}
 
+  // Find each microdump in the SIZE bytes at DATA, such as a logcat
+  // capture, and append its byte offset and length to RANGES. Each range
+  // runs from its BEGIN line through its END line; one that is cut short
+  // runs up to the next BEGIN line, or the end of DATA.
+  static void FindMicrodumps(const char* data, size_t size,
+                             std::vector<std::pair<size_t, size_t> >* ranges);
+
   DumpContext* GetContext() { return context_.get(); }
   MicrodumpMemoryRegion* GetMemory() { return stack_region_.get(); }
   MicrodumpModules* GetModules() { return modules_.get(); }
@@ -122,6 +135,9 @@ class Microdump {
   string GetCrashReason() { return crash_reason_; }
   uint64_t GetCrashAddress() { return crash_address_; }
  private:
+  // Parse the first microdump in the SIZE bytes at DATA.
+  void Parse(const char* data, size_t size);
+
   scoped_ptr<MicrodumpContext> context_;
   scoped_ptr<MicrodumpMemoryRegion> stack_region_;
   scoped_ptr<MicrodumpModules> modules_;
@@ -87,6 +87,7 @@
 
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -143,14 +144,15 @@ class MinidumpStream : public MinidumpObject {
   explicit MinidumpStream(Minidump* minidump);
 
  private:
-  // Populate (and validate) the MinidumpStream.  minidump_ is expected
-  // to be positioned at the beginning of the stream, so that the next
-  // read from the minidump will be at the beginning of the stream.
+  // Populate (and validate) the MinidumpStream from the stream data that
+  // begins at offset in the minidump.  Streams are read with
+  // Minidump::ReadBytesAt, so they neither depend on nor move the minidump's
+  // current position, and different streams may be read concurrently.
   // expected_size should be set to the stream's length as contained in
   // the MDRawDirectory record or other identifying record.  A class
   // that implements MinidumpStream can compare expected_size to a
   // known size as an integrity check.
-  virtual bool Read(uint32_t expected_size) = 0;
+  virtual bool Read(off_t offset, uint32_t expected_size) = 0;
 
   DISALLOW_COPY_AND_ASSIGN(MinidumpStream);
 };
@@ -177,7 +179,7 @@ class MinidumpContext : public DumpContext {
   friend class MinidumpThread;
   friend class MinidumpException;
 
-  bool Read(uint32_t expected_size);
+  bool Read(off_t offset, uint32_t expected_size);
 
   // If the minidump contains a SYSTEM_INFO_STREAM, makes sure that the
   // system info stream gives an appropriate CPU type matching the context
@@ -216,7 +218,7 @@ class MinidumpMemoryRegion : public MinidumpObject,
 
   // Returns a pointer to the base of the memory region.  Returns the
   // cached value if available, otherwise, reads the minidump file and
-  // caches the memory region.
+  // caches the memory region.  Safe to call from several threads at once.
   const uint8_t* GetMemory() const;
 
   // The address of the base of the memory region.
@@ -311,7 +313,7 @@ class MinidumpThread : public MinidumpObject {
   // This works like MinidumpStream::Read, but is driven by
   // MinidumpThreadList.  No size checking is done, because
   // MinidumpThreadList handles that directly.
-  bool Read();
+  bool Read(off_t offset);
 
   MDRawThread           thread_;
   MinidumpMemoryRegion* memory_;
@@ -354,7 +356,7 @@ class MinidumpThreadList : public MinidumpStream {
 
   static const uint32_t kStreamType = MD_THREAD_LIST_STREAM;
 
-  bool Read(uint32_t aExpectedSize) override;
+  bool Read(off_t offset, uint32_t aExpectedSize) override;
 
   // The largest number of threads that will be read from a minidump.  The
   // default is 256.
@@ -421,7 +423,8 @@ class MinidumpModule : public MinidumpObject,
   // the various types.  Current toolchains generate modules which carry
   // MDCVInfoPDB70 by default.  Returns a pointer to the CodeView record on
   // success, and NULL on failure.  On success, the optional |size| argument
-  // is set to the size of the CodeView record.
+  // is set to the size of the CodeView record.  Like GetMiscRecord, this is
+  // safe to call from several threads at once.
   const uint8_t* GetCVRecord(uint32_t* size);
 
   // The miscellaneous debug record, which is obsolete.  Current toolchains
@@ -443,7 +446,7 @@ class MinidumpModule : public MinidumpObject,
   // This works like MinidumpStream::Read, but is driven by
   // MinidumpModuleList.  No size checking is done, because
   // MinidumpModuleList handles that directly.
-  bool Read();
+  bool Read(off_t offset);
 
   // Reads indirectly-referenced data, including the module name, CodeView
   // record, and miscellaneous debugging record.  This is necessary to allow
@@ -536,7 +539,7 @@ class MinidumpModuleList : public MinidumpStream,
 
   static const uint32_t kStreamType = MD_MODULE_LIST_STREAM;
 
-  bool Read(uint32_t expected_size);
+  bool Read(off_t offset, uint32_t expected_size);
 
   bool StoreRange(const MinidumpModule& module,
                   uint64_t base_address,
@@ -599,7 +602,7 @@ class MinidumpMemoryList : public MinidumpStream {
 
   explicit MinidumpMemoryList(Minidump* minidump);
 
-  bool Read(uint32_t expected_size) override;
+  bool Read(off_t offset, uint32_t expected_size) override;
 
   // The largest number of memory regions that will be read from a minidump.
   // The default is 256.
@@ -654,7 +657,7 @@ class MinidumpException : public MinidumpStream {
 
   explicit MinidumpException(Minidump* minidump);
 
-  bool Read(uint32_t expected_size) override;
+  bool Read(off_t offset, uint32_t expected_size) override;
 
   MDRawExceptionStream exception_;
   MinidumpContext*     context_;
@@ -694,7 +697,7 @@ class MinidumpAssertion : public MinidumpStream {
 
   explicit MinidumpAssertion(Minidump* minidump);
 
-  bool Read(uint32_t expected_size) override;
+  bool Read(off_t offset, uint32_t expected_size) override;
 
   MDRawAssertionInfo assertion_;
   string expression_;
@@ -751,7 +754,7 @@ class MinidumpSystemInfo : public MinidumpStream {
 
   static const uint32_t kStreamType = MD_SYSTEM_INFO_STREAM;
 
-  bool Read(uint32_t expected_size) override;
+  bool Read(off_t offset, uint32_t expected_size) override;
 
   // A string identifying the CPU vendor, if known.
   const string* cpu_vendor_;
@@ -796,7 +799,7 @@ class MinidumpUnloadedModule : public MinidumpObject,
 
   // This works like MinidumpStream::Read, but is driven by
   // MinidumpUnloadedModuleList.
-  bool Read(uint32_t expected_size);
+  bool Read(off_t offset, uint32_t expected_size);
 
   // Reads the module name. This is done separately from Read to
   // allow contiguous reading of code modules by MinidumpUnloadedModuleList.
@@ -855,7 +858,7 @@ class MinidumpUnloadedModuleList : public MinidumpStream,
 
   static const uint32_t kStreamType = MD_UNLOADED_MODULE_LIST_STREAM;
 
-  bool Read(uint32_t expected_size_) override;
+  bool Read(off_t offset, uint32_t expected_size_) override;
 
   // The largest number of modules that will be read from a minidump.  The
   // default is 1024.
@@ -891,7 +894,7 @@ class MinidumpMiscInfo : public MinidumpStream {
 
   explicit MinidumpMiscInfo(Minidump* minidump_);
 
-  bool Read(uint32_t expected_size_) override;
+  bool Read(off_t offset, uint32_t expected_size_) override;
 
   MDRawMiscInfo misc_info_;
 
@@ -932,13 +935,24 @@ class MinidumpBreakpadInfo : public MinidumpStream {
 
   explicit MinidumpBreakpadInfo(Minidump* minidump_);
 
-  bool Read(uint32_t expected_size_) override;
+  bool Read(off_t offset, uint32_t expected_size_) override;
 
   MDRawBreakpadInfo breakpad_info_;
 
   DISALLOW_COPY_AND_ASSIGN(MinidumpBreakpadInfo);
 };
 
+// MinidumpAddressRange is one entry of the address index that
+// MinidumpMemoryInfoList and MinidumpLinuxMapsList build when they are read:
+// a range [base, base + size) covered by the list element at index.  The
+// index is sorted by base and its ranges do not overlap, so an address can be
+// looked up by binary search, and a sorted batch of addresses in one pass.
+struct MinidumpAddressRange {
+  uint64_t base;
+  uint64_t size;
+  unsigned int index;
+};
+
 // MinidumpMemoryInfo wraps MDRawMemoryInfo, which provides information
 // about mapped memory regions in a process, including their ranges
 // and protection.
@@ -970,7 +984,7 @@ class MinidumpMemoryInfo : public MinidumpObject {
   // This works like MinidumpStream::Read, but is driven by
   // MinidumpMemoryInfoList.  No size checking is done, because
   // MinidumpMemoryInfoList handles that directly.
-  bool Read();
+  bool Read(off_t offset);
 
   MDRawMemoryInfo memory_info_;
 };
@@ -988,6 +1002,15 @@ class MinidumpMemoryInfoList : public MinidumpStream {
   const MinidumpMemoryInfo* GetMemoryInfoForAddress(uint64_t address) const;
   const MinidumpMemoryInfo* GetMemoryInfoAtIndex(unsigned int index) const;
 
+  // Looks up each of addresses, and sets the corresponding element of
+  // infos to the memory info containing it, or to NULL if there is none.
+  // addresses should be sorted in ascending order, which lets all of them be
+  // answered in a single pass over the list; unsorted addresses are still
+  // answered correctly, but more slowly.
+  void GetMemoryInfoForAddresses(
+      const vector<uint64_t>& addresses,
+      vector<const MinidumpMemoryInfo*>* infos) const;
+
   // Print a human-readable representation of the object to stdout.
   void Print();
 
@@ -1000,10 +1023,10 @@ class MinidumpMemoryInfoList : public MinidumpStream {
 
   explicit MinidumpMemoryInfoList(Minidump* minidump_);
 
-  bool Read(uint32_t expected_size) override;
+  bool Read(off_t offset, uint32_t expected_size) override;
 
   // Access to memory info using addresses as the key.
-  RangeMap<uint64_t, unsigned int>* range_map_;
+  vector<MinidumpAddressRange> ranges_;
 
   MinidumpMemoryInfos* infos_;
   uint32_t info_count_;
@@ -1075,7 +1098,15 @@ class MinidumpLinuxMapsList : public MinidumpStream {
   unsigned int get_maps_count() const { return valid_ ? maps_count_ : 0; }
 
   // Get mapping at the given memory address. The caller owns the pointer.
+  // Returns NULL, without logging, if no mapping contains the address.
   const MinidumpLinuxMaps* GetLinuxMapsForAddress(uint64_t address) const;
+  // Get the mapping containing each of addresses, or NULL where there is
+  // none, in the corresponding element of maps.  addresses should be sorted
+  // in ascending order, which lets all of them be answered in a single pass
+  // over the mappings; unsorted addresses are answered more slowly.
+  void GetLinuxMapsForAddresses(
+      const vector<uint64_t>& addresses,
+      vector<const MinidumpLinuxMaps*>* maps) const;
   // Get mapping at the given index. The caller owns the pointer.
   const MinidumpLinuxMaps* GetLinuxMapsAtIndex(unsigned int index) const;
 
@@ -1095,10 +1126,14 @@ class MinidumpLinuxMapsList : public MinidumpStream {
   // Read and load the contents of the process mapping data.
   // The stream should have data in the form of /proc/self/maps.
   // This method returns whether the stream was read successfully.
-  bool Read(uint32_t expected_size) override;
+  bool Read(off_t offset, uint32_t expected_size) override;
 
   // The list of individual mappings.
   MinidumpLinuxMappings* maps_;
+  // The mappings' address ranges, for lookups by address.  Where mappings
+  // overlap, an address belongs to the first of them in the list, so a
+  // mapping may be split into several ranges.  Empty mappings are left out.
+  vector<MinidumpAddressRange> ranges_;
   // The number of mappings.
   uint32_t maps_count_;
 
@@ -1124,7 +1159,7 @@ class MinidumpCrashpadInfo : public MinidumpStream {
 
   explicit MinidumpCrashpadInfo(Minidump* minidump_);
 
-  bool Read(uint32_t expected_size);
+  bool Read(off_t offset, uint32_t expected_size);
 
   MDRawCrashpadInfo crashpad_info_;
   std::vector<uint32_t> module_crashpad_info_links_;
@@ -1146,7 +1181,8 @@ class Minidump {
                     unsigned int hexdump_width=16);
   // input is an istream wrapping minidump data. Minidump holds a
   // weak pointer to input, and the caller must ensure that the stream
-  // is valid as long as the Minidump object is.
+  // is valid as long as the Minidump object is.  As with a file, gzipped
+  // data is decompressed into memory when the minidump is read.
   explicit Minidump(std::istream& input);
 
   virtual ~Minidump();
@@ -1172,9 +1208,7 @@ class Minidump {
   // if the CPU type bits were set in the context_flags of a context record.
   // On success, context_cpu_flags will have the flags that identify the CPU.
   // If a system info stream is missing, context_cpu_flags will be 0.
-  // Returns true if the current position in the stream was not changed.
-  // Returns false when the current location in the stream was changed and the
-  // attempt to restore the original position failed.
+  // The current position in the stream is not changed.  Always returns true.
   bool GetContextCPUFlagsFromSystemInfo(uint32_t* context_cpu_flags);
 
   // Reads the minidump file's header and top-level stream directory.
@@ -1212,7 +1246,17 @@ class Minidump {
   }
   const MDRawDirectory* GetDirectoryEntryAtIndex(unsigned int index) const;
 
-  // The next 2 methods are lower-level I/O routines.  They use fd_.
+  // The next methods are lower-level I/O routines.
+
+  // Reads count bytes from the minidump at offset into the storage area
+  // pointed to by bytes.  bytes must be of sufficient size.  This does not
+  // use or change the current position, and may be called from several
+  // threads at once.  All of the Minidump* classes read through this.
+  bool ReadBytesAt(off_t offset, void* bytes, size_t count);
+
+  // ReadBytes, SeekSet and Tell share a single current position, and are
+  // kept for callers that walk the minidump sequentially.  They must not be
+  // used from more than one thread at a time.
 
   // Reads count bytes from the minidump at the current position into
   // the storage area pointed to by bytes.  bytes must be of sufficient
@@ -1254,6 +1298,12 @@ class Minidump {
   // type in a single minidump file.
   bool SeekToStreamType(uint32_t stream_type, uint32_t* stream_length);
 
+  // Like SeekToStreamType, but sets *stream_offset to the offset of the
+  // stream instead of moving the current position.
+  bool LocateStreamType(uint32_t stream_type,
+                        off_t* stream_offset,
+                        uint32_t* stream_length);
+
   bool swap() const { return valid_ ? swap_ : false; }
 
   bool is_big_endian() const { return valid_ ? is_big_endian_ : false; }
@@ -1272,6 +1322,13 @@ class Minidump {
   unsigned int HexdumpMode() const { return hexdump_ ? hexdump_width_ : 0; }
 
  private:
+  // Lazily-read fields of the Minidump* classes are published under
+  // cache_lock_.
+  friend class MinidumpMemoryRegion;
+  friend class MinidumpThread;
+  friend class MinidumpModule;
+  friend class MinidumpException;
+
   // MinidumpStreamInfo is used in the MinidumpStreamMap.  It lets
   // the Minidump object locate interesting streams quickly, and
   // provides a convenient place to stash MinidumpStream objects.
@@ -1294,6 +1351,14 @@ class Minidump {
   // Opens the minidump file, or if already open, seeks to the beginning.
   bool Open();
 
+  // Inflates the gzipped minidump being opened into contents_, reading it
+  // through ReadAt.  Only built with zlib.
+  bool Decompress();
+
+  // Reads up to count bytes at offset into bytes, setting *bytes_read to
+  // the number read.  Short reads are not logged.  Returns false on error.
+  bool ReadAt(off_t offset, void* bytes, size_t count, size_t* bytes_read);
+
   // The largest number of top-level streams that will be read from a minidump.
   // Note that streams are only read (and only consume memory) as needed,
   // when directed by the caller.  The default is 128.
@@ -1317,9 +1382,24 @@ class Minidump {
   // This may be empty if the minidump was opened directly from a stream.
   const string              path_;
 
-  // The stream for all file I/O.  Used by ReadBytes and SeekSet.
-  // Set based on the path in Open, or directly in the constructor.
+  // The source of the minidump's bytes.  fd_ is a file opened from path_ in
+  // Open and read with pread.  stream_ is the stream passed to the
+  // constructor (or, on Windows, a file opened from path_), and is read
+  // under io_lock_ because reading it moves its position.  contents_ holds
+  // a minidump that Open decompressed into memory from either, and once
+  // in_memory_ is set it is read in their place.
+  int                       fd_;
+  string                    contents_;
+  bool                      in_memory_;
   std::istream*             stream_;
+  std::mutex                io_lock_;
+
+  // The position used by ReadBytes, SeekSet and Tell.
+  off_t                     position_;
+
+  // Guards the stream objects cached in stream_map_ and the data that
+  // Minidump* objects read lazily.  It is never held during I/O.
+  std::mutex                cache_lock_;
 
   // swap_ is true if the minidump file should be byte-swapped.  If the
   // minidump was produced by a CPU that is other-endian than the CPU
@@ -41,6 +41,7 @@ namespace google_breakpad {
 
 class Minidump;
 class ProcessState;
+struct ProcessingStats;
 class StackFrameSymbolizer;
 class SourceLineResolverInterface;
 class SymbolSupplier;
@@ -127,6 +128,11 @@ class MinidumpProcessor {
 
   void set_enable_objdump(bool enabled) { enable_objdump_ = enabled; }
 
+  // If |stats| is not NULL, each Process call clears it and records in it
+  // where that call's time went.  Does not take ownership of |stats|,
+  // which must outlive any Process call made while it is set.
+  void set_stats(ProcessingStats* stats) { stats_ = stats; }
+
  private:
   StackFrameSymbolizer* frame_symbolizer_;
   // Indicate whether resolver_helper_ is owned by this instance.
@@ -140,6 +146,9 @@ class MinidumpProcessor {
   // This flag permits the exploitability scanner to shell out to objdump
   // for purposes of disassembly.
   bool enable_objdump_;
+
+  // Where to record timings and counters, or NULL.
+  ProcessingStats* stats_;
 };
 
 }  // namespace google_breakpad
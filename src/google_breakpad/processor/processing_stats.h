@@ -0,0 +1,116 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// processing_stats.h: Timings and counters describing where
+// MinidumpProcessor spent its time on a dump.
+//
+// Collection is off unless the caller hands a ProcessingStats to
+// MinidumpProcessor::set_stats.  When it is off, the instrumented code
+// pays one NULL check per frame, stack scan and symbol lookup.
+
+#ifndef GOOGLE_BREAKPAD_PROCESSOR_PROCESSING_STATS_H__
+#define GOOGLE_BREAKPAD_PROCESSOR_PROCESSING_STATS_H__
+
+#include <time.h>
+
+#include <vector>
+
+#include "google_breakpad/common/breakpad_types.h"
+#include "google_breakpad/processor/stack_frame.h"
+
+namespace google_breakpad {
+
+struct ProcessingStats {
+  // One past the largest StackFrame::FrameTrust value.
+  static const int kFrameTrustCount = StackFrame::FRAME_TRUST_CONTEXT + 1;
+
+  ProcessingStats() { Clear(); }
+
+  void Clear() {
+    read_dump_us = 0;
+    locate_symbols_us = 0;
+    parse_symbols_us = 0;
+    walk_us = 0;
+    thread_walk_us.clear();
+    for (int i = 0; i < kFrameTrustCount; ++i)
+      frames_by_trust[i] = 0;
+    words_scanned = 0;
+    symbol_cache_hits = 0;
+    symbol_negative_cache_hits = 0;
+    symbol_files_loaded = 0;
+    symbol_files_missing = 0;
+    symbol_bytes_parsed = 0;
+  }
+
+  // Returns a monotonic time in microseconds, for timing phases.
+  static uint64_t NowMicroseconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+  }
+
+  // Time spent reading the minidump file and the streams processing
+  // needs before any thread is walked, in microseconds.
+  uint64_t read_dump_us;
+
+  // Time spent in SymbolSupplier finding and reading symbol files.
+  uint64_t locate_symbols_us;
+
+  // Time spent in the SourceLineResolver parsing symbol files.
+  uint64_t parse_symbols_us;
+
+  // Time spent walking all threads, including the symbol time above.
+  uint64_t walk_us;
+
+  // Time spent walking each thread, in ProcessState::threads() order.
+  std::vector<uint64_t> thread_walk_us;
+
+  // The number of frames found by each method, indexed by
+  // StackFrame::FrameTrust.
+  uint64_t frames_by_trust[kFrameTrustCount];
+
+  // The number of stack words examined while scanning for return
+  // addresses.
+  uint64_t words_scanned;
+
+  // Symbol lookups for modules whose symbols were already loaded, and for
+  // modules already known to have no symbols.
+  uint64_t symbol_cache_hits;
+  uint64_t symbol_negative_cache_hits;
+
+  // Symbol files loaded into the resolver, modules for which none was
+  // found or loadable, and the size of the symbol data loaded.
+  uint64_t symbol_files_loaded;
+  uint64_t symbol_files_missing;
+  uint64_t symbol_bytes_parsed;
+};
+
+}  // namespace google_breakpad
+
+#endif  // GOOGLE_BREAKPAD_PROCESSOR_PROCESSING_STATS_H__
@@ -45,6 +45,7 @@
 namespace google_breakpad {
 class CFIFrameInfo;
 class CodeModules;
+struct ProcessingStats;
 class SymbolSupplier;
 class SourceLineResolverInterface;
 struct StackFrame;
@@ -97,12 +98,17 @@ class StackFrameSymbolizer {
   SourceLineResolverInterface* resolver() { return resolver_; }
   SymbolSupplier* supplier() { return supplier_; }
 
+  // Records symbol lookup counts and the time spent locating and loading
+  // symbol files in |stats|, if it is not NULL.
+  void set_stats(ProcessingStats* stats) { stats_ = stats; }
+
  protected:
   SymbolSupplier* supplier_;
   SourceLineResolverInterface* resolver_;
   // A list of modules known to have symbols missing. This helps avoid
   // repeated lookups for the missing symbols within one minidump.
   std::set<string> no_symbol_modules_;
+  ProcessingStats* stats_;
 };
 
 }  // namespace google_breakpad
@@ -49,6 +49,7 @@
 #include "google_breakpad/common/breakpad_types.h"
 #include "google_breakpad/processor/code_modules.h"
 #include "google_breakpad/processor/memory_region.h"
+#include "google_breakpad/processor/processing_stats.h"
 #include "google_breakpad/processor/stack_frame_symbolizer.h"
 
 namespace google_breakpad {
@@ -103,6 +104,16 @@ class Stackwalker {
     max_frames_scanned_ = max_frames_scanned;
   }
 
+  // Stops this walker's Walk after |frame_limit| frames, without treating
+  // the truncation as an error.  Callers that only need the innermost
+  // frames use this to avoid unwinding, and loading symbols for, the rest
+  // of the stack.  0, the default, means no limit beyond max_frames().
+  void set_frame_limit(uint32_t frame_limit) { frame_limit_ = frame_limit; }
+
+  // Counts the frames this walker finds by each method, and the stack
+  // words it scans, in |stats|, if it is not NULL.
+  void set_stats(ProcessingStats* stats) { stats_ = stats; }
+
  protected:
   // system_info identifies the operating system, NULL or empty if unknown.
   // memory identifies a MemoryRegion that provides the stack memory
@@ -175,6 +186,8 @@ class Stackwalker {
       InstructionType ip;
       if (!memory_->GetMemoryAtAddress(location, &ip))
         break;
+      if (stats_)
+        ++stats_->words_scanned;
 
       // The return address points to the instruction after a call. If the
       // caller was a no return function, this might point past the end of the
@@ -212,6 +225,9 @@ class Stackwalker {
   // The StackFrameSymbolizer implementation.
   StackFrameSymbolizer* frame_symbolizer_;
 
+  // Where to count frames and scanned words, or NULL.
+  ProcessingStats* stats_;
+
  private:
   // Obtains the context frame, the innermost called procedure in a stack
   // trace.  Returns NULL on failure.  GetContextFrame allocates a new
@@ -253,6 +269,9 @@ class Stackwalker {
   // disable or limit it is helpful in cases where unwind performance is
   // important.  This defaults to 1024, the same as max_frames_.
   static uint32_t max_frames_scanned_;
+
+  // The per-walker frame limit set by set_frame_limit, or 0.
+  uint32_t frame_limit_;
 };
 
 }  // namespace google_breakpad
@@ -344,7 +344,8 @@ CFIFrameInfo* BasicSourceLineResolver::Module::FindCFIFrameInfo(
   // Create a frame info structure, and populate it with the rules from
   // the STACK CFI INIT record.
   scoped_ptr<CFIFrameInfo> rules(new CFIFrameInfo());
-  if (!ParseCFIRuleSet(initial_rules, rules.get()))
+  const string* rule_set = ExpandCFIRuleSet(initial_rules);
+  if (!rule_set || !ParseCFIRuleSet(*rule_set, rules.get()))
     return NULL;
 
   // Find the first delta rule that falls within the initial rule's range.
@@ -353,13 +354,26 @@ CFIFrameInfo* BasicSourceLineResolver::Module::FindCFIFrameInfo(
 
   // Apply delta rules up to and including the frame's address.
   while (delta != cfi_delta_rules_.end() && delta->first <= address) {
-    ParseCFIRuleSet(delta->second, rules.get());
+    rule_set = ExpandCFIRuleSet(delta->second);
+    if (rule_set)
+      ParseCFIRuleSet(*rule_set, rules.get());
     delta++;
   }
 
   return rules.release();
 }
 
+const string* BasicSourceLineResolver::Module::ExpandCFIRuleSet(
+    const string& rules) const {
+  if (rules.empty() || rules[0] != '@')
+    return &rules;
+  map<int, string>::const_iterator rule_set =
+      cfi_rule_sets_.find(strtoul(rules.c_str() + 1, NULL, 16));
+  if (rule_set == cfi_rule_sets_.end())
+    return NULL;
+  return &rule_set->second;
+}
+
 bool BasicSourceLineResolver::Module::ParseFile(char* file_line) {
   long index;
   char* filename;
@@ -506,6 +520,18 @@ bool BasicSourceLineResolver::Module::ParseCFIFrameInfo(
     return true;
   }
 
+  if (strcmp(init_or_address, "RULES") == 0) {
+    // This record has the form "STACK RULES <index> <rules...>".
+    char* index_field = strtok_r(NULL, " \r\n", &cursor);
+    if (!index_field) return false;
+
+    char* rules = strtok_r(NULL, "\r\n", &cursor);
+    if (!rules) return false;
+
+    cfi_rule_sets_[strtoul(index_field, NULL, 16)] = rules;
+    return true;
+  }
+
   // This record has the form "STACK <address> <rules...>".
   char* address_field = init_or_address;
   char* delta_rules = strtok_r(NULL, "\r\n", &cursor);
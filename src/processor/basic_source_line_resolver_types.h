@@ -142,6 +142,11 @@ class BasicSourceLineResolver::Module : public SourceLineResolverBase::Module {
   // Parses a STACK CFI record, storing it in cfi_frame_info_.
   bool ParseCFIFrameInfo(char* stack_info_line);
 
+  // Return the rule set a STACK CFI record's RULES text stands for: the
+  // shared rule set it refers to, if it is an '@' reference, or RULES
+  // itself. Return NULL if the referenced rule set is not defined.
+  const string* ExpandCFIRuleSet(const string& rules) const;
+
   string name_;
   FileMap files_;
   RangeMap< MemAddr, linked_ptr<Function> > functions_;
@@ -172,6 +177,12 @@ class BasicSourceLineResolver::Module : public SourceLineResolverBase::Module {
   // this map, or the end of the range as given by the cfi_initial_rules_
   // entry (which FindCFIFrameInfo looks up first).
   std::map<MemAddr, string> cfi_delta_rules_;
+
+  // STACK CFI RULES records: rule sets shared by many STACK CFI INIT and
+  // STACK CFI records, indexed by the number those records use to refer
+  // to them. Records that share a rule set store only the "@<index>"
+  // reference, which is short enough to need no heap storage of its own.
+  std::map<int, string> cfi_rule_sets_;
 };
 
 }  // namespace google_breakpad
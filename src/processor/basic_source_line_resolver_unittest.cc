@@ -381,6 +381,76 @@ TEST_F(TestBasicSourceLineResolver, TestLoadAndResolve)
   ASSERT_EQ(frame.function_name, "Public2_2");
 }
 
+TEST_F(TestBasicSourceLineResolver, TestSharedCFIRules)
+{
+  TestCodeModule module5("module5");
+  ASSERT_TRUE(resolver.LoadModule(&module5, testdata_dir + "/module5.out"));
+  ASSERT_TRUE(resolver.HasModule(&module5));
+
+  StackFrame frame;
+  scoped_ptr<CFIFrameInfo> cfi_frame_info;
+  CFIFrameInfo::RegisterValueMap<uint32_t> current_registers;
+  CFIFrameInfo::RegisterValueMap<uint32_t> caller_registers;
+  CFIFrameInfo::RegisterValueMap<uint32_t> expected_caller_registers;
+  MockMemoryRegion memory;
+
+  expected_caller_registers[".cfa"] = 0x1001c;
+  expected_caller_registers[".ra"]  = 0xf6438648;
+  expected_caller_registers["$ebp"] = 0x10038;
+  expected_caller_registers["$ebx"] = 0x98ecadc3;
+  expected_caller_registers["$esi"] = 0x878f7524;
+  expected_caller_registers["$edi"] = 0x6312f9a5;
+
+  // An initial rule set given by reference.
+  frame.instruction = 0x3d40;
+  frame.module = &module5;
+  current_registers["$esp"] = 0x10018;
+  current_registers["$ebp"] = 0x10038;
+  current_registers["$ebx"] = 0x98ecadc3;
+  current_registers["$esi"] = 0x878f7524;
+  current_registers["$edi"] = 0x6312f9a5;
+  cfi_frame_info.reset(resolver.FindCFIFrameInfo(&frame));
+  ASSERT_TRUE(cfi_frame_info.get());
+  ASSERT_TRUE(cfi_frame_info.get()
+              ->FindCallerRegs<uint32_t>(current_registers, memory,
+                                          &caller_registers));
+  ASSERT_TRUE(VerifyRegisters(__FILE__, __LINE__,
+                              expected_caller_registers, caller_registers));
+
+  // Shared and inline delta rule sets, applied in turn.
+  frame.instruction = 0x3d84;
+  current_registers["$esp"] = 0x10014;
+  current_registers["$ebp"] = 0x10014;
+  current_registers["$ebx"] = 0x6864f054U;
+  current_registers["$esi"] = 0x6285f79aU;
+  current_registers["$edi"] = 0x64061449U;
+  cfi_frame_info.reset(resolver.FindCFIFrameInfo(&frame));
+  ASSERT_TRUE(cfi_frame_info.get());
+  ASSERT_TRUE(cfi_frame_info.get()
+              ->FindCallerRegs<uint32_t>(current_registers, memory,
+                                          &caller_registers));
+  ASSERT_TRUE(VerifyRegisters(__FILE__, __LINE__,
+                              expected_caller_registers, caller_registers));
+
+  // The same shared rule sets, used by a second function.
+  frame.instruction = 0x3df3;
+  current_registers.clear();
+  current_registers["$esp"] = 0x10014;
+  current_registers["$ebp"] = 0x10014;
+  cfi_frame_info.reset(resolver.FindCFIFrameInfo(&frame));
+  ASSERT_TRUE(cfi_frame_info.get());
+  ASSERT_TRUE(cfi_frame_info.get()
+              ->FindCallerRegs<uint32_t>(current_registers, memory,
+                                          &caller_registers));
+  EXPECT_EQ(0x1001cU, caller_registers[".cfa"]);
+  EXPECT_EQ(0x10038U, caller_registers["$ebp"]);
+
+  // A reference to a rule set that is never defined.
+  frame.instruction = 0x3ea4;
+  cfi_frame_info.reset(resolver.FindCFIFrameInfo(&frame));
+  ASSERT_FALSE(cfi_frame_info.get());
+}
+
 TEST_F(TestBasicSourceLineResolver, TestInvalidLoads)
 {
   TestCodeModule module3("module3");
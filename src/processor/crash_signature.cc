@@ -0,0 +1,397 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// crash_signature.cc: CrashSignatureGenerator implementation.
+//
+// See crash_signature.h for documentation.
+
+#include "google_breakpad/processor/crash_signature.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <map>
+
+#include "google_breakpad/processor/call_stack.h"
+#include "google_breakpad/processor/code_module.h"
+#include "google_breakpad/processor/code_modules.h"
+#include "google_breakpad/processor/minidump.h"
+#include "google_breakpad/processor/minidump_processor.h"
+#include "google_breakpad/processor/stack_frame.h"
+#include "google_breakpad/processor/stackwalker.h"
+#include "google_breakpad/processor/symbol_supplier.h"
+#include "google_breakpad/processor/system_info.h"
+#include "processor/logging.h"
+#include "processor/pathname_stripper.h"
+
+namespace google_breakpad {
+
+namespace {
+
+// The symbol file records a stack walk uses.  Everything else, which is
+// FILE records and the line records following each FUNC, is dropped.
+const char* const kUnwindRecords[] = {
+  "MODULE ", "INFO ", "FUNC ", "PUBLIC ", "STACK "
+};
+
+bool IsUnwindRecord(const char* line, size_t length) {
+  for (size_t i = 0; i < sizeof(kUnwindRecords) / sizeof(kUnwindRecords[0]);
+       ++i) {
+    size_t prefix_length = strlen(kUnwindRecords[i]);
+    if (length >= prefix_length &&
+        memcmp(line, kUnwindRecords[i], prefix_length) == 0)
+      return true;
+  }
+  return false;
+}
+
+// Appends the records of the |size| bytes of symbol data at |data| that
+// IsUnwindRecord accepts to |out|.
+void AppendUnwindRecords(const char* data, size_t size, string* out) {
+  const char* end = data + size;
+  while (data < end && *data) {
+    const char* eol = static_cast<const char*>(memchr(data, '\n', end - data));
+    const char* next = eol ? eol + 1 : end;
+    if (IsUnwindRecord(data, next - data))
+      out->append(data, next - data);
+    data = next;
+  }
+}
+
+// A SymbolSupplier that hands out only the records of another supplier's
+// symbol files that AppendUnwindRecords keeps.  Line records are most of a
+// typical symbol file, and most of the cost of loading it.
+class UnwindSymbolSupplier : public SymbolSupplier {
+ public:
+  explicit UnwindSymbolSupplier(SymbolSupplier* supplier)
+      : supplier_(supplier) {}
+  virtual ~UnwindSymbolSupplier();
+
+  virtual SymbolResult GetSymbolFile(const CodeModule* module,
+                                     const SystemInfo* system_info,
+                                     string* symbol_file);
+  virtual SymbolResult GetSymbolFile(const CodeModule* module,
+                                     const SystemInfo* system_info,
+                                     string* symbol_file,
+                                     string* symbol_data);
+  virtual SymbolResult GetCStringSymbolData(const CodeModule* module,
+                                            const SystemInfo* system_info,
+                                            string* symbol_file,
+                                            char** symbol_data,
+                                            size_t* symbol_data_size);
+  virtual void FreeSymbolData(const CodeModule* module);
+
+ private:
+  SymbolSupplier* supplier_;
+
+  // The buffers handed out by GetCStringSymbolData, by code file.
+  std::map<string, char*> memory_buffers_;
+};
+
+UnwindSymbolSupplier::~UnwindSymbolSupplier() {
+  for (std::map<string, char*>::iterator it = memory_buffers_.begin();
+       it != memory_buffers_.end(); ++it) {
+    delete [] it->second;
+  }
+}
+
+SymbolSupplier::SymbolResult UnwindSymbolSupplier::GetSymbolFile(
+    const CodeModule* module,
+    const SystemInfo* system_info,
+    string* symbol_file) {
+  return supplier_->GetSymbolFile(module, system_info, symbol_file);
+}
+
+SymbolSupplier::SymbolResult UnwindSymbolSupplier::GetSymbolFile(
+    const CodeModule* module,
+    const SystemInfo* system_info,
+    string* symbol_file,
+    string* symbol_data) {
+  if (!symbol_data)
+    return supplier_->GetSymbolFile(module, system_info, symbol_file, NULL);
+
+  string all_data;
+  SymbolResult result =
+      supplier_->GetSymbolFile(module, system_info, symbol_file, &all_data);
+  symbol_data->clear();
+  if (result == FOUND)
+    AppendUnwindRecords(all_data.data(), all_data.size(), symbol_data);
+  return result;
+}
+
+SymbolSupplier::SymbolResult UnwindSymbolSupplier::GetCStringSymbolData(
+    const CodeModule* module,
+    const SystemInfo* system_info,
+    string* symbol_file,
+    char** symbol_data,
+    size_t* symbol_data_size) {
+  assert(symbol_data);
+  assert(symbol_data_size);
+
+  char* all_data = NULL;
+  size_t all_data_size = 0;
+  SymbolResult result = supplier_->GetCStringSymbolData(
+      module, system_info, symbol_file, &all_data, &all_data_size);
+  if (result != FOUND)
+    return result;
+
+  string data;
+  AppendUnwindRecords(all_data, all_data_size, &data);
+  supplier_->FreeSymbolData(module);
+
+  FreeSymbolData(module);
+  char* buffer = new char[data.size() + 1];
+  memcpy(buffer, data.data(), data.size());
+  buffer[data.size()] = '\0';
+  memory_buffers_[module->code_file()] = buffer;
+
+  *symbol_data = buffer;
+  *symbol_data_size = data.size() + 1;
+  return FOUND;
+}
+
+void UnwindSymbolSupplier::FreeSymbolData(const CodeModule* module) {
+  if (!module) {
+    BPLOG(INFO) << "Cannot free symbol data buffer for NULL module";
+    return;
+  }
+
+  std::map<string, char*>::iterator it =
+      memory_buffers_.find(module->code_file());
+  if (it != memory_buffers_.end()) {
+    delete [] it->second;
+    memory_buffers_.erase(it);
+  }
+}
+
+// 64-bit FNV-1a.
+const uint64_t kFNVOffsetBasis = 0xcbf29ce484222325ULL;
+const uint64_t kFNVPrime = 0x100000001b3ULL;
+
+uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= kFNVPrime;
+  }
+  return hash;
+}
+
+// Hashes |frame| into |hash|: its module name with its terminating NUL,
+// then its offset as 8 little-endian bytes.  A frame outside any module
+// hashes as an empty module name alone.
+uint64_t HashFrame(uint64_t hash, const CrashSignatureFrame& frame) {
+  hash = HashBytes(hash, frame.module.c_str(), frame.module.size() + 1);
+  if (frame.module.empty())
+    return hash;
+  uint8_t offset[8];
+  for (int i = 0; i < 8; ++i)
+    offset[i] = static_cast<uint8_t>(frame.offset >> (i * 8));
+  return HashBytes(hash, offset, sizeof(offset));
+}
+
+}  // namespace
+
+CrashSignatureGenerator::CrashSignatureGenerator(SymbolSupplier* supplier)
+    : supplier_(supplier ? new UnwindSymbolSupplier(supplier) : NULL),
+      resolver_(),
+      frame_symbolizer_(supplier_.get(), &resolver_),
+      frame_count_(kDefaultFrameCount) {
+}
+
+CrashSignatureGenerator::~CrashSignatureGenerator() {
+}
+
+ProcessResult CrashSignatureGenerator::Generate(const string& minidump_file,
+                                                CrashSignature* signature) {
+  BPLOG(INFO) << "Generating crash signature for " << minidump_file;
+
+  Minidump dump(minidump_file);
+  if (!dump.Read()) {
+     BPLOG(ERROR) << "Minidump " << dump.path() << " could not be read";
+     return PROCESS_ERROR_MINIDUMP_NOT_FOUND;
+  }
+
+  return Generate(&dump, signature);
+}
+
+ProcessResult CrashSignatureGenerator::Generate(Minidump* dump,
+                                                CrashSignature* signature) {
+  assert(dump);
+  assert(signature);
+
+  signature->hash = kFNVOffsetBasis;
+  signature->thread_id = 0;
+  signature->frames.clear();
+
+  if (!dump->header()) {
+    BPLOG(ERROR) << "Minidump " << dump->path() << " has no header";
+    return PROCESS_ERROR_NO_MINIDUMP_HEADER;
+  }
+
+  SystemInfo system_info;
+  MinidumpProcessor::GetCPUInfo(dump, &system_info);
+  MinidumpProcessor::GetOSInfo(dump, &system_info);
+
+  MinidumpThreadList* threads = dump->GetThreadList();
+  if (!threads) {
+    BPLOG(ERROR) << "Minidump " << dump->path() << " has no thread list";
+    return PROCESS_ERROR_NO_THREAD_LIST;
+  }
+
+  // The crashing thread is the one the exception stream names, walked from
+  // the exception context.  Without an exception, use the thread that
+  // requested the dump, walked from its own context.
+  uint32_t thread_id = 0;
+  bool has_thread_id = false;
+  MinidumpContext* context = NULL;
+  MinidumpException* exception = dump->GetException();
+  if (exception && exception->GetThreadID(&thread_id)) {
+    has_thread_id = true;
+    context = exception->GetContext();
+  } else {
+    MinidumpBreakpadInfo* breakpad_info = dump->GetBreakpadInfo();
+    has_thread_id = breakpad_info &&
+                    breakpad_info->GetRequestingThreadID(&thread_id);
+  }
+  if (!has_thread_id) {
+    BPLOG(ERROR) << "Minidump " << dump->path() << " has no crashing thread";
+    return PROCESS_ERROR_GETTING_THREAD_ID;
+  }
+
+  MinidumpThread* thread = threads->GetThreadByID(thread_id);
+  if (!thread) {
+    BPLOG(ERROR) << "Minidump " << dump->path() << " has no thread " <<
+        HexString(thread_id);
+    return PROCESS_ERROR_GETTING_THREAD;
+  }
+  if (!context)
+    context = thread->GetContext();
+
+  MinidumpMemoryRegion* thread_memory = thread->GetMemory();
+  if (!thread_memory) {
+    MinidumpMemoryList* memory_list = dump->GetMemoryList();
+    uint64_t start_stack_memory_range = thread->GetStartOfStackMemoryRange();
+    if (memory_list && start_stack_memory_range) {
+      thread_memory = memory_list->GetMemoryRegionForAddress(
+          start_stack_memory_range);
+    }
+  }
+  if (!thread_memory) {
+    BPLOG(ERROR) << "No memory region for thread " << HexString(thread_id);
+  }
+
+  signature->thread_id = thread_id;
+
+  UnloadStaleSymbols(dump->GetModuleList());
+  frame_symbolizer_.Reset();
+  scoped_ptr<Stackwalker> stackwalker(
+      Stackwalker::StackwalkerForCPU(&system_info,
+                                     context,
+                                     thread_memory,
+                                     dump->GetModuleList(),
+                                     dump->GetUnloadedModuleList(),
+                                     &frame_symbolizer_));
+  if (!stackwalker.get()) {
+    BPLOG(ERROR) << "No stackwalker for thread " << HexString(thread_id);
+    return PROCESS_ERROR_GETTING_THREAD;
+  }
+  stackwalker->set_frame_limit(frame_count_);
+
+  CallStack stack;
+  vector<const CodeModule*> modules_without_symbols;
+  vector<const CodeModule*> modules_with_corrupt_symbols;
+  const bool walked = stackwalker->Walk(&stack, &modules_without_symbols,
+                                        &modules_with_corrupt_symbols);
+  RecordLoadedSymbols(dump->GetModuleList());
+  if (!walked) {
+    BPLOG(INFO) << "Stackwalker interrupt (missing symbols?) at thread " <<
+        HexString(thread_id);
+    return PROCESS_SYMBOL_SUPPLIER_INTERRUPTED;
+  }
+
+  const vector<StackFrame*>* frames = stack.frames();
+  for (vector<StackFrame*>::const_iterator it = frames->begin();
+       it != frames->end(); ++it) {
+    const StackFrame* frame = *it;
+    CrashSignatureFrame signature_frame;
+    if (frame->module) {
+      signature_frame.module =
+          PathnameStripper::File(frame->module->code_file());
+      signature_frame.offset =
+          frame->instruction - frame->module->base_address();
+    } else {
+      signature_frame.offset = frame->instruction;
+    }
+    signature->hash = HashFrame(signature->hash, signature_frame);
+    signature->frames.push_back(signature_frame);
+  }
+
+  return PROCESS_OK;
+}
+
+void CrashSignatureGenerator::UnloadStaleSymbols(const CodeModules* modules) {
+  if (!modules)
+    return;
+  for (unsigned int i = 0; i < modules->module_count(); ++i) {
+    const CodeModule* module = modules->GetModuleAtIndex(i);
+    std::map<string, string>::iterator loaded =
+        loaded_debug_identifiers_.find(module->code_file());
+    if (loaded == loaded_debug_identifiers_.end() ||
+        loaded->second == module->debug_identifier())
+      continue;
+    BPLOG(INFO) << "Unloading symbols for " << module->code_file() <<
+        " " << loaded->second << ", the dump has " <<
+        module->debug_identifier();
+    resolver_.UnloadModule(module);
+    loaded_debug_identifiers_.erase(loaded);
+  }
+}
+
+void CrashSignatureGenerator::RecordLoadedSymbols(const CodeModules* modules) {
+  if (!modules)
+    return;
+  for (unsigned int i = 0; i < modules->module_count(); ++i) {
+    const CodeModule* module = modules->GetModuleAtIndex(i);
+    if (resolver_.HasModule(module))
+      loaded_debug_identifiers_[module->code_file()] =
+          module->debug_identifier();
+  }
+}
+
+// static
+string CrashSignatureGenerator::HashString(uint64_t hash) {
+  char buffer[17];
+  snprintf(buffer, sizeof(buffer), "%016llx",
+           static_cast<unsigned long long>(hash));
+  return buffer;
+}
+
+}  // namespace google_breakpad
@@ -0,0 +1,256 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Unit test for CrashSignatureGenerator.
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "breakpad_googletest_includes.h"
+#include "common/using_std_string.h"
+#include "google_breakpad/processor/basic_source_line_resolver.h"
+#include "google_breakpad/processor/call_stack.h"
+#include "google_breakpad/processor/code_module.h"
+#include "google_breakpad/processor/crash_signature.h"
+#include "google_breakpad/processor/minidump.h"
+#include "google_breakpad/processor/minidump_processor.h"
+#include "google_breakpad/processor/process_state.h"
+#include "google_breakpad/processor/stack_frame.h"
+#include "processor/pathname_stripper.h"
+#include "processor/simple_symbol_supplier.h"
+
+namespace {
+
+using google_breakpad::BasicSourceLineResolver;
+using google_breakpad::CallStack;
+using google_breakpad::CodeModule;
+using google_breakpad::CrashSignature;
+using google_breakpad::CrashSignatureGenerator;
+using google_breakpad::Minidump;
+using google_breakpad::MinidumpModule;
+using google_breakpad::MinidumpProcessor;
+using google_breakpad::PathnameStripper;
+using google_breakpad::ProcessState;
+using google_breakpad::SimpleSymbolSupplier;
+using google_breakpad::StackFrame;
+using google_breakpad::SystemInfo;
+using std::vector;
+
+string GetTestDataPath() {
+  char* srcdir = getenv("srcdir");
+
+  return string(srcdir ? srcdir : ".") + "/src/processor/testdata/";
+}
+
+// A SimpleSymbolSupplier that counts the symbol files it is asked for, by
+// code file.
+class CountingSymbolSupplier : public SimpleSymbolSupplier {
+ public:
+  explicit CountingSymbolSupplier(const string& path)
+      : SimpleSymbolSupplier(path) {}
+
+  virtual SymbolResult GetCStringSymbolData(const CodeModule* module,
+                                            const SystemInfo* system_info,
+                                            string* symbol_file,
+                                            char** symbol_data,
+                                            size_t* symbol_data_size) {
+    ++requests[PathnameStripper::File(module->code_file())];
+    return SimpleSymbolSupplier::GetCStringSymbolData(
+        module, system_info, symbol_file, symbol_data, symbol_data_size);
+  }
+
+  std::map<string, int> requests;
+};
+
+class CrashSignatureTest : public ::testing::Test {
+ public:
+  CrashSignatureTest()
+      : minidump_file_(GetTestDataPath() + "minidump2.dmp"),
+        supplier_(GetTestDataPath() + "symbols") {}
+
+  string minidump_file_;
+  SimpleSymbolSupplier supplier_;
+};
+
+TEST_F(CrashSignatureTest, WithoutSymbols) {
+  CrashSignatureGenerator generator(NULL);
+  CrashSignature signature;
+  ASSERT_EQ(google_breakpad::PROCESS_OK,
+            generator.Generate(minidump_file_, &signature));
+
+  ASSERT_FALSE(signature.frames.empty());
+  ASSERT_LE(signature.frames.size(),
+            static_cast<size_t>(CrashSignatureGenerator::kDefaultFrameCount));
+  ASSERT_EQ(0xbf4U, signature.thread_id);
+  ASSERT_EQ("test_app.exe", signature.frames[0].module);
+  ASSERT_EQ(0x429eU, signature.frames[0].offset);
+  ASSERT_EQ(16U, CrashSignatureGenerator::HashString(signature.hash).size());
+
+  // The signature depends only on the dump.
+  CrashSignatureGenerator other_generator(NULL);
+  CrashSignature other_signature;
+  ASSERT_EQ(google_breakpad::PROCESS_OK,
+            other_generator.Generate(minidump_file_, &other_signature));
+  ASSERT_EQ(signature.hash, other_signature.hash);
+}
+
+TEST_F(CrashSignatureTest, MatchesFullProcessing) {
+  // minidump2.dmp is walked with STACK WIN records, linux_overflow.dmp
+  // with STACK CFI records.
+  const char* const kMinidumps[] = { "minidump2.dmp", "linux_overflow.dmp" };
+  for (size_t m = 0; m < sizeof(kMinidumps) / sizeof(kMinidumps[0]); ++m) {
+    SCOPED_TRACE(kMinidumps[m]);
+    string minidump_file = GetTestDataPath() + kMinidumps[m];
+
+    BasicSourceLineResolver resolver;
+    MinidumpProcessor processor(&supplier_, &resolver);
+    ProcessState state;
+    ASSERT_EQ(google_breakpad::PROCESS_OK,
+              processor.Process(minidump_file, &state));
+    ASSERT_GE(state.requesting_thread(), 0);
+    const CallStack* stack = state.threads()->at(state.requesting_thread());
+    const vector<StackFrame*>* frames = stack->frames();
+
+    CrashSignatureGenerator generator(&supplier_);
+    CrashSignature signature;
+    ASSERT_EQ(google_breakpad::PROCESS_OK,
+              generator.Generate(minidump_file, &signature));
+
+    // Walking with the unwind records alone finds the same frames as a
+    // full walk with all of the symbol data.
+    ASSERT_EQ(stack->tid(), signature.thread_id);
+    ASSERT_EQ(std::min(frames->size(),
+                       static_cast<size_t>(
+                           CrashSignatureGenerator::kDefaultFrameCount)),
+              signature.frames.size());
+    for (size_t i = 0; i < signature.frames.size(); ++i) {
+      const StackFrame* frame = frames->at(i);
+      ASSERT_TRUE(frame->module);
+      EXPECT_EQ(PathnameStripper::File(frame->module->code_file()),
+                signature.frames[i].module);
+      EXPECT_EQ(frame->instruction - frame->module->base_address(),
+                signature.frames[i].offset);
+    }
+  }
+}
+
+TEST_F(CrashSignatureTest, FrameCount) {
+  CrashSignatureGenerator generator(&supplier_);
+  CrashSignature signature;
+  ASSERT_EQ(google_breakpad::PROCESS_OK,
+            generator.Generate(minidump_file_, &signature));
+  ASSERT_GT(signature.frames.size(), 2U);
+
+  generator.set_frame_count(2);
+  CrashSignature short_signature;
+  ASSERT_EQ(google_breakpad::PROCESS_OK,
+            generator.Generate(minidump_file_, &short_signature));
+  ASSERT_EQ(2U, short_signature.frames.size());
+  for (size_t i = 0; i < short_signature.frames.size(); ++i) {
+    EXPECT_EQ(signature.frames[i].module, short_signature.frames[i].module);
+    EXPECT_EQ(signature.frames[i].offset, short_signature.frames[i].offset);
+  }
+  EXPECT_NE(signature.hash, short_signature.hash);
+}
+
+TEST_F(CrashSignatureTest, DropsSymbolsOfOtherBuilds) {
+  // A copy of minidump2.dmp whose test_app.exe is a different build: one
+  // byte of its CodeView signature is changed.
+  std::ifstream file(minidump_file_.c_str(), std::ios::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  string other_build = contents.str();
+  {
+    Minidump dump(minidump_file_);
+    ASSERT_TRUE(dump.Read());
+    const MinidumpModule* module = static_cast<const MinidumpModule*>(
+        dump.GetModuleList()->GetMainModule());
+    ASSERT_TRUE(module);
+    ASSERT_EQ("test_app.exe", PathnameStripper::File(module->code_file()));
+    uint32_t cv_record_size;
+    const uint8_t* cv_record =
+        const_cast<MinidumpModule*>(module)->GetCVRecord(&cv_record_size);
+    ASSERT_TRUE(cv_record);
+    size_t offset = other_build.find(
+        string(reinterpret_cast<const char*>(cv_record), cv_record_size));
+    ASSERT_NE(string::npos, offset);
+    // Skip the record's four-byte signature to reach its GUID.
+    other_build[offset + 4] ^= 0xff;
+  }
+  std::istringstream other_build_stream(other_build);
+  Minidump other_build_dump(other_build_stream);
+  ASSERT_TRUE(other_build_dump.Read());
+
+  CountingSymbolSupplier supplier(GetTestDataPath() + "symbols");
+  CrashSignatureGenerator generator(&supplier);
+  CrashSignature signature;
+  ASSERT_EQ(google_breakpad::PROCESS_OK,
+            generator.Generate(minidump_file_, &signature));
+  ASSERT_EQ(1, supplier.requests["test_app.exe"]);
+
+  // The same build reuses the symbols already loaded.
+  ASSERT_EQ(google_breakpad::PROCESS_OK,
+            generator.Generate(minidump_file_, &signature));
+  ASSERT_EQ(1, supplier.requests["test_app.exe"]);
+
+  // Another build asks for its own symbols, which don't exist, so the
+  // walk has none.
+  CrashSignature other_signature;
+  ASSERT_EQ(google_breakpad::PROCESS_OK,
+            generator.Generate(&other_build_dump, &other_signature));
+  ASSERT_EQ(2, supplier.requests["test_app.exe"]);
+  CrashSignatureGenerator unsymbolized_generator(NULL);
+  CrashSignature unsymbolized_signature;
+  ASSERT_EQ(google_breakpad::PROCESS_OK,
+            unsymbolized_generator.Generate(&other_build_dump,
+                                            &unsymbolized_signature));
+  EXPECT_EQ(unsymbolized_signature.hash, other_signature.hash);
+
+  // And going back loads the first build's symbols again.
+  ASSERT_EQ(google_breakpad::PROCESS_OK,
+            generator.Generate(minidump_file_, &other_signature));
+  ASSERT_EQ(3, supplier.requests["test_app.exe"]);
+  EXPECT_EQ(signature.hash, other_signature.hash);
+}
+
+TEST_F(CrashSignatureTest, MissingMinidump) {
+  CrashSignatureGenerator generator(NULL);
+  CrashSignature signature;
+  ASSERT_EQ(google_breakpad::PROCESS_ERROR_MINIDUMP_NOT_FOUND,
+            generator.Generate(GetTestDataPath() + "nonexistent.dmp",
+                               &signature));
+}
+
+}  // namespace
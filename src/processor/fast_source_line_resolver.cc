@@ -40,12 +40,16 @@
 #include "google_breakpad/processor/fast_source_line_resolver.h"
 #include "processor/fast_source_line_resolver_types.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <map>
 #include <string>
 #include <utility>
 
 #include "common/scoped_ptr.h"
 #include "common/using_std_string.h"
+#include "processor/logging.h"
 #include "processor/module_factory.h"
 #include "processor/simple_serializer-inl.h"
 
@@ -158,22 +162,48 @@ bool FastSourceLineResolver::Module::LoadMapFromMemory(
     size_t memory_buffer_size) {
   if (!memory_buffer) return false;
 
+  // Check the format magic and version, then that the header and every map
+  // it describes lie inside the buffer. Anything else was written by a
+  // different serializer or is truncated, and reading it would run off the
+  // end of memory_buffer.
+  uint32_t format[2];
+  const size_t prefix_size = sizeof(format) + SimpleSerializer<bool>::SizeOf(0);
+  unsigned int header_size = kNumberMaps_ * sizeof(uint32_t);
+  if (memory_buffer_size < prefix_size + header_size) {
+    BPLOG(ERROR) << "Serialized module " << name_ << " is truncated";
+    return LoadEmptyMaps();
+  }
+  memcpy(format, memory_buffer, sizeof(format));
+  if (format[0] != kSerializedMagic_ || format[1] != kSerializedVersion_) {
+    BPLOG(ERROR) << "Serialized module " << name_ << " has format "
+                 << std::hex << format[0] << "/" << std::dec << format[1]
+                 << ", expected " << std::hex << kSerializedMagic_ << "/"
+                 << std::dec << kSerializedVersion_;
+    return LoadEmptyMaps();
+  }
+
   // Read the "is_corrupt" flag.
-  const char* mem_buffer = memory_buffer;
+  const char* mem_buffer = memory_buffer + sizeof(format);
   mem_buffer = SimpleSerializer<bool>::Read(mem_buffer, &is_corrupt_);
 
-  const uint32_t* map_sizes = reinterpret_cast<const uint32_t*>(mem_buffer);
-
-  unsigned int header_size = kNumberMaps_ * sizeof(unsigned int);
+  uint32_t map_sizes[kNumberMaps_];
+  memcpy(map_sizes, mem_buffer, header_size);
 
   // offsets[]: an array of offset addresses (with respect to mem_buffer),
   // for each "Static***Map" component of Module.
   // "Static***Map": static version of std::map or map wrapper, i.e., StaticMap,
   // StaticAddressMap, StaticContainedRangeMap, and StaticRangeMap.
   unsigned int offsets[kNumberMaps_];
-  offsets[0] = header_size;
-  for (int i = 1; i < kNumberMaps_; ++i) {
-    offsets[i] = offsets[i - 1] + map_sizes[i - 1];
+  uint64_t end = header_size;
+  for (int i = 0; i < kNumberMaps_; ++i) {
+    offsets[i] = static_cast<unsigned int>(end);
+    end += map_sizes[i];
+  }
+  if (end > memory_buffer_size - prefix_size) {
+    BPLOG(ERROR) << "Serialized module " << name_ << " has maps extending "
+                 << "past the end of its " << memory_buffer_size
+                 << "-byte buffer";
+    return LoadEmptyMaps();
   }
 
   // Use pointers to construct Static*Map data members in Module:
@@ -190,10 +220,32 @@ bool FastSourceLineResolver::Module::LoadMapFromMemory(
   cfi_initial_rules_ =
       StaticRangeMap<MemAddr, char>(mem_buffer + offsets[map_id++]);
   cfi_delta_rules_ = StaticMap<MemAddr, char>(mem_buffer + offsets[map_id++]);
+  cfi_rule_sets_ = StaticMap<int, char>(mem_buffer + offsets[map_id++]);
 
   return true;
 }
 
+// Points every map at an empty serialized map, so a module whose data was
+// rejected answers lookups with nothing rather than dereferencing NULL, and
+// marks the module corrupt. Always returns false.
+bool FastSourceLineResolver::Module::LoadEmptyMaps() {
+  // Zeroes read as an empty map of any of the Static*Map types; the largest,
+  // StaticContainedRangeMap<MemAddr, char>, spans 16 bytes.
+  static const uint64_t kEmptyMap[2] = { 0, 0 };
+  const char* empty = reinterpret_cast<const char*>(kEmptyMap);
+
+  files_ = StaticMap<int, char>(empty);
+  functions_ = StaticRangeMap<MemAddr, Function>(empty);
+  public_symbols_ = StaticAddressMap<MemAddr, PublicSymbol>(empty);
+  for (int i = 0; i < WindowsFrameInfo::STACK_INFO_LAST; ++i)
+    windows_frame_info_[i] = StaticContainedRangeMap<MemAddr, char>(empty);
+  cfi_initial_rules_ = StaticRangeMap<MemAddr, char>(empty);
+  cfi_delta_rules_ = StaticMap<MemAddr, char>(empty);
+  cfi_rule_sets_ = StaticMap<int, char>(empty);
+  is_corrupt_ = true;
+  return false;
+}
+
 WindowsFrameInfo* FastSourceLineResolver::Module::FindWindowsFrameInfo(
     const StackFrame* frame) const {
   MemAddr address = frame->instruction - frame->module->base_address();
@@ -265,7 +317,8 @@ CFIFrameInfo* FastSourceLineResolver::Module::FindCFIFrameInfo(
   // Create a frame info structure, and populate it with the rules from
   // the STACK CFI INIT record.
   scoped_ptr<CFIFrameInfo> rules(new CFIFrameInfo());
-  if (!ParseCFIRuleSet(initial_rules, rules.get()))
+  const char* rule_set = ExpandCFIRuleSet(initial_rules);
+  if (!rule_set || !ParseCFIRuleSet(rule_set, rules.get()))
     return NULL;
 
   // Find the first delta rule that falls within the initial rule's range.
@@ -274,11 +327,24 @@ CFIFrameInfo* FastSourceLineResolver::Module::FindCFIFrameInfo(
 
   // Apply delta rules up to and including the frame's address.
   while (delta != cfi_delta_rules_.end() && delta.GetKey() <= address) {
-    ParseCFIRuleSet(delta.GetValuePtr(), rules.get());
+    rule_set = ExpandCFIRuleSet(delta.GetValuePtr());
+    if (rule_set)
+      ParseCFIRuleSet(rule_set, rules.get());
     delta++;
   }
 
   return rules.release();
 }
 
+const char* FastSourceLineResolver::Module::ExpandCFIRuleSet(
+    const char* rules) const {
+  if (rules[0] != '@')
+    return rules;
+  StaticMap<int, char>::iterator rule_set =
+      cfi_rule_sets_.find(strtoul(rules + 1, NULL, 16));
+  if (rule_set == cfi_rule_sets_.end())
+    return NULL;
+  return rule_set.GetValuePtr();
+}
+
 }  // namespace google_breakpad
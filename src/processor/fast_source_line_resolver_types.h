@@ -141,13 +141,28 @@ class FastSourceLineResolver::Module: public SourceLineResolverBase::Module {
   virtual CFIFrameInfo* FindCFIFrameInfo(const StackFrame* frame) const;
 
   // Number of serialized map components of Module.
-  static const int kNumberMaps_ = 5 + WindowsFrameInfo::STACK_INFO_LAST;
+  static const int kNumberMaps_ = 6 + WindowsFrameInfo::STACK_INFO_LAST;
+
+  // Leading words of a serialized Module. LoadMapFromMemory rejects data
+  // that does not start with both, so blobs written with a different set
+  // of maps are not misread. Bump kSerializedVersion_ whenever the layout
+  // written by ModuleSerializer changes.
+  static const uint32_t kSerializedMagic_ = 0x4d465042;  // "BPFM"
+  static const uint32_t kSerializedVersion_ = 2;
 
  private:
   friend class FastSourceLineResolver;
   friend class ModuleComparer;
   typedef StaticMap<int, char> FileMap;
 
+  // Return the rule set a STACK CFI record's RULES text stands for: the
+  // shared rule set it refers to, if it is an '@' reference, or RULES
+  // itself. Return NULL if the referenced rule set is not defined.
+  const char* ExpandCFIRuleSet(const char* rules) const;
+
+  // Reset every map to empty and mark the module corrupt. Returns false.
+  bool LoadEmptyMaps();
+
   string name_;
   StaticMap<int, char> files_;
   StaticRangeMap<MemAddr, Function> functions_;
@@ -178,6 +193,11 @@ class FastSourceLineResolver::Module: public SourceLineResolverBase::Module {
   // this map, or the end of the range as given by the cfi_initial_rules_
   // entry (which FindCFIFrameInfo looks up first).
   StaticMap<MemAddr, char> cfi_delta_rules_;
+
+  // STACK CFI RULES records: rule sets shared by many STACK CFI INIT and
+  // STACK CFI records, indexed by the number those records use to refer
+  // to them as "@<index>".
+  StaticMap<int, char> cfi_rule_sets_;
 };
 
 }  // namespace google_breakpad
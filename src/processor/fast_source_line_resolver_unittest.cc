@@ -39,6 +39,7 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <sstream>
 #include <string>
@@ -65,6 +66,8 @@ using google_breakpad::MemoryRegion;
 using google_breakpad::StackFrame;
 using google_breakpad::WindowsFrameInfo;
 using google_breakpad::linked_ptr;
+using google_breakpad::SourceLineResolverInterface;
+using google_breakpad::scoped_array;
 using google_breakpad::scoped_ptr;
 
 class TestCodeModule : public CodeModule {
@@ -408,6 +411,77 @@ TEST_F(TestFastSourceLineResolver, TestLoadAndResolve) {
   ASSERT_EQ(frame.function_name, "Public2_2");
 }
 
+TEST_F(TestFastSourceLineResolver, TestSharedCFIRules) {
+  TestCodeModule module5("module5");
+  ASSERT_TRUE(basic_resolver.LoadModule(&module5, symbol_file(5)));
+  ASSERT_TRUE(serializer.ConvertOneModule(
+      module5.code_file(), &basic_resolver, &fast_resolver));
+  ASSERT_TRUE(fast_resolver.HasModule(&module5));
+
+  StackFrame frame;
+  scoped_ptr<CFIFrameInfo> cfi_frame_info;
+  CFIFrameInfo::RegisterValueMap<uint32_t> current_registers;
+  CFIFrameInfo::RegisterValueMap<uint32_t> caller_registers;
+  CFIFrameInfo::RegisterValueMap<uint32_t> expected_caller_registers;
+  MockMemoryRegion memory;
+
+  expected_caller_registers[".cfa"] = 0x1001c;
+  expected_caller_registers[".ra"]  = 0xf6438648;
+  expected_caller_registers["$ebp"] = 0x10038;
+  expected_caller_registers["$ebx"] = 0x98ecadc3;
+  expected_caller_registers["$esi"] = 0x878f7524;
+  expected_caller_registers["$edi"] = 0x6312f9a5;
+
+  // An initial rule set given by reference.
+  frame.instruction = 0x3d40;
+  frame.module = &module5;
+  current_registers["$esp"] = 0x10018;
+  current_registers["$ebp"] = 0x10038;
+  current_registers["$ebx"] = 0x98ecadc3;
+  current_registers["$esi"] = 0x878f7524;
+  current_registers["$edi"] = 0x6312f9a5;
+  cfi_frame_info.reset(fast_resolver.FindCFIFrameInfo(&frame));
+  ASSERT_TRUE(cfi_frame_info.get());
+  ASSERT_TRUE(cfi_frame_info.get()
+              ->FindCallerRegs<uint32_t>(current_registers, memory,
+                                          &caller_registers));
+  ASSERT_TRUE(VerifyRegisters(__FILE__, __LINE__,
+                              expected_caller_registers, caller_registers));
+
+  // Shared and inline delta rule sets, applied in turn.
+  frame.instruction = 0x3d84;
+  current_registers["$esp"] = 0x10014;
+  current_registers["$ebp"] = 0x10014;
+  current_registers["$ebx"] = 0x6864f054U;
+  current_registers["$esi"] = 0x6285f79aU;
+  current_registers["$edi"] = 0x64061449U;
+  cfi_frame_info.reset(fast_resolver.FindCFIFrameInfo(&frame));
+  ASSERT_TRUE(cfi_frame_info.get());
+  ASSERT_TRUE(cfi_frame_info.get()
+              ->FindCallerRegs<uint32_t>(current_registers, memory,
+                                          &caller_registers));
+  ASSERT_TRUE(VerifyRegisters(__FILE__, __LINE__,
+                              expected_caller_registers, caller_registers));
+
+  // The same shared rule sets, used by a second function.
+  frame.instruction = 0x3df3;
+  current_registers.clear();
+  current_registers["$esp"] = 0x10014;
+  current_registers["$ebp"] = 0x10014;
+  cfi_frame_info.reset(fast_resolver.FindCFIFrameInfo(&frame));
+  ASSERT_TRUE(cfi_frame_info.get());
+  ASSERT_TRUE(cfi_frame_info.get()
+              ->FindCallerRegs<uint32_t>(current_registers, memory,
+                                          &caller_registers));
+  EXPECT_EQ(0x1001cU, caller_registers[".cfa"]);
+  EXPECT_EQ(0x10038U, caller_registers["$ebp"]);
+
+  // A reference to a rule set that is never defined.
+  frame.instruction = 0x3ea4;
+  cfi_frame_info.reset(fast_resolver.FindCFIFrameInfo(&frame));
+  ASSERT_FALSE(cfi_frame_info.get());
+}
+
 TEST_F(TestFastSourceLineResolver, TestInvalidLoads) {
   TestCodeModule module3("module3");
   ASSERT_TRUE(basic_resolver.LoadModule(&module3,
@@ -442,6 +516,52 @@ TEST_F(TestFastSourceLineResolver, TestInvalidLoads) {
   ASSERT_FALSE(fast_resolver.HasModule(&invalidmodule));
 }
 
+TEST_F(TestFastSourceLineResolver, RejectsMismatchedSerializedData) {
+  char* symbol_data;
+  size_t symbol_data_size;
+  ASSERT_TRUE(SourceLineResolverBase::ReadSymbolFile(
+      symbol_file(1), &symbol_data, &symbol_data_size));
+  string symbol_data_string(symbol_data, symbol_data_size);
+  delete [] symbol_data;
+  unsigned int serialized_size = 0;
+  scoped_array<char> serialized(serializer.SerializeSymbolFileData(
+      symbol_data_string, &serialized_size));
+  ASSERT_TRUE(serialized.get());
+  SourceLineResolverInterface* resolver = &fast_resolver;
+
+  // Well-formed data loads cleanly.
+  TestCodeModule good("good");
+  ASSERT_TRUE(resolver->LoadModuleUsingMemoryBuffer(&good, serialized.get(),
+                                                    serialized_size));
+  ASSERT_FALSE(fast_resolver.IsModuleCorrupt(&good));
+
+  // Data cut off partway through its maps is rejected.
+  TestCodeModule truncated("truncated");
+  ASSERT_TRUE(resolver->LoadModuleUsingMemoryBuffer(&truncated,
+                                                    serialized.get(),
+                                                    serialized_size / 2));
+  ASSERT_TRUE(fast_resolver.IsModuleCorrupt(&truncated));
+  TestCodeModule tiny("tiny");
+  ASSERT_TRUE(resolver->LoadModuleUsingMemoryBuffer(&tiny, serialized.get(),
+                                                    4));
+  ASSERT_TRUE(fast_resolver.IsModuleCorrupt(&tiny));
+
+  // Data written with a different format version is rejected.
+  scoped_array<char> other_version(new char[serialized_size]);
+  memcpy(other_version.get(), serialized.get(), serialized_size);
+  other_version[sizeof(uint32_t)] ^= 0xff;
+  TestCodeModule old("old");
+  ASSERT_TRUE(resolver->LoadModuleUsingMemoryBuffer(&old, other_version.get(),
+                                                    serialized_size));
+  ASSERT_TRUE(fast_resolver.IsModuleCorrupt(&old));
+
+  StackFrame frame;
+  frame.instruction = 0x1000;
+  frame.module = &old;
+  fast_resolver.FillSourceLineInfo(&frame);
+  ASSERT_TRUE(frame.function_name.empty());
+}
+
 TEST_F(TestFastSourceLineResolver, TestUnload) {
   TestCodeModule module1("module1");
   ASSERT_FALSE(basic_resolver.HasModule(&module1));
@@ -482,6 +602,12 @@ TEST_F(TestFastSourceLineResolver, CompareModule) {
     delete [] symbol_data;
     ASSERT_TRUE(module_comparer.Compare(symbol_data_string));
   }
+
+  ASSERT_TRUE(SourceLineResolverBase::ReadSymbolFile(
+      symbol_file(5), &symbol_data, &symbol_data_size));
+  symbol_data_string.assign(symbol_data, symbol_data_size);
+  delete [] symbol_data;
+  ASSERT_TRUE(module_comparer.Compare(symbol_data_string));
 }
 
 }  // namespace
@@ -0,0 +1,207 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// json_writer.cc: JsonWriter implementation.
+//
+// See json_writer.h for documentation.
+
+#include "processor/json_writer.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+
+namespace google_breakpad {
+
+JsonWriter::JsonWriter(FILE* output)
+    : output_(output), used_(0), failed_(false), after_key_(false) {
+}
+
+JsonWriter::~JsonWriter() {
+  Flush();
+}
+
+void JsonWriter::BeginObject() {
+  Begin('{');
+}
+
+void JsonWriter::EndObject() {
+  End('}');
+}
+
+void JsonWriter::BeginArray() {
+  Begin('[');
+}
+
+void JsonWriter::EndArray() {
+  End(']');
+}
+
+void JsonWriter::Key(const char* key) {
+  BeginValue();
+  PutString(key, strlen(key));
+  Put(':');
+  after_key_ = true;
+}
+
+void JsonWriter::String(const char* value) {
+  String(value, strlen(value));
+}
+
+void JsonWriter::String(const string& value) {
+  String(value.data(), value.size());
+}
+
+void JsonWriter::String(const char* value, size_t length) {
+  BeginValue();
+  PutString(value, length);
+}
+
+void JsonWriter::Int(int64_t value) {
+  char text[24];
+  int length = snprintf(text, sizeof(text), "%" PRId64, value);
+  BeginValue();
+  Put(text, length);
+}
+
+void JsonWriter::Double(double value) {
+  if (!isfinite(value)) {
+    Null();
+    return;
+  }
+  char text[32];
+  int length = snprintf(text, sizeof(text), "%.15g", value);
+  BeginValue();
+  Put(text, length);
+}
+
+void JsonWriter::Bool(bool value) {
+  BeginValue();
+  if (value)
+    Put("true", 4);
+  else
+    Put("false", 5);
+}
+
+void JsonWriter::Null() {
+  BeginValue();
+  Put("null", 4);
+}
+
+void JsonWriter::Hex(uint64_t value) {
+  char text[24];
+  int length = snprintf(text, sizeof(text), "0x%" PRIx64, value);
+  String(text, length);
+}
+
+bool JsonWriter::Flush() {
+  FlushBuffer();
+  if (fflush(output_) != 0)
+    failed_ = true;
+  return !failed_;
+}
+
+void JsonWriter::BeginValue() {
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (has_members_.empty())
+    return;
+  if (has_members_.back())
+    Put(',');
+  has_members_.back() = true;
+}
+
+void JsonWriter::Begin(char bracket) {
+  BeginValue();
+  Put(bracket);
+  has_members_.push_back(false);
+}
+
+void JsonWriter::End(char bracket) {
+  has_members_.pop_back();
+  Put(bracket);
+  if (has_members_.empty())
+    Put('\n');
+}
+
+void JsonWriter::PutString(const char* value, size_t length) {
+  static const char kHex[] = "0123456789abcdef";
+  Put('"');
+  // Copy runs of characters that need no escaping in one go.
+  const char* run = value;
+  const char* end = value + length;
+  for (const char* p = value; p != end; ++p) {
+    unsigned char c = *p;
+    if (c >= 0x20 && c != '"' && c != '\\')
+      continue;
+    Put(run, p - run);
+    run = p + 1;
+    Put('\\');
+    switch (c) {
+      case '"':  Put('"'); break;
+      case '\\': Put('\\'); break;
+      case '\b': Put('b'); break;
+      case '\f': Put('f'); break;
+      case '\n': Put('n'); break;
+      case '\r': Put('r'); break;
+      case '\t': Put('t'); break;
+      default:
+        Put("u00", 3);
+        Put(kHex[c >> 4]);
+        Put(kHex[c & 0xf]);
+        break;
+    }
+  }
+  Put(run, end - run);
+  Put('"');
+}
+
+void JsonWriter::Put(const char* text, size_t length) {
+  while (length > 0) {
+    if (used_ == kBufferSize)
+      FlushBuffer();
+    size_t count = kBufferSize - used_;
+    if (count > length)
+      count = length;
+    memcpy(buffer_ + used_, text, count);
+    used_ += count;
+    text += count;
+    length -= count;
+  }
+}
+
+void JsonWriter::FlushBuffer() {
+  if (used_ > 0 && fwrite(buffer_, 1, used_, output_) != used_)
+    failed_ = true;
+  used_ = 0;
+}
+
+}  // namespace google_breakpad
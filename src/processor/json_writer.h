@@ -0,0 +1,125 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// json_writer.h: JsonWriter writes a JSON document to a stdio stream
+// while it is being built.
+//
+// The document goes through a fixed-size buffer straight to the stream,
+// so writing it takes time linear in its size and memory independent of
+// it. JsonWriter checks nothing about the structure of the document: the
+// caller must balance Begin/End calls and precede each value in an
+// object with a Key.
+
+#ifndef PROCESSOR_JSON_WRITER_H__
+#define PROCESSOR_JSON_WRITER_H__
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "common/using_std_string.h"
+#include "google_breakpad/common/breakpad_types.h"
+
+namespace google_breakpad {
+
+class JsonWriter {
+ public:
+  // Write the document to OUTPUT, which the caller continues to own.
+  explicit JsonWriter(FILE* output);
+
+  // Flush any buffered output.
+  ~JsonWriter();
+
+  void BeginObject();
+  void EndObject();
+  void BeginArray();
+  void EndArray();
+
+  // Write the name of the next member of the current object.
+  void Key(const char* key);
+
+  // Write a value.
+  void String(const char* value);
+  void String(const string& value);
+  void String(const char* value, size_t length);
+  void Int(int64_t value);
+  // Written to 15 significant digits; infinities and NaNs, which JSON
+  // cannot represent, are written as null.
+  void Double(double value);
+  void Bool(bool value);
+  void Null();
+
+  // Write VALUE as a string holding "0x" and VALUE's hexadecimal digits,
+  // since addresses do not fit in the integers many JSON readers handle.
+  void Hex(uint64_t value);
+
+  // Write out any buffered output. Return false if writing to the stream
+  // has failed at any point.
+  bool Flush();
+
+ private:
+  static const size_t kBufferSize = 16384;
+
+  // Write the separator the next value needs, if any.
+  void BeginValue();
+  void Begin(char bracket);
+  void End(char bracket);
+
+  void Put(char c) {
+    if (used_ == kBufferSize)
+      FlushBuffer();
+    buffer_[used_++] = c;
+  }
+  void Put(const char* text, size_t length);
+
+  // Write VALUE as a quoted, escaped JSON string.
+  void PutString(const char* value, size_t length);
+  void FlushBuffer();
+
+  FILE* output_;
+  char buffer_[kBufferSize];
+  size_t used_;
+  bool failed_;
+
+  // For each open object or array, whether it has any members yet.
+  std::vector<bool> has_members_;
+
+  // True if a key has just been written and its value has not.
+  bool after_key_;
+
+  // Disallow copy constructor and assignment operator.
+  JsonWriter(const JsonWriter&);
+  void operator=(const JsonWriter&);
+};
+
+}  // namespace google_breakpad
+
+#endif  // PROCESSOR_JSON_WRITER_H__
@@ -0,0 +1,151 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// json_writer_unittest.cc: Unit tests for JsonWriter.
+
+#include <math.h>
+#include <stdio.h>
+
+#include <string>
+
+#include "breakpad_googletest_includes.h"
+#include "common/using_std_string.h"
+#include "processor/json_writer.h"
+
+namespace {
+
+using google_breakpad::JsonWriter;
+
+// Return everything written to FILE.
+string ReadAll(FILE* file) {
+  rewind(file);
+  string contents;
+  char buffer[4096];
+  for (size_t n; (n = fread(buffer, 1, sizeof(buffer), file)) > 0; )
+    contents.append(buffer, n);
+  return contents;
+}
+
+class JsonWriterTest : public ::testing::Test {
+ public:
+  void SetUp() {
+    file_ = tmpfile();
+    ASSERT_TRUE(file_);
+  }
+  void TearDown() {
+    fclose(file_);
+  }
+
+  FILE* file_;
+};
+
+TEST_F(JsonWriterTest, Empty) {
+  {
+    JsonWriter json(file_);
+    json.BeginObject();
+    json.Key("array");
+    json.BeginArray();
+    json.EndArray();
+    json.Key("object");
+    json.BeginObject();
+    json.EndObject();
+    json.EndObject();
+  }
+  EXPECT_EQ("{\"array\":[],\"object\":{}}\n", ReadAll(file_));
+}
+
+TEST_F(JsonWriterTest, Values) {
+  {
+    JsonWriter json(file_);
+    json.BeginArray();
+    json.Int(-42);
+    json.Int(0x7fffffffffffffffLL);
+    json.Hex(0xfedcba9876543210ULL);
+    json.Double(0.1);
+    json.Double(-2.5e-20);
+    json.Double(HUGE_VAL);
+    json.Bool(true);
+    json.Bool(false);
+    json.Null();
+    json.String("text");
+    json.BeginObject();
+    json.Key("a");
+    json.Int(1);
+    json.Key("b");
+    json.BeginArray();
+    json.Int(2);
+    json.Int(3);
+    json.EndArray();
+    json.EndObject();
+    json.EndArray();
+    EXPECT_TRUE(json.Flush());
+  }
+  EXPECT_EQ("[-42,9223372036854775807,\"0xfedcba9876543210\",0.1,-2.5e-20,"
+            "null,true,false,null,\"text\",{\"a\":1,\"b\":[2,3]}]\n", ReadAll(file_));
+}
+
+TEST_F(JsonWriterTest, Escaping) {
+  {
+    JsonWriter json(file_);
+    json.BeginObject();
+    json.Key("key \"quoted\"");
+    json.String(string("quote \" backslash \\ newline \n tab \t nul \0 "
+                       "bell \a utf-8 \xc3\xa9", 57));
+    json.EndObject();
+  }
+  EXPECT_EQ("{\"key \\\"quoted\\\"\":"
+            "\"quote \\\" backslash \\\\ newline \\n tab \\t nul \\u0000 "
+            "bell \\u0007 utf-8 \xc3\xa9\"}\n", ReadAll(file_));
+}
+
+// Documents much larger than the buffer come out whole.
+TEST_F(JsonWriterTest, Large) {
+  const int kCount = 100000;
+  string expected = "[";
+  {
+    JsonWriter json(file_);
+    json.BeginArray();
+    for (int i = 0; i < kCount; ++i) {
+      json.String("\"abc\"");
+      if (i != 0)
+        expected += ",";
+      expected += "\"\\\"abc\\\"\"";
+    }
+    json.EndArray();
+  }
+  expected += "]\n";
+  EXPECT_EQ(expected, ReadAll(file_));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
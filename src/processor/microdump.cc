@@ -33,12 +33,14 @@
 
 #include "google_breakpad/processor/microdump.h"
 
+#include <ctype.h>
 #include <stdio.h>
 #include <string.h>
 
+#include <iostream>
 #include <memory>
-#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "google_breakpad/common/minidump_cpu_arm.h"
@@ -60,6 +62,8 @@ static const char kGpuKey[] = ": G ";
 static const char kMmapKey[] = ": M ";
 static const char kStackKey[] = ": S ";
 static const char kStackFirstLineKey[] = ": S 0 ";
+static const char kStackBase64Key[] = ": B ";
+static const char kStackZeroRunsKey[] = ": Z ";
 static const char kArmArchitecture[] = "arm";
 static const char kArm64Architecture[] = "arm64";
 static const char kX86Architecture[] = "x86";
@@ -67,33 +71,178 @@ static const char kMipsArchitecture[] = "mips";
 static const char kMips64Architecture[] = "mips64";
 static const char kGpuUnknown[] = "UNKNOWN";
 
-template<typename T>
-T HexStrToL(const string& str) {
+// The value of each hexadecimal digit character, or -1.
+class HexDigits {
+ public:
+  HexDigits() {
+    for (int i = 0; i < 256; i++)
+      values_[i] = -1;
+    for (int i = 0; i < 10; i++)
+      values_['0' + i] = i;
+    for (int i = 0; i < 6; i++)
+      values_['a' + i] = values_['A' + i] = 10 + i;
+  }
+  int operator[](char c) const { return values_[static_cast<uint8_t>(c)]; }
+
+ private:
+  int values_[256];
+};
+
+const HexDigits kHexDigits;
+
+// The value of each base64 digit character, or -1.
+class Base64Digits {
+ public:
+  Base64Digits() {
+    for (int i = 0; i < 256; i++)
+      values_[i] = -1;
+    for (int i = 0; i < 26; i++) {
+      values_['A' + i] = i;
+      values_['a' + i] = 26 + i;
+    }
+    for (int i = 0; i < 10; i++)
+      values_['0' + i] = 52 + i;
+    values_['+'] = 62;
+    values_['/'] = 63;
+  }
+  int operator[](char c) const { return values_[static_cast<uint8_t>(c)]; }
+
+ private:
+  int values_[256];
+};
+
+const Base64Digits kBase64Digits;
+
+// A run of characters in the microdump text, which is not copied.
+struct Token {
+  Token() : begin(NULL), end(NULL) { }
+  Token(const char* b, const char* e) : begin(b), end(e) { }
+
+  bool empty() const { return begin == end; }
+  string str() const { return string(begin, end - begin); }
+  bool operator==(const char* other) const {
+    size_t length = strlen(other);
+    return static_cast<size_t>(end - begin) == length &&
+           memcmp(begin, other, length) == 0;
+  }
+
+  const char* begin;
+  const char* end;
+};
+
+// Parse TOKEN as a hexadecimal number, with an optional "0x" prefix,
+// stopping at the first character that is not a digit, as reading it
+// from a stream with std::hex would.
+uint64_t HexValue(Token token) {
+  const char* p = token.begin;
+  if (token.end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X') &&
+      kHexDigits[p[2]] >= 0)
+    p += 2;
   uint64_t res = 0;
-  std::istringstream ss(str);
-  ss >> std::hex >> res;
-  return static_cast<T>(res);
+  for (int digit; p != token.end && (digit = kHexDigits[*p]) >= 0; p++)
+    res = (res << 4) | digit;
+  return res;
 }
 
-std::vector<uint8_t> ParseHexBuf(const string& str) {
-  std::vector<uint8_t> buf;
-  for (size_t i = 0; i < str.length(); i += 2) {
-    buf.push_back(HexStrToL<uint8_t>(str.substr(i, 2)));
+// Append the bytes the pairs of hex digits in TOKEN stand for to BUF.
+void ParseHexBuf(Token token, std::vector<uint8_t>* buf) {
+  size_t length = token.end - token.begin;
+  buf->reserve(buf->size() + (length + 1) / 2);
+  for (const char* p = token.begin; p < token.end; p += 2) {
+    int high = kHexDigits[p[0]];
+    int low = p + 1 < token.end ? kHexDigits[p[1]] : -1;
+    if (high < 0)
+      buf->push_back(0);
+    else if (low < 0)
+      buf->push_back(high);
+    else
+      buf->push_back((high << 4) | low);
   }
-  return buf;
 }
 
-bool GetLine(std::istringstream* istream, string* str) {
-  if (std::getline(*istream, *str)) {
-    // Trim any trailing newline from the end of the line. Allows us
-    // to seamlessly handle both Windows/DOS and Unix formatted input. The
-    // adb tool generally writes logcat dumps in Windows/DOS format.
-    if (!str->empty() && str->at(str->size() - 1) == '\r') {
-      str->erase(str->size() - 1);
+// Append the bytes the base64 digits in TOKEN stand for to BUF, stopping
+// at the padding or the first character that is not a base64 digit. If
+// ZERO_RUNS is true, the decoded bytes are in the packed form of "Z"
+// records, where a zero byte followed by a count byte stands for that many
+// zero bytes.
+void ParseBase64Buf(Token token, bool zero_runs, std::vector<uint8_t>* buf) {
+  size_t length = token.end - token.begin;
+  buf->reserve(buf->size() + length / 4 * 3);
+  uint32_t bits = 0;
+  int num_bits = 0;
+  bool in_zero_run = false;
+  for (const char* p = token.begin; p != token.end; p++) {
+    int digit = kBase64Digits[*p];
+    if (digit < 0)
+      break;
+    bits = (bits << 6) | digit;
+    num_bits += 6;
+    if (num_bits < 8)
+      continue;
+    num_bits -= 8;
+    uint8_t byte = static_cast<uint8_t>(bits >> num_bits);
+    if (in_zero_run) {
+      buf->insert(buf->end(), byte, 0);
+      in_zero_run = false;
+    } else if (zero_runs && byte == 0) {
+      in_zero_run = true;
+    } else {
+      buf->push_back(byte);
     }
-    return true;
   }
-  return false;
+}
+
+// Return the next whitespace-separated token in [*P, END), and advance *P
+// past it.
+Token NextToken(const char** p, const char* end) {
+  const char* begin = *p;
+  while (begin != end && isspace(static_cast<unsigned char>(*begin)))
+    begin++;
+  const char* stop = begin;
+  while (stop != end && !isspace(static_cast<unsigned char>(*stop)))
+    stop++;
+  *p = stop;
+  return Token(begin, stop);
+}
+
+// Return the position of KEY in LINE, or NULL if it does not occur.
+const char* Find(Token line, const char* key) {
+  size_t length = strlen(key);
+  const char* last = line.end - length;
+  for (const char* p = line.begin;
+       p <= last &&
+       (p = static_cast<const char*>(memchr(p, key[0], last - p + 1)));
+       p++) {
+    if (memcmp(p, key, length) == 0)
+      return p;
+  }
+  return NULL;
+}
+
+// Return the rest of LINE after KEY, if KEY occurs in it.
+bool FindValue(Token line, const char* key, Token* value) {
+  const char* p = Find(line, key);
+  if (!p)
+    return false;
+  *value = Token(p + strlen(key), line.end);
+  return true;
+}
+
+// Read the next line of [*P, END) into *LINE and advance *P past it.
+bool GetLine(const char** p, const char* end, Token* line) {
+  if (*p == end)
+    return false;
+  const char* newline =
+      static_cast<const char*>(memchr(*p, '\n', end - *p));
+  const char* stop = newline ? newline : end;
+  *line = Token(*p, stop);
+  // Trim any trailing newline from the end of the line. Allows us
+  // to seamlessly handle both Windows/DOS and Unix formatted input. The
+  // adb tool generally writes logcat dumps in Windows/DOS format.
+  if (!line->empty() && stop[-1] == '\r')
+    line->end--;
+  *p = newline ? newline + 1 : end;
+  return true;
 }
 
 }  // namespace
@@ -219,50 +368,85 @@ Microdump::Microdump(const string& contents)
     crash_reason_(),
     crash_address_(0u) {
   assert(!contents.empty());
+  Parse(contents.data(), contents.size());
+}
+
+Microdump::Microdump(const char* data, size_t size)
+  : context_(new MicrodumpContext()),
+    stack_region_(new MicrodumpMemoryRegion()),
+    modules_(new MicrodumpModules()),
+    system_info_(new SystemInfo()),
+    crash_reason_(),
+    crash_address_(0u) {
+  assert(size != 0);
+  Parse(data, size);
+}
+
+// static
+void Microdump::FindMicrodumps(
+    const char* data, size_t size,
+    std::vector<std::pair<size_t, size_t> >* ranges) {
+  const char* p = data;
+  const char* end = data + size;
+  const char* begin = NULL;
+  Token line;
+  while (GetLine(&p, end, &line)) {
+    if (!Find(line, kGoogleBreakpadKey))
+      continue;
+    if (Find(line, kMicrodumpBegin)) {
+      // A microdump cut short ends where the next one begins.
+      if (begin)
+        ranges->push_back(std::make_pair(begin - data, line.begin - begin));
+      begin = line.begin;
+    } else if (begin && Find(line, kMicrodumpEnd)) {
+      ranges->push_back(std::make_pair(begin - data, p - begin));
+      begin = NULL;
+    }
+  }
+  if (begin)
+    ranges->push_back(std::make_pair(begin - data, end - begin));
+}
 
+void Microdump::Parse(const char* data, size_t size) {
   bool in_microdump = false;
-  string line;
+  Token line;
   uint64_t stack_start = 0;
   std::vector<uint8_t> stack_content;
   string arch;
 
-  std::istringstream stream(contents);
-  while (GetLine(&stream, &line)) {
-    if (line.find(kGoogleBreakpadKey) == string::npos) {
+  const char* p = data;
+  const char* end = data + size;
+  while (GetLine(&p, end, &line)) {
+    if (!Find(line, kGoogleBreakpadKey)) {
       continue;
     }
-    if (line.find(kMicrodumpBegin) != string::npos) {
+    if (Find(line, kMicrodumpBegin)) {
       in_microdump = true;
       continue;
     }
     if (!in_microdump) {
       continue;
     }
-    if (line.find(kMicrodumpEnd) != string::npos) {
+    if (Find(line, kMicrodumpEnd)) {
       break;
     }
 
-    size_t pos;
-    if ((pos = line.find(kOsKey)) != string::npos) {
-      string os_str(line, pos + strlen(kOsKey));
-      std::istringstream os_tokens(os_str);
-      string os_id;
-      string num_cpus;
-      string os_version;
+    Token value;
+    if (FindValue(line, kOsKey, &value)) {
+      const char* tokens = value.begin;
+      Token os_id = NextToken(&tokens, value.end);
       // This reflect the actual HW arch and might not match the arch emulated
       // for the execution (e.g., running a 32-bit binary on a 64-bit cpu).
-      string hw_arch;
-
-      os_tokens >> os_id;
-      os_tokens >> arch;
-      os_tokens >> num_cpus;
-      os_tokens >> hw_arch;
-      GetLine(&os_tokens, &os_version);
-      os_version.erase(0, 1);  // remove leading space.
+      arch = NextToken(&tokens, value.end).str();
+      Token num_cpus = NextToken(&tokens, value.end);
+      NextToken(&tokens, value.end);  // hw_arch
+      // Skip the space that separates the version from the other fields.
+      if (tokens != value.end)
+        tokens++;
 
       system_info_->cpu = arch;
-      system_info_->cpu_count = HexStrToL<uint8_t>(num_cpus);
-      system_info_->os_version = os_version;
+      system_info_->cpu_count = static_cast<uint8_t>(HexValue(num_cpus));
+      system_info_->os_version = string(tokens, value.end - tokens);
 
       if (os_id == "L") {
         system_info_->os = "Linux";
@@ -274,21 +458,30 @@ Microdump::Microdump(const string& contents)
       }
 
       // OS line also contains release and version for future use.
-    } else if ((pos = line.find(kStackKey)) != string::npos) {
-      if (line.find(kStackFirstLineKey) != string::npos) {
+    } else if (FindValue(line, kStackKey, &value) ||
+               FindValue(line, kStackBase64Key, &value) ||
+               FindValue(line, kStackZeroRunsKey, &value)) {
+      if (Find(line, kStackFirstLineKey)) {
         // The first line of the stack (S 0 stack header) provides the value of
         // the stack pointer, the start address of the stack being dumped and
         // the length of the stack. We could use it in future to double check
-        // that we received all the stack as expected.
+        // that we received all the stack as expected. For now, it just
+        // says how much room the stack will need.
+        const char* tokens = Find(line, kStackFirstLineKey) +
+                             strlen(kStackFirstLineKey);
+        NextToken(&tokens, line.end);  // stack pointer
+        NextToken(&tokens, line.end);  // start address
+        uint64_t length = HexValue(NextToken(&tokens, line.end));
+        if (length <= size)
+          stack_content.reserve(length);
         continue;
       }
-      string stack_str(line, pos + strlen(kStackKey));
-      std::istringstream stack_tokens(stack_str);
-      string start_addr_str;
-      string raw_content;
-      stack_tokens >> start_addr_str;
-      stack_tokens >> raw_content;
-      uint64_t start_addr = HexStrToL<uint64_t>(start_addr_str);
+      // The record's key letter precedes its value: "S" for hex, "B" for
+      // base64 and "Z" for base64 with runs of zeros packed.
+      const char key = value.begin[-2];
+      const char* tokens = value.begin;
+      uint64_t start_addr = HexValue(NextToken(&tokens, value.end));
+      Token raw_content = NextToken(&tokens, value.end);
 
       if (stack_start != 0) {
         // Verify that the stack chunks in the microdump are contiguous.
@@ -296,12 +489,14 @@ Microdump::Microdump(const string& contents)
       } else {
         stack_start = start_addr;
       }
-      std::vector<uint8_t> chunk = ParseHexBuf(raw_content);
-      stack_content.insert(stack_content.end(), chunk.begin(), chunk.end());
-
-    } else if ((pos = line.find(kCpuKey)) != string::npos) {
-      string cpu_state_str(line, pos + strlen(kCpuKey));
-      std::vector<uint8_t> cpu_state_raw = ParseHexBuf(cpu_state_str);
+      if (key == 'S')
+        ParseHexBuf(raw_content, &stack_content);
+      else
+        ParseBase64Buf(raw_content, key == 'Z', &stack_content);
+
+    } else if (FindValue(line, kCpuKey, &value)) {
+      std::vector<uint8_t> cpu_state_raw;
+      ParseHexBuf(value, &cpu_state_raw);
       if (strcmp(arch.c_str(), kArmArchitecture) == 0) {
         if (cpu_state_raw.size() != sizeof(MDRawContextARM)) {
           std::cerr << "Malformed CPU context. Got " << cpu_state_raw.size()
@@ -362,36 +557,36 @@ Microdump::Microdump(const string& contents)
       } else {
         std::cerr << "Unsupported architecture: " << arch << std::endl;
       }
-    } else if ((pos = line.find(kCrashReasonKey)) != string::npos) {
-      string crash_reason_str(line, pos + strlen(kCrashReasonKey));
-      std::istringstream crash_reason_tokens(crash_reason_str);
-      string signal;
-      string address;
-      crash_reason_tokens >> signal;
-      crash_reason_tokens >> crash_reason_;
-      crash_reason_tokens >> address;
-      crash_address_ = HexStrToL<uint64_t>(address);
-    } else if ((pos = line.find(kGpuKey)) != string::npos) {
-      string gpu_str(line, pos + strlen(kGpuKey));
-      if (strcmp(gpu_str.c_str(), kGpuUnknown) != 0) {
-        std::istringstream gpu_tokens(gpu_str);
-        std::getline(gpu_tokens, system_info_->gl_version, '|');
-        std::getline(gpu_tokens, system_info_->gl_vendor, '|');
-        std::getline(gpu_tokens, system_info_->gl_renderer, '|');
+    } else if (FindValue(line, kCrashReasonKey, &value)) {
+      const char* tokens = value.begin;
+      NextToken(&tokens, value.end);  // signal
+      crash_reason_ = NextToken(&tokens, value.end).str();
+      crash_address_ = HexValue(NextToken(&tokens, value.end));
+    } else if (FindValue(line, kGpuKey, &value)) {
+      if (!(value == kGpuUnknown)) {
+        string* fields[] = { &system_info_->gl_version,
+                             &system_info_->gl_vendor,
+                             &system_info_->gl_renderer };
+        const char* field = value.begin;
+        for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+          const char* bar = static_cast<const char*>(
+              memchr(field, '|', value.end - field));
+          const char* stop = bar ? bar : value.end;
+          fields[i]->assign(field, stop - field);
+          field = bar ? bar + 1 : value.end;
+        }
       }
-    } else if ((pos = line.find(kMmapKey)) != string::npos) {
-      string mmap_line(line, pos + strlen(kMmapKey));
-      std::istringstream mmap_tokens(mmap_line);
-      string addr, offset, size, identifier, filename;
-      mmap_tokens >> addr;
-      mmap_tokens >> offset;
-      mmap_tokens >> size;
-      mmap_tokens >> identifier;
-      mmap_tokens >> filename;
+    } else if (FindValue(line, kMmapKey, &value)) {
+      const char* tokens = value.begin;
+      uint64_t addr = HexValue(NextToken(&tokens, value.end));
+      NextToken(&tokens, value.end);  // offset
+      uint64_t module_size = HexValue(NextToken(&tokens, value.end));
+      string identifier = NextToken(&tokens, value.end).str();
+      string filename = NextToken(&tokens, value.end).str();
 
       modules_->Add(new BasicCodeModule(
-          HexStrToL<uint64_t>(addr),  // base_address
-          HexStrToL<uint64_t>(size),  // size
+          addr,                       // base_address
+          module_size,                // size
           filename,                   // code_file
           identifier,                 // code_identifier
           filename,                   // debug_file
@@ -29,9 +29,12 @@
 
 // Unit test for MicrodumpProcessor.
 
+#include <string.h>
+
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "breakpad_googletest_includes.h"
@@ -49,6 +52,7 @@ namespace {
 
 using google_breakpad::BasicSourceLineResolver;
 using google_breakpad::Microdump;
+using google_breakpad::MicrodumpMemoryRegion;
 using google_breakpad::MicrodumpProcessor;
 using google_breakpad::ProcessState;
 using google_breakpad::SimpleSymbolSupplier;
@@ -208,6 +212,39 @@ TEST_F(MicrodumpProcessorTest, TestProcessArm64) {
             state.threads()->at(0)->frames()->at(7)->module->code_file());
 }
 
+TEST_F(MicrodumpProcessorTest, TestProcessArm64Compact) {
+  // The same microdump as above, with the stack in compact "B" and "Z"
+  // records instead of hex "S" records.
+  ProcessState state;
+  AnalyzeDump("microdump-arm64-compact.dmp", false /* omit_symbols */,
+              2 /* expected_cpu_count*/, &state);
+
+  ASSERT_EQ(8U, state.modules()->module_count());
+  ASSERT_EQ(9U, state.threads()->at(0)->frames()->size());
+  ASSERT_EQ("MicrodumpWriterTest_Setup_Test::TestBody",
+            state.threads()->at(0)->frames()->at(0)->function_name);
+  ASSERT_EQ("main",
+            state.threads()->at(0)->frames()->at(7)->function_name);
+
+  string hex_contents, compact_contents;
+  ReadFile(files_path_ + "microdump-arm64.dmp", &hex_contents);
+  ReadFile(files_path_ + "microdump-arm64-compact.dmp", &compact_contents);
+  Microdump hex(hex_contents);
+  Microdump compact(compact_contents);
+  MicrodumpMemoryRegion* hex_stack = hex.GetMemory();
+  MicrodumpMemoryRegion* compact_stack = compact.GetMemory();
+  ASSERT_EQ(0x3000U, compact_stack->GetSize());
+  ASSERT_EQ(hex_stack->GetBase(), compact_stack->GetBase());
+  ASSERT_EQ(hex_stack->GetSize(), compact_stack->GetSize());
+  for (uint64_t offset = 0; offset < hex_stack->GetSize(); offset++) {
+    uint8_t hex_byte = 0, compact_byte = 1;
+    hex_stack->GetMemoryAtAddress(hex_stack->GetBase() + offset, &hex_byte);
+    compact_stack->GetMemoryAtAddress(compact_stack->GetBase() + offset,
+                                      &compact_byte);
+    ASSERT_EQ(hex_byte, compact_byte) << "at offset " << offset;
+  }
+}
+
 TEST_F(MicrodumpProcessorTest, TestProcessX86) {
   ProcessState state;
   AnalyzeDump("microdump-x86.dmp", false /* omit_symbols */,
@@ -235,6 +272,64 @@ TEST_F(MicrodumpProcessorTest, TestProcessMultiple) {
   ASSERT_EQ(5U, state.threads()->at(0)->frames()->size());
 }
 
+TEST_F(MicrodumpProcessorTest, TestFindMicrodumps) {
+  string contents;
+  ReadFile(files_path_ + "microdump-multiple.dmp", &contents);
+  string log = "unrelated logcat line\r\n" + contents + contents;
+
+  std::vector<std::pair<size_t, size_t> > ranges;
+  Microdump::FindMicrodumps(log.data(), log.size(), &ranges);
+  ASSERT_EQ(4U, ranges.size());
+  EXPECT_EQ(0U, log.compare(ranges[0].first, strlen("02-25"), "02-25"));
+  EXPECT_EQ(ranges[0].first + ranges[0].second, ranges[1].first);
+  EXPECT_EQ(ranges[2].first - ranges[0].first, contents.size());
+
+  // Each range holds exactly one microdump, which parses the same way
+  // in place as it does copied out of the log.
+  for (size_t i = 0; i < ranges.size(); i++) {
+    Microdump in_place(log.data() + ranges[i].first, ranges[i].second);
+    Microdump copied(log.substr(ranges[i].first, ranges[i].second));
+    EXPECT_EQ(copied.GetModules()->module_count(),
+              in_place.GetModules()->module_count());
+    EXPECT_EQ(copied.GetMemory()->GetBase(), in_place.GetMemory()->GetBase());
+    EXPECT_EQ(copied.GetMemory()->GetSize(), in_place.GetMemory()->GetSize());
+    EXPECT_EQ(copied.GetSystemInfo()->os_version,
+              in_place.GetSystemInfo()->os_version);
+  }
+  Microdump first(log.data() + ranges[0].first, ranges[0].second);
+  EXPECT_EQ(156U, first.GetModules()->module_count());
+  // The file ends with the start of a microdump cut short, which the next
+  // copy's leftover END line closes.
+  Microdump truncated(log.data() + ranges[1].first, ranges[1].second);
+  EXPECT_EQ("Android", truncated.GetSystemInfo()->os);
+  EXPECT_EQ(6, truncated.GetSystemInfo()->cpu_count);
+}
+
+TEST_F(MicrodumpProcessorTest, TestFindMicrodumpsTruncated) {
+  string log =
+      "F/google-breakpad(1): -----BEGIN BREAKPAD MICRODUMP-----\n"
+      "F/google-breakpad(1): O A arm 04 armv7l some version\n"
+      "F/google-breakpad(2): -----BEGIN BREAKPAD MICRODUMP-----\n"
+      "F/google-breakpad(2): O A arm 02 armv7l other version\n"
+      "F/google-breakpad(2): -----END BREAKPAD MICRODUMP-----\n"
+      "F/google-breakpad(3): -----BEGIN BREAKPAD MICRODUMP-----\n"
+      "F/google-breakpad(3): O L arm 01 armv7l last version";
+
+  std::vector<std::pair<size_t, size_t> > ranges;
+  Microdump::FindMicrodumps(log.data(), log.size(), &ranges);
+  ASSERT_EQ(3U, ranges.size());
+  const char* expected_versions[] = {
+    "some version", "other version", "last version"
+  };
+  const int expected_cpus[] = { 4, 2, 1 };
+  for (size_t i = 0; i < ranges.size(); i++) {
+    Microdump microdump(log.data() + ranges[i].first, ranges[i].second);
+    EXPECT_EQ(expected_versions[i], microdump.GetSystemInfo()->os_version);
+    EXPECT_EQ(expected_cpus[i], microdump.GetSystemInfo()->cpu_count);
+  }
+  EXPECT_EQ(log.size(), ranges[2].first + ranges[2].second);
+}
+
 TEST_F(MicrodumpProcessorTest, TestProcessMips) {
   ProcessState state;
   AnalyzeDump("microdump-mips32.dmp", false /* omit_symbols */,
@@ -30,12 +30,17 @@
 // microdump_stackwalk.cc: Process a microdump with MicrodumpProcessor, printing
 // the results, including stack traces.
 
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
-#include <fstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/path_helper.h"
@@ -55,7 +60,10 @@ namespace {
 
 struct Options {
   bool machine_readable;
+  bool json;
   bool output_stack_contents;
+  bool all_microdumps;
+  int threads;
 
   string microdump_file;
   std::vector<string> symbol_paths;
@@ -70,6 +78,162 @@ using google_breakpad::scoped_ptr;
 using google_breakpad::SimpleSymbolSupplier;
 using google_breakpad::StackFrameSymbolizer;
 
+// A microdump file, mapped into memory.
+class MappedFile {
+ public:
+  MappedFile() : data_(NULL), size_(0) { }
+  ~MappedFile() {
+    if (data_)
+      munmap(data_, size_);
+  }
+
+  bool Map(const string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+      return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        data_ = data;
+        size_ = st.st_size;
+      }
+    }
+    close(fd);
+    return data_ != NULL;
+  }
+
+  const char* data() const { return static_cast<const char*>(data_); }
+  size_t size() const { return size_; }
+
+ private:
+  void* data_;
+  size_t size_;
+};
+
+// Processes the microdump in the SIZE bytes at DATA, using RESOLVER and
+// SYMBOL_SUPPLIER, into *PROCESS_STATE.
+ProcessResult ProcessMicrodump(const char* data, size_t size,
+                               SimpleSymbolSupplier* symbol_supplier,
+                               BasicSourceLineResolver* resolver,
+                               ProcessState* process_state) {
+  StackFrameSymbolizer frame_symbolizer(symbol_supplier, resolver);
+  MicrodumpProcessor microdump_processor(&frame_symbolizer);
+  Microdump microdump(data, size);
+  return microdump_processor.Process(&microdump, process_state);
+}
+
+void PrintMicrodump(const Options& options, const ProcessState& process_state,
+                    BasicSourceLineResolver* resolver) {
+  if (options.json) {
+    PrintProcessStateJSON(process_state);
+  } else if (options.machine_readable) {
+    PrintProcessStateMachineReadable(process_state);
+  } else {
+    PrintProcessState(process_state, options.output_stack_contents, resolver);
+  }
+}
+
+// The microdumps found in a log file, and how far processing them has
+// got. Worker threads take the next microdump under LOCK, and print
+// their results in the order the microdumps appear in the file.
+struct LogJob {
+  const Options* options;
+  const char* data;
+  std::vector<std::pair<size_t, size_t> > ranges;
+
+  pthread_mutex_t lock;
+  pthread_cond_t printed;
+  size_t next;
+  size_t next_to_print;
+  int failures;
+};
+
+void* ProcessMicrodumps(void* arg) {
+  LogJob* job = static_cast<LogJob*>(arg);
+  const Options& options = *job->options;
+
+  scoped_ptr<SimpleSymbolSupplier> symbol_supplier;
+  if (!options.symbol_paths.empty()) {
+    symbol_supplier.reset(new SimpleSymbolSupplier(options.symbol_paths));
+  }
+
+  while (true) {
+    pthread_mutex_lock(&job->lock);
+    size_t index = job->next++;
+    pthread_mutex_unlock(&job->lock);
+    if (index >= job->ranges.size())
+      break;
+
+    // Resolvers know modules by name only, and microdumps from different
+    // builds may share module names, so each microdump needs its own.
+    BasicSourceLineResolver resolver;
+    ProcessState process_state;
+    ProcessResult res = ProcessMicrodump(job->data + job->ranges[index].first,
+                                         job->ranges[index].second,
+                                         symbol_supplier.get(), &resolver,
+                                         &process_state);
+
+    pthread_mutex_lock(&job->lock);
+    while (job->next_to_print != index)
+      pthread_cond_wait(&job->printed, &job->lock);
+    // JSON output is one document per line.
+    if (index != 0 && !options.json)
+      printf("\n");
+    if (!options.machine_readable && !options.json) {
+      printf("Microdump %zu of %zu, at byte offset %zu\n\n", index + 1,
+             job->ranges.size(), job->ranges[index].first);
+    }
+    if (res == google_breakpad::PROCESS_OK) {
+      PrintMicrodump(options, process_state, &resolver);
+    } else {
+      BPLOG(ERROR) << "MicrodumpProcessor::Process failed for microdump "
+                   << index + 1 << " (code = " << res << ")";
+      job->failures++;
+    }
+    fflush(stdout);
+    job->next_to_print++;
+    pthread_cond_broadcast(&job->printed);
+    pthread_mutex_unlock(&job->lock);
+  }
+  return NULL;
+}
+
+// Processes every microdump in |options.microdump_file|, on
+// |options.threads| threads, printing the results for each in turn.
+// Returns 0 if the file contains microdumps and all of them could be
+// processed.
+int PrintAllMicrodumps(const Options& options, const MappedFile& file) {
+  LogJob job;
+  job.options = &options;
+  job.data = file.data();
+  Microdump::FindMicrodumps(file.data(), file.size(), &job.ranges);
+  if (job.ranges.empty()) {
+    BPLOG(ERROR) << "No microdumps found in " << options.microdump_file;
+    return 1;
+  }
+
+  pthread_mutex_init(&job.lock, NULL);
+  pthread_cond_init(&job.printed, NULL);
+  job.next = 0;
+  job.next_to_print = 0;
+  job.failures = 0;
+  std::vector<pthread_t> workers;
+  for (int i = 1; i < options.threads &&
+                  static_cast<size_t>(i) < job.ranges.size(); i++) {
+    pthread_t worker;
+    if (pthread_create(&worker, NULL, ProcessMicrodumps, &job) != 0)
+      break;
+    workers.push_back(worker);
+  }
+  ProcessMicrodumps(&job);
+  for (size_t i = 0; i < workers.size(); i++)
+    pthread_join(workers[i], NULL);
+  pthread_cond_destroy(&job.printed);
+  pthread_mutex_destroy(&job.lock);
+  return job.failures ? 1 : 0;
+}
+
 // Processes |options.microdump_file| using
 // MicrodumpProcessor. |options.symbol_path|, if non-empty, is the
 // base directory of a symbol storage area, laid out in the format
@@ -81,17 +245,14 @@ using google_breakpad::StackFrameSymbolizer;
 // information and call stacks for the crashing thread.
 // All information is printed to stdout.
 int PrintMicrodumpProcess(const Options& options) {
-  std::ifstream file_stream(options.microdump_file);
-  std::vector<char> bytes;
-  file_stream.seekg(0, std::ios_base::end);
-  bytes.resize(file_stream.tellg());
-  if (bytes.empty()) {
-    BPLOG(ERROR) << "Microdump is empty.";
+  MappedFile file;
+  if (!file.Map(options.microdump_file)) {
+    BPLOG(ERROR) << "Microdump is empty or could not be read.";
     return 1;
   }
-  file_stream.seekg(0, std::ios_base::beg);
-  file_stream.read(&bytes[0], bytes.size());
-  string microdump_content(&bytes[0], bytes.size());
+
+  if (options.all_microdumps)
+    return PrintAllMicrodumps(options, file);
 
   scoped_ptr<SimpleSymbolSupplier> symbol_supplier;
   if (!options.symbol_paths.empty()) {
@@ -99,19 +260,13 @@ int PrintMicrodumpProcess(const Options& options) {
   }
 
   BasicSourceLineResolver resolver;
-  StackFrameSymbolizer frame_symbolizer(symbol_supplier.get(), &resolver);
   ProcessState process_state;
-  MicrodumpProcessor microdump_processor(&frame_symbolizer);
-  Microdump microdump(microdump_content);
-  ProcessResult res = microdump_processor.Process(&microdump,
-                                                  &process_state);
+  ProcessResult res = ProcessMicrodump(file.data(), file.size(),
+                                       symbol_supplier.get(), &resolver,
+                                       &process_state);
 
   if (res == google_breakpad::PROCESS_OK) {
-    if (options.machine_readable) {
-      PrintProcessStateMachineReadable(process_state);
-    } else {
-      PrintProcessState(process_state, options.output_stack_contents, &resolver);
-    }
+    PrintMicrodump(options, process_state, &resolver);
     return 0;
   }
 
@@ -130,7 +285,13 @@ static void Usage(int argc, const char *argv[], bool error) {
           "Options:\n"
           "\n"
           "  -m         Output in machine-readable format\n"
-          "  -s         Output stack contents\n",
+          "  -J         Output in JSON format\n"
+          "  -s         Output stack contents\n"
+          "  -a         Process every microdump in the file, such as a "
+          "logcat capture\n"
+          "  -j <count> With -a, process this many microdumps at once "
+          "(default: the\n"
+          "             number of CPUs)\n",
           google_breakpad::BaseName(argv[0]).c_str());
 }
 
@@ -138,9 +299,14 @@ static void SetupOptions(int argc, const char *argv[], Options* options) {
   int ch;
 
   options->machine_readable = false;
+  options->json = false;
   options->output_stack_contents = false;
+  options->all_microdumps = false;
+  options->threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (options->threads < 1)
+    options->threads = 1;
 
-  while ((ch = getopt(argc, (char * const*)argv, "hms")) != -1) {
+  while ((ch = getopt(argc, (char * const*)argv, "ahJj:ms")) != -1) {
     switch (ch) {
       case 'h':
         Usage(argc, argv, false);
@@ -150,9 +316,23 @@ static void SetupOptions(int argc, const char *argv[], Options* options) {
       case 'm':
         options->machine_readable = true;
         break;
+      case 'J':
+        options->json = true;
+        break;
       case 's':
         options->output_stack_contents = true;
         break;
+      case 'a':
+        options->all_microdumps = true;
+        break;
+      case 'j':
+        options->threads = atoi(optarg);
+        if (options->threads < 1) {
+          fprintf(stderr, "%s: Invalid thread count %s\n", argv[0], optarg);
+          Usage(argc, argv, true);
+          exit(1);
+        }
+        break;
 
       case '?':
         Usage(argc, argv, true);
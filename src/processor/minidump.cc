@@ -33,9 +33,14 @@
 //
 // Author: Mark Mentovai
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
 #include "google_breakpad/processor/minidump.h"
 
 #include <assert.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <stddef.h>
 #include <string.h>
@@ -47,9 +52,15 @@
 #include <unistd.h>
 #endif  // _WIN32
 
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
 #include <algorithm>
 #include <fstream>
 #include <limits>
+#include <set>
+#include <sstream>
 #include <utility>
 
 #include "processor/range_map-inl.h"
@@ -99,6 +110,189 @@ bool IsContextSizeUnique(uint32_t context_size) {
   return num_matching_contexts == 1;
 }
 
+// Reads |count| bytes from |minidump| at |*offset| into |bytes| and advances
+// |*offset| past them, so that consecutive fields of a structure can be read
+// in turn without touching the minidump's current position.
+bool ReadBytesAndAdvance(Minidump* minidump, off_t* offset,
+                         void* bytes, size_t count) {
+  if (!minidump->ReadBytesAt(*offset, bytes, count))
+    return false;
+  *offset += count;
+  return true;
+}
+
+// Orders address ranges by base address, and ranges sharing a base by their
+// position in the list they index.
+bool AddressRangeBaseLess(const MinidumpAddressRange& a,
+                          const MinidumpAddressRange& b) {
+  return a.base < b.base || (a.base == b.base && a.index < b.index);
+}
+
+bool AddressBeforeRange(uint64_t address, const MinidumpAddressRange& range) {
+  return address < range.base;
+}
+
+bool AddressRangeContains(const MinidumpAddressRange& range,
+                          uint64_t address) {
+  return address >= range.base && address - range.base < range.size;
+}
+
+// Sorts |ranges| by base address, and removes the ranges that are empty,
+// that wrap around the end of the address space, or that overlap a range
+// with a lower base.  Returns the number of ranges removed.
+size_t SortAddressRanges(vector<MinidumpAddressRange>* ranges) {
+  std::sort(ranges->begin(), ranges->end(), AddressRangeBaseLess);
+  size_t kept = 0;
+  for (size_t i = 0; i < ranges->size(); ++i) {
+    const MinidumpAddressRange& range = (*ranges)[i];
+    if (range.size == 0 || range.base + (range.size - 1) < range.base)
+      continue;
+    if (kept > 0) {
+      const MinidumpAddressRange& previous = (*ranges)[kept - 1];
+      if (range.base - previous.base < previous.size)
+        continue;
+    }
+    (*ranges)[kept++] = range;
+  }
+  size_t removed = ranges->size() - kept;
+  ranges->resize(kept);
+  return removed;
+}
+
+// Turns |ranges|, given in list order, into an index of the same form as
+// SortAddressRanges builds, in which an address covered by several ranges
+// belongs to the first of them in the list, as it would for a search of the
+// list in order.  Overlapped ranges are split into the pieces no earlier
+// range covers.  Empty ranges and ranges that wrap around the end of the
+// address space are removed; returns how many were.
+size_t IndexAddressRangesInListOrder(vector<MinidumpAddressRange>* ranges) {
+  // Each range starts at its base and ends one past its last address.  A
+  // range reaching the top of the address space never ends.
+  vector<std::pair<uint64_t, MinidumpAddressRange> > events;
+  size_t removed = 0;
+  for (size_t i = 0; i < ranges->size(); ++i) {
+    const MinidumpAddressRange& range = (*ranges)[i];
+    if (range.size == 0 || range.base + (range.size - 1) < range.base) {
+      ++removed;
+      continue;
+    }
+    events.push_back(std::make_pair(range.base, range));
+    const uint64_t last = range.base + (range.size - 1);
+    if (last != numeric_limits<uint64_t>::max()) {
+      MinidumpAddressRange end = range;
+      end.size = 0;
+      events.push_back(std::make_pair(last + 1, end));
+    }
+  }
+  std::sort(events.begin(), events.end(),
+            [](const std::pair<uint64_t, MinidumpAddressRange>& a,
+               const std::pair<uint64_t, MinidumpAddressRange>& b) {
+              return a.first < b.first;
+            });
+
+  // Sweep the address space, keeping the list indices of the ranges that
+  // cover it; the lowest owns each stretch.
+  vector<MinidumpAddressRange> pieces;
+  std::set<unsigned int> covering;
+  bool open = false;
+  for (size_t i = 0; i < events.size();) {
+    const uint64_t address = events[i].first;
+    for (; i < events.size() && events[i].first == address; ++i) {
+      if (events[i].second.size)
+        covering.insert(events[i].second.index);
+      else
+        covering.erase(events[i].second.index);
+    }
+    if (open && (covering.empty() ||
+                 *covering.begin() != pieces.back().index)) {
+      pieces.back().size = address - pieces.back().base;
+      open = false;
+    }
+    if (!open && !covering.empty()) {
+      MinidumpAddressRange piece;
+      piece.base = address;
+      piece.size = 0;
+      piece.index = *covering.begin();
+      pieces.push_back(piece);
+      open = true;
+    }
+  }
+  // A piece still open reaches the top of the address space.  The very top
+  // address is given up if the piece would otherwise cover all of it.
+  if (open) {
+    pieces.back().size = numeric_limits<uint64_t>::max() - pieces.back().base;
+    if (pieces.back().base != 0)
+      ++pieces.back().size;
+  }
+
+  ranges->swap(pieces);
+  return removed;
+}
+
+// Returns the range in |ranges|, as sorted by SortAddressRanges, that
+// contains |address|, or NULL if there is none.
+const MinidumpAddressRange* FindAddressRange(
+    const vector<MinidumpAddressRange>& ranges, uint64_t address) {
+  vector<MinidumpAddressRange>::const_iterator range =
+      std::upper_bound(ranges.begin(), ranges.end(), address,
+                       AddressBeforeRange);
+  if (range == ranges.begin())
+    return NULL;
+  --range;
+  return AddressRangeContains(*range, address) ? &*range : NULL;
+}
+
+// Sets each element of |found| to the range in |ranges| containing the
+// corresponding element of |addresses|, or to NULL.  Ascending addresses are
+// matched by walking |ranges| once alongside them; an address lower than the
+// one before it restarts the walk with a binary search.
+void FindAddressRanges(const vector<MinidumpAddressRange>& ranges,
+                       const vector<uint64_t>& addresses,
+                       vector<const MinidumpAddressRange*>* found) {
+  found->assign(addresses.size(), NULL);
+
+  // The first range whose base is above the previous address.
+  size_t next_range = 0;
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    uint64_t address = addresses[i];
+    if (i > 0 && address < addresses[i - 1]) {
+      next_range = std::upper_bound(ranges.begin(), ranges.end(), address,
+                                    AddressBeforeRange) - ranges.begin();
+    } else {
+      while (next_range < ranges.size() &&
+             ranges[next_range].base <= address) {
+        ++next_range;
+      }
+    }
+
+    if (next_range > 0 &&
+        AddressRangeContains(ranges[next_range - 1], address)) {
+      (*found)[i] = &ranges[next_range - 1];
+    }
+  }
+}
+
+// Fields that Minidump* objects read lazily may be filled by several threads
+// at once.  Each thread reads its own copy without holding |lock|, and the
+// first copy published under |lock| is kept; later ones are discarded.
+template<typename T>
+T* LoadCachedField(std::mutex* lock, T* const* field) {
+  lock->lock();
+  T* value = *field;
+  lock->unlock();
+  return value;
+}
+
+template<typename T>
+T* PublishCachedField(std::mutex* lock, T** field, scoped_ptr<T>* value) {
+  lock->lock();
+  if (!*field)
+    *field = value->release();
+  T* published = *field;
+  lock->unlock();
+  return published;
+}
+
 //
 // Swapping routines
 //
@@ -445,7 +639,7 @@ MinidumpContext::MinidumpContext(Minidump* minidump)
 MinidumpContext::~MinidumpContext() {
 }
 
-bool MinidumpContext::Read(uint32_t expected_size) {
+bool MinidumpContext::Read(off_t offset, uint32_t expected_size) {
   valid_ = false;
 
   // Certain raw context types are currently assumed to have unique sizes.
@@ -474,8 +668,8 @@ bool MinidumpContext::Read(uint32_t expected_size) {
     BPLOG(INFO) << "MinidumpContext: looks like AMD64 context";
 
     scoped_ptr<MDRawContextAMD64> context_amd64(new MDRawContextAMD64());
-    if (!minidump_->ReadBytes(context_amd64.get(),
-                              sizeof(MDRawContextAMD64))) {
+    if (!ReadBytesAndAdvance(minidump_, &offset, context_amd64.get(),
+                             sizeof(MDRawContextAMD64))) {
       BPLOG(ERROR) << "MinidumpContext could not read amd64 context";
       return false;
     }
@@ -500,8 +694,6 @@ bool MinidumpContext::Read(uint32_t expected_size) {
       return false;
     }
 
-    // Do this after reading the entire MDRawContext structure because
-    // GetSystemInfo may seek minidump to a new position.
     if (!CheckAgainstSystemInfo(cpu_type)) {
       BPLOG(ERROR) << "MinidumpContext amd64 does not match system info";
       return false;
@@ -576,7 +768,8 @@ bool MinidumpContext::Read(uint32_t expected_size) {
     // |context_flags| of MDRawContextPPC64 is 64 bits, but other MDRawContext
     // in the else case have 32 bits |context_flags|, so special case it here.
     uint64_t context_flags;
-    if (!minidump_->ReadBytes(&context_flags, sizeof(context_flags))) {
+    if (!ReadBytesAndAdvance(minidump_, &offset, &context_flags,
+                             sizeof(context_flags))) {
       BPLOG(ERROR) << "MinidumpContext could not read context flags";
       return false;
     }
@@ -610,14 +803,12 @@ bool MinidumpContext::Read(uint32_t expected_size) {
     size_t flags_size = sizeof(context_ppc64->context_flags);
     uint8_t* context_after_flags =
           reinterpret_cast<uint8_t*>(context_ppc64.get()) + flags_size;
-    if (!minidump_->ReadBytes(context_after_flags,
-                              sizeof(MDRawContextPPC64) - flags_size)) {
+    if (!ReadBytesAndAdvance(minidump_, &offset, context_after_flags,
+                             sizeof(MDRawContextPPC64) - flags_size)) {
       BPLOG(ERROR) << "MinidumpContext could not read ppc64 context";
       return false;
     }
 
-    // Do this after reading the entire MDRawContext structure because
-    // GetSystemInfo may seek minidump to a new position.
     if (!CheckAgainstSystemInfo(cpu_type)) {
       BPLOG(ERROR) << "MinidumpContext ppc64 does not match system info";
       return false;
@@ -673,7 +864,8 @@ bool MinidumpContext::Read(uint32_t expected_size) {
 
     BPLOG(INFO) << "MinidumpContext: looks like ARM64 context";
 
-    if (!minidump_->ReadBytes(&context_flags, sizeof(context_flags))) {
+    if (!ReadBytesAndAdvance(minidump_, &offset, &context_flags,
+                             sizeof(context_flags))) {
       BPLOG(ERROR) << "MinidumpContext could not read context flags";
       return false;
     }
@@ -707,14 +899,12 @@ bool MinidumpContext::Read(uint32_t expected_size) {
     size_t flags_size = sizeof(context_arm64->context_flags);
     uint8_t* context_after_flags =
         reinterpret_cast<uint8_t*>(context_arm64.get()) + flags_size;
-    if (!minidump_->ReadBytes(context_after_flags,
-                              sizeof(MDRawContextARM64_Old) - flags_size)) {
+    if (!ReadBytesAndAdvance(minidump_, &offset, context_after_flags,
+                             sizeof(MDRawContextARM64_Old) - flags_size)) {
       BPLOG(ERROR) << "MinidumpContext could not read arm64 context";
       return false;
     }
 
-    // Do this after reading the entire MDRawContext structure because
-    // GetSystemInfo may seek minidump to a new position.
     if (!CheckAgainstSystemInfo(cpu_type)) {
       BPLOG(ERROR) << "MinidumpContext arm64 does not match system info";
       return false;
@@ -745,7 +935,8 @@ bool MinidumpContext::Read(uint32_t expected_size) {
     SetContextARM64(new_context.release());
   } else {
     uint32_t context_flags;
-    if (!minidump_->ReadBytes(&context_flags, sizeof(context_flags))) {
+    if (!ReadBytesAndAdvance(minidump_, &offset, &context_flags,
+                             sizeof(context_flags))) {
       BPLOG(ERROR) << "MinidumpContext could not read context flags";
       return false;
     }
@@ -796,14 +987,12 @@ bool MinidumpContext::Read(uint32_t expected_size) {
         size_t flags_size = sizeof(context_x86->context_flags);
         uint8_t* context_after_flags =
           reinterpret_cast<uint8_t*>(context_x86.get()) + flags_size;
-        if (!minidump_->ReadBytes(context_after_flags,
-                                  sizeof(MDRawContextX86) - flags_size)) {
+        if (!ReadBytesAndAdvance(minidump_, &offset, context_after_flags,
+                                 sizeof(MDRawContextX86) - flags_size)) {
           BPLOG(ERROR) << "MinidumpContext could not read x86 context";
           return false;
         }
 
-        // Do this after reading the entire MDRawContext structure because
-        // GetSystemInfo may seek minidump to a new position.
         if (!CheckAgainstSystemInfo(cpu_type)) {
           BPLOG(ERROR) << "MinidumpContext x86 does not match system info";
           return false;
@@ -869,14 +1058,12 @@ bool MinidumpContext::Read(uint32_t expected_size) {
         size_t flags_size = sizeof(context_ppc->context_flags);
         uint8_t* context_after_flags =
           reinterpret_cast<uint8_t*>(context_ppc.get()) + flags_size;
-        if (!minidump_->ReadBytes(context_after_flags,
-                                  sizeof(MDRawContextPPC) - flags_size)) {
+        if (!ReadBytesAndAdvance(minidump_, &offset, context_after_flags,
+                                 sizeof(MDRawContextPPC) - flags_size)) {
           BPLOG(ERROR) << "MinidumpContext could not read ppc context";
           return false;
         }
 
-        // Do this after reading the entire MDRawContext structure because
-        // GetSystemInfo may seek minidump to a new position.
         if (!CheckAgainstSystemInfo(cpu_type)) {
           BPLOG(ERROR) << "MinidumpContext ppc does not match system info";
           return false;
@@ -945,14 +1132,12 @@ bool MinidumpContext::Read(uint32_t expected_size) {
         size_t flags_size = sizeof(context_sparc->context_flags);
         uint8_t* context_after_flags =
             reinterpret_cast<uint8_t*>(context_sparc.get()) + flags_size;
-        if (!minidump_->ReadBytes(context_after_flags,
-                                  sizeof(MDRawContextSPARC) - flags_size)) {
+        if (!ReadBytesAndAdvance(minidump_, &offset, context_after_flags,
+                                 sizeof(MDRawContextSPARC) - flags_size)) {
           BPLOG(ERROR) << "MinidumpContext could not read sparc context";
           return false;
         }
 
-        // Do this after reading the entire MDRawContext structure because
-        // GetSystemInfo may seek minidump to a new position.
         if (!CheckAgainstSystemInfo(cpu_type)) {
           BPLOG(ERROR) << "MinidumpContext sparc does not match system info";
           return false;
@@ -1001,14 +1186,12 @@ bool MinidumpContext::Read(uint32_t expected_size) {
         size_t flags_size = sizeof(context_arm->context_flags);
         uint8_t* context_after_flags =
             reinterpret_cast<uint8_t*>(context_arm.get()) + flags_size;
-        if (!minidump_->ReadBytes(context_after_flags,
-                                  sizeof(MDRawContextARM) - flags_size)) {
+        if (!ReadBytesAndAdvance(minidump_, &offset, context_after_flags,
+                                 sizeof(MDRawContextARM) - flags_size)) {
           BPLOG(ERROR) << "MinidumpContext could not read arm context";
           return false;
         }
 
-        // Do this after reading the entire MDRawContext structure because
-        // GetSystemInfo may seek minidump to a new position.
         if (!CheckAgainstSystemInfo(cpu_type)) {
           BPLOG(ERROR) << "MinidumpContext arm does not match system info";
           return false;
@@ -1056,14 +1239,12 @@ bool MinidumpContext::Read(uint32_t expected_size) {
         size_t flags_size = sizeof(context_arm64->context_flags);
         uint8_t* context_after_flags =
             reinterpret_cast<uint8_t*>(context_arm64.get()) + flags_size;
-        if (!minidump_->ReadBytes(context_after_flags,
-                                  sizeof(*context_arm64) - flags_size)) {
+        if (!ReadBytesAndAdvance(minidump_, &offset, context_after_flags,
+                                 sizeof(*context_arm64) - flags_size)) {
           BPLOG(ERROR) << "MinidumpContext could not read arm64 context";
           return false;
         }
 
-        // Do this after reading the entire MDRawContext structure because
-        // GetSystemInfo may seek minidump to a new position.
         if (!CheckAgainstSystemInfo(cpu_type)) {
           BPLOG(ERROR) << "MinidumpContext arm does not match system info";
           return false;
@@ -1111,14 +1292,12 @@ bool MinidumpContext::Read(uint32_t expected_size) {
         size_t flags_size = sizeof(context_mips->context_flags);
         uint8_t* context_after_flags =
             reinterpret_cast<uint8_t*>(context_mips.get()) + flags_size;
-        if (!minidump_->ReadBytes(context_after_flags,
-                                  sizeof(MDRawContextMIPS) - flags_size)) {
+        if (!ReadBytesAndAdvance(minidump_, &offset, context_after_flags,
+                                 sizeof(MDRawContextMIPS) - flags_size)) {
           BPLOG(ERROR) << "MinidumpContext could not read MIPS context";
           return false;
         }
 
-        // Do this after reading the entire MDRawContext structure because
-        // GetSystemInfo may seek minidump to a new position.
         if (!CheckAgainstSystemInfo(cpu_type)) {
           BPLOG(ERROR) << "MinidumpContext MIPS does not match system info";
           return false;
@@ -1298,17 +1477,14 @@ const uint8_t* MinidumpMemoryRegion::GetMemory() const {
     return NULL;
   }
 
-  if (!memory_) {
+  vector<uint8_t>* cached_memory =
+      LoadCachedField(&minidump_->cache_lock_, &memory_);
+  if (!cached_memory) {
     if (descriptor_->memory.data_size == 0) {
       BPLOG(ERROR) << "MinidumpMemoryRegion is empty";
       return NULL;
     }
 
-    if (!minidump_->SeekSet(descriptor_->memory.rva)) {
-      BPLOG(ERROR) << "MinidumpMemoryRegion could not seek to memory region";
-      return NULL;
-    }
-
     if (descriptor_->memory.data_size > max_bytes_) {
       BPLOG(ERROR) << "MinidumpMemoryRegion size " <<
                       descriptor_->memory.data_size << " exceeds maximum " <<
@@ -1319,15 +1495,17 @@ const uint8_t* MinidumpMemoryRegion::GetMemory() const {
     scoped_ptr< vector<uint8_t> > memory(
         new vector<uint8_t>(descriptor_->memory.data_size));
 
-    if (!minidump_->ReadBytes(&(*memory)[0], descriptor_->memory.data_size)) {
+    if (!minidump_->ReadBytesAt(descriptor_->memory.rva, &(*memory)[0],
+                                descriptor_->memory.data_size)) {
       BPLOG(ERROR) << "MinidumpMemoryRegion could not read memory region";
       return NULL;
     }
 
-    memory_ = memory.release();
+    cached_memory =
+        PublishCachedField(&minidump_->cache_lock_, &memory_, &memory);
   }
 
-  return &(*memory_)[0];
+  return &(*cached_memory)[0];
 }
 
 
@@ -1523,7 +1701,7 @@ MinidumpThread::~MinidumpThread() {
 }
 
 
-bool MinidumpThread::Read() {
+bool MinidumpThread::Read(off_t offset) {
   // Invalidate cached data.
   delete memory_;
   memory_ = NULL;
@@ -1532,7 +1710,7 @@ bool MinidumpThread::Read() {
 
   valid_ = false;
 
-  if (!minidump_->ReadBytes(&thread_, sizeof(thread_))) {
+  if (!minidump_->ReadBytesAt(offset, &thread_, sizeof(thread_))) {
     BPLOG(ERROR) << "MinidumpThread cannot read thread";
     return false;
   }
@@ -1591,23 +1769,22 @@ MinidumpContext* MinidumpThread::GetContext() {
     return NULL;
   }
 
-  if (!context_) {
-    if (!minidump_->SeekSet(thread_.thread_context.rva)) {
-      BPLOG(ERROR) << "MinidumpThread cannot seek to context";
-      return NULL;
-    }
-
+  MinidumpContext* cached_context =
+      LoadCachedField(&minidump_->cache_lock_, &context_);
+  if (!cached_context) {
     scoped_ptr<MinidumpContext> context(new MinidumpContext(minidump_));
 
-    if (!context->Read(thread_.thread_context.data_size)) {
+    if (!context->Read(thread_.thread_context.rva,
+                       thread_.thread_context.data_size)) {
       BPLOG(ERROR) << "MinidumpThread cannot read context";
       return NULL;
     }
 
-    context_ = context.release();
+    cached_context =
+        PublishCachedField(&minidump_->cache_lock_, &context_, &context);
   }
 
-  return context_;
+  return cached_context;
 }
 
 
@@ -1690,7 +1867,7 @@ MinidumpThreadList::~MinidumpThreadList() {
 }
 
 
-bool MinidumpThreadList::Read(uint32_t expected_size) {
+bool MinidumpThreadList::Read(off_t offset, uint32_t expected_size) {
   // Invalidate cached data.
   id_to_thread_map_.clear();
   delete threads_;
@@ -1705,7 +1882,8 @@ bool MinidumpThreadList::Read(uint32_t expected_size) {
                     expected_size << " < " << sizeof(thread_count);
     return false;
   }
-  if (!minidump_->ReadBytes(&thread_count, sizeof(thread_count))) {
+  if (!ReadBytesAndAdvance(minidump_, &offset, &thread_count,
+                           sizeof(thread_count))) {
     BPLOG(ERROR) << "MinidumpThreadList cannot read thread count";
     return false;
   }
@@ -1725,7 +1903,7 @@ bool MinidumpThreadList::Read(uint32_t expected_size) {
     if (expected_size == sizeof(thread_count) + 4 +
                          thread_count * sizeof(MDRawThread)) {
       uint32_t useless;
-      if (!minidump_->ReadBytes(&useless, 4)) {
+      if (!ReadBytesAndAdvance(minidump_, &offset, &useless, 4)) {
         BPLOG(ERROR) << "MinidumpThreadList cannot read threadlist padded "
                         "bytes";
         return false;
@@ -1754,8 +1932,7 @@ bool MinidumpThreadList::Read(uint32_t expected_size) {
          ++thread_index) {
       MinidumpThread* thread = &(*threads)[thread_index];
 
-      // Assume that the file offset is correct after the last read.
-      if (!thread->Read()) {
+      if (!thread->Read(offset + thread_index * sizeof(MDRawThread))) {
         BPLOG(ERROR) << "MinidumpThreadList cannot read thread " <<
                         thread_index << "/" << thread_count;
         return false;
@@ -1860,7 +2037,7 @@ MinidumpModule::~MinidumpModule() {
 }
 
 
-bool MinidumpModule::Read() {
+bool MinidumpModule::Read(off_t offset) {
   // Invalidate cached data.
   delete name_;
   name_ = NULL;
@@ -1874,7 +2051,7 @@ bool MinidumpModule::Read() {
   has_debug_info_ = false;
   valid_ = false;
 
-  if (!minidump_->ReadBytes(&module_, MD_MODULE_SIZE)) {
+  if (!minidump_->ReadBytesAt(offset, &module_, MD_MODULE_SIZE)) {
     BPLOG(ERROR) << "MinidumpModule cannot read module";
     return false;
   }
@@ -2328,18 +2505,15 @@ const uint8_t* MinidumpModule::GetCVRecord(uint32_t* size) {
     return NULL;
   }
 
-  if (!cv_record_) {
+  vector<uint8_t>* cached_cv_record =
+      LoadCachedField(&minidump_->cache_lock_, &cv_record_);
+  if (!cached_cv_record) {
     // This just guards against 0-sized CodeView records; more specific checks
     // are used when the signature is checked against various structure types.
     if (module_.cv_record.data_size == 0) {
       return NULL;
     }
 
-    if (!minidump_->SeekSet(module_.cv_record.rva)) {
-      BPLOG(ERROR) << "MinidumpModule could not seek to CodeView record";
-      return NULL;
-    }
-
     if (module_.cv_record.data_size > max_cv_bytes_) {
       BPLOG(ERROR) << "MinidumpModule CodeView record size " <<
                       module_.cv_record.data_size << " exceeds maximum " <<
@@ -2357,7 +2531,8 @@ const uint8_t* MinidumpModule::GetCVRecord(uint32_t* size) {
     scoped_ptr< vector<uint8_t> > cv_record(
         new vector<uint8_t>(module_.cv_record.data_size));
 
-    if (!minidump_->ReadBytes(&(*cv_record)[0], module_.cv_record.data_size)) {
+    if (!minidump_->ReadBytesAt(module_.cv_record.rva, &(*cv_record)[0],
+                                module_.cv_record.data_size)) {
       BPLOG(ERROR) << "MinidumpModule could not read CodeView record";
       return NULL;
     }
@@ -2447,15 +2622,21 @@ const uint8_t* MinidumpModule::GetCVRecord(uint32_t* size) {
     // although byte-swapping can't be done.
 
     // Store the vector type because that's how storage was allocated, but
-    // return it casted to uint8_t*.
-    cv_record_ = cv_record.release();
-    cv_record_signature_ = signature;
+    // return it casted to uint8_t*.  The signature is published along with
+    // the record it describes.
+    minidump_->cache_lock_.lock();
+    if (!cv_record_) {
+      cv_record_ = cv_record.release();
+      cv_record_signature_ = signature;
+    }
+    cached_cv_record = cv_record_;
+    minidump_->cache_lock_.unlock();
   }
 
   if (size)
     *size = module_.cv_record.data_size;
 
-  return &(*cv_record_)[0];
+  return &(*cached_cv_record)[0];
 }
 
 
@@ -2465,7 +2646,9 @@ const MDImageDebugMisc* MinidumpModule::GetMiscRecord(uint32_t* size) {
     return NULL;
   }
 
-  if (!misc_record_) {
+  vector<uint8_t>* cached_misc_record =
+      LoadCachedField(&minidump_->cache_lock_, &misc_record_);
+  if (!cached_misc_record) {
     if (module_.misc_record.data_size == 0) {
       return NULL;
     }
@@ -2477,12 +2660,6 @@ const MDImageDebugMisc* MinidumpModule::GetMiscRecord(uint32_t* size) {
       return NULL;
     }
 
-    if (!minidump_->SeekSet(module_.misc_record.rva)) {
-      BPLOG(ERROR) << "MinidumpModule could not seek to miscellaneous "
-                      "debugging record";
-      return NULL;
-    }
-
     if (module_.misc_record.data_size > max_misc_bytes_) {
       BPLOG(ERROR) << "MinidumpModule miscellaneous debugging record size " <<
                       module_.misc_record.data_size << " exceeds maximum " <<
@@ -2501,7 +2678,8 @@ const MDImageDebugMisc* MinidumpModule::GetMiscRecord(uint32_t* size) {
     MDImageDebugMisc* misc_record =
         reinterpret_cast<MDImageDebugMisc*>(&(*misc_record_mem)[0]);
 
-    if (!minidump_->ReadBytes(misc_record, module_.misc_record.data_size)) {
+    if (!minidump_->ReadBytesAt(module_.misc_record.rva, misc_record,
+                                module_.misc_record.data_size)) {
       BPLOG(ERROR) << "MinidumpModule could not read miscellaneous debugging "
                       "record";
       return NULL;
@@ -2532,13 +2710,14 @@ const MDImageDebugMisc* MinidumpModule::GetMiscRecord(uint32_t* size) {
 
     // Store the vector type because that's how storage was allocated, but
     // return it casted to MDImageDebugMisc*.
-    misc_record_ = misc_record_mem.release();
+    cached_misc_record = PublishCachedField(&minidump_->cache_lock_,
+                                            &misc_record_, &misc_record_mem);
   }
 
   if (size)
     *size = module_.misc_record.data_size;
 
-  return reinterpret_cast<MDImageDebugMisc*>(&(*misc_record_)[0]);
+  return reinterpret_cast<MDImageDebugMisc*>(&(*cached_misc_record)[0]);
 }
 
 
@@ -2715,7 +2894,7 @@ MinidumpModuleList::~MinidumpModuleList() {
 }
 
 
-bool MinidumpModuleList::Read(uint32_t expected_size) {
+bool MinidumpModuleList::Read(off_t offset, uint32_t expected_size) {
   // Invalidate cached data.
   range_map_->Clear();
   delete modules_;
@@ -2730,7 +2909,8 @@ bool MinidumpModuleList::Read(uint32_t expected_size) {
                     expected_size << " < " << sizeof(module_count);
     return false;
   }
-  if (!minidump_->ReadBytes(&module_count, sizeof(module_count))) {
+  if (!ReadBytesAndAdvance(minidump_, &offset, &module_count,
+                           sizeof(module_count))) {
     BPLOG(ERROR) << "MinidumpModuleList could not read module count";
     return false;
   }
@@ -2750,7 +2930,7 @@ bool MinidumpModuleList::Read(uint32_t expected_size) {
     if (expected_size == sizeof(module_count) + 4 +
                          module_count * MD_MODULE_SIZE) {
       uint32_t useless;
-      if (!minidump_->ReadBytes(&useless, 4)) {
+      if (!ReadBytesAndAdvance(minidump_, &offset, &useless, 4)) {
         BPLOG(ERROR) << "MinidumpModuleList cannot read modulelist padded "
                         "bytes";
         return false;
@@ -2777,8 +2957,7 @@ bool MinidumpModuleList::Read(uint32_t expected_size) {
          ++module_index) {
       MinidumpModule* module = &(*modules)[module_index];
 
-      // Assume that the file offset is correct after the last read.
-      if (!module->Read()) {
+      if (!module->Read(offset + module_index * MD_MODULE_SIZE)) {
         BPLOG(ERROR) << "MinidumpModuleList could not read module " <<
                         module_index << "/" << module_count;
         return false;
@@ -3021,7 +3200,7 @@ MinidumpMemoryList::~MinidumpMemoryList() {
 }
 
 
-bool MinidumpMemoryList::Read(uint32_t expected_size) {
+bool MinidumpMemoryList::Read(off_t offset, uint32_t expected_size) {
   // Invalidate cached data.
   delete descriptors_;
   descriptors_ = NULL;
@@ -3038,7 +3217,8 @@ bool MinidumpMemoryList::Read(uint32_t expected_size) {
                     expected_size << " < " << sizeof(region_count);
     return false;
   }
-  if (!minidump_->ReadBytes(&region_count, sizeof(region_count))) {
+  if (!ReadBytesAndAdvance(minidump_, &offset, &region_count,
+                           sizeof(region_count))) {
     BPLOG(ERROR) << "MinidumpMemoryList could not read memory region count";
     return false;
   }
@@ -3059,7 +3239,7 @@ bool MinidumpMemoryList::Read(uint32_t expected_size) {
     if (expected_size == sizeof(region_count) + 4 +
                          region_count * sizeof(MDMemoryDescriptor)) {
       uint32_t useless;
-      if (!minidump_->ReadBytes(&useless, 4)) {
+      if (!ReadBytesAndAdvance(minidump_, &offset, &useless, 4)) {
         BPLOG(ERROR) << "MinidumpMemoryList cannot read memorylist padded "
                         "bytes";
         return false;
@@ -3084,8 +3264,8 @@ bool MinidumpMemoryList::Read(uint32_t expected_size) {
 
     // Read the entire array in one fell swoop, instead of reading one entry
     // at a time in the loop.
-    if (!minidump_->ReadBytes(&(*descriptors)[0],
-                              sizeof(MDMemoryDescriptor) * region_count)) {
+    if (!ReadBytesAndAdvance(minidump_, &offset, &(*descriptors)[0],
+                             sizeof(MDMemoryDescriptor) * region_count)) {
       BPLOG(ERROR) << "MinidumpMemoryList could not read memory region list";
       return false;
     }
@@ -3221,7 +3401,7 @@ MinidumpException::~MinidumpException() {
 }
 
 
-bool MinidumpException::Read(uint32_t expected_size) {
+bool MinidumpException::Read(off_t offset, uint32_t expected_size) {
   // Invalidate cached data.
   delete context_;
   context_ = NULL;
@@ -3234,7 +3414,7 @@ bool MinidumpException::Read(uint32_t expected_size) {
     return false;
   }
 
-  if (!minidump_->ReadBytes(&exception_, sizeof(exception_))) {
+  if (!minidump_->ReadBytesAt(offset, &exception_, sizeof(exception_))) {
     BPLOG(ERROR) << "MinidumpException cannot read exception";
     return false;
   }
@@ -3285,25 +3465,24 @@ MinidumpContext* MinidumpException::GetContext() {
     return NULL;
   }
 
-  if (!context_) {
-    if (!minidump_->SeekSet(exception_.thread_context.rva)) {
-      BPLOG(ERROR) << "MinidumpException cannot seek to context";
-      return NULL;
-    }
-
+  MinidumpContext* cached_context =
+      LoadCachedField(&minidump_->cache_lock_, &context_);
+  if (!cached_context) {
     scoped_ptr<MinidumpContext> context(new MinidumpContext(minidump_));
 
     // Don't log as an error if we can still fall back on the thread's context
     // (which must be possible if we got this far.)
-    if (!context->Read(exception_.thread_context.data_size)) {
+    if (!context->Read(exception_.thread_context.rva,
+                       exception_.thread_context.data_size)) {
       BPLOG(INFO) << "MinidumpException cannot read context";
       return NULL;
     }
 
-    context_ = context.release();
+    cached_context =
+        PublishCachedField(&minidump_->cache_lock_, &context_, &context);
   }
 
-  return context_;
+  return cached_context;
 }
 
 
@@ -3365,7 +3544,7 @@ MinidumpAssertion::~MinidumpAssertion() {
 }
 
 
-bool MinidumpAssertion::Read(uint32_t expected_size) {
+bool MinidumpAssertion::Read(off_t offset, uint32_t expected_size) {
   // Invalidate cached data.
   valid_ = false;
 
@@ -3375,7 +3554,7 @@ bool MinidumpAssertion::Read(uint32_t expected_size) {
     return false;
   }
 
-  if (!minidump_->ReadBytes(&assertion_, sizeof(assertion_))) {
+  if (!minidump_->ReadBytesAt(offset, &assertion_, sizeof(assertion_))) {
     BPLOG(ERROR) << "MinidumpAssertion cannot read assertion";
     return false;
   }
@@ -3439,7 +3618,7 @@ MinidumpSystemInfo::~MinidumpSystemInfo() {
 }
 
 
-bool MinidumpSystemInfo::Read(uint32_t expected_size) {
+bool MinidumpSystemInfo::Read(off_t offset, uint32_t expected_size) {
   // Invalidate cached data.
   delete csd_version_;
   csd_version_ = NULL;
@@ -3454,7 +3633,7 @@ bool MinidumpSystemInfo::Read(uint32_t expected_size) {
     return false;
   }
 
-  if (!minidump_->ReadBytes(&system_info_, sizeof(system_info_))) {
+  if (!minidump_->ReadBytesAt(offset, &system_info_, sizeof(system_info_))) {
     BPLOG(ERROR) << "MinidumpSystemInfo cannot read system info";
     return false;
   }
@@ -3828,7 +4007,7 @@ void MinidumpUnloadedModule::SetShrinkDownDelta(uint64_t shrink_down_delta) {
   assert(false);
 }
 
-bool MinidumpUnloadedModule::Read(uint32_t expected_size) {
+bool MinidumpUnloadedModule::Read(off_t offset, uint32_t expected_size) {
 
   delete name_;
   valid_ = false;
@@ -3840,20 +4019,14 @@ bool MinidumpUnloadedModule::Read(uint32_t expected_size) {
     return false;
   }
 
-  if (!minidump_->ReadBytes(&unloaded_module_, sizeof(unloaded_module_))) {
+  // Any bytes of the entry beyond the known structure are skipped by
+  // MinidumpUnloadedModuleList, which locates each entry itself.
+  if (!minidump_->ReadBytesAt(offset, &unloaded_module_,
+                              sizeof(unloaded_module_))) {
     BPLOG(ERROR) << "MinidumpUnloadedModule cannot read module";
     return false;
   }
 
-  if (expected_size > sizeof(unloaded_module_)) {
-    uint32_t module_bytes_remaining = expected_size - sizeof(unloaded_module_);
-    off_t pos = minidump_->Tell();
-    if (!minidump_->SeekSet(pos + module_bytes_remaining)) {
-      BPLOG(ERROR) << "MinidumpUnloadedModule unable to seek to end of module";
-      return false;
-    }
-  }
-
   if (minidump_->swap()) {
     Swap(&unloaded_module_.base_of_image);
     Swap(&unloaded_module_.size_of_image);
@@ -3917,7 +4090,7 @@ MinidumpUnloadedModuleList::~MinidumpUnloadedModuleList() {
 }
 
 
-bool MinidumpUnloadedModuleList::Read(uint32_t expected_size) {
+bool MinidumpUnloadedModuleList::Read(off_t offset, uint32_t expected_size) {
   range_map_->Clear();
   delete unloaded_modules_;
   unloaded_modules_ = NULL;
@@ -3926,19 +4099,22 @@ bool MinidumpUnloadedModuleList::Read(uint32_t expected_size) {
   valid_ = false;
 
   uint32_t size_of_header;
-  if (!minidump_->ReadBytes(&size_of_header, sizeof(size_of_header))) {
+  if (!ReadBytesAndAdvance(minidump_, &offset, &size_of_header,
+                           sizeof(size_of_header))) {
     BPLOG(ERROR) << "MinidumpUnloadedModuleList could not read header size";
     return false;
   }
 
   uint32_t size_of_entry;
-  if (!minidump_->ReadBytes(&size_of_entry, sizeof(size_of_entry))) {
+  if (!ReadBytesAndAdvance(minidump_, &offset, &size_of_entry,
+                           sizeof(size_of_entry))) {
     BPLOG(ERROR) << "MinidumpUnloadedModuleList could not read entry size";
     return false;
   }
 
   uint32_t number_of_entries;
-  if (!minidump_->ReadBytes(&number_of_entries, sizeof(number_of_entries))) {
+  if (!ReadBytesAndAdvance(minidump_, &offset, &number_of_entries,
+                           sizeof(number_of_entries))) {
     BPLOG(ERROR) <<
                  "MinidumpUnloadedModuleList could not read number of entries";
     return false;
@@ -3952,14 +4128,7 @@ bool MinidumpUnloadedModuleList::Read(uint32_t expected_size) {
 
   uint32_t header_bytes_remaining = size_of_header - sizeof(size_of_header) -
       sizeof(size_of_entry) - sizeof(number_of_entries);
-  if (header_bytes_remaining) {
-    off_t pos = minidump_->Tell();
-    if (!minidump_->SeekSet(pos + header_bytes_remaining)) {
-      BPLOG(ERROR) << "MinidumpUnloadedModuleList could not read header sized "
-                   << size_of_header;
-      return false;
-    }
-  }
+  offset += header_bytes_remaining;
 
   if (expected_size != size_of_header + (size_of_entry * number_of_entries)) {
     BPLOG(ERROR) << "MinidumpUnloadedModuleList expected_size mismatch " <<
@@ -3984,7 +4153,8 @@ bool MinidumpUnloadedModuleList::Read(uint32_t expected_size) {
          ++module_index) {
       MinidumpUnloadedModule* module = &(*modules)[module_index];
 
-      if (!module->Read(size_of_entry)) {
+      if (!module->Read(offset + module_index * size_of_entry,
+                        size_of_entry)) {
         BPLOG(ERROR) << "MinidumpUnloadedModuleList could not read module " <<
                      module_index << "/" << number_of_entries;
         return false;
@@ -4106,7 +4276,7 @@ MinidumpMiscInfo::MinidumpMiscInfo(Minidump* minidump)
 }
 
 
-bool MinidumpMiscInfo::Read(uint32_t expected_size) {
+bool MinidumpMiscInfo::Read(off_t offset, uint32_t expected_size) {
   valid_ = false;
 
   size_t padding = 0;
@@ -4130,25 +4300,12 @@ bool MinidumpMiscInfo::Read(uint32_t expected_size) {
     }
   }
 
-  if (!minidump_->ReadBytes(&misc_info_, expected_size)) {
+  // Any padding after the structure is simply not read.
+  if (!minidump_->ReadBytesAt(offset, &misc_info_, expected_size)) {
     BPLOG(ERROR) << "MinidumpMiscInfo cannot read miscellaneous info";
     return false;
   }
 
-  if (padding != 0) {
-    off_t saved_position = minidump_->Tell();
-    if (saved_position == -1) {
-      BPLOG(ERROR) << "MinidumpMiscInfo could not tell the current position";
-      return false;
-    }
-
-    if (!minidump_->SeekSet(saved_position + static_cast<off_t>(padding))) {
-      BPLOG(ERROR) << "MinidumpMiscInfo could not seek past the miscellaneous "
-                   << "info structure";
-      return false;
-    }
-  }
-
   if (minidump_->swap()) {
     // Swap version 1 fields
     Swap(&misc_info_.size_of_info);
@@ -4379,7 +4536,7 @@ MinidumpBreakpadInfo::MinidumpBreakpadInfo(Minidump* minidump)
 }
 
 
-bool MinidumpBreakpadInfo::Read(uint32_t expected_size) {
+bool MinidumpBreakpadInfo::Read(off_t offset, uint32_t expected_size) {
   valid_ = false;
 
   if (expected_size != sizeof(breakpad_info_)) {
@@ -4388,7 +4545,8 @@ bool MinidumpBreakpadInfo::Read(uint32_t expected_size) {
     return false;
   }
 
-  if (!minidump_->ReadBytes(&breakpad_info_, sizeof(breakpad_info_))) {
+  if (!minidump_->ReadBytesAt(offset, &breakpad_info_,
+                              sizeof(breakpad_info_))) {
     BPLOG(ERROR) << "MinidumpBreakpadInfo cannot read Breakpad info";
     return false;
   }
@@ -4500,10 +4658,10 @@ bool MinidumpMemoryInfo::IsWritable() const {
 }
 
 
-bool MinidumpMemoryInfo::Read() {
+bool MinidumpMemoryInfo::Read(off_t offset) {
   valid_ = false;
 
-  if (!minidump_->ReadBytes(&memory_info_, sizeof(memory_info_))) {
+  if (!minidump_->ReadBytesAt(offset, &memory_info_, sizeof(memory_info_))) {
     BPLOG(ERROR) << "MinidumpMemoryInfo cannot read memory info";
     return false;
   }
@@ -4560,23 +4718,22 @@ void MinidumpMemoryInfo::Print() {
 
 MinidumpMemoryInfoList::MinidumpMemoryInfoList(Minidump* minidump)
     : MinidumpStream(minidump),
-      range_map_(new RangeMap<uint64_t, unsigned int>()),
+      ranges_(),
       infos_(NULL),
       info_count_(0) {
 }
 
 
 MinidumpMemoryInfoList::~MinidumpMemoryInfoList() {
-  delete range_map_;
   delete infos_;
 }
 
 
-bool MinidumpMemoryInfoList::Read(uint32_t expected_size) {
+bool MinidumpMemoryInfoList::Read(off_t offset, uint32_t expected_size) {
   // Invalidate cached data.
   delete infos_;
   infos_ = NULL;
-  range_map_->Clear();
+  ranges_.clear();
   info_count_ = 0;
 
   valid_ = false;
@@ -4587,7 +4744,7 @@ bool MinidumpMemoryInfoList::Read(uint32_t expected_size) {
                     expected_size << " < " << sizeof(MDRawMemoryInfoList);
     return false;
   }
-  if (!minidump_->ReadBytes(&header, sizeof(header))) {
+  if (!ReadBytesAndAdvance(minidump_, &offset, &header, sizeof(header))) {
     BPLOG(ERROR) << "MinidumpMemoryInfoList could not read header";
     return false;
   }
@@ -4653,24 +4810,33 @@ bool MinidumpMemoryInfoList::Read(uint32_t expected_size) {
          ++index) {
       MinidumpMemoryInfo* info = &(*infos)[index];
 
-      // Assume that the file offset is correct after the last read.
-      if (!info->Read()) {
+      if (!info->Read(offset + index * sizeof(MDRawMemoryInfo))) {
         BPLOG(ERROR) << "MinidumpMemoryInfoList cannot read info " <<
                         index << "/" << header.number_of_entries;
         return false;
       }
 
-      uint64_t base_address = info->GetBase();
-      uint64_t region_size = info->GetSize();
+      MinidumpAddressRange range;
+      range.base = info->GetBase();
+      range.size = info->GetSize();
+      range.index = index;
 
-      if (!range_map_->StoreRange(base_address, region_size, index)) {
+      if (range.size == 0 || range.base + (range.size - 1) < range.base) {
         BPLOG(ERROR) << "MinidumpMemoryInfoList could not store"
                         " memory region " <<
                         index << "/" << header.number_of_entries << ", " <<
-                        HexString(base_address) << "+" <<
-                        HexString(region_size);
+                        HexString(range.base) << "+" <<
+                        HexString(range.size);
+        ranges_.clear();
         return false;
       }
+      ranges_.push_back(range);
+    }
+
+    if (SortAddressRanges(&ranges_) != 0) {
+      BPLOG(ERROR) << "MinidumpMemoryInfoList has overlapping memory regions";
+      ranges_.clear();
+      return false;
     }
 
     infos_ = infos.release();
@@ -4708,15 +4874,37 @@ const MinidumpMemoryInfo* MinidumpMemoryInfoList::GetMemoryInfoForAddress(
     return NULL;
   }
 
-  unsigned int info_index;
-  if (!range_map_->RetrieveRange(address, &info_index, NULL /* base */,
-                                 NULL /* delta */, NULL /* size */)) {
+  const MinidumpAddressRange* range = FindAddressRange(ranges_, address);
+  if (!range) {
     BPLOG(INFO) << "MinidumpMemoryInfoList has no memory info at " <<
                    HexString(address);
     return NULL;
   }
 
-  return GetMemoryInfoAtIndex(info_index);
+  return GetMemoryInfoAtIndex(range->index);
+}
+
+
+void MinidumpMemoryInfoList::GetMemoryInfoForAddresses(
+    const vector<uint64_t>& addresses,
+    vector<const MinidumpMemoryInfo*>* infos) const {
+  BPLOG_IF(ERROR, !infos) << "MinidumpMemoryInfoList::"
+                             "GetMemoryInfoForAddresses requires |infos|";
+  assert(infos);
+  infos->assign(addresses.size(), NULL);
+
+  if (!valid_) {
+    BPLOG(ERROR) << "Invalid MinidumpMemoryInfoList for"
+                    " GetMemoryInfoForAddresses";
+    return;
+  }
+
+  vector<const MinidumpAddressRange*> ranges;
+  FindAddressRanges(ranges_, addresses, &ranges);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (ranges[i])
+      (*infos)[i] = &(*infos_)[ranges[i]->index];
+  }
 }
 
 
@@ -4762,6 +4950,7 @@ void MinidumpLinuxMaps::Print() const {
 MinidumpLinuxMapsList::MinidumpLinuxMapsList(Minidump* minidump)
     : MinidumpStream(minidump),
       maps_(NULL),
+      ranges_(),
       maps_count_(0) {
 }
 
@@ -4781,19 +4970,32 @@ const MinidumpLinuxMaps* MinidumpLinuxMapsList::GetLinuxMapsForAddress(
     return NULL;
   }
 
-  // Search every memory mapping.
-  for (unsigned int index = 0; index < maps_count_; index++) {
-    // Check if address is within bounds of the current memory region.
-    if ((*maps_)[index]->GetBase() <= address &&
-        (*maps_)[index]->GetBase() + (*maps_)[index]->GetSize() > address) {
-      return (*maps_)[index];
-    }
+  // Callers probe many addresses that no mapping encloses, so a miss is
+  // not logged.
+  const MinidumpAddressRange* range = FindAddressRange(ranges_, address);
+  return range ? (*maps_)[range->index] : NULL;
+}
+
+void MinidumpLinuxMapsList::GetLinuxMapsForAddresses(
+    const vector<uint64_t>& addresses,
+    vector<const MinidumpLinuxMaps*>* maps) const {
+  BPLOG_IF(ERROR, !maps) << "MinidumpLinuxMapsList::GetLinuxMapsForAddresses "
+                            "requires |maps|";
+  assert(maps);
+  maps->assign(addresses.size(), NULL);
+
+  if (!valid_ || (maps_ == NULL)) {
+    BPLOG(ERROR) << "Invalid MinidumpLinuxMapsList for "
+                    "GetLinuxMapsForAddresses";
+    return;
   }
 
-  // No mapping encloses the memory address.
-  BPLOG(ERROR) << "MinidumpLinuxMapsList has no mapping at "
-               << HexString(address);
-  return NULL;
+  vector<const MinidumpAddressRange*> ranges;
+  FindAddressRanges(ranges_, addresses, &ranges);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (ranges[i])
+      (*maps)[i] = (*maps_)[ranges[i]->index];
+  }
 }
 
 const MinidumpLinuxMaps* MinidumpLinuxMapsList::GetLinuxMapsAtIndex(
@@ -4814,7 +5016,7 @@ const MinidumpLinuxMaps* MinidumpLinuxMapsList::GetLinuxMapsAtIndex(
   return (*maps_)[index];
 }
 
-bool MinidumpLinuxMapsList::Read(uint32_t expected_size) {
+bool MinidumpLinuxMapsList::Read(off_t offset, uint32_t expected_size) {
   // Invalidate cached data.
   if (maps_) {
     for (unsigned int i = 0; i < maps_->size(); i++) {
@@ -4823,28 +5025,16 @@ bool MinidumpLinuxMapsList::Read(uint32_t expected_size) {
     delete maps_;
   }
   maps_ = NULL;
+  ranges_.clear();
   maps_count_ = 0;
 
   valid_ = false;
 
-  // Load and check expected stream length.
-  uint32_t length = 0;
-  if (!minidump_->SeekToStreamType(MD_LINUX_MAPS, &length)) {
-    BPLOG(ERROR) << "MinidumpLinuxMapsList stream type not found";
-    return false;
-  }
-  if (expected_size != length) {
-    BPLOG(ERROR) << "MinidumpLinuxMapsList size mismatch: "
-                 << expected_size
-                 << " != "
-                 << length;
-    return false;
-  }
-
   // Create a vector to read stream data. The vector needs to have
   // at least enough capacity to read all the data.
+  uint32_t length = expected_size;
   vector<char> mapping_bytes(length);
-  if (!minidump_->ReadBytes(&mapping_bytes[0], length)) {
+  if (!minidump_->ReadBytesAt(offset, &mapping_bytes[0], length)) {
     BPLOG(ERROR) << "MinidumpLinuxMapsList failed to read bytes";
     return false;
   }
@@ -4858,15 +5048,26 @@ bool MinidumpLinuxMapsList::Read(uint32_t expected_size) {
 
   scoped_ptr<MinidumpLinuxMappings> maps(new MinidumpLinuxMappings());
 
-  // Push mapping data into wrapper classes.
+  // Push mapping data into wrapper classes, and index their address ranges.
+  vector<MinidumpAddressRange> ranges(all_regions.size());
   for (size_t i = 0; i < all_regions.size(); i++) {
     scoped_ptr<MinidumpLinuxMaps> ele(new MinidumpLinuxMaps(minidump_));
     ele->region_ = all_regions[i];
     ele->valid_ = true;
+    ranges[i].base = ele->GetBase();
+    ranges[i].size = ele->GetSize();
+    ranges[i].index = static_cast<unsigned int>(i);
     maps->push_back(ele.release());
   }
 
+  size_t unindexed = IndexAddressRangesInListOrder(&ranges);
+  if (unindexed) {
+    BPLOG(INFO) << "MinidumpLinuxMapsList left " << unindexed <<
+                   " empty mappings out of its address index";
+  }
+
   // Set instance variables.
+  ranges_.swap(ranges);
   maps_ = maps.release();
   maps_count_ = static_cast<uint32_t>(maps_->size());
   valid_ = true;
@@ -4899,7 +5100,7 @@ MinidumpCrashpadInfo::MinidumpCrashpadInfo(Minidump* minidump)
 }
 
 
-bool MinidumpCrashpadInfo::Read(uint32_t expected_size) {
+bool MinidumpCrashpadInfo::Read(off_t offset, uint32_t expected_size) {
   valid_ = false;
 
   if (expected_size != sizeof(crashpad_info_)) {
@@ -4908,7 +5109,8 @@ bool MinidumpCrashpadInfo::Read(uint32_t expected_size) {
     return false;
   }
 
-  if (!minidump_->ReadBytes(&crashpad_info_, sizeof(crashpad_info_))) {
+  if (!minidump_->ReadBytesAt(offset, &crashpad_info_,
+                              sizeof(crashpad_info_))) {
     BPLOG(ERROR) << "MinidumpCrashpadInfo cannot read Crashpad info";
     return false;
   }
@@ -4931,13 +5133,11 @@ bool MinidumpCrashpadInfo::Read(uint32_t expected_size) {
   }
 
   if (crashpad_info_.module_list.data_size) {
-    if (!minidump_->SeekSet(crashpad_info_.module_list.rva)) {
-      BPLOG(ERROR) << "MinidumpCrashpadInfo cannot seek to module_list";
-      return false;
-    }
+    off_t module_list_offset = crashpad_info_.module_list.rva;
 
     uint32_t count;
-    if (!minidump_->ReadBytes(&count, sizeof(count))) {
+    if (!ReadBytesAndAdvance(minidump_, &module_list_offset, &count,
+                             sizeof(count))) {
       BPLOG(ERROR) << "MinidumpCrashpadInfo cannot read module_list count";
       return false;
     }
@@ -4951,9 +5151,9 @@ bool MinidumpCrashpadInfo::Read(uint32_t expected_size) {
 
     // Read the entire array in one fell swoop, instead of reading one entry
     // at a time in the loop.
-    if (!minidump_->ReadBytes(
-            &module_crashpad_info_links[0],
-            sizeof(MDRawModuleCrashpadInfoLink) * count)) {
+    if (!ReadBytesAndAdvance(minidump_, &module_list_offset,
+                             &module_crashpad_info_links[0],
+                             sizeof(MDRawModuleCrashpadInfoLink) * count)) {
       BPLOG(ERROR)
           << "MinidumpCrashpadInfo could not read Crashpad module links";
       return false;
@@ -4965,15 +5165,10 @@ bool MinidumpCrashpadInfo::Read(uint32_t expected_size) {
         Swap(&module_crashpad_info_links[index].location);
       }
 
-      if (!minidump_->SeekSet(module_crashpad_info_links[index].location.rva)) {
-        BPLOG(ERROR)
-            << "MinidumpCrashpadInfo cannot seek to Crashpad module info";
-        return false;
-      }
-
       MDRawModuleCrashpadInfo module_crashpad_info;
-      if (!minidump_->ReadBytes(&module_crashpad_info,
-                                sizeof(module_crashpad_info))) {
+      if (!minidump_->ReadBytesAt(
+              module_crashpad_info_links[index].location.rva,
+              &module_crashpad_info, sizeof(module_crashpad_info))) {
         BPLOG(ERROR) << "MinidumpCrashpadInfo cannot read Crashpad module info";
         return false;
       }
@@ -5083,7 +5278,11 @@ Minidump::Minidump(const string& path, bool hexdump, unsigned int hexdump_width)
       directory_(NULL),
       stream_map_(new MinidumpStreamMap()),
       path_(path),
+      fd_(-1),
+      contents_(),
+      in_memory_(false),
       stream_(NULL),
+      position_(0),
       swap_(false),
       is_big_endian_(false),
       valid_(false),
@@ -5096,7 +5295,11 @@ Minidump::Minidump(istream& stream)
       directory_(NULL),
       stream_map_(new MinidumpStreamMap()),
       path_(),
+      fd_(-1),
+      contents_(),
+      in_memory_(false),
       stream_(&stream),
+      position_(0),
       swap_(false),
       is_big_endian_(false),
       valid_(false),
@@ -5105,9 +5308,12 @@ Minidump::Minidump(istream& stream)
 }
 
 Minidump::~Minidump() {
-  if (stream_) {
+  if (fd_ != -1 || in_memory_ || stream_) {
     BPLOG(INFO) << "Minidump closing minidump";
   }
+  if (fd_ != -1) {
+    close(fd_);
+  }
   if (!path_.empty()) {
     delete stream_;
   }
@@ -5117,7 +5323,7 @@ Minidump::~Minidump() {
 
 
 bool Minidump::Open() {
-  if (stream_ != NULL) {
+  if (fd_ != -1 || in_memory_ || (stream_ != NULL && !path_.empty())) {
     BPLOG(INFO) << "Minidump reopening minidump " << path_;
 
     // The file is already open.  Seek to the beginning, which is the position
@@ -5125,31 +5331,111 @@ bool Minidump::Open() {
     return SeekSet(0);
   }
 
-  stream_ = new ifstream(path_.c_str(), std::ios::in | std::ios::binary);
-  if (!stream_ || !stream_->good()) {
-    string error_string;
-    int error_code = ErrnoString(&error_string);
-    BPLOG(ERROR) << "Minidump could not open minidump " << path_ <<
-                    ", error " << error_code << ": " << error_string;
-    return false;
+  if (stream_ == NULL) {
+#ifdef _WIN32
+    stream_ = new ifstream(path_.c_str(), std::ios::in | std::ios::binary);
+    if (!stream_->good()) {
+      string error_string;
+      int error_code = ErrnoString(&error_string);
+      BPLOG(ERROR) << "Minidump could not open minidump " << path_ <<
+                      ", error " << error_code << ": " << error_string;
+      delete stream_;
+      stream_ = NULL;
+      return false;
+    }
+#else  // _WIN32
+    fd_ = open(path_.c_str(), O_RDONLY);
+    if (fd_ == -1) {
+      string error_string;
+      int error_code = ErrnoString(&error_string);
+      BPLOG(ERROR) << "Minidump could not open minidump " << path_ <<
+                      ", error " << error_code << ": " << error_string;
+      return false;
+    }
+#endif  // _WIN32
+  }
+  position_ = 0;
+
+#if defined(HAVE_LIBZ)
+  // Clients may compress the whole minidump (see MinidumpCompression in
+  // the Linux client).  Streams are read at random offsets, so decompress
+  // it into memory up front.
+  unsigned char magic[2];
+  size_t magic_read;
+  if (ReadAt(0, magic, sizeof(magic), &magic_read) &&
+      magic_read == sizeof(magic) && magic[0] == 0x1f && magic[1] == 0x8b) {
+    bool decompressed = Decompress();
+#ifdef _WIN32
+    if (!path_.empty()) {
+      delete stream_;
+      stream_ = NULL;
+    }
+#else  // _WIN32
+    if (fd_ != -1) {
+      close(fd_);
+      fd_ = -1;
+    }
+#endif  // _WIN32
+    if (!decompressed) {
+      BPLOG(ERROR) << "Minidump could not decompress minidump " << path_;
+      contents_.clear();
+      return false;
+    }
+    in_memory_ = true;
+    BPLOG(INFO) << "Minidump opened compressed minidump " << path_;
+    return true;
   }
+#endif  // HAVE_LIBZ
 
   BPLOG(INFO) << "Minidump opened minidump " << path_;
   return true;
 }
 
+#if defined(HAVE_LIBZ)
+bool Minidump::Decompress() {
+  z_stream zstream;
+  memset(&zstream, 0, sizeof(zstream));
+  // Accept only a gzip wrapper, which Open has already sniffed.
+  if (inflateInit2(&zstream, 15 + 16) != Z_OK)
+    return false;
+
+  string contents;
+  vector<unsigned char> input(64 * 1024);
+  vector<char> output(256 * 1024);
+  off_t offset = 0;
+  int result = Z_OK;
+  while (result != Z_STREAM_END) {
+    size_t bytes_read;
+    if (!ReadAt(offset, &input[0], input.size(), &bytes_read) ||
+        bytes_read == 0) {
+      break;
+    }
+    offset += bytes_read;
+    zstream.next_in = &input[0];
+    zstream.avail_in = static_cast<uInt>(bytes_read);
+    do {
+      zstream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+      zstream.avail_out = static_cast<uInt>(output.size());
+      result = inflate(&zstream, Z_NO_FLUSH);
+      contents.append(&output[0], output.size() - zstream.avail_out);
+    } while (result == Z_OK && zstream.avail_out == 0);
+    // Z_BUF_ERROR only means that inflate wants more input.
+    if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+      break;
+  }
+  inflateEnd(&zstream);
+
+  if (result != Z_STREAM_END)
+    return false;
+  contents_.swap(contents);
+  return true;
+}
+#endif  // HAVE_LIBZ
+
 bool Minidump::GetContextCPUFlagsFromSystemInfo(uint32_t* context_cpu_flags) {
   // Initialize output parameters
   *context_cpu_flags = 0;
 
-  // Save the current stream position
-  off_t saved_position = Tell();
-  if (saved_position == -1) {
-    // Failed to save the current stream position.
-    // Returns true because the current position of the stream is preserved.
-    return true;
-  }
-
   const MDRawSystemInfo* system_info =
     GetSystemInfo() ? GetSystemInfo()->system_info() : NULL;
 
@@ -5212,8 +5498,7 @@ bool Minidump::GetContextCPUFlagsFromSystemInfo(uint32_t* context_cpu_flags) {
     }
   }
 
-  // Restore position and return
-  return SeekSet(saved_position);
+  return true;
 }
 
 
@@ -5230,7 +5515,7 @@ bool Minidump::Read() {
     return false;
   }
 
-  if (!ReadBytes(&header_, sizeof(MDRawHeader))) {
+  if (!ReadBytesAt(0, &header_, sizeof(MDRawHeader))) {
     BPLOG(ERROR) << "Minidump cannot read header";
     return false;
   }
@@ -5286,11 +5571,6 @@ bool Minidump::Read() {
     return false;
   }
 
-  if (!SeekSet(header_.stream_directory_rva)) {
-    BPLOG(ERROR) << "Minidump cannot seek to stream directory";
-    return false;
-  }
-
   if (header_.stream_count > max_streams_) {
     BPLOG(ERROR) << "Minidump stream count " << header_.stream_count <<
                     " exceeds maximum " << max_streams_;
@@ -5303,8 +5583,9 @@ bool Minidump::Read() {
 
     // Read the entire array in one fell swoop, instead of reading one entry
     // at a time in the loop.
-    if (!ReadBytes(&(*directory)[0],
-                   sizeof(MDRawDirectory) * header_.stream_count)) {
+    if (!ReadBytesAt(header_.stream_directory_rva,
+                     &(*directory)[0],
+                     sizeof(MDRawDirectory) * header_.stream_count)) {
       BPLOG(ERROR) << "Minidump cannot read stream directory";
       return false;
     }
@@ -5425,20 +5706,9 @@ bool Minidump::IsAndroid() {
 }
 
 bool Minidump::GetPlatform(MDOSPlatform* platform) {
-  // Save the current stream position
-  off_t saved_position = Tell();
-  if (saved_position == -1) {
-    return false;
-  }
   const MDRawSystemInfo* system_info =
     GetSystemInfo() ? GetSystemInfo()->system_info() : NULL;
 
-  // Restore position and return
-  if (!SeekSet(saved_position)) {
-    BPLOG(ERROR) << "Couldn't seek back to saved position";
-    return false;
-  }
-
   if (!system_info) {
     return false;
   }
@@ -5592,34 +5862,89 @@ const MDRawDirectory* Minidump::GetDirectoryEntryAtIndex(unsigned int index)
 }
 
 
-bool Minidump::ReadBytes(void* bytes, size_t count) {
-  // Can't check valid_ because Read needs to call this method before
-  // validity can be determined.
+bool Minidump::ReadAt(off_t offset, void* bytes, size_t count,
+                      size_t* bytes_read) {
+  *bytes_read = 0;
+  if (offset < 0) {
+    return false;
+  }
+
+  if (in_memory_) {
+    if (static_cast<uint64_t>(offset) < contents_.size()) {
+      *bytes_read = std::min(count,
+                             contents_.size() - static_cast<size_t>(offset));
+      memcpy(bytes, contents_.data() + offset, *bytes_read);
+    }
+    return true;
+  }
+
+#ifndef _WIN32
+  if (fd_ != -1) {
+    char* buffer = static_cast<char*>(bytes);
+    while (*bytes_read < count) {
+      ssize_t result = pread(fd_, buffer + *bytes_read, count - *bytes_read,
+                             offset + *bytes_read);
+      if (result == -1) {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+      if (result == 0)
+        break;
+      *bytes_read += result;
+    }
+    return true;
+  }
+#endif  // _WIN32
+
   if (!stream_) {
     return false;
   }
-  stream_->read(static_cast<char*>(bytes), count);
-  std::streamsize bytes_read = stream_->gcount();
-  if (bytes_read == -1) {
+
+  // A stream has a single position of its own, so seeking and reading must
+  // happen together.
+  io_lock_.lock();
+  stream_->clear();
+  stream_->seekg(offset, std::ios_base::beg);
+  bool ok = stream_->good();
+  if (ok) {
+    stream_->read(static_cast<char*>(bytes), count);
+    std::streamsize stream_bytes_read = stream_->gcount();
+    if (stream_bytes_read > 0)
+      *bytes_read = static_cast<size_t>(stream_bytes_read);
+  }
+  io_lock_.unlock();
+  return ok;
+}
+
+
+bool Minidump::ReadBytesAt(off_t offset, void* bytes, size_t count) {
+  // Can't check valid_ because Read needs to call this method before
+  // validity can be determined.
+  size_t bytes_read;
+  if (!ReadAt(offset, bytes, count, &bytes_read)) {
     string error_string;
     int error_code = ErrnoString(&error_string);
-    BPLOG(ERROR) << "ReadBytes: error " << error_code << ": " << error_string;
+    BPLOG(ERROR) << "ReadBytesAt: error " << error_code << ": " <<
+                    error_string << " at offset " << offset;
     return false;
   }
 
-  // Convert to size_t and check for data loss
-  size_t bytes_read_converted = static_cast<size_t>(bytes_read);
-  if (static_cast<std::streamsize>(bytes_read_converted) != bytes_read) {
-    BPLOG(ERROR) << "ReadBytes: conversion data loss detected when converting "
-                 << bytes_read << " to " << bytes_read_converted;
+  if (bytes_read != count) {
+    BPLOG(ERROR) << "ReadBytesAt: read " << bytes_read << "/" << count <<
+                    " at offset " << offset;
     return false;
   }
 
-  if (bytes_read_converted != count) {
-    BPLOG(ERROR) << "ReadBytes: read " << bytes_read_converted << "/" << count;
+  return true;
+}
+
+
+bool Minidump::ReadBytes(void* bytes, size_t count) {
+  if (!ReadBytesAt(position_, bytes, count)) {
     return false;
   }
-
+  position_ += count;
   return true;
 }
 
@@ -5627,33 +5952,20 @@ bool Minidump::ReadBytes(void* bytes, size_t count) {
 bool Minidump::SeekSet(off_t offset) {
   // Can't check valid_ because Read needs to call this method before
   // validity can be determined.
-  if (!stream_) {
-    return false;
-  }
-  stream_->seekg(offset, std::ios_base::beg);
-  if (!stream_->good()) {
-    string error_string;
-    int error_code = ErrnoString(&error_string);
-    BPLOG(ERROR) << "SeekSet: error " << error_code << ": " << error_string;
+  if ((fd_ == -1 && !in_memory_ && !stream_) || offset < 0) {
+    BPLOG(ERROR) << "SeekSet: cannot seek to " << offset;
     return false;
   }
+  position_ = offset;
   return true;
 }
 
 off_t Minidump::Tell() {
-  if (!valid_ || !stream_) {
+  if (!valid_ || (fd_ == -1 && !in_memory_ && !stream_)) {
     return (off_t)-1;
   }
 
-  // Check for conversion data loss
-  std::streamoff std_streamoff = stream_->tellg();
-  off_t rv = static_cast<off_t>(std_streamoff);
-  if (static_cast<std::streamoff>(rv) == std_streamoff) {
-    return rv;
-  } else {
-    BPLOG(ERROR) << "Data loss detected";
-    return (off_t)-1;
-  }
+  return position_;
 }
 
 
@@ -5662,13 +5974,8 @@ string* Minidump::ReadString(off_t offset) {
     BPLOG(ERROR) << "Invalid Minidump for ReadString";
     return NULL;
   }
-  if (!SeekSet(offset)) {
-    BPLOG(ERROR) << "ReadString could not seek to string at offset " << offset;
-    return NULL;
-  }
-
   uint32_t bytes;
-  if (!ReadBytes(&bytes, sizeof(bytes))) {
+  if (!ReadBytesAt(offset, &bytes, sizeof(bytes))) {
     BPLOG(ERROR) << "ReadString could not read string size at offset " <<
                     offset;
     return NULL;
@@ -5693,7 +6000,7 @@ string* Minidump::ReadString(off_t offset) {
   vector<uint16_t> string_utf16(utf16_words);
 
   if (utf16_words) {
-    if (!ReadBytes(&string_utf16[0], bytes)) {
+    if (!ReadBytesAt(offset + sizeof(bytes), &string_utf16[0], bytes)) {
       BPLOG(ERROR) << "ReadString could not read " << bytes <<
                       "-byte string at offset " << offset;
       return NULL;
@@ -5709,14 +6016,8 @@ bool Minidump::ReadUTF8String(off_t offset, string* string_utf8) {
     BPLOG(ERROR) << "Invalid Minidump for ReadString";
     return false;
   }
-  if (!SeekSet(offset)) {
-    BPLOG(ERROR) << "ReadUTF8String could not seek to string at offset "
-                 << offset;
-    return false;
-  }
-
   uint32_t bytes;
-  if (!ReadBytes(&bytes, sizeof(bytes))) {
+  if (!ReadBytesAt(offset, &bytes, sizeof(bytes))) {
     BPLOG(ERROR) << "ReadUTF8String could not read string size at offset " <<
                     offset;
     return false;
@@ -5735,7 +6036,7 @@ bool Minidump::ReadUTF8String(off_t offset, string* string_utf8) {
 
   string_utf8->resize(bytes);
 
-  if (!ReadBytes(&(*string_utf8)[0], bytes)) {
+  if (!ReadBytesAt(offset + sizeof(bytes), &(*string_utf8)[0], bytes)) {
     BPLOG(ERROR) << "ReadUTF8String could not read " << bytes <<
                     "-byte string at offset " << offset;
     return false;
@@ -5750,13 +6051,8 @@ bool Minidump::ReadStringList(
     std::vector<std::string>* string_list) {
   string_list->clear();
 
-  if (!SeekSet(offset)) {
-    BPLOG(ERROR) << "Minidump cannot seek to string_list";
-    return false;
-  }
-
   uint32_t count;
-  if (!ReadBytes(&count, sizeof(count))) {
+  if (!ReadBytesAt(offset, &count, sizeof(count))) {
     BPLOG(ERROR) << "Minidump cannot read string_list count";
     return false;
   }
@@ -5769,7 +6065,7 @@ bool Minidump::ReadStringList(
 
   // Read the entire array in one fell swoop, instead of reading one entry
   // at a time in the loop.
-  if (!ReadBytes(&rvas[0], sizeof(MDRVA) * count)) {
+  if (!ReadBytesAt(offset + sizeof(count), &rvas[0], sizeof(MDRVA) * count)) {
     BPLOG(ERROR) << "Minidump could not read string_list";
     return false;
   }
@@ -5797,13 +6093,8 @@ bool Minidump::ReadSimpleStringDictionary(
     std::map<std::string, std::string>* simple_string_dictionary) {
   simple_string_dictionary->clear();
 
-  if (!SeekSet(offset)) {
-    BPLOG(ERROR) << "Minidump cannot seek to simple_string_dictionary";
-    return false;
-  }
-
   uint32_t count;
-  if (!ReadBytes(&count, sizeof(count))) {
+  if (!ReadBytesAt(offset, &count, sizeof(count))) {
     BPLOG(ERROR)
         << "Minidump cannot read simple_string_dictionary count";
     return false;
@@ -5818,7 +6109,8 @@ bool Minidump::ReadSimpleStringDictionary(
 
   // Read the entire array in one fell swoop, instead of reading one entry
   // at a time in the loop.
-  if (!ReadBytes(
+  if (!ReadBytesAt(
+          offset + sizeof(count),
           &entries[0],
           sizeof(MDRawSimpleStringDictionaryEntry) * count)) {
     BPLOG(ERROR) << "Minidump could not read simple_string_dictionary";
@@ -5863,33 +6155,55 @@ bool Minidump::SeekToStreamType(uint32_t  stream_type,
   assert(stream_length);
   *stream_length = 0;
 
+  off_t stream_offset;
+  if (!LocateStreamType(stream_type, &stream_offset, stream_length)) {
+    return false;
+  }
+
+  if (!SeekSet(stream_offset)) {
+    BPLOG(ERROR) << "SeekToStreamType could not seek to stream type " <<
+                    stream_type;
+    *stream_length = 0;
+    return false;
+  }
+
+  return true;
+}
+
+
+bool Minidump::LocateStreamType(uint32_t  stream_type,
+                                off_t*    stream_offset,
+                                uint32_t* stream_length) {
+  BPLOG_IF(ERROR, !stream_offset || !stream_length) <<
+      "Minidump::LocateStreamType requires |stream_offset| and "
+      "|stream_length|";
+  assert(stream_offset);
+  assert(stream_length);
+  *stream_offset = 0;
+  *stream_length = 0;
+
   if (!valid_) {
-    BPLOG(ERROR) << "Invalid Mindump for SeekToStreamType";
+    BPLOG(ERROR) << "Invalid Mindump for LocateStreamType";
     return false;
   }
 
   MinidumpStreamMap::const_iterator iterator = stream_map_->find(stream_type);
   if (iterator == stream_map_->end()) {
     // This stream type didn't exist in the directory.
-    BPLOG(INFO) << "SeekToStreamType: type " << stream_type << " not present";
+    BPLOG(INFO) << "LocateStreamType: type " << stream_type << " not present";
     return false;
   }
 
   const MinidumpStreamInfo& info = iterator->second;
   if (info.stream_index >= header_.stream_count) {
-    BPLOG(ERROR) << "SeekToStreamType: type " << stream_type <<
+    BPLOG(ERROR) << "LocateStreamType: type " << stream_type <<
                     " out of range: " <<
                     info.stream_index << "/" << header_.stream_count;
     return false;
   }
 
   MDRawDirectory* directory_entry = &(*directory_)[info.stream_index];
-  if (!SeekSet(directory_entry->location.rva)) {
-    BPLOG(ERROR) << "SeekToStreamType could not seek to stream type " <<
-                    stream_type;
-    return false;
-  }
-
+  *stream_offset = directory_entry->location.rva;
   *stream_length = directory_entry->location.data_size;
 
   return true;
@@ -5920,31 +6234,43 @@ T* Minidump::GetStream(T** stream) {
     return NULL;
   }
 
-  // Get a pointer so that the stored stream field can be altered.
+  // Get a pointer so that the stored stream field can be altered.  The map
+  // itself is not modified after Read, so the pointer is stable.
   MinidumpStreamInfo* info = &iterator->second;
 
-  if (info->stream) {
+  cache_lock_.lock();
+  MinidumpStream* cached_stream = info->stream;
+  cache_lock_.unlock();
+  if (cached_stream) {
     // This cast is safe because info.stream is only populated by this
     // method, and there is a direct correlation between T and stream_type.
-    *stream = static_cast<T*>(info->stream);
+    *stream = static_cast<T*>(cached_stream);
     return *stream;
   }
 
+  off_t stream_offset;
   uint32_t stream_length;
-  if (!SeekToStreamType(stream_type, &stream_length)) {
-    BPLOG(ERROR) << "GetStream could not seek to stream type " << stream_type;
+  if (!LocateStreamType(stream_type, &stream_offset, &stream_length)) {
+    BPLOG(ERROR) << "GetStream could not locate stream type " << stream_type;
     return NULL;
   }
 
+  // The stream is read without holding cache_lock_: reading some streams
+  // requires others (contexts consult the system info stream).  If another
+  // thread reads the same stream meanwhile, the first one cached wins.
   scoped_ptr<T> new_stream(new T(this));
 
-  if (!new_stream->Read(stream_length)) {
+  if (!new_stream->Read(stream_offset, stream_length)) {
     BPLOG(ERROR) << "GetStream could not read stream type " << stream_type;
     return NULL;
   }
 
-  *stream = new_stream.release();
-  info->stream = *stream;
+  cache_lock_.lock();
+  if (!info->stream) {
+    info->stream = new_stream.release();
+  }
+  *stream = static_cast<T*>(info->stream);
+  cache_lock_.unlock();
   return *stream;
 }
 
@@ -40,6 +40,7 @@
 #include "google_breakpad/processor/call_stack.h"
 #include "google_breakpad/processor/minidump.h"
 #include "google_breakpad/processor/process_state.h"
+#include "google_breakpad/processor/processing_stats.h"
 #include "google_breakpad/processor/exploitability.h"
 #include "google_breakpad/processor/stack_frame_symbolizer.h"
 #include "processor/logging.h"
@@ -53,7 +54,8 @@ MinidumpProcessor::MinidumpProcessor(SymbolSupplier* supplier,
     : frame_symbolizer_(new StackFrameSymbolizer(supplier, resolver)),
       own_frame_symbolizer_(true),
       enable_exploitability_(false),
-      enable_objdump_(false) {
+      enable_objdump_(false),
+      stats_(NULL) {
 }
 
 MinidumpProcessor::MinidumpProcessor(SymbolSupplier* supplier,
@@ -62,7 +64,8 @@ MinidumpProcessor::MinidumpProcessor(SymbolSupplier* supplier,
     : frame_symbolizer_(new StackFrameSymbolizer(supplier, resolver)),
       own_frame_symbolizer_(true),
       enable_exploitability_(enable_exploitability),
-      enable_objdump_(false) {
+      enable_objdump_(false),
+      stats_(NULL) {
 }
 
 MinidumpProcessor::MinidumpProcessor(StackFrameSymbolizer* frame_symbolizer,
@@ -70,7 +73,8 @@ MinidumpProcessor::MinidumpProcessor(StackFrameSymbolizer* frame_symbolizer,
     : frame_symbolizer_(frame_symbolizer),
       own_frame_symbolizer_(false),
       enable_exploitability_(enable_exploitability),
-      enable_objdump_(false) {
+      enable_objdump_(false),
+      stats_(NULL) {
   assert(frame_symbolizer_);
 }
 
@@ -78,6 +82,29 @@ MinidumpProcessor::~MinidumpProcessor() {
   if (own_frame_symbolizer_) delete frame_symbolizer_;
 }
 
+namespace {
+
+// Lends a ProcessingStats to a StackFrameSymbolizer for the scope of one
+// Process call, so that the symbolizer never keeps a pointer to stats that
+// the caller may free or replace afterwards.
+class ScopedSymbolizerStats {
+ public:
+  ScopedSymbolizerStats(StackFrameSymbolizer* frame_symbolizer,
+                        ProcessingStats* stats)
+      : frame_symbolizer_(frame_symbolizer) {
+    frame_symbolizer_->set_stats(stats);
+  }
+  ~ScopedSymbolizerStats() { frame_symbolizer_->set_stats(NULL); }
+
+ private:
+  StackFrameSymbolizer* frame_symbolizer_;
+
+  ScopedSymbolizerStats(const ScopedSymbolizerStats&);
+  void operator=(const ScopedSymbolizerStats&);
+};
+
+}  // namespace
+
 ProcessResult MinidumpProcessor::Process(
     Minidump* dump, ProcessState* process_state) {
   assert(dump);
@@ -85,6 +112,13 @@ ProcessResult MinidumpProcessor::Process(
 
   process_state->Clear();
 
+  uint64_t start_us = 0;
+  if (stats_) {
+    stats_->Clear();
+    start_us = ProcessingStats::NowMicroseconds();
+  }
+  ScopedSymbolizerStats symbolizer_stats(frame_symbolizer_, stats_);
+
   const MDRawHeader* header = dump->header();
   if (!header) {
     BPLOG(ERROR) << "Minidump " << dump->path() << " has no header";
@@ -199,6 +233,12 @@ ProcessResult MinidumpProcessor::Process(
   // Reset frame_symbolizer_ at the beginning of stackwalk for each minidump.
   frame_symbolizer_->Reset();
 
+  if (stats_) {
+    uint64_t walk_start_us = ProcessingStats::NowMicroseconds();
+    stats_->read_dump_us += walk_start_us - start_us;
+    start_us = walk_start_us;
+  }
+
   for (unsigned int thread_index = 0;
        thread_index < thread_count;
        ++thread_index) {
@@ -293,8 +333,10 @@ ProcessResult MinidumpProcessor::Process(
                                        process_state->unloaded_modules_,
                                        frame_symbolizer_));
 
+    uint64_t thread_start_us = stats_ ? ProcessingStats::NowMicroseconds() : 0;
     scoped_ptr<CallStack> stack(new CallStack());
     if (stackwalker.get()) {
+      stackwalker->set_stats(stats_);
       if (!stackwalker->Walk(stack.get(),
                              &process_state->modules_without_symbols_,
                              &process_state->modules_with_corrupt_symbols_)) {
@@ -308,11 +350,18 @@ ProcessResult MinidumpProcessor::Process(
       // one bad thread.
       BPLOG(ERROR) << "No stackwalker for " << thread_string;
     }
+    if (stats_) {
+      stats_->thread_walk_us.push_back(
+          ProcessingStats::NowMicroseconds() - thread_start_us);
+    }
     stack->set_tid(thread_id);
     process_state->threads_.push_back(stack.release());
     process_state->thread_memory_regions_.push_back(thread_memory);
   }
 
+  if (stats_)
+    stats_->walk_us += ProcessingStats::NowMicroseconds() - start_us;
+
   if (interrupted) {
     BPLOG(INFO) << "Processing interrupted for " << dump->path();
     return PROCESS_SYMBOL_SUPPLIER_INTERRUPTED;
@@ -353,13 +402,18 @@ ProcessResult MinidumpProcessor::Process(
     const string& minidump_file, ProcessState* process_state) {
   BPLOG(INFO) << "Processing minidump in file " << minidump_file;
 
+  uint64_t start_us = stats_ ? ProcessingStats::NowMicroseconds() : 0;
   Minidump dump(minidump_file);
   if (!dump.Read()) {
      BPLOG(ERROR) << "Minidump " << dump.path() << " could not be read";
      return PROCESS_ERROR_MINIDUMP_NOT_FOUND;
   }
+  uint64_t read_us = stats_ ? ProcessingStats::NowMicroseconds() - start_us : 0;
 
-  return Process(&dump, process_state);
+  ProcessResult result = Process(&dump, process_state);
+  if (stats_)
+    stats_->read_dump_us += read_us;
+  return result;
 }
 
 // Returns the MDRawSystemInfo from a minidump, or NULL if system info is
@@ -48,6 +48,7 @@
 #include "google_breakpad/processor/minidump.h"
 #include "google_breakpad/processor/minidump_processor.h"
 #include "google_breakpad/processor/process_state.h"
+#include "google_breakpad/processor/processing_stats.h"
 #include "google_breakpad/processor/stack_frame.h"
 #include "google_breakpad/processor/symbol_supplier.h"
 #include "processor/logging.h"
@@ -176,7 +177,9 @@ using google_breakpad::MockMinidumpThreadList;
 using google_breakpad::MockMinidumpUnloadedModule;
 using google_breakpad::MockMinidumpUnloadedModuleList;
 using google_breakpad::ProcessState;
+using google_breakpad::ProcessingStats;
 using google_breakpad::scoped_ptr;
+using google_breakpad::StackFrame;
 using google_breakpad::SymbolSupplier;
 using google_breakpad::SystemInfo;
 using ::testing::_;
@@ -583,6 +586,38 @@ TEST_F(MinidumpProcessorTest, TestBasicProcessing) {
             google_breakpad::PROCESS_SYMBOL_SUPPLIER_INTERRUPTED);
 }
 
+TEST_F(MinidumpProcessorTest, TestProcessingStats) {
+  TestSymbolSupplier supplier;
+  BasicSourceLineResolver resolver;
+  MinidumpProcessor processor(&supplier, &resolver);
+  ProcessingStats stats;
+  processor.set_stats(&stats);
+
+  string minidump_file = GetTestDataPath() + "minidump2.dmp";
+
+  // Stats describe only the latest Process call.
+  for (int i = 0; i < 2; ++i) {
+    ProcessState state;
+    ASSERT_EQ(processor.Process(minidump_file, &state),
+              google_breakpad::PROCESS_OK);
+    ASSERT_EQ(state.threads()->size(), size_t(1));
+    ASSERT_EQ(stats.thread_walk_us.size(), size_t(1));
+    EXPECT_LE(stats.thread_walk_us[0], stats.walk_us);
+
+    uint64_t frames = 0;
+    for (int trust = 0; trust < ProcessingStats::kFrameTrustCount; ++trust)
+      frames += stats.frames_by_trust[trust];
+    EXPECT_EQ(state.threads()->at(0)->frames()->size(), frames);
+    EXPECT_EQ(1U, stats.frames_by_trust[StackFrame::FRAME_TRUST_CONTEXT]);
+  }
+
+  // test_app.pdb's symbols were loaded by the first Process call, and the
+  // second call's frames in test_app.exe found them already loaded.
+  EXPECT_EQ(0U, stats.symbol_files_loaded);
+  EXPECT_EQ(0U, stats.symbol_bytes_parsed);
+  EXPECT_GE(stats.symbol_cache_hits, 3U);
+}
+
 TEST_F(MinidumpProcessorTest, TestThreadMissingMemory) {
   MockMinidump dump;
   EXPECT_CALL(dump, path()).WillRepeatedly(Return("mock minidump"));
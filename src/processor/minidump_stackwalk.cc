@@ -33,6 +33,7 @@
 // Author: Mark Mentovai
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -44,10 +45,14 @@
 #include "common/scoped_ptr.h"
 #include "common/using_std_string.h"
 #include "google_breakpad/processor/basic_source_line_resolver.h"
+#include "google_breakpad/processor/crash_signature.h"
 #include "google_breakpad/processor/minidump.h"
 #include "google_breakpad/processor/minidump_processor.h"
 #include "google_breakpad/processor/process_state.h"
+#include "google_breakpad/processor/processing_stats.h"
+#include "processor/json_writer.h"
 #include "processor/logging.h"
+#include "processor/process_state_proto_writer.h"
 #include "processor/simple_symbol_supplier.h"
 #include "processor/stackwalk_common.h"
 
@@ -56,18 +61,26 @@ namespace {
 
 struct Options {
   bool machine_readable;
+  bool json;
+  bool output_proto;
   bool output_stack_contents;
+  bool print_stats;
+  int signature_frames;
 
   string minidump_file;
   std::vector<string> symbol_paths;
 };
 
 using google_breakpad::BasicSourceLineResolver;
+using google_breakpad::CrashSignature;
+using google_breakpad::CrashSignatureGenerator;
+using google_breakpad::JsonWriter;
 using google_breakpad::Minidump;
 using google_breakpad::MinidumpMemoryList;
 using google_breakpad::MinidumpThreadList;
 using google_breakpad::MinidumpProcessor;
 using google_breakpad::ProcessState;
+using google_breakpad::ProcessingStats;
 using google_breakpad::SimpleSymbolSupplier;
 using google_breakpad::scoped_ptr;
 
@@ -91,29 +104,100 @@ bool PrintMinidumpProcess(const Options& options) {
 
   BasicSourceLineResolver resolver;
   MinidumpProcessor minidump_processor(symbol_supplier.get(), &resolver);
+  ProcessingStats stats;
+  if (options.print_stats)
+    minidump_processor.set_stats(&stats);
 
   // Increase the maximum number of threads and regions.
   MinidumpThreadList::set_max_threads(std::numeric_limits<uint32_t>::max());
   MinidumpMemoryList::set_max_regions(std::numeric_limits<uint32_t>::max());
   // Process the minidump.
+  uint64_t read_start_us =
+      options.print_stats ? ProcessingStats::NowMicroseconds() : 0;
   Minidump dump(options.minidump_file);
   if (!dump.Read()) {
      BPLOG(ERROR) << "Minidump " << dump.path() << " could not be read";
      return false;
   }
+  uint64_t read_us = options.print_stats ?
+      ProcessingStats::NowMicroseconds() - read_start_us : 0;
   ProcessState process_state;
   if (minidump_processor.Process(&dump, &process_state) !=
       google_breakpad::PROCESS_OK) {
     BPLOG(ERROR) << "MinidumpProcessor::Process failed";
     return false;
   }
+  stats.read_dump_us += read_us;
 
-  if (options.machine_readable) {
+  if (options.output_proto) {
+    if (!WriteDelimitedProcessStateProto(process_state, stdout)) {
+      BPLOG(ERROR) << "Could not write the ProcessStateProto";
+      return false;
+    }
+  } else if (options.json) {
+    PrintProcessStateJSON(process_state);
+  } else if (options.machine_readable) {
     PrintProcessStateMachineReadable(process_state);
   } else {
     PrintProcessState(process_state, options.output_stack_contents, &resolver);
   }
 
+  if (options.print_stats)
+    PrintProcessingStats(stats, process_state);
+
+  return true;
+}
+
+// Computes the crash signature of |options.minidump_file| with
+// CrashSignatureGenerator, using the symbols under |options.symbol_paths|
+// only to unwind, and prints it.  Returns false if the signature could not
+// be computed.
+bool PrintMinidumpSignature(const Options& options) {
+  scoped_ptr<SimpleSymbolSupplier> symbol_supplier;
+  if (!options.symbol_paths.empty()) {
+    symbol_supplier.reset(new SimpleSymbolSupplier(options.symbol_paths));
+  }
+
+  CrashSignatureGenerator generator(symbol_supplier.get());
+  generator.set_frame_count(options.signature_frames);
+  CrashSignature signature;
+  if (generator.Generate(options.minidump_file, &signature) !=
+      google_breakpad::PROCESS_OK) {
+    BPLOG(ERROR) << "CrashSignatureGenerator::Generate failed";
+    return false;
+  }
+
+  string hash = CrashSignatureGenerator::HashString(signature.hash);
+  if (options.json) {
+    JsonWriter json(stdout);
+    json.BeginObject();
+    json.Key("signature");
+    json.String(hash);
+    json.Key("thread_id");
+    json.Int(signature.thread_id);
+    json.Key("frames");
+    json.BeginArray();
+    for (size_t i = 0; i < signature.frames.size(); ++i) {
+      json.BeginObject();
+      json.Key("module");
+      if (signature.frames[i].module.empty())
+        json.Null();
+      else
+        json.String(signature.frames[i].module);
+      json.Key("offset");
+      json.Hex(signature.frames[i].offset);
+      json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+    return json.Flush();
+  }
+
+  printf("%s\n", hash.c_str());
+  for (size_t i = 0; i < signature.frames.size(); ++i) {
+    printf("%d|%s|0x%" PRIx64 "\n", static_cast<int>(i),
+           signature.frames[i].module.c_str(), signature.frames[i].offset);
+  }
   return true;
 }
 
@@ -127,8 +211,17 @@ static void Usage(int argc, const char *argv[], bool error) {
           "\n"
           "Options:\n"
           "\n"
+          "  -b <count> Output only a signature of the crash: a hash of the\n"
+          "             module and offset of the crashing thread's innermost\n"
+          "             <count> frames, and those frames\n"
           "  -m         Output in machine-readable format\n"
-          "  -s         Output stack contents\n",
+          "  -J         Output in JSON format\n"
+          "  -p         Output a ProcessStateProto (see\n"
+          "             src/processor/proto/process_state.proto) in binary\n"
+          "             form, preceded by its length as a varint\n"
+          "  -s         Output stack contents\n"
+          "  -S         Print where processing time went, and how frames\n"
+          "             were found, to stderr\n",
           google_breakpad::BaseName(argv[0]).c_str());
 }
 
@@ -136,21 +229,42 @@ static void SetupOptions(int argc, const char *argv[], Options* options) {
   int ch;
 
   options->machine_readable = false;
+  options->json = false;
+  options->output_proto = false;
   options->output_stack_contents = false;
+  options->print_stats = false;
+  options->signature_frames = 0;
 
-  while ((ch = getopt(argc, (char * const*)argv, "hms")) != -1) {
+  while ((ch = getopt(argc, (char * const*)argv, "b:hJmpSs")) != -1) {
     switch (ch) {
       case 'h':
         Usage(argc, argv, false);
         exit(0);
         break;
 
+      case 'b':
+        options->signature_frames = atoi(optarg);
+        if (options->signature_frames <= 0) {
+          fprintf(stderr, "%s: Invalid frame count: %s\n", argv[0], optarg);
+          Usage(argc, argv, true);
+          exit(1);
+        }
+        break;
       case 'm':
         options->machine_readable = true;
         break;
+      case 'J':
+        options->json = true;
+        break;
+      case 'p':
+        options->output_proto = true;
+        break;
       case 's':
         options->output_stack_contents = true;
         break;
+      case 'S':
+        options->print_stats = true;
+        break;
 
       case '?':
         Usage(argc, argv, true);
@@ -175,5 +289,7 @@ int main(int argc, const char* argv[]) {
   Options options;
   SetupOptions(argc, argv, &options);
 
+  if (options.signature_frames)
+    return PrintMinidumpSignature(options) ? 0 : 1;
   return PrintMinidumpProcess(options) ? 0 : 1;
 }
@@ -30,14 +30,24 @@
 // Unit test for Minidump.  Uses a pre-generated minidump and
 // verifies that certain streams are correct.
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
 #include <iostream>
 #include <fstream>
+#include <pthread.h>
 #include <sstream>
 #include <stdlib.h>
 #include <string>
 #include <vector>
 
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
 #include "breakpad_googletest_includes.h"
+#include "common/tests/auto_tempdir.h"
 #include "common/using_std_string.h"
 #include "google_breakpad/common/minidump_format.h"
 #include "google_breakpad/processor/minidump.h"
@@ -46,9 +56,12 @@
 
 namespace {
 
+using google_breakpad::AutoTempDir;
 using google_breakpad::Minidump;
 using google_breakpad::MinidumpContext;
 using google_breakpad::MinidumpException;
+using google_breakpad::MinidumpLinuxMaps;
+using google_breakpad::MinidumpLinuxMapsList;
 using google_breakpad::MinidumpMemoryInfo;
 using google_breakpad::MinidumpMemoryInfoList;
 using google_breakpad::MinidumpMemoryList;
@@ -105,6 +118,123 @@ TEST_F(MinidumpTest, TestMinidumpFromFile) {
   ASSERT_EQ("5A9832E5287241C1838ED98914E9B7FF1", md_module->debug_identifier());
 }
 
+#if defined(HAVE_LIBZ)
+TEST_F(MinidumpTest, TestMinidumpFromGzipFile) {
+  ifstream file_stream(minidump_file_.c_str(), std::ios::in | std::ios::binary);
+  ASSERT_TRUE(file_stream.good());
+  string contents((std::istreambuf_iterator<char>(file_stream)),
+                  std::istreambuf_iterator<char>());
+
+  AutoTempDir temp_dir;
+  const string compressed_file = temp_dir.path() + "/minidump2.dmp.gz";
+  gzFile file = gzopen(compressed_file.c_str(), "wb");
+  ASSERT_TRUE(file != NULL);
+  ASSERT_EQ(static_cast<int>(contents.size()),
+            gzwrite(file, contents.data(), contents.size()));
+  ASSERT_EQ(Z_OK, gzclose(file));
+
+  Minidump minidump(compressed_file);
+  ASSERT_TRUE(minidump.Read());
+  const MDRawHeader* header = minidump.header();
+  ASSERT_NE(header, (MDRawHeader*)NULL);
+  ASSERT_EQ(header->signature, uint32_t(MD_HEADER_SIGNATURE));
+
+  MinidumpModuleList* md_module_list = minidump.GetModuleList();
+  ASSERT_TRUE(md_module_list != NULL);
+  const MinidumpModule* md_module = md_module_list->GetModuleAtIndex(0);
+  ASSERT_TRUE(md_module != NULL);
+  ASSERT_EQ("c:\\test_app.exe", md_module->code_file());
+  ASSERT_EQ("5A9832E5287241C1838ED98914E9B7FF1", md_module->debug_identifier());
+
+  // The same compressed bytes are accepted from a stream.
+  ifstream compressed_stream(compressed_file.c_str(),
+                             std::ios::in | std::ios::binary);
+  string compressed((std::istreambuf_iterator<char>(compressed_stream)),
+                    std::istreambuf_iterator<char>());
+  istringstream stream(compressed);
+  Minidump stream_minidump(stream);
+  ASSERT_TRUE(stream_minidump.Read());
+  md_module_list = stream_minidump.GetModuleList();
+  ASSERT_TRUE(md_module_list != NULL);
+  md_module = md_module_list->GetModuleAtIndex(0);
+  ASSERT_TRUE(md_module != NULL);
+  ASSERT_EQ("c:\\test_app.exe", md_module->code_file());
+
+  // A truncated one is not.
+  istringstream truncated_stream(compressed.substr(0, compressed.size() / 2));
+  Minidump truncated_minidump(truncated_stream);
+  ASSERT_FALSE(truncated_minidump.Read());
+}
+#endif  // HAVE_LIBZ
+
+// What one thread saw when reading a minidump shared with other threads.
+struct ConcurrentReadResult {
+  Minidump* minidump;
+  MinidumpThreadList* thread_list;
+  vector<const uint8_t*> stack_memory;
+  vector<MinidumpContext*> contexts;
+  vector<const uint8_t*> cv_records;
+};
+
+void* ReadMinidumpConcurrently(void* argument) {
+  ConcurrentReadResult* result = static_cast<ConcurrentReadResult*>(argument);
+  result->thread_list = result->minidump->GetThreadList();
+  if (!result->thread_list)
+    return NULL;
+  for (unsigned int i = 0; i < result->thread_list->thread_count(); ++i) {
+    MinidumpThread* thread = result->thread_list->GetThreadAtIndex(i);
+    MinidumpMemoryRegion* memory = thread->GetMemory();
+    result->stack_memory.push_back(memory ? memory->GetMemory() : NULL);
+    result->contexts.push_back(thread->GetContext());
+  }
+  MinidumpModuleList* module_list = result->minidump->GetModuleList();
+  for (unsigned int i = 0; module_list && i < module_list->module_count();
+       ++i) {
+    MinidumpModule* module = const_cast<MinidumpModule*>(
+        module_list->GetModuleAtIndex(i));
+    result->cv_records.push_back(module->GetCVRecord(NULL));
+  }
+  return NULL;
+}
+
+TEST_F(MinidumpTest, TestConcurrentStreamAccess) {
+  Minidump minidump(minidump_file_);
+  ASSERT_TRUE(minidump.Read());
+
+  // Positional reads leave the current position alone.
+  ASSERT_TRUE(minidump.SeekSet(4));
+  uint32_t signature;
+  ASSERT_TRUE(minidump.ReadBytesAt(0, &signature, sizeof(signature)));
+  EXPECT_EQ(uint32_t(MD_HEADER_SIGNATURE), signature);
+  EXPECT_EQ(4, minidump.Tell());
+
+  const int kThreadCount = 8;
+  pthread_t threads[kThreadCount];
+  ConcurrentReadResult results[kThreadCount];
+  for (int i = 0; i < kThreadCount; ++i) {
+    results[i].minidump = &minidump;
+    ASSERT_EQ(0, pthread_create(&threads[i], NULL, ReadMinidumpConcurrently,
+                                &results[i]));
+  }
+  for (int i = 0; i < kThreadCount; ++i)
+    ASSERT_EQ(0, pthread_join(threads[i], NULL));
+
+  // Every thread must have been handed the same cached objects.
+  ASSERT_TRUE(results[0].thread_list != NULL);
+  ASSERT_FALSE(results[0].stack_memory.empty());
+  ASSERT_FALSE(results[0].cv_records.empty());
+  for (int i = 0; i < kThreadCount; ++i) {
+    EXPECT_EQ(minidump.GetThreadList(), results[i].thread_list);
+    EXPECT_EQ(results[0].stack_memory, results[i].stack_memory);
+    EXPECT_EQ(results[0].contexts, results[i].contexts);
+    EXPECT_EQ(results[0].cv_records, results[i].cv_records);
+  }
+  for (size_t i = 0; i < results[0].stack_memory.size(); ++i) {
+    EXPECT_TRUE(results[0].stack_memory[i] != NULL);
+    EXPECT_TRUE(results[0].contexts[i] != NULL);
+  }
+}
+
 TEST_F(MinidumpTest, TestMinidumpFromStream) {
   // read minidump contents into memory, construct a stringstream around them
   ifstream file_stream(minidump_file_.c_str(), std::ios::in);
@@ -1045,6 +1175,177 @@ TEST(Dump, OneMemoryInfo) {
   ASSERT_EQ(kRegionSize, info2->GetSize());
 }
 
+TEST(Dump, MemoryInfoBatchLookup) {
+  Dump dump(0, kLittleEndian);
+  Stream stream(dump, MD_MEMORY_INFO_LIST_STREAM);
+
+  // Two regions, stored out of address order.
+  const uint64_t kBaseAddresses[] = { 0x5000, 0x1000 };
+  const uint64_t kRegionSize = 0x2000;
+  stream.D32(sizeof(MDRawMemoryInfoList))  // size_of_header
+        .D32(sizeof(MDRawMemoryInfo))      // size_of_entry
+        .D64(2);                           // number_of_entries
+  for (int i = 0; i < 2; ++i) {
+    stream.D64(kBaseAddresses[i])            // base_address
+          .D64(kBaseAddresses[i])            // allocation_base
+          .D32(MD_MEMORY_PROTECT_READWRITE)  // allocation_protection
+          .D32(0)                            // __alignment1
+          .D64(kRegionSize)                  // region_size
+          .D32(MD_MEMORY_STATE_COMMIT)       // state
+          .D32(MD_MEMORY_PROTECT_READWRITE)  // protection
+          .D32(MD_MEMORY_TYPE_PRIVATE)       // type
+          .D32(0);                           // __alignment2
+  }
+
+  dump.Add(&stream);
+  dump.Finish();
+
+  string contents;
+  ASSERT_TRUE(dump.GetContents(&contents));
+  istringstream minidump_stream(contents);
+  Minidump minidump(minidump_stream);
+  ASSERT_TRUE(minidump.Read());
+
+  MinidumpMemoryInfoList* info_list = minidump.GetMemoryInfoList();
+  ASSERT_TRUE(info_list != NULL);
+  ASSERT_EQ(2U, info_list->info_count());
+  const MinidumpMemoryInfo* high_info = info_list->GetMemoryInfoAtIndex(0);
+  const MinidumpMemoryInfo* low_info = info_list->GetMemoryInfoAtIndex(1);
+
+  EXPECT_EQ(low_info, info_list->GetMemoryInfoForAddress(0x1000));
+  EXPECT_EQ(low_info, info_list->GetMemoryInfoForAddress(0x2fff));
+  EXPECT_EQ(NULL, info_list->GetMemoryInfoForAddress(0x3000));
+  EXPECT_EQ(high_info, info_list->GetMemoryInfoForAddress(0x6000));
+
+  uint64_t sorted[] = { 0x0, 0x1000, 0x2fff, 0x3000, 0x5000, 0x6fff, 0x7000 };
+  vector<uint64_t> addresses(sorted, sorted + sizeof(sorted) / sizeof(*sorted));
+  vector<const MinidumpMemoryInfo*> infos;
+  info_list->GetMemoryInfoForAddresses(addresses, &infos);
+  ASSERT_EQ(addresses.size(), infos.size());
+  EXPECT_EQ(NULL, infos[0]);
+  EXPECT_EQ(low_info, infos[1]);
+  EXPECT_EQ(low_info, infos[2]);
+  EXPECT_EQ(NULL, infos[3]);
+  EXPECT_EQ(high_info, infos[4]);
+  EXPECT_EQ(high_info, infos[5]);
+  EXPECT_EQ(NULL, infos[6]);
+
+  // Out-of-order addresses are still answered.
+  uint64_t unsorted[] = { 0x6000, 0x1000, 0x8000, 0x5000 };
+  addresses.assign(unsorted, unsorted + sizeof(unsorted) / sizeof(*unsorted));
+  info_list->GetMemoryInfoForAddresses(addresses, &infos);
+  ASSERT_EQ(addresses.size(), infos.size());
+  EXPECT_EQ(high_info, infos[0]);
+  EXPECT_EQ(low_info, infos[1]);
+  EXPECT_EQ(NULL, infos[2]);
+  EXPECT_EQ(high_info, infos[3]);
+}
+
+TEST(Dump, LinuxMapsLookup) {
+  Dump dump(0, kLittleEndian);
+  Stream stream(dump, MD_LINUX_MAPS);
+  // Mappings out of address order, as well as an empty one.
+  stream.Append(
+      "7f0000002000-7f0000003000 rw-p 00000000 00:00 0 \n"
+      "00400000-00452000 r-xp 00000000 08:01 123 /bin/app\n"
+      "7f0000000000-7f0000001000 r-xp 00000000 08:01 456 /lib/libc.so\n"
+      "7f0000004000-7f0000004000 ---p 00000000 00:00 0 \n");
+  dump.Add(&stream);
+  dump.Finish();
+
+  string contents;
+  ASSERT_TRUE(dump.GetContents(&contents));
+  istringstream minidump_stream(contents);
+  Minidump minidump(minidump_stream);
+  ASSERT_TRUE(minidump.Read());
+
+  MinidumpLinuxMapsList* maps_list = minidump.GetLinuxMapsList();
+  ASSERT_TRUE(maps_list != NULL);
+  ASSERT_EQ(4U, maps_list->get_maps_count());
+  const MinidumpLinuxMaps* anonymous = maps_list->GetLinuxMapsAtIndex(0);
+  const MinidumpLinuxMaps* app = maps_list->GetLinuxMapsAtIndex(1);
+  const MinidumpLinuxMaps* libc = maps_list->GetLinuxMapsAtIndex(2);
+
+  EXPECT_EQ(app, maps_list->GetLinuxMapsForAddress(0x400000));
+  EXPECT_EQ(app, maps_list->GetLinuxMapsForAddress(0x451fff));
+  EXPECT_EQ(NULL, maps_list->GetLinuxMapsForAddress(0x452000));
+  EXPECT_EQ(libc, maps_list->GetLinuxMapsForAddress(0x7f0000000800ULL));
+  EXPECT_EQ(NULL, maps_list->GetLinuxMapsForAddress(0x7f0000001000ULL));
+  EXPECT_EQ(anonymous, maps_list->GetLinuxMapsForAddress(0x7f0000002000ULL));
+  EXPECT_EQ(NULL, maps_list->GetLinuxMapsForAddress(0x7f0000004000ULL));
+
+  uint64_t sorted[] = { 0x3fffff, 0x400000, 0x410000, 0x7f0000000000ULL,
+                        0x7f0000001000ULL, 0x7f0000002fffULL,
+                        0x7f0000004000ULL };
+  vector<uint64_t> addresses(sorted, sorted + sizeof(sorted) / sizeof(*sorted));
+  vector<const MinidumpLinuxMaps*> maps;
+  maps_list->GetLinuxMapsForAddresses(addresses, &maps);
+  ASSERT_EQ(addresses.size(), maps.size());
+  EXPECT_EQ(NULL, maps[0]);
+  EXPECT_EQ(app, maps[1]);
+  EXPECT_EQ(app, maps[2]);
+  EXPECT_EQ(libc, maps[3]);
+  EXPECT_EQ(NULL, maps[4]);
+  EXPECT_EQ(anonymous, maps[5]);
+  EXPECT_EQ(NULL, maps[6]);
+
+  // Out-of-order addresses are still answered.
+  uint64_t unsorted[] = { 0x7f0000002000ULL, 0x400000, 0x7f0000000000ULL };
+  addresses.assign(unsorted, unsorted + sizeof(unsorted) / sizeof(*unsorted));
+  maps_list->GetLinuxMapsForAddresses(addresses, &maps);
+  ASSERT_EQ(addresses.size(), maps.size());
+  EXPECT_EQ(anonymous, maps[0]);
+  EXPECT_EQ(app, maps[1]);
+  EXPECT_EQ(libc, maps[2]);
+}
+
+TEST(Dump, LinuxMapsOverlapping) {
+  Dump dump(0, kLittleEndian);
+  Stream stream(dump, MD_LINUX_MAPS);
+  // A mapping inside a later, larger one, and another overlapping the end
+  // of the larger one.  Where mappings overlap, the earlier one wins.
+  stream.Append(
+      "7f0000001000-7f0000002000 r-xp 00000000 08:01 456 /lib/libc.so\n"
+      "7f0000000000-7f0000004000 rw-p 00000000 00:00 0 \n"
+      "7f0000003000-7f0000005000 r--p 00000000 08:01 789 /lib/libm.so\n");
+  dump.Add(&stream);
+  dump.Finish();
+
+  string contents;
+  ASSERT_TRUE(dump.GetContents(&contents));
+  istringstream minidump_stream(contents);
+  Minidump minidump(minidump_stream);
+  ASSERT_TRUE(minidump.Read());
+
+  MinidumpLinuxMapsList* maps_list = minidump.GetLinuxMapsList();
+  ASSERT_TRUE(maps_list != NULL);
+  ASSERT_EQ(3U, maps_list->get_maps_count());
+  const MinidumpLinuxMaps* libc = maps_list->GetLinuxMapsAtIndex(0);
+  const MinidumpLinuxMaps* anonymous = maps_list->GetLinuxMapsAtIndex(1);
+  const MinidumpLinuxMaps* libm = maps_list->GetLinuxMapsAtIndex(2);
+
+  EXPECT_EQ(anonymous, maps_list->GetLinuxMapsForAddress(0x7f0000000800ULL));
+  EXPECT_EQ(libc, maps_list->GetLinuxMapsForAddress(0x7f0000001000ULL));
+  EXPECT_EQ(libc, maps_list->GetLinuxMapsForAddress(0x7f0000001fffULL));
+  EXPECT_EQ(anonymous, maps_list->GetLinuxMapsForAddress(0x7f0000002000ULL));
+  EXPECT_EQ(anonymous, maps_list->GetLinuxMapsForAddress(0x7f0000003fffULL));
+  EXPECT_EQ(libm, maps_list->GetLinuxMapsForAddress(0x7f0000004000ULL));
+  EXPECT_EQ(NULL, maps_list->GetLinuxMapsForAddress(0x7f0000005000ULL));
+
+  uint64_t sorted[] = { 0x7f0000000000ULL, 0x7f0000001800ULL,
+                        0x7f0000003000ULL, 0x7f0000004800ULL,
+                        0x7f0000005000ULL };
+  vector<uint64_t> addresses(sorted, sorted + sizeof(sorted) / sizeof(*sorted));
+  vector<const MinidumpLinuxMaps*> maps;
+  maps_list->GetLinuxMapsForAddresses(addresses, &maps);
+  ASSERT_EQ(addresses.size(), maps.size());
+  EXPECT_EQ(anonymous, maps[0]);
+  EXPECT_EQ(libc, maps[1]);
+  EXPECT_EQ(anonymous, maps[2]);
+  EXPECT_EQ(libm, maps[3]);
+  EXPECT_EQ(NULL, maps[4]);
+}
+
 TEST(Dump, OneExceptionX86) {
   Dump dump(0, kLittleEndian);
 
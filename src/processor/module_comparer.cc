@@ -185,6 +185,24 @@ bool ModuleComparer::CompareModule(const BasicModule *basic_module,
     ASSERT_TRUE(iter2 == fast_module->cfi_delta_rules_.end());
   }
 
+  // Compare cfi_rule_sets_:
+  {
+    map<int, string>::const_iterator iter1;
+    StaticMap<int, char>::iterator iter2;
+    iter1 = basic_module->cfi_rule_sets_.begin();
+    iter2 = fast_module->cfi_rule_sets_.begin();
+    while (iter1 != basic_module->cfi_rule_sets_.end()
+        && iter2 != fast_module->cfi_rule_sets_.end()) {
+      ASSERT_TRUE(iter1->first == iter2.GetKey());
+      string tmp(iter2.GetValuePtr());
+      ASSERT_TRUE(iter1->second == tmp);
+      ++iter1;
+      ++iter2;
+    }
+    ASSERT_TRUE(iter1 == basic_module->cfi_rule_sets_.end());
+    ASSERT_TRUE(iter2 == fast_module->cfi_rule_sets_.end());
+  }
+
   return true;
 }
 
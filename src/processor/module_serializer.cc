@@ -51,6 +51,9 @@ SimpleSerializer<BasicSourceLineResolver::Function>::range_map_serializer_;
 size_t ModuleSerializer::SizeOf(const BasicSourceLineResolver::Module& module) {
   size_t total_size_alloc_ = 0;
 
+  // Size of the format magic and version.
+  total_size_alloc_ += 2 * sizeof(uint32_t);
+
   // Size of the "is_corrupt" flag.
   total_size_alloc_ += SimpleSerializer<bool>::SizeOf(module.is_corrupt_);
 
@@ -66,6 +69,8 @@ size_t ModuleSerializer::SizeOf(const BasicSourceLineResolver::Module& module) {
      module.cfi_initial_rules_);
   map_sizes_[map_index++] = cfi_delta_rules_serializer_.SizeOf(
      module.cfi_delta_rules_);
+  map_sizes_[map_index++] = cfi_rule_sets_serializer_.SizeOf(
+     module.cfi_rule_sets_);
 
   // Header size.
   total_size_alloc_ += kNumberMaps_ * sizeof(uint32_t);
@@ -82,6 +87,13 @@ size_t ModuleSerializer::SizeOf(const BasicSourceLineResolver::Module& module) {
 
 char* ModuleSerializer::Write(const BasicSourceLineResolver::Module& module,
                               char* dest) {
+  // Write the format magic and version.
+  const uint32_t format[2] = {
+    FastSourceLineResolver::Module::kSerializedMagic_,
+    FastSourceLineResolver::Module::kSerializedVersion_
+  };
+  memcpy(dest, format, sizeof(format));
+  dest += sizeof(format);
   // Write the is_corrupt flag.
   dest = SimpleSerializer<bool>::Write(module.is_corrupt_, dest);
   // Write header.
@@ -95,6 +107,7 @@ char* ModuleSerializer::Write(const BasicSourceLineResolver::Module& module,
     dest = wfi_serializer_.Write(&(module.windows_frame_info_[i]), dest);
   dest = cfi_init_rules_serializer_.Write(module.cfi_initial_rules_, dest);
   dest = cfi_delta_rules_serializer_.Write(module.cfi_delta_rules_, dest);
+  dest = cfi_rule_sets_serializer_.Write(module.cfi_rule_sets_, dest);
   // Write a null terminator.
   dest = SimpleSerializer<char>::Write(0, dest);
   return dest;
@@ -0,0 +1,239 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// process_state_proto_writer.cc: Serialize a ProcessState as a
+// ProcessStateProto message.
+//
+// See process_state_proto_writer.h for documentation.
+
+#include "processor/process_state_proto_writer.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "google_breakpad/processor/call_stack.h"
+#include "google_breakpad/processor/code_module.h"
+#include "google_breakpad/processor/code_modules.h"
+#include "google_breakpad/processor/process_state.h"
+#include "google_breakpad/processor/stack_frame.h"
+#include "google_breakpad/processor/system_info.h"
+
+namespace google_breakpad {
+
+namespace {
+
+// Field numbers from proto/process_state.proto.
+enum ProcessStateProtoField {
+  kTimeDateStamp = 1,
+  kCrash = 2,
+  kAssertion = 3,
+  kRequestingThread = 4,
+  kThreads = 5,
+  kModules = 6,
+  kOS = 7,
+  kOSShort = 8,
+  kOSVersion = 9,
+  kCPU = 10,
+  kCPUInfo = 11,
+  kCPUCount = 12,
+  kProcessCreateTime = 13
+};
+
+enum CrashField {
+  kCrashReason = 1,
+  kCrashAddress = 2
+};
+
+enum ThreadField {
+  kThreadFrames = 1
+};
+
+enum StackFrameField {
+  kFrameInstruction = 1,
+  kFrameModule = 2,
+  kFrameFunctionName = 3,
+  kFrameFunctionBase = 4,
+  kFrameSourceFileName = 5,
+  kFrameSourceLine = 6,
+  kFrameSourceLineBase = 7
+};
+
+enum CodeModuleField {
+  kModuleBaseAddress = 1,
+  kModuleSize = 2,
+  kModuleCodeFile = 3,
+  kModuleCodeIdentifier = 4,
+  kModuleDebugFile = 5,
+  kModuleDebugIdentifier = 6,
+  kModuleVersion = 7
+};
+
+// Wire types.
+const int kVarint = 0;
+const int kLengthDelimited = 2;
+
+void AppendVarint(uint64_t value, string* output) {
+  while (value >= 0x80) {
+    output->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  output->push_back(static_cast<char>(value));
+}
+
+void AppendTag(int field, int wire_type, string* output) {
+  AppendVarint((static_cast<uint64_t>(field) << 3) | wire_type, output);
+}
+
+// int32 and int64 fields both sign-extend negative values to 64 bits.
+void AppendIntField(int field, int64_t value, string* output) {
+  AppendTag(field, kVarint, output);
+  AppendVarint(static_cast<uint64_t>(value), output);
+}
+
+// Used for both string and embedded message fields.
+void AppendBytesField(int field, const string& value, string* output) {
+  AppendTag(field, kLengthDelimited, output);
+  AppendVarint(value.size(), output);
+  output->append(value);
+}
+
+void AppendStringFieldIfNotEmpty(int field, const string& value,
+                                 string* output) {
+  if (!value.empty())
+    AppendBytesField(field, value, output);
+}
+
+void SerializeCodeModule(const CodeModule& module, string* output) {
+  AppendIntField(kModuleBaseAddress, module.base_address(), output);
+  AppendIntField(kModuleSize, module.size(), output);
+  AppendStringFieldIfNotEmpty(kModuleCodeFile, module.code_file(), output);
+  AppendStringFieldIfNotEmpty(kModuleCodeIdentifier, module.code_identifier(),
+                              output);
+  AppendStringFieldIfNotEmpty(kModuleDebugFile, module.debug_file(), output);
+  AppendStringFieldIfNotEmpty(kModuleDebugIdentifier,
+                              module.debug_identifier(), output);
+  AppendStringFieldIfNotEmpty(kModuleVersion, module.version(), output);
+}
+
+// Encodes CodeModule messages, remembering each one so that the frames
+// of a stack, which mostly fall in a handful of modules, reuse the
+// encoding.
+class CodeModuleEncoder {
+ public:
+  const string& Encode(const CodeModule* module) {
+    std::map<const CodeModule*, string>::iterator it = encoded_.find(module);
+    if (it == encoded_.end()) {
+      it = encoded_.insert(std::make_pair(module, string())).first;
+      SerializeCodeModule(*module, &it->second);
+    }
+    return it->second;
+  }
+
+ private:
+  std::map<const CodeModule*, string> encoded_;
+};
+
+void SerializeStackFrame(const StackFrame& frame,
+                         CodeModuleEncoder* modules,
+                         string* output) {
+  AppendIntField(kFrameInstruction, frame.instruction, output);
+  if (frame.module)
+    AppendBytesField(kFrameModule, modules->Encode(frame.module), output);
+  if (!frame.function_name.empty()) {
+    AppendBytesField(kFrameFunctionName, frame.function_name, output);
+    AppendIntField(kFrameFunctionBase, frame.function_base, output);
+  }
+  if (!frame.source_file_name.empty()) {
+    AppendBytesField(kFrameSourceFileName, frame.source_file_name, output);
+    AppendIntField(kFrameSourceLine, frame.source_line, output);
+    AppendIntField(kFrameSourceLineBase, frame.source_line_base, output);
+  }
+}
+
+}  // namespace
+
+void SerializeProcessStateProto(const ProcessState& process_state,
+                                string* output) {
+  AppendIntField(kTimeDateStamp, process_state.time_date_stamp(), output);
+  AppendIntField(kProcessCreateTime, process_state.process_create_time(),
+                 output);
+
+  if (process_state.crashed()) {
+    string crash;
+    AppendBytesField(kCrashReason, process_state.crash_reason(), &crash);
+    AppendIntField(kCrashAddress, process_state.crash_address(), &crash);
+    AppendBytesField(kCrash, crash, output);
+  }
+  AppendStringFieldIfNotEmpty(kAssertion, process_state.assertion(), output);
+  AppendIntField(kRequestingThread, process_state.requesting_thread(), output);
+
+  CodeModuleEncoder module_encoder;
+  string thread, frame;
+  const std::vector<CallStack*>* threads = process_state.threads();
+  for (size_t i = 0; i < threads->size(); ++i) {
+    thread.clear();
+    const std::vector<StackFrame*>* frames = threads->at(i)->frames();
+    for (size_t j = 0; j < frames->size(); ++j) {
+      frame.clear();
+      SerializeStackFrame(*frames->at(j), &module_encoder, &frame);
+      AppendBytesField(kThreadFrames, frame, &thread);
+    }
+    AppendBytesField(kThreads, thread, output);
+  }
+
+  const CodeModules* modules = process_state.modules();
+  if (modules) {
+    for (unsigned int i = 0; i < modules->module_count(); ++i) {
+      const CodeModule* module = modules->GetModuleAtSequence(i);
+      AppendBytesField(kModules, module_encoder.Encode(module), output);
+    }
+  }
+
+  const SystemInfo* system_info = process_state.system_info();
+  AppendBytesField(kOS, system_info->os, output);
+  AppendBytesField(kOSShort, system_info->os_short, output);
+  AppendBytesField(kOSVersion, system_info->os_version, output);
+  AppendBytesField(kCPU, system_info->cpu, output);
+  AppendBytesField(kCPUInfo, system_info->cpu_info, output);
+  AppendIntField(kCPUCount, system_info->cpu_count, output);
+}
+
+bool WriteDelimitedProcessStateProto(const ProcessState& process_state,
+                                     FILE* output) {
+  string message;
+  SerializeProcessStateProto(process_state, &message);
+  string length;
+  AppendVarint(message.size(), &length);
+  return fwrite(length.data(), 1, length.size(), output) == length.size() &&
+         fwrite(message.data(), 1, message.size(), output) == message.size() &&
+         fflush(output) == 0;
+}
+
+}  // namespace google_breakpad
@@ -0,0 +1,65 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// process_state_proto_writer.h: Serialize a ProcessState as a
+// ProcessStateProto message, as described by proto/process_state.proto.
+//
+// The encoder writes the protocol buffer wire format directly, so the
+// processor does not need the protobuf library to produce it; any
+// protobuf implementation can read the result using that schema.
+
+#ifndef PROCESSOR_PROCESS_STATE_PROTO_WRITER_H__
+#define PROCESSOR_PROCESS_STATE_PROTO_WRITER_H__
+
+#include <stdio.h>
+
+#include <string>
+
+#include "common/using_std_string.h"
+
+namespace google_breakpad {
+
+class ProcessState;
+
+// Append the ProcessStateProto encoding of PROCESS_STATE to OUTPUT.
+void SerializeProcessStateProto(const ProcessState& process_state,
+                                string* output);
+
+// Write the ProcessStateProto encoding of PROCESS_STATE to OUTPUT,
+// preceded by its length in bytes as a varint. This is the framing
+// protobuf's delimited stream readers expect (for example
+// parseDelimitedFrom in Java, or ParseDelimitedFromZeroCopyStream in
+// C++), so the output of many runs can be concatenated into one stream.
+// Return true on success, or false if writing fails.
+bool WriteDelimitedProcessStateProto(const ProcessState& process_state,
+                                     FILE* output);
+
+}  // namespace google_breakpad
+
+#endif  // PROCESSOR_PROCESS_STATE_PROTO_WRITER_H__
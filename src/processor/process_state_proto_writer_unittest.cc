@@ -0,0 +1,238 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Unit test for SerializeProcessStateProto and
+// WriteDelimitedProcessStateProto.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "breakpad_googletest_includes.h"
+#include "common/using_std_string.h"
+#include "google_breakpad/processor/basic_source_line_resolver.h"
+#include "google_breakpad/processor/call_stack.h"
+#include "google_breakpad/processor/code_module.h"
+#include "google_breakpad/processor/code_modules.h"
+#include "google_breakpad/processor/microdump.h"
+#include "google_breakpad/processor/microdump_processor.h"
+#include "google_breakpad/processor/process_state.h"
+#include "google_breakpad/processor/stack_frame.h"
+#include "google_breakpad/processor/stack_frame_symbolizer.h"
+#include "processor/process_state_proto_writer.h"
+#include "processor/simple_symbol_supplier.h"
+
+namespace {
+
+using google_breakpad::BasicSourceLineResolver;
+using google_breakpad::CodeModule;
+using google_breakpad::Microdump;
+using google_breakpad::MicrodumpProcessor;
+using google_breakpad::ProcessState;
+using google_breakpad::SerializeProcessStateProto;
+using google_breakpad::SimpleSymbolSupplier;
+using google_breakpad::StackFrame;
+using google_breakpad::StackFrameSymbolizer;
+using google_breakpad::WriteDelimitedProcessStateProto;
+using std::vector;
+
+// A field of a decoded protocol buffer message. Varint fields have only a
+// value; length-delimited fields have only bytes.
+struct Field {
+  int number;
+  uint64_t value;
+  string bytes;
+};
+
+// Read a varint from DATA at *OFFSET, advancing *OFFSET past it.
+bool ReadVarint(const string& data, size_t* offset, uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; *offset < data.size() && shift < 64; shift += 7) {
+    uint8_t byte = data[(*offset)++];
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+// Decode the fields of the message DATA, which may only use varint and
+// length-delimited fields.
+bool Decode(const string& data, vector<Field>* fields) {
+  fields->clear();
+  size_t offset = 0;
+  while (offset < data.size()) {
+    uint64_t tag;
+    if (!ReadVarint(data, &offset, &tag))
+      return false;
+    Field field;
+    field.number = static_cast<int>(tag >> 3);
+    field.value = 0;
+    if ((tag & 7) == 0) {
+      if (!ReadVarint(data, &offset, &field.value))
+        return false;
+    } else if ((tag & 7) == 2) {
+      uint64_t length;
+      if (!ReadVarint(data, &offset, &length) ||
+          length > data.size() - offset)
+        return false;
+      field.bytes = data.substr(offset, length);
+      offset += length;
+    } else {
+      return false;
+    }
+    fields->push_back(field);
+  }
+  return true;
+}
+
+// Return the fields of FIELDS numbered NUMBER, in order.
+vector<Field> Find(const vector<Field>& fields, int number) {
+  vector<Field> found;
+  for (size_t i = 0; i < fields.size(); ++i) {
+    if (fields[i].number == number)
+      found.push_back(fields[i]);
+  }
+  return found;
+}
+
+class ProcessStateProtoWriterTest : public ::testing::Test {
+ public:
+  void SetUp() {
+    string files_path = string(getenv("srcdir") ? getenv("srcdir") : ".") +
+                        "/src/processor/testdata/";
+    std::ifstream file((files_path + "microdump-arm64.dmp").c_str());
+    ASSERT_TRUE(file.good());
+    string contents((std::istreambuf_iterator<char>(file)),
+                    std::istreambuf_iterator<char>());
+
+    SimpleSymbolSupplier supplier(files_path + "symbols/microdump");
+    BasicSourceLineResolver resolver;
+    StackFrameSymbolizer frame_symbolizer(&supplier, &resolver);
+    MicrodumpProcessor processor(&frame_symbolizer);
+    Microdump microdump(contents);
+    ASSERT_EQ(google_breakpad::PROCESS_OK,
+              processor.Process(&microdump, &state_));
+  }
+
+  ProcessState state_;
+};
+
+void ExpectModule(const CodeModule& module, const string& encoded) {
+  vector<Field> fields;
+  ASSERT_TRUE(Decode(encoded, &fields));
+  ASSERT_EQ(1U, Find(fields, 1).size());
+  EXPECT_EQ(module.base_address(), Find(fields, 1)[0].value);
+  EXPECT_EQ(module.size(), Find(fields, 2)[0].value);
+  EXPECT_EQ(module.code_file(), Find(fields, 3)[0].bytes);
+  EXPECT_EQ(module.debug_identifier(), Find(fields, 6)[0].bytes);
+}
+
+TEST_F(ProcessStateProtoWriterTest, Microdump) {
+  string encoded;
+  SerializeProcessStateProto(state_, &encoded);
+  vector<Field> fields;
+  ASSERT_TRUE(Decode(encoded, &fields));
+
+  ASSERT_EQ(1U, Find(fields, 2).size());  // crash
+  ASSERT_EQ(1U, Find(fields, 4).size());
+  EXPECT_EQ(0U, Find(fields, 4)[0].value);  // requesting_thread
+  EXPECT_EQ("Android", Find(fields, 7)[0].bytes);
+  EXPECT_EQ("android", Find(fields, 8)[0].bytes);
+  EXPECT_EQ("OS 64 VERSION INFO", Find(fields, 9)[0].bytes);
+  EXPECT_EQ("arm64", Find(fields, 10)[0].bytes);
+  EXPECT_EQ(2U, Find(fields, 12)[0].value);  // cpu_count
+
+  vector<Field> modules = Find(fields, 6);
+  ASSERT_EQ(8U, modules.size());
+  for (size_t i = 0; i < modules.size(); ++i)
+    ExpectModule(*state_.modules()->GetModuleAtSequence(i), modules[i].bytes);
+
+  vector<Field> threads = Find(fields, 5);
+  ASSERT_EQ(1U, threads.size());
+  vector<Field> thread;
+  ASSERT_TRUE(Decode(threads[0].bytes, &thread));
+  const vector<StackFrame*>* frames = state_.threads()->at(0)->frames();
+  ASSERT_EQ(frames->size(), thread.size());
+  for (size_t i = 0; i < frames->size(); ++i) {
+    const StackFrame* frame = frames->at(i);
+    vector<Field> frame_fields;
+    ASSERT_TRUE(Decode(thread[i].bytes, &frame_fields));
+    EXPECT_EQ(frame->instruction, Find(frame_fields, 1)[0].value);
+    if (frame->module) {
+      ASSERT_EQ(1U, Find(frame_fields, 2).size());
+      ExpectModule(*frame->module, Find(frame_fields, 2)[0].bytes);
+    }
+    if (!frame->function_name.empty()) {
+      EXPECT_EQ(frame->function_name, Find(frame_fields, 3)[0].bytes);
+      EXPECT_EQ(frame->function_base, Find(frame_fields, 4)[0].value);
+    } else {
+      EXPECT_TRUE(Find(frame_fields, 3).empty());
+    }
+  }
+  EXPECT_EQ("MicrodumpWriterTest_Setup_Test::TestBody",
+            frames->at(0)->function_name);
+}
+
+TEST_F(ProcessStateProtoWriterTest, Delimited) {
+  string encoded;
+  SerializeProcessStateProto(state_, &encoded);
+
+  FILE* file = tmpfile();
+  ASSERT_TRUE(file);
+  ASSERT_TRUE(WriteDelimitedProcessStateProto(state_, file));
+  ASSERT_TRUE(WriteDelimitedProcessStateProto(state_, file));
+  rewind(file);
+  string stream;
+  char buffer[4096];
+  for (size_t n; (n = fread(buffer, 1, sizeof(buffer), file)) > 0; )
+    stream.append(buffer, n);
+  fclose(file);
+
+  // Two records, each the length of the message followed by the message.
+  size_t offset = 0;
+  for (int i = 0; i < 2; ++i) {
+    uint64_t length;
+    ASSERT_TRUE(ReadVarint(stream, &offset, &length));
+    ASSERT_EQ(encoded.size(), length);
+    EXPECT_EQ(encoded, stream.substr(offset, length));
+    offset += length;
+  }
+  EXPECT_EQ(stream.size(), offset);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,688 @@
+// Copyright (c) 2026, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// processor_benchmark.cc: Measure the processor's hot paths on synthetic
+// inputs.
+//
+// The benchmark generates a large symbol file and a minidump with many
+// deep threads, using SynthMinidump and test_assembler, so that its
+// results depend only on the code being measured.  It reports symbol
+// load times, address lookup and CFI evaluation rates for both source
+// line resolvers, RangeMap, StaticMap and PostfixEvaluator throughput,
+// and the rate at which the x86 stackwalker recovers frames with frame
+// pointers and with CFI.  The results are written to stdout as a JSON
+// object, each with the peak resident set size at the time it was taken.
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/basictypes.h"
+#include "common/path_helper.h"
+#include "common/scoped_ptr.h"
+#include "common/test_assembler.h"
+#include "common/using_std_string.h"
+#include "google_breakpad/common/minidump_format.h"
+#include "google_breakpad/processor/basic_source_line_resolver.h"
+#include "google_breakpad/processor/call_stack.h"
+#include "google_breakpad/processor/fast_source_line_resolver.h"
+#include "google_breakpad/processor/memory_region.h"
+#include "google_breakpad/processor/minidump.h"
+#include "google_breakpad/processor/minidump_processor.h"
+#include "google_breakpad/processor/process_state.h"
+#include "google_breakpad/processor/processing_stats.h"
+#include "google_breakpad/processor/stack_frame.h"
+#include "google_breakpad/processor/symbol_supplier.h"
+#include "processor/basic_code_module.h"
+#include "processor/cfi_frame_info.h"
+#include "processor/json_writer.h"
+#include "processor/map_serializers-inl.h"
+#include "processor/module_serializer.h"
+#include "processor/postfix_evaluator-inl.h"
+#include "processor/range_map-inl.h"
+#include "processor/static_map-inl.h"
+#include "processor/synth_minidump.h"
+
+namespace {
+
+using google_breakpad::BasicCodeModule;
+using google_breakpad::BasicSourceLineResolver;
+using google_breakpad::CallStack;
+using google_breakpad::CFIFrameInfo;
+using google_breakpad::CodeModule;
+using google_breakpad::FastSourceLineResolver;
+using google_breakpad::JsonWriter;
+using google_breakpad::MemoryRegion;
+using google_breakpad::Minidump;
+using google_breakpad::MinidumpProcessor;
+using google_breakpad::ModuleSerializer;
+using google_breakpad::PostfixEvaluator;
+using google_breakpad::ProcessState;
+using google_breakpad::ProcessingStats;
+using google_breakpad::RangeMap;
+using google_breakpad::SourceLineResolverInterface;
+using google_breakpad::StackFrame;
+using google_breakpad::StaticMap;
+using google_breakpad::StdMapSerializer;
+using google_breakpad::SymbolSupplier;
+using google_breakpad::SystemInfo;
+using google_breakpad::scoped_array;
+using google_breakpad::scoped_ptr;
+using google_breakpad::test_assembler::kLittleEndian;
+using google_breakpad::test_assembler::Label;
+using std::map;
+using std::vector;
+
+namespace SynthMinidump = google_breakpad::SynthMinidump;
+
+// The layout of the synthetic module: kFunctionSize-byte functions, the
+// first at kFirstFunction, in a module loaded at kModuleBase.
+const uint64_t kModuleBase = 0x40000000;
+const uint64_t kFirstFunction = 0x1000;
+const uint64_t kFunctionSize = 0x40;
+const int kLinesPerFunction = 4;
+const int kSourceFiles = 64;
+const char kModuleName[] = "c:\\bench\\bench.exe";
+
+// Sizes of the inputs at scale 1.
+const int kFunctions = 100000;
+const int kThreads = 16;
+const int kFramesPerThread = 512;
+const int kLookups = 500000;
+const int kCFIEvaluations = 100000;
+const int kPostfixEvaluations = 100000;
+const int kStackwalkIterations = 10;
+
+struct Options {
+  double scale;
+};
+
+// Return COUNT multiplied by OPTIONS' scale, but at least 1.
+int Scaled(int count, const Options& options) {
+  double scaled = count * options.scale;
+  if (scaled < 1)
+    return 1;
+  return scaled < INT_MAX ? static_cast<int>(scaled) : INT_MAX;
+}
+
+// Discards everything logged with BPLOG(INFO) while in scope, so that the
+// loop being timed does not also measure the logging.
+class ScopedDiscardInfoLog {
+ public:
+  ScopedDiscardInfoLog() : buffer_(std::clog.rdbuf(NULL)) {}
+  // Restoring the buffer also clears the stream's error state.
+  ~ScopedDiscardInfoLog() { std::clog.rdbuf(buffer_); }
+
+ private:
+  std::streambuf* buffer_;
+};
+
+// A deterministic pseudo-random sequence, so that every run performs the
+// same lookups.
+class Random {
+ public:
+  Random() : state_(0x2545f4914f6cdd1dULL) {}
+  uint64_t Next() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 7;
+    state_ ^= state_ << 17;
+    return state_;
+  }
+  uint64_t Below(uint64_t limit) { return Next() % limit; }
+
+ private:
+  uint64_t state_;
+};
+
+uint64_t FunctionAddress(int function) {
+  return kFirstFunction + function * kFunctionSize;
+}
+
+// Return a symbol file for the synthetic module with FUNCTIONS functions.
+// Every function has line records, every fourth a PUBLIC record, and
+// every function STACK CFI records describing a standard x86 frame: push
+// %ebp at offset 0, mov %esp, %ebp at offset 1, and a frame based on %ebp
+// from offset 3 on.
+string GenerateSymbolFile(int functions) {
+  string sym;
+  sym.reserve(functions * 400);
+  char line[256];
+  sym += "MODULE windows x86 5A9832E5287241C1838ED98914E9B7FF1 bench.pdb\n";
+  for (int file = 0; file < kSourceFiles; ++file) {
+    snprintf(line, sizeof(line), "FILE %d c:\\bench\\src\\file%d.cc\n",
+             file, file);
+    sym += line;
+  }
+  for (int function = 0; function < functions; ++function) {
+    uint64_t address = FunctionAddress(function);
+    snprintf(line, sizeof(line), "FUNC %" PRIx64 " %" PRIx64 " 0 "
+             "bench::Function%d(int, char const*)\n",
+             address, kFunctionSize, function);
+    sym += line;
+    uint64_t line_size = kFunctionSize / kLinesPerFunction;
+    for (int i = 0; i < kLinesPerFunction; ++i) {
+      snprintf(line, sizeof(line), "%" PRIx64 " %" PRIx64 " %d %d\n",
+               address + i * line_size, line_size, 10 + function % 1000 + i,
+               function % kSourceFiles);
+      sym += line;
+    }
+  }
+  for (int function = 0; function < functions; function += 4) {
+    snprintf(line, sizeof(line), "PUBLIC %" PRIx64 " 0 bench_public_%d\n",
+             FunctionAddress(function), function);
+    sym += line;
+  }
+  for (int function = 0; function < functions; ++function) {
+    uint64_t address = FunctionAddress(function);
+    snprintf(line, sizeof(line),
+             "STACK CFI INIT %" PRIx64 " %" PRIx64
+             " .cfa: $esp 4 + .ra: .cfa 4 - ^\n"
+             "STACK CFI %" PRIx64 " .cfa: $esp 8 + $ebp: .cfa 8 - ^\n"
+             "STACK CFI %" PRIx64 " .cfa: $ebp 8 +\n",
+             address, kFunctionSize, address + 1, address + 3);
+    sym += line;
+  }
+  return sym;
+}
+
+// A MemoryRegion covering all addresses, in which each address holds
+// its own value plus one.
+class FakeMemoryRegion : public MemoryRegion {
+ public:
+  virtual uint64_t GetBase() const { return 0; }
+  virtual uint32_t GetSize() const { return 0xffffffff; }
+  virtual bool GetMemoryAtAddress(uint64_t address, uint8_t* value) const {
+    *value = address + 1;
+    return true;
+  }
+  virtual bool GetMemoryAtAddress(uint64_t address, uint16_t* value) const {
+    *value = address + 1;
+    return true;
+  }
+  virtual bool GetMemoryAtAddress(uint64_t address, uint32_t* value) const {
+    *value = address + 1;
+    return true;
+  }
+  virtual bool GetMemoryAtAddress(uint64_t address, uint64_t* value) const {
+    *value = address + 1;
+    return true;
+  }
+  virtual void Print() const {}
+};
+
+// A SymbolSupplier that supplies SYMBOL_DATA for the synthetic module.
+class BenchmarkSymbolSupplier : public SymbolSupplier {
+ public:
+  explicit BenchmarkSymbolSupplier(const string& symbol_data)
+      : symbol_data_(symbol_data) {}
+
+  virtual SymbolResult GetSymbolFile(const CodeModule* module,
+                                     const SystemInfo*,
+                                     string* symbol_file) {
+    if (module->code_file() != kModuleName)
+      return NOT_FOUND;
+    *symbol_file = "bench.sym";
+    return FOUND;
+  }
+  virtual SymbolResult GetSymbolFile(const CodeModule* module,
+                                     const SystemInfo* system_info,
+                                     string* symbol_file,
+                                     string* symbol_data) {
+    SymbolResult result = GetSymbolFile(module, system_info, symbol_file);
+    if (result == FOUND && symbol_data)
+      *symbol_data = symbol_data_;
+    return result;
+  }
+  virtual SymbolResult GetCStringSymbolData(const CodeModule* module,
+                                            const SystemInfo* system_info,
+                                            string* symbol_file,
+                                            char** symbol_data,
+                                            size_t* symbol_data_size) {
+    SymbolResult result = GetSymbolFile(module, system_info, symbol_file);
+    if (result != FOUND)
+      return result;
+    buffer_.reset(new char[symbol_data_.size() + 1]);
+    memcpy(buffer_.get(), symbol_data_.c_str(), symbol_data_.size() + 1);
+    *symbol_data = buffer_.get();
+    *symbol_data_size = symbol_data_.size() + 1;
+    return FOUND;
+  }
+  virtual void FreeSymbolData(const CodeModule*) {
+    buffer_.reset();
+  }
+
+ private:
+  const string& symbol_data_;
+  scoped_array<char> buffer_;
+};
+
+// Return a minidump of an x86 process with THREADS threads, each with a
+// stack of FRAMES standard frames whose return addresses are spread over
+// the synthetic module's FUNCTIONS functions.
+string GenerateMinidump(int functions, int threads, int frames) {
+  SynthMinidump::Dump dump(MD_NORMAL, kLittleEndian);
+  SynthMinidump::String csd_version(
+      dump, SynthMinidump::SystemInfo::windows_x86_csd_version);
+  SynthMinidump::SystemInfo system_info(
+      dump, SynthMinidump::SystemInfo::windows_x86, csd_version);
+  dump.Add(&system_info);
+  dump.Add(&csd_version);
+
+  SynthMinidump::String module_name(dump, kModuleName);
+  SynthMinidump::Module module(dump, kModuleBase,
+                               FunctionAddress(functions), module_name);
+  dump.Add(&module);
+  dump.Add(&module_name);
+
+  // Every frame is 16 bytes: saved %ebp, return address, and two words of
+  // locals.
+  const uint32_t kFrameSize = 16;
+  const uint64_t kStackSpacing = 0x100000;
+  Random random;
+  vector<SynthMinidump::Memory*> stacks;
+  vector<SynthMinidump::Context*> contexts;
+  vector<SynthMinidump::Thread*> thread_list;
+  for (int thread = 0; thread < threads; ++thread) {
+    uint64_t stack_base = 0x10000000 + thread * kStackSpacing;
+    SynthMinidump::Memory* stack = new SynthMinidump::Memory(dump, stack_base);
+    // The innermost frame's locals.
+    stack->D32(0).D32(0);
+    for (int frame = 1; frame < frames; ++frame) {
+      uint64_t frame_base = stack_base + 8 + (frame - 1) * kFrameSize;
+      uint32_t caller_ebp = static_cast<uint32_t>(frame_base + kFrameSize);
+      uint32_t return_address = static_cast<uint32_t>(
+          kModuleBase + FunctionAddress(random.Below(functions)) + 0x20);
+      stack->D32(caller_ebp).D32(return_address).D32(0).D32(0);
+    }
+    // The outermost frame returns to address zero, ending the walk.
+    stack->D32(0).D32(0);
+    stacks.push_back(stack);
+
+    MDRawContextX86 raw_context;
+    memset(&raw_context, 0, sizeof(raw_context));
+    raw_context.context_flags = MD_CONTEXT_X86_FULL;
+    raw_context.eip = static_cast<uint32_t>(
+        kModuleBase + FunctionAddress(random.Below(functions)) + 0x10);
+    raw_context.esp = static_cast<uint32_t>(stack_base);
+    raw_context.ebp = static_cast<uint32_t>(stack_base + 8);
+    SynthMinidump::Context* context =
+        new SynthMinidump::Context(dump, raw_context);
+    contexts.push_back(context);
+
+    thread_list.push_back(
+        new SynthMinidump::Thread(dump, 0x1000 + thread, *stack, *context));
+  }
+  for (int thread = 0; thread < threads; ++thread) {
+    dump.Add(stacks[thread]);
+    dump.Add(contexts[thread]);
+    dump.Add(thread_list[thread]);
+  }
+  dump.Finish();
+
+  string contents;
+  dump.GetContents(&contents);
+  for (int thread = 0; thread < threads; ++thread) {
+    delete stacks[thread];
+    delete contexts[thread];
+    delete thread_list[thread];
+  }
+  return contents;
+}
+
+int64_t PeakRSSKilobytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return -1;
+#if defined(__APPLE__)
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+uint64_t PerSecond(uint64_t count, uint64_t elapsed_us) {
+  return count * 1000000 / (elapsed_us ? elapsed_us : 1);
+}
+
+void Report(JsonWriter* json, const string& name, uint64_t value,
+            const char* unit) {
+  json->BeginObject();
+  json->Key("name");
+  json->String(name);
+  json->Key("value");
+  json->Int(value);
+  json->Key("unit");
+  json->String(unit);
+  json->Key("peak_rss_kb");
+  json->Int(PeakRSSKilobytes());
+  json->EndObject();
+}
+
+// Measure address lookups and CFI evaluation in RESOLVER, which has
+// loaded the synthetic module's symbols for MODULE, reporting them under
+// PREFIX.
+void BenchmarkResolverLookups(const string& prefix,
+                              SourceLineResolverInterface* resolver,
+                              const CodeModule* module,
+                              int functions, const Options& options,
+                              JsonWriter* json) {
+  Random random;
+  int lookups = Scaled(kLookups, options);
+  int found = 0;
+  uint64_t start_us = ProcessingStats::NowMicroseconds();
+  for (int i = 0; i < lookups; ++i) {
+    StackFrame frame;
+    frame.module = module;
+    frame.instruction = kModuleBase +
+        FunctionAddress(random.Below(functions)) + random.Below(kFunctionSize);
+    resolver->FillSourceLineInfo(&frame);
+    if (frame.source_line)
+      ++found;
+  }
+  uint64_t elapsed_us = ProcessingStats::NowMicroseconds() - start_us;
+  if (found != lookups)
+    fprintf(stderr, "%s: only %d of %d lookups found a line\n",
+            prefix.c_str(), found, lookups);
+  Report(json, prefix + ".lookups", PerSecond(lookups, elapsed_us),
+         "lookups/s");
+
+  FakeMemoryRegion memory;
+  CFIFrameInfo::RegisterValueMap<uint32_t> registers;
+  registers["$esp"] = 0x10000000;
+  registers["$ebp"] = 0x10000010;
+  registers["$eip"] = 0;
+  int evaluations = Scaled(kCFIEvaluations, options);
+  int evaluated = 0;
+  start_us = ProcessingStats::NowMicroseconds();
+  for (int i = 0; i < evaluations; ++i) {
+    StackFrame frame;
+    frame.module = module;
+    frame.instruction = kModuleBase +
+        FunctionAddress(random.Below(functions)) + random.Below(kFunctionSize);
+    scoped_ptr<CFIFrameInfo> cfi(resolver->FindCFIFrameInfo(&frame));
+    CFIFrameInfo::RegisterValueMap<uint32_t> caller_registers;
+    if (cfi.get() &&
+        cfi->FindCallerRegs(registers, memory, &caller_registers))
+      ++evaluated;
+  }
+  elapsed_us = ProcessingStats::NowMicroseconds() - start_us;
+  if (evaluated != evaluations)
+    fprintf(stderr, "%s: only %d of %d CFI evaluations succeeded\n",
+            prefix.c_str(), evaluated, evaluations);
+  Report(json, prefix + ".cfi_evaluations", PerSecond(evaluations, elapsed_us),
+         "evaluations/s");
+}
+
+void BenchmarkResolvers(const string& symbol_data, int functions,
+                        const Options& options, JsonWriter* json) {
+  BasicCodeModule module(kModuleBase, FunctionAddress(functions), kModuleName,
+                         "", "bench.pdb", "", "");
+
+  {
+    BasicSourceLineResolver resolver;
+    uint64_t start_us = ProcessingStats::NowMicroseconds();
+    if (!resolver.LoadModuleUsingMapBuffer(&module, symbol_data)) {
+      fprintf(stderr, "BasicSourceLineResolver could not load symbols\n");
+      exit(1);
+    }
+    Report(json, "basic_resolver.load",
+           ProcessingStats::NowMicroseconds() - start_us, "us");
+    BenchmarkResolverLookups("basic_resolver", &resolver, &module, functions,
+                             options, json);
+  }
+
+  ModuleSerializer serializer;
+  unsigned int serialized_size = 0;
+  uint64_t start_us = ProcessingStats::NowMicroseconds();
+  scoped_array<char> serialized(
+      serializer.SerializeSymbolFileData(symbol_data, &serialized_size));
+  if (!serialized.get()) {
+    fprintf(stderr, "ModuleSerializer could not serialize symbols\n");
+    exit(1);
+  }
+  Report(json, "module_serializer.serialize",
+         ProcessingStats::NowMicroseconds() - start_us, "us");
+
+  FastSourceLineResolver resolver;
+  start_us = ProcessingStats::NowMicroseconds();
+  if (!resolver.LoadModuleUsingMemoryBuffer(&module, serialized.get(),
+                                            serialized_size)) {
+    fprintf(stderr, "FastSourceLineResolver could not load symbols\n");
+    exit(1);
+  }
+  Report(json, "fast_resolver.load",
+         ProcessingStats::NowMicroseconds() - start_us, "us");
+  BenchmarkResolverLookups("fast_resolver", &resolver, &module, functions,
+                           options, json);
+  resolver.UnloadModule(&module);
+}
+
+void BenchmarkMaps(int functions, const Options& options, JsonWriter* json) {
+  int ranges = functions * kLinesPerFunction;
+  uint64_t range_size = kFunctionSize / kLinesPerFunction;
+  int lookups = Scaled(kLookups, options);
+
+  RangeMap<uint64_t, int> range_map;
+  uint64_t start_us = ProcessingStats::NowMicroseconds();
+  for (int i = 0; i < ranges; ++i)
+    range_map.StoreRange(kFirstFunction + i * range_size, range_size, i);
+  Report(json, "range_map.stores",
+         PerSecond(ranges, ProcessingStats::NowMicroseconds() - start_us),
+         "stores/s");
+
+  Random random;
+  uint64_t checksum = 0;
+  start_us = ProcessingStats::NowMicroseconds();
+  for (int i = 0; i < lookups; ++i) {
+    int entry;
+    uint64_t address = kFirstFunction + random.Below(ranges * range_size);
+    if (range_map.RetrieveRange(address, &entry, NULL, NULL, NULL))
+      checksum += entry;
+  }
+  Report(json, "range_map.lookups",
+         PerSecond(lookups, ProcessingStats::NowMicroseconds() - start_us),
+         "lookups/s");
+
+  map<uint64_t, uint64_t> std_map;
+  for (int i = 0; i < ranges; ++i)
+    std_map[kFirstFunction + i * range_size] = i;
+  StdMapSerializer<uint64_t, uint64_t> serializer;
+  unsigned int size = 0;
+  scoped_array<char> serialized(serializer.Serialize(std_map, &size));
+  StaticMap<uint64_t, uint64_t> static_map(serialized.get());
+  start_us = ProcessingStats::NowMicroseconds();
+  for (int i = 0; i < lookups; ++i) {
+    StaticMap<uint64_t, uint64_t>::iterator it = static_map.upper_bound(
+        kFirstFunction + random.Below(ranges * range_size));
+    if (it != static_map.end())
+      checksum += *it.GetValuePtr();
+  }
+  Report(json, "static_map.lookups",
+         PerSecond(lookups, ProcessingStats::NowMicroseconds() - start_us),
+         "lookups/s");
+
+  // Keep the lookups from being optimized away.
+  if (checksum == 1)
+    fprintf(stderr, "checksum %" PRIu64 "\n", checksum);
+}
+
+void BenchmarkPostfixEvaluator(const Options& options, JsonWriter* json) {
+  // A typical STACK WIN program string.
+  const string kProgram =
+      "$T0 $ebp = $eip $T0 4 + ^ = $ebp $T0 ^ = $esp $T0 8 + = "
+      "$ebx $T0 28 - ^ = $esi $T0 20 - ^ =";
+  FakeMemoryRegion memory;
+  PostfixEvaluator<uint32_t>::DictionaryType dictionary;
+  PostfixEvaluator<uint32_t> evaluator(&dictionary, &memory);
+  int evaluations = Scaled(kPostfixEvaluations, options);
+  int evaluated = 0;
+  uint64_t start_us = ProcessingStats::NowMicroseconds();
+  for (int i = 0; i < evaluations; ++i) {
+    dictionary["$ebp"] = 0x10000000 + i;
+    dictionary["$esp"] = 0x10000000;
+    PostfixEvaluator<uint32_t>::DictionaryValidityType assigned;
+    if (evaluator.Evaluate(kProgram, &assigned))
+      ++evaluated;
+  }
+  uint64_t elapsed_us = ProcessingStats::NowMicroseconds() - start_us;
+  if (evaluated != evaluations)
+    fprintf(stderr, "postfix_evaluator: only %d of %d evaluations "
+            "succeeded\n", evaluated, evaluations);
+  Report(json, "postfix_evaluator.evaluations",
+         PerSecond(evaluations, elapsed_us), "evaluations/s");
+}
+
+// Walk every thread of the synthetic minidump repeatedly, with SUPPLIER's
+// symbols if it is not NULL, and report the frames recovered per second
+// under NAME.  The first walk, which loads symbols, is not timed.
+void BenchmarkStackwalk(const string& name, const string& minidump,
+                        SymbolSupplier* supplier, const Options& options,
+                        JsonWriter* json) {
+  std::istringstream input(minidump);
+  Minidump dump(input);
+  if (!dump.Read()) {
+    fprintf(stderr, "%s: could not read the synthetic minidump\n",
+            name.c_str());
+    exit(1);
+  }
+
+  BasicSourceLineResolver resolver;
+  MinidumpProcessor processor(supplier, &resolver);
+  ProcessState state;
+  if (processor.Process(&dump, &state) != google_breakpad::PROCESS_OK) {
+    fprintf(stderr, "%s: could not process the synthetic minidump\n",
+            name.c_str());
+    exit(1);
+  }
+
+  uint64_t frames = 0;
+  uint64_t elapsed_us;
+  {
+    ScopedDiscardInfoLog discard_info_log;
+    uint64_t start_us = ProcessingStats::NowMicroseconds();
+    for (int i = 0; i < kStackwalkIterations; ++i) {
+      processor.Process(&dump, &state);
+      for (size_t thread = 0; thread < state.threads()->size(); ++thread)
+        frames += state.threads()->at(thread)->frames()->size();
+    }
+    elapsed_us = ProcessingStats::NowMicroseconds() - start_us;
+  }
+  uint64_t expected_frames = static_cast<uint64_t>(kStackwalkIterations) *
+      Scaled(kThreads, options) * kFramesPerThread;
+  if (frames != expected_frames)
+    fprintf(stderr, "%s: walked %" PRIu64 " of %" PRIu64 " frames\n",
+            name.c_str(), frames, expected_frames);
+  Report(json, name + ".frames", PerSecond(frames, elapsed_us), "frames/s");
+}
+
+void Usage(const char* argv0, bool error) {
+  fprintf(error ? stderr : stdout,
+          "Usage: %s [options]\n"
+          "\n"
+          "Measure the processor on synthetic symbols and minidumps, and\n"
+          "print the results as JSON\n"
+          "\n"
+          "Options:\n"
+          "\n"
+          "  -s <scale> Multiply the input sizes and iteration counts by\n"
+          "             <scale>, which may be a fraction such as 0.1\n"
+          "             (default 1)\n",
+          google_breakpad::BaseName(argv0).c_str());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  options.scale = 1;
+
+  int ch;
+  while ((ch = getopt(argc, argv, "hs:")) != -1) {
+    switch (ch) {
+      case 'h':
+        Usage(argv[0], false);
+        return 0;
+      case 's': {
+        char* end;
+        options.scale = strtod(optarg, &end);
+        if (end == optarg || *end || !(options.scale > 0)) {
+          fprintf(stderr, "%s: Invalid scale: %s\n", argv[0], optarg);
+          Usage(argv[0], true);
+          return 1;
+        }
+        break;
+      }
+      default:
+        Usage(argv[0], true);
+        return 1;
+    }
+  }
+
+  int functions = Scaled(kFunctions, options);
+  uint64_t start_us = ProcessingStats::NowMicroseconds();
+  string symbol_data = GenerateSymbolFile(functions);
+  uint64_t generate_us = ProcessingStats::NowMicroseconds() - start_us;
+  string minidump = GenerateMinidump(functions, Scaled(kThreads, options),
+                                     kFramesPerThread);
+
+  JsonWriter json(stdout);
+  json.BeginObject();
+  json.Key("scale");
+  json.Double(options.scale);
+  json.Key("symbol_file_bytes");
+  json.Int(symbol_data.size());
+  json.Key("minidump_bytes");
+  json.Int(minidump.size());
+  json.Key("results");
+  json.BeginArray();
+  Report(&json, "symbol_file.generate", generate_us, "us");
+
+  BenchmarkResolvers(symbol_data, functions, options, &json);
+  BenchmarkMaps(functions, options, &json);
+  BenchmarkPostfixEvaluator(options, &json);
+  BenchmarkStackwalk("stackwalk_frame_pointer", minidump, NULL, options,
+                     &json);
+  BenchmarkSymbolSupplier supplier(symbol_data);
+  BenchmarkStackwalk("stackwalk_cfi", minidump, &supplier, options, &json);
+
+  json.EndArray();
+  json.Key("peak_rss_kb");
+  json.Int(PeakRSSKilobytes());
+  json.EndObject();
+  return json.Flush() ? 0 : 1;
+}
@@ -39,6 +39,7 @@
 #include "common/scoped_ptr.h"
 #include "google_breakpad/processor/code_module.h"
 #include "google_breakpad/processor/code_modules.h"
+#include "google_breakpad/processor/processing_stats.h"
 #include "google_breakpad/processor/source_line_resolver_interface.h"
 #include "google_breakpad/processor/stack_frame.h"
 #include "google_breakpad/processor/symbol_supplier.h"
@@ -51,7 +52,8 @@ namespace google_breakpad {
 StackFrameSymbolizer::StackFrameSymbolizer(
     SymbolSupplier* supplier,
     SourceLineResolverInterface* resolver) : supplier_(supplier),
-                                             resolver_(resolver) { }
+                                             resolver_(resolver),
+                                             stats_(NULL) { }
 
 StackFrameSymbolizer::SymbolizerResult StackFrameSymbolizer::FillSourceLineInfo(
     const CodeModules* modules,
@@ -75,11 +77,13 @@ StackFrameSymbolizer::SymbolizerResult StackFrameSymbolizer::FillSourceLineInfo(
   // If module is known to have missing symbol file, return.
   if (no_symbol_modules_.find(module->code_file()) !=
       no_symbol_modules_.end()) {
+    if (stats_) ++stats_->symbol_negative_cache_hits;
     return kError;
   }
 
   // If module is already loaded, go ahead to fill source line info and return.
   if (resolver_->HasModule(frame->module)) {
+    if (stats_) ++stats_->symbol_cache_hits;
     resolver_->FillSourceLineInfo(frame);
     return resolver_->IsModuleCorrupt(frame->module) ?
         kWarningCorruptSymbols : kNoError;
@@ -94,8 +98,14 @@ StackFrameSymbolizer::SymbolizerResult StackFrameSymbolizer::FillSourceLineInfo(
   string symbol_file;
   char* symbol_data = NULL;
   size_t symbol_data_size;
+  uint64_t start_us = stats_ ? ProcessingStats::NowMicroseconds() : 0;
   SymbolSupplier::SymbolResult symbol_result = supplier_->GetCStringSymbolData(
       module, system_info, &symbol_file, &symbol_data, &symbol_data_size);
+  if (stats_) {
+    uint64_t located_us = ProcessingStats::NowMicroseconds();
+    stats_->locate_symbols_us += located_us - start_us;
+    start_us = located_us;
+  }
 
   switch (symbol_result) {
     case SymbolSupplier::FOUND: {
@@ -103,6 +113,13 @@ StackFrameSymbolizer::SymbolizerResult StackFrameSymbolizer::FillSourceLineInfo(
           frame->module,
           symbol_data,
           symbol_data_size);
+      if (stats_) {
+        stats_->parse_symbols_us +=
+            ProcessingStats::NowMicroseconds() - start_us;
+        stats_->symbol_bytes_parsed += symbol_data_size;
+        ++(load_success ? stats_->symbol_files_loaded :
+                          stats_->symbol_files_missing);
+      }
       if (resolver_->ShouldDeleteMemoryBufferAfterLoadModule()) {
         supplier_->FreeSymbolData(module);
       }
@@ -119,6 +136,7 @@ StackFrameSymbolizer::SymbolizerResult StackFrameSymbolizer::FillSourceLineInfo(
     }
 
     case SymbolSupplier::NOT_FOUND:
+      if (stats_) ++stats_->symbol_files_missing;
       no_symbol_modules_.insert(module->code_file());
       return kError;
 
@@ -47,8 +47,10 @@
 #include "google_breakpad/processor/code_module.h"
 #include "google_breakpad/processor/code_modules.h"
 #include "google_breakpad/processor/process_state.h"
+#include "google_breakpad/processor/processing_stats.h"
 #include "google_breakpad/processor/source_line_resolver_interface.h"
 #include "google_breakpad/processor/stack_frame_cpu.h"
+#include "processor/json_writer.h"
 #include "processor/logging.h"
 #include "processor/pathname_stripper.h"
 
@@ -782,6 +784,119 @@ static void PrintModulesMachineReadable(const CodeModules* modules) {
   }
 }
 
+// FrameTrustName returns a short name for how |trust| says a frame was
+// found, for the JSON output.
+static const char* FrameTrustName(StackFrame::FrameTrust trust) {
+  switch (trust) {
+    case StackFrame::FRAME_TRUST_CONTEXT:
+      return "context";
+    case StackFrame::FRAME_TRUST_PREWALKED:
+      return "prewalked";
+    case StackFrame::FRAME_TRUST_CFI:
+      return "cfi";
+    case StackFrame::FRAME_TRUST_CFI_SCAN:
+      return "cfi_scan";
+    case StackFrame::FRAME_TRUST_FP:
+      return "frame_pointer";
+    case StackFrame::FRAME_TRUST_SCAN:
+      return "scan";
+    default:
+      return "none";
+  }
+}
+
+// PrintStackJSON writes the frames of |stack| as a JSON array. Module,
+// function and source members appear only when they are known, and the
+// offsets follow the same rules as PrintStack above.
+static void PrintStackJSON(const CallStack* stack, JsonWriter* json) {
+  json->BeginArray();
+  int frame_count = stack->frames()->size();
+  for (int frame_index = 0; frame_index < frame_count; ++frame_index) {
+    const StackFrame* frame = stack->frames()->at(frame_index);
+    uint64_t instruction_address = frame->ReturnAddress();
+
+    json->BeginObject();
+    json->Key("frame");
+    json->Int(frame_index);
+    json->Key("trust");
+    json->String(FrameTrustName(frame->trust));
+    json->Key("instruction");
+    json->Hex(instruction_address);
+    if (frame->module) {
+      json->Key("module");
+      json->String(PathnameStripper::File(frame->module->code_file()));
+      json->Key("module_offset");
+      json->Hex(instruction_address - frame->module->base_address());
+    }
+    if (!frame->function_name.empty()) {
+      json->Key("function");
+      json->String(frame->function_name);
+      json->Key("function_offset");
+      json->Hex(instruction_address - frame->function_base);
+    }
+    if (!frame->source_file_name.empty()) {
+      json->Key("file");
+      json->String(frame->source_file_name);
+      json->Key("line");
+      json->Int(frame->source_line);
+      json->Key("line_offset");
+      json->Hex(instruction_address - frame->source_line_base);
+    }
+    json->EndObject();
+  }
+  json->EndArray();
+}
+
+// PrintModulesJSON writes the list of loaded |modules| as a JSON array.
+static void PrintModulesJSON(
+    const CodeModules* modules,
+    const vector<const CodeModule*>* modules_without_symbols,
+    const vector<const CodeModule*>* modules_with_corrupt_symbols,
+    JsonWriter* json) {
+  json->BeginArray();
+  if (!modules) {
+    json->EndArray();
+    return;
+  }
+
+  uint64_t main_address = 0;
+  const CodeModule* main_module = modules->GetMainModule();
+  if (main_module) {
+    main_address = main_module->base_address();
+  }
+
+  unsigned int module_count = modules->module_count();
+  for (unsigned int module_sequence = 0;
+       module_sequence < module_count;
+       ++module_sequence) {
+    const CodeModule* module = modules->GetModuleAtSequence(module_sequence);
+    uint64_t base_address = module->base_address();
+    json->BeginObject();
+    json->Key("filename");
+    json->String(PathnameStripper::File(module->code_file()));
+    json->Key("code_id");
+    json->String(module->code_identifier());
+    json->Key("version");
+    json->String(module->version());
+    json->Key("debug_file");
+    json->String(PathnameStripper::File(module->debug_file()));
+    json->Key("debug_id");
+    json->String(module->debug_identifier());
+    json->Key("base_address");
+    json->Hex(base_address);
+    json->Key("end_address");
+    json->Hex(base_address + module->size() - 1);
+    json->Key("main");
+    json->Bool(main_module != NULL && base_address == main_address);
+    json->Key("missing_symbols");
+    json->Bool(ContainsModule(modules_without_symbols, module));
+    json->Key("corrupt_symbols");
+    json->Bool(ContainsModule(modules_with_corrupt_symbols, module));
+    json->EndObject();
+  }
+  json->EndArray();
+}
+
 }  // namespace
 
 void PrintProcessState(const ProcessState& process_state,
@@ -947,4 +1062,133 @@ void PrintProcessStateMachineReadable(const ProcessState& process_state) {
   }
 }
 
+void PrintProcessStateJSON(const ProcessState& process_state) {
+  JsonWriter json(stdout);
+  const SystemInfo* system_info = process_state.system_info();
+  json.BeginObject();
+
+  json.Key("system_info");
+  json.BeginObject();
+  json.Key("os");
+  json.String(system_info->os);
+  json.Key("os_short");
+  json.String(system_info->os_short);
+  json.Key("os_version");
+  json.String(system_info->os_version);
+  json.Key("cpu");
+  json.String(system_info->cpu);
+  json.Key("cpu_info");
+  json.String(system_info->cpu_info);
+  json.Key("cpu_count");
+  json.Int(system_info->cpu_count);
+  json.Key("gpu");
+  json.BeginObject();
+  json.Key("version");
+  json.String(system_info->gl_version);
+  json.Key("vendor");
+  json.String(system_info->gl_vendor);
+  json.Key("renderer");
+  json.String(system_info->gl_renderer);
+  json.EndObject();
+  json.EndObject();
+
+  json.Key("crashed");
+  json.Bool(process_state.crashed());
+  json.Key("crash_info");
+  if (process_state.crashed()) {
+    const ExceptionRecord* exception = process_state.exception_record();
+    json.BeginObject();
+    json.Key("type");
+    json.String(process_state.crash_reason());
+    json.Key("address");
+    json.Hex(process_state.crash_address());
+    json.Key("exception_code");
+    json.Int(exception->code());
+    json.Key("exception_flags");
+    json.Int(exception->flags());
+    json.Key("exception_parameters");
+    json.BeginArray();
+    for (size_t i = 0; i < exception->parameters()->size(); ++i)
+      json.Hex(exception->parameters()->at(i).value());
+    json.EndArray();
+    json.EndObject();
+  } else {
+    json.Null();
+  }
+  if (!process_state.assertion().empty()) {
+    json.Key("assertion");
+    json.String(process_state.assertion());
+  }
+  json.Key("requesting_thread");
+  if (process_state.requesting_thread() != -1)
+    json.Int(process_state.requesting_thread());
+  else
+    json.Null();
+  json.Key("time_date_stamp");
+  json.Int(process_state.time_date_stamp());
+  json.Key("process_create_time");
+  json.Int(process_state.process_create_time());
+
+  json.Key("threads");
+  json.BeginArray();
+  int thread_count = process_state.threads()->size();
+  for (int thread_index = 0; thread_index < thread_count; ++thread_index) {
+    const CallStack* stack = process_state.threads()->at(thread_index);
+    json.BeginObject();
+    json.Key("thread");
+    json.Int(thread_index);
+    json.Key("thread_id");
+    json.Int(stack->tid());
+    json.Key("frames");
+    PrintStackJSON(stack, &json);
+    json.EndObject();
+  }
+  json.EndArray();
+
+  json.Key("modules");
+  PrintModulesJSON(process_state.modules(),
+                   process_state.modules_without_symbols(),
+                   process_state.modules_with_corrupt_symbols(), &json);
+
+  json.EndObject();
+  if (!json.Flush())
+    BPLOG(ERROR) << "Could not write the JSON output";
+}
+
+void PrintProcessingStats(const ProcessingStats& stats,
+                          const ProcessState& process_state) {
+  fprintf(stderr, "Processing statistics:\n");
+  fprintf(stderr, "  read dump:      %10" PRIu64 " us\n", stats.read_dump_us);
+  fprintf(stderr, "  locate symbols: %10" PRIu64 " us\n",
+          stats.locate_symbols_us);
+  fprintf(stderr, "  parse symbols:  %10" PRIu64 " us "
+          "(%" PRIu64 " files, %" PRIu64 " bytes; %" PRIu64 " missing)\n",
+          stats.parse_symbols_us, stats.symbol_files_loaded,
+          stats.symbol_bytes_parsed, stats.symbol_files_missing);
+  fprintf(stderr, "  walk threads:   %10" PRIu64 " us\n", stats.walk_us);
+
+  int thread_count = process_state.threads()->size();
+  for (int thread_index = 0; thread_index < thread_count; ++thread_index) {
+    if (static_cast<size_t>(thread_index) >= stats.thread_walk_us.size())
+      break;
+    const CallStack* stack = process_state.threads()->at(thread_index);
+    fprintf(stderr, "    thread %d (id 0x%x): %" PRIu64 " us, %d frames\n",
+            thread_index, stack->tid(), stats.thread_walk_us[thread_index],
+            static_cast<int>(stack->frames()->size()));
+  }
+
+  fprintf(stderr, "  frames found by:");
+  for (int trust = ProcessingStats::kFrameTrustCount - 1; trust >= 0;
+       --trust) {
+    fprintf(stderr, " %s %" PRIu64,
+            FrameTrustName(static_cast<StackFrame::FrameTrust>(trust)),
+            stats.frames_by_trust[trust]);
+  }
+  fprintf(stderr, "\n");
+  fprintf(stderr, "  words scanned: %" PRIu64 "\n", stats.words_scanned);
+  fprintf(stderr, "  symbol cache: %" PRIu64 " hits, %" PRIu64
+          " known missing\n",
+          stats.symbol_cache_hits, stats.symbol_negative_cache_hits);
+}
+
 }  // namespace google_breakpad
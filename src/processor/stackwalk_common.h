@@ -37,13 +37,19 @@
 namespace google_breakpad {
 
 class ProcessState;
+struct ProcessingStats;
 class SourceLineResolverInterface;
 
 void PrintProcessStateMachineReadable(const ProcessState& process_state);
+void PrintProcessStateJSON(const ProcessState& process_state);
 void PrintProcessState(const ProcessState& process_state,
                        bool output_stack_contents,
                        SourceLineResolverInterface* resolver);
 
+// Prints |stats|, gathered while processing |process_state|, to stderr.
+void PrintProcessingStats(const ProcessingStats& stats,
+                          const ProcessState& process_state);
+
 }  // namespace google_breakpad
 
 #endif  // PROCESSOR_STACKWALK_COMMON_H__
@@ -78,7 +78,9 @@ Stackwalker::Stackwalker(const SystemInfo* system_info,
       memory_(memory),
       modules_(modules),
       unloaded_modules_(NULL),
-      frame_symbolizer_(frame_symbolizer) {
+      frame_symbolizer_(frame_symbolizer),
+      stats_(NULL),
+      frame_limit_(0) {
   assert(frame_symbolizer_);
 }
 
@@ -173,6 +175,8 @@ bool Stackwalker::Walk(
       default:
         break;
     }
+    if (stats_ && frame->trust < ProcessingStats::kFrameTrustCount)
+      ++stats_->frames_by_trust[frame->trust];
 
     // Add the frame to the call stack.  Relinquish the ownership claim
     // over the frame, because the stack now owns it.
@@ -184,6 +188,8 @@ bool Stackwalker::Walk(
         BPLOG(ERROR) << "The stack is over " << max_frames_ << " frames.";
       break;
     }
+    if (frame_limit_ && stack->frames_.size() >= frame_limit_)
+      break;
 
     // Get the next frame and take ownership.
     bool stack_scan_allowed = scanned_frames < max_frames_scanned_;
@@ -30,16 +30,23 @@
 // core2md.cc: A utility to convert an ELF core file to a minidump file.
 
 #include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
+#include "client/linux/minidump_writer/core_dump_reducer.h"
 #include "client/linux/minidump_writer/minidump_writer.h"
 #include "client/linux/minidump_writer/linux_core_dumper.h"
 
 using google_breakpad::AppMemoryList;
+using google_breakpad::CoreDumpReducer;
 using google_breakpad::MappingList;
 using google_breakpad::LinuxCoreDumper;
 
 static int ShowUsage(const char* argv0) {
   fprintf(stderr, "Usage: %s <core file> <procfs dir> <output>\n", argv0);
+  fprintf(stderr, "\nIf <core file> is -, the core dump is read from "
+          "standard input, keeping only what the minidump needs.\n");
   return 1;
 }
 
@@ -61,6 +68,26 @@ int main(int argc, char *argv[]) {
   const char* core_file = argv[1];
   const char* procfs_dir = argv[2];
   const char* minidump_file = argv[3];
+
+  char reduced_core_file[32];
+  int reduced_core_fd = -1;
+  if (strcmp(core_file, "-") == 0) {
+    reduced_core_fd = memfd_create("core_file", MFD_CLOEXEC);
+    if (reduced_core_fd == -1) {
+      perror("core2md: Unable to create a file for the core dump");
+      return 1;
+    }
+    CoreDumpReducer reducer;
+    if (!reducer.Reduce(STDIN_FILENO, reduced_core_fd)) {
+      fprintf(stderr, "core2md: Unable to read the core dump: %s\n",
+              reducer.error());
+      return 1;
+    }
+    snprintf(reduced_core_file, sizeof(reduced_core_file), "/proc/self/fd/%d",
+             reduced_core_fd);
+    core_file = reduced_core_file;
+  }
+
   if (!WriteMinidumpFromCore(minidump_file,
                              core_file,
                              procfs_dir)) {
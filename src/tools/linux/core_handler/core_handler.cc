@@ -38,24 +38,16 @@
 #include <unistd.h>
 #include <sstream>
 
+#include "client/linux/minidump_writer/core_dump_reducer.h"
 #include "client/linux/minidump_writer/linux_core_dumper.h"
 #include "client/linux/minidump_writer/minidump_writer.h"
-#include "common/scoped_ptr.h"
 
 namespace {
 
 using google_breakpad::AppMemoryList;
+using google_breakpad::CoreDumpReducer;
 using google_breakpad::LinuxCoreDumper;
 using google_breakpad::MappingList;
-using google_breakpad::scoped_array;
-
-// Size of the core dump to read in order to access all the threads
-// descriptions.
-//
-// The first section is the note0 section which contains the thread states. On
-// x86-64 a typical thread description take about 1432B. Reading 1 MB allows
-// several hundreds of threads.
-const int core_read_size = 1024 * 1024;
 
 void ShowUsage(const char* argv0) {
   fprintf(stderr, "Usage: %s <process id> <minidump file>\n\n", argv0);
@@ -79,25 +71,19 @@ bool WriteMinidumpFromCore(const char* filename,
 }
 
 bool HandleCrash(pid_t pid, const char* procfs_dir, const char* md_filename) {
-  int r = 0;
-  scoped_array<char> buf(new char[core_read_size]);
-  while (r != core_read_size) {
-    int ret = read(STDIN_FILENO, &buf[r], core_read_size - r);
-    if (ret == 0) {
-      break;
-    } else if (ret == -1) {
-      return false;
-    }
-    r += ret;
-  }
-
   int fd = memfd_create("core_file", MFD_CLOEXEC);
   if (fd == -1) {
     return false;
   }
 
-  int w = write(fd, &buf[0], r);
-  if (w != r) {
+  // Keep only what the minidump needs out of the core dump.  The rest of
+  // stdin is left unread: the kernel keeps the process around until the
+  // pipe is closed, so whatever was not kept can still be read from
+  // /proc/<pid>/mem.
+  CoreDumpReducer reducer;
+  if (!reducer.Reduce(STDIN_FILENO, fd)) {
+    syslog(LOG_ERR, "Cannot reduce the core dump of %d: %s\n", pid,
+           reducer.error());
     close(fd);
     return false;
   }
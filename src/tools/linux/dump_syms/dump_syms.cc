@@ -30,22 +30,112 @@
 #include "compat/linux.h"
 #include "compat/paths.h"
 
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/linux/dump_symbols.h"
 
 using google_breakpad::WriteSymbolFile;
 using google_breakpad::WriteSymbolFileHeader;
+using google_breakpad::WriteSymbolFileToStore;
+
+namespace {
+
+// The binaries a symbol store run is dumping, and how far it has got.
+// Worker threads take the next binary under LOCK.
+struct StoreJob {
+  std::vector<string> binaries;
+  const char* obj_os;
+  std::vector<string> debug_dirs;
+  const google_breakpad::DumpOptions* options;
+  string store_path;
+  FILE* log;
+
+  pthread_mutex_t lock;
+  size_t next;
+  int failures;
+};
+
+void* DumpToStore(void* arg) {
+  StoreJob* job = static_cast<StoreJob*>(arg);
+  while (true) {
+    pthread_mutex_lock(&job->lock);
+    size_t index = job->next++;
+    pthread_mutex_unlock(&job->lock);
+    if (index >= job->binaries.size())
+      break;
+
+    const string& binary = job->binaries[index];
+    string sym_path;
+    bool skipped;
+    bool result = WriteSymbolFileToStore(binary, job->obj_os,
+                                         job->debug_dirs, *job->options,
+                                         job->store_path, &sym_path,
+                                         &skipped);
+    pthread_mutex_lock(&job->lock);
+    if (!result) {
+      fprintf(job->log, "Failed to write symbol file for %s\n",
+              binary.c_str());
+      job->failures++;
+    } else {
+      printf("%s: %s\n", skipped ? "Exists" : "Wrote", sym_path.c_str());
+    }
+    pthread_mutex_unlock(&job->lock);
+  }
+  return NULL;
+}
+
+// Dump every binary in JOB into its symbol store, on THREADS threads.
+// Return the number of binaries that could not be dumped.
+int DumpAllToStore(StoreJob* job, int threads) {
+  // Start on the largest binaries first, so that one big binary is not
+  // left running alone at the end.
+  std::vector<std::pair<off_t, string> > by_size;
+  for (size_t i = 0; i < job->binaries.size(); i++) {
+    struct stat st;
+    off_t size = stat(job->binaries[i].c_str(), &st) == 0 ? st.st_size : 0;
+    by_size.push_back(std::make_pair(-size, job->binaries[i]));
+  }
+  std::sort(by_size.begin(), by_size.end());
+  for (size_t i = 0; i < by_size.size(); i++)
+    job->binaries[i] = by_size[i].second;
+
+  pthread_mutex_init(&job->lock, NULL);
+  job->next = 0;
+  job->failures = 0;
+  std::vector<pthread_t> workers;
+  for (int i = 1; i < threads && static_cast<size_t>(i) < by_size.size();
+       i++) {
+    pthread_t worker;
+    if (pthread_create(&worker, NULL, DumpToStore, job) != 0)
+      break;
+    workers.push_back(worker);
+  }
+  DumpToStore(job);
+  for (size_t i = 0; i < workers.size(); i++)
+    pthread_join(workers[i], NULL);
+  pthread_mutex_destroy(&job->lock);
+  return job->failures;
+}
+
+}  // namespace
 
 int usage(const char* self) {
   fprintf(stderr, "Usage: %s [OPTION] <binary-with-debugging-info> "
-          "[directories-for-debug-file]\n\n", self);
+          "[directories-for-debug-file]\n", self);
+  fprintf(stderr, "       %s [OPTION] -s <store> [-l <list>] "
+          "[<binary-with-debugging-info>...]\n\n", self);
   fprintf(stderr, "Options:\n");
   fprintf(stderr, "  -i:         Output module header information only.\n");
   fprintf(stderr, "  -c          Do not generate CFI section\n");
@@ -55,6 +145,26 @@ int usage(const char* self) {
   fprintf(stderr, "  -n <name>   Use specified name for name of the object\n");
   fprintf(stderr, "  -o <os>     Use specified name for the "
                                  "operating system\n");
+  fprintf(stderr, "  -m <MiB>    Hold at most about this much function and "
+                                 "line data in\n"
+                  "              memory, spilling the rest to temporary "
+                                 "files\n");
+  fprintf(stderr, "  -t          Write register rules shared by several "
+                                 "CFI records once,\n"
+                  "              as STACK CFI RULES records\n");
+  fprintf(stderr, "  -d <dir>    Also look for debug files in this "
+                                 "directory\n");
+  fprintf(stderr, "  -s <store>  Write each binary's symbols into this "
+                                 "symbol store, as\n"
+                  "              <debug_file>/<id>/<debug_file>.sym, "
+                                 "skipping binaries\n"
+                  "              whose symbol file already exists\n");
+  fprintf(stderr, "  -l <list>   With -s, also dump the binaries named, "
+                                 "one per line,\n"
+                  "              in this file\n");
+  fprintf(stderr, "  -j <count>  With -s, dump this many binaries at once "
+                                 "(default:\n"
+                  "              the number of CPUs)\n");
   return 1;
 }
 
@@ -67,6 +177,12 @@ int main(int argc, char** argv) {
   bool log_to_stderr = false;
   std::string obj_name;
   const char* obj_os = "Linux";
+  size_t function_memory_budget = 0;
+  bool share_cfi_rules = false;
+  std::vector<string> debug_dirs;
+  const char* store_path = NULL;
+  const char* list_path = NULL;
+  long threads = sysconf(_SC_NPROCESSORS_ONLN);
   int arg_index = 1;
   while (arg_index < argc && strlen(argv[arg_index]) > 0 &&
          argv[arg_index][0] == '-') {
@@ -76,6 +192,8 @@ int main(int argc, char** argv) {
       cfi = false;
     } else if (strcmp("-r", argv[arg_index]) == 0) {
       handle_inter_cu_refs = false;
+    } else if (strcmp("-t", argv[arg_index]) == 0) {
+      share_cfi_rules = true;
     } else if (strcmp("-v", argv[arg_index]) == 0) {
       log_to_stderr = true;
     } else if (strcmp("-n", argv[arg_index]) == 0) {
@@ -92,14 +210,53 @@ int main(int argc, char** argv) {
       }
       obj_os = argv[arg_index + 1];
       ++arg_index;
+    } else if (strcmp("-m", argv[arg_index]) == 0) {
+      char* end = NULL;
+      unsigned long megabytes = arg_index + 1 < argc ?
+          strtoul(argv[arg_index + 1], &end, 10) : 0;
+      if (!end || *end || megabytes == 0) {
+        fprintf(stderr, "Missing or invalid argument to -m\n");
+        return usage(argv[0]);
+      }
+      function_memory_budget = static_cast<size_t>(megabytes) << 20;
+      ++arg_index;
+    } else if (strcmp("-d", argv[arg_index]) == 0 ||
+               strcmp("-s", argv[arg_index]) == 0 ||
+               strcmp("-l", argv[arg_index]) == 0) {
+      if (arg_index + 1 >= argc) {
+        fprintf(stderr, "Missing argument to %s\n", argv[arg_index]);
+        return usage(argv[0]);
+      }
+      const char* value = argv[arg_index + 1];
+      if (argv[arg_index][1] == 'd')
+        debug_dirs.push_back(value);
+      else if (argv[arg_index][1] == 's')
+        store_path = value;
+      else
+        list_path = value;
+      ++arg_index;
+    } else if (strcmp("-j", argv[arg_index]) == 0) {
+      char* end = NULL;
+      threads = arg_index + 1 < argc ?
+          strtol(argv[arg_index + 1], &end, 10) : 0;
+      if (!end || *end || threads <= 0) {
+        fprintf(stderr, "Missing or invalid argument to -j\n");
+        return usage(argv[0]);
+      }
+      ++arg_index;
     } else {
       printf("2.4 %s\n", argv[arg_index]);
       return usage(argv[0]);
     }
     ++arg_index;
   }
-  if (arg_index == argc)
+  if (store_path) {
+    // Each binary's module name gives its place in the store.
+    if (header_only || !obj_name.empty() || (arg_index == argc && !list_path))
+      return usage(argv[0]);
+  } else if (arg_index == argc || list_path) {
     return usage(argv[0]);
+  }
   // Save stderr so it can be used below.
   FILE* saved_stderr = fdopen(dup(fileno(stderr)), "w");
   if (!log_to_stderr) {
@@ -108,8 +265,36 @@ int main(int argc, char** argv) {
       // Add this brace section to silence gcc warnings.
     }
   }
+
+  SymbolData symbol_data = cfi ? ALL_SYMBOL_DATA : NO_CFI;
+  google_breakpad::DumpOptions options(symbol_data, handle_inter_cu_refs);
+  options.function_memory_budget = function_memory_budget;
+  options.share_cfi_rules = share_cfi_rules;
+
+  if (store_path) {
+    StoreJob job;
+    job.binaries.assign(argv + arg_index, argv + argc);
+    if (list_path) {
+      std::ifstream list(list_path);
+      if (!list) {
+        fprintf(saved_stderr, "Failed to open %s\n", list_path);
+        return 1;
+      }
+      string line;
+      while (std::getline(list, line)) {
+        if (!line.empty())
+          job.binaries.push_back(line);
+      }
+    }
+    job.obj_os = obj_os;
+    job.debug_dirs = debug_dirs;
+    job.options = &options;
+    job.store_path = store_path;
+    job.log = saved_stderr;
+    return DumpAllToStore(&job, threads) ? 1 : 0;
+  }
+
   const char* binary;
-  std::vector<string> debug_dirs;
   binary = argv[arg_index];
   for (int debug_dir_index = arg_index + 1;
        debug_dir_index < argc;
@@ -126,8 +311,6 @@ int main(int argc, char** argv) {
       return 1;
     }
   } else {
-    SymbolData symbol_data = cfi ? ALL_SYMBOL_DATA : NO_CFI;
-    google_breakpad::DumpOptions options(symbol_data, handle_inter_cu_refs);
     if (!WriteSymbolFile(binary, obj_name, obj_os, debug_dirs, options,
                          std::cout)) {
       fprintf(saved_stderr, "Failed to write symbol file.\n");
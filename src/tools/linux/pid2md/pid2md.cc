@@ -33,6 +33,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include "client/linux/minidump_writer/mapping_info_cache.h"
 #include "client/linux/minidump_writer/minidump_writer.h"
 
 int main(int argc, char* argv[]) {
@@ -48,7 +49,10 @@ int main(int argc, char* argv[]) {
   pid_t process_id = atoi(argv[1]);
   const char* minidump_file = argv[2];
 
-  if (!google_breakpad::WriteMinidump(minidump_file, process_id, process_id)) {
+  // Modules are looked up several times per dump; read each file once.
+  google_breakpad::MappingInfoCache mapping_cache;
+  if (!google_breakpad::WriteMinidump(minidump_file, process_id, process_id,
+                                      &mapping_cache)) {
     fprintf(stderr, "Unable to generate minidump.\n");
     return EXIT_FAILURE;
   }
@@ -57,12 +57,40 @@ def symbolize(bin, symdir):
         proc.terminate()
 
 
+def symbolize_all(bins, symdir, jobs):
+    # Plain Linux binaries are dumped by a single dump_syms run, which
+    # works through them in parallel and skips those already in the store.
+    batch = [b for b in bins if not b.endswith((".exe", ".nexe"))]
+    for bin in batch:
+        if not os.path.isfile(bin):
+            print("Binary doesn't exist:", bin)
+            exit(1)
+    if not os.path.isdir(symdir):
+        print("Symbol directory doesn't exist:", symdir)
+        exit(1)
+    returncode = 0
+    if batch:
+        cmd = [dump_syms_path(batch[0]), "-s", symdir]
+        if jobs:
+            cmd += ["-j", str(jobs)]
+        try:
+            returncode = subprocess.call(cmd + batch, stdin=subprocess.DEVNULL)
+        except FileNotFoundError:
+            print("You need to build the dump_syms binary", dump_syms_path(batch[0]))
+            exit(1)
+    for bin in bins:
+        if bin not in batch:
+            returncode = symbolize(bin, symdir) or returncode
+    return returncode
+
+
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(
         description="Generate debug symbols and store in required directory structure",
         formatter_class=argparse.ArgumentDefaultsHelpFormatter)
-    parser.add_argument("binary", help="Non-stripped Linux, Windows, or NaCl binary")
+    parser.add_argument("binary", nargs="+", help="Non-stripped Linux, Windows, or NaCl binary")
     symbols = os.path.join(os.path.dirname(__file__), "symbols")
     parser.add_argument("-s", "--symbol-directory", default=symbols, help="Where to store output")
+    parser.add_argument("-j", "--jobs", type=int, help="Binaries to dump at once (default: one per CPU)")
     args = parser.parse_args()
-    exit(symbolize(args.binary, args.symbol_directory))
+    exit(symbolize_all(args.binary, args.symbol_directory, args.jobs))